@@ -218,7 +218,7 @@ static const char* getFilterPatternByType(const int32_t type, const bool isSave)
     switch (type & 0x0E)
     {
         case LOADSAVETYPE_GAME:
-            return isSave ? "*.sv6" : "*.sv6;*.sc6;*.sc4;*.sv4;*.sv7;*.sea;";
+            return isSave ? "*.sv6" : "*.sv6;*.park;*.sc6;*.sc4;*.sv4;*.sv7;*.sea;";
 
         case LOADSAVETYPE_LANDSCAPE:
             return isSave ? "*.sc6" : "*.sc6;*.sv6;*.sc4;*.sv4;*.sv7;*.sea;";
@@ -433,7 +433,9 @@ static bool browse(bool isSave, char* path, size_t pathSize)
     {
         // When the given save type was given, Windows still interprets a filename with a dot in its name as a custom extension,
         // meaning files like "My Coaster v1.2" will not get the .td6 extension by default.
-        if (isSave && get_file_extension_type(path) != fileType)
+        // Games can also be saved as park files by typing the extension.
+        uint32_t pathFileType = get_file_extension_type(path);
+        if (isSave && pathFileType != fileType && !(fileType == FILE_EXTENSION_SV6 && pathFileType == FILE_EXTENSION_PARK))
             path_append_extension(path, extension, pathSize);
 
         return true;
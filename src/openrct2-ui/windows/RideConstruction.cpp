@@ -2437,18 +2437,6 @@ static void sub_6CBCE2(
         auto northTileCoords = centreTileCoords + TileDirectionDelta[TILE_ELEMENT_DIRECTION_NORTH];
         auto southTileCoords = centreTileCoords + TileDirectionDelta[TILE_ELEMENT_DIRECTION_SOUTH];
 
-        // Replace map elements with temporary ones containing track
-        _backupTileElementArrays[0] = map_get_first_element_at(centreTileCoords.ToCoordsXY());
-        _backupTileElementArrays[1] = map_get_first_element_at(eastTileCoords.ToCoordsXY());
-        _backupTileElementArrays[2] = map_get_first_element_at(westTileCoords.ToCoordsXY());
-        _backupTileElementArrays[3] = map_get_first_element_at(northTileCoords.ToCoordsXY());
-        _backupTileElementArrays[4] = map_get_first_element_at(southTileCoords.ToCoordsXY());
-        map_set_tile_element(centreTileCoords, &_tempTrackTileElement);
-        map_set_tile_element(eastTileCoords, &_tempSideTrackTileElement);
-        map_set_tile_element(westTileCoords, &_tempSideTrackTileElement);
-        map_set_tile_element(northTileCoords, &_tempSideTrackTileElement);
-        map_set_tile_element(southTileCoords, &_tempSideTrackTileElement);
-
         // Set the temporary track element
         _tempTrackTileElement.SetType(TILE_ELEMENT_TYPE_TRACK);
         _tempTrackTileElement.SetDirection(trackDirection);
@@ -2465,6 +2453,22 @@ static void sub_6CBCE2(
         // Skipping seat rotation, should not be necessary for a temporary piece.
         _tempTrackTileElement.AsTrack()->SetRideIndex(rideIndex);
 
+        // Replace map elements with temporary ones containing track. Tiles can only refer to elements in the tile
+        // element storage, so the temporary elements are copied into its scratch elements.
+        TileElement* scratchElements = map_get_scratch_tile_elements();
+        scratchElements[0] = _tempTrackTileElement;
+        scratchElements[1] = _tempSideTrackTileElement;
+        _backupTileElementArrays[0] = map_get_first_element_at(centreTileCoords.ToCoordsXY());
+        _backupTileElementArrays[1] = map_get_first_element_at(eastTileCoords.ToCoordsXY());
+        _backupTileElementArrays[2] = map_get_first_element_at(westTileCoords.ToCoordsXY());
+        _backupTileElementArrays[3] = map_get_first_element_at(northTileCoords.ToCoordsXY());
+        _backupTileElementArrays[4] = map_get_first_element_at(southTileCoords.ToCoordsXY());
+        map_set_tile_element(centreTileCoords, &scratchElements[0]);
+        map_set_tile_element(eastTileCoords, &scratchElements[1]);
+        map_set_tile_element(westTileCoords, &scratchElements[1]);
+        map_set_tile_element(northTileCoords, &scratchElements[1]);
+        map_set_tile_element(southTileCoords, &scratchElements[1]);
+
         // Draw this map tile
         sub_68B2B7(session, coords);
 
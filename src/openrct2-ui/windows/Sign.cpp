@@ -177,7 +177,7 @@ rct_window* window_sign_open(rct_windownumber number)
             }
         }
         tile_element++;
-        if (tile_element >= &gTileElements[std::size(gTileElements)])
+        if (tile_element >= gTileElements.data() + gTileElements.size())
         {
             return nullptr;
         }
@@ -233,7 +233,7 @@ static void window_sign_mouseup(rct_window* w, rct_widgetindex widgetIndex)
                     }
                 }
                 tile_element++;
-                if (tile_element >= &gTileElements[std::size(gTileElements)])
+                if (tile_element >= gTileElements.data() + gTileElements.size())
                 {
                     return;
                 }
@@ -159,6 +159,9 @@ namespace OpenRCT2
             network_close();
             window_close_all();
 
+            // Let an autosave that is still being written finish before shutting down.
+            scenario_save_wait();
+
             // Unload objects after closing all windows, this is to overcome windows like
             // the object selection window which loads objects when closed.
             if (_objectManager != nullptr)
@@ -586,7 +589,11 @@ namespace OpenRCT2
                 }
 
                 std::unique_ptr<IParkImporter> parkImporter;
-                if (info.Version <= FILE_TYPE_S4_CUTOFF)
+                if (info.IsParkFile)
+                {
+                    parkImporter = ParkImporter::CreateParkFile();
+                }
+                else if (info.Version <= FILE_TYPE_S4_CUTOFF)
                 {
                     // Save is an S4 (RCT1 format)
                     parkImporter = ParkImporter::CreateS4();
@@ -9,6 +9,7 @@
 
 #include "FileClassifier.h"
 
+#include "ParkFile.h"
 #include "core/Console.hpp"
 #include "core/FileStream.hpp"
 #include "core/Path.hpp"
@@ -16,6 +17,7 @@
 #include "scenario/Scenario.h"
 #include "util/SawyerCoding.h"
 
+static bool TryClassifyAsPark(OpenRCT2::IStream* stream, ClassifiedFileInfo* result);
 static bool TryClassifyAsS6(OpenRCT2::IStream* stream, ClassifiedFileInfo* result);
 static bool TryClassifyAsS4(OpenRCT2::IStream* stream, ClassifiedFileInfo* result);
 static bool TryClassifyAsTD4_TD6(OpenRCT2::IStream* stream, ClassifiedFileInfo* result);
@@ -40,6 +42,12 @@ bool TryClassifyFile(OpenRCT2::IStream* stream, ClassifiedFileInfo* result)
     //      between them is to decode it. Decoding however is currently not protected
     //      against invalid compression data for that decoding algorithm and will crash.
 
+    // Park file detection, these have a magic number so can be told apart without decoding anything
+    if (TryClassifyAsPark(stream, result))
+    {
+        return true;
+    }
+
     // S6 detection
     if (TryClassifyAsS6(stream, result))
     {
@@ -61,6 +69,38 @@ bool TryClassifyFile(OpenRCT2::IStream* stream, ClassifiedFileInfo* result)
     return false;
 }
 
+static bool TryClassifyAsPark(OpenRCT2::IStream* stream, ClassifiedFileInfo* result)
+{
+    if (!ParkFileReader::IsParkFile(stream))
+    {
+        return false;
+    }
+
+    bool success = false;
+    uint64_t originalPosition = stream->GetPosition();
+    try
+    {
+        ParkFileReader reader(stream);
+        if (reader.GetType() == S6_TYPE_SAVEDGAME)
+        {
+            result->Type = FILE_TYPE::SAVED_GAME;
+        }
+        else if (reader.GetType() == S6_TYPE_SCENARIO)
+        {
+            result->Type = FILE_TYPE::SCENARIO;
+        }
+        result->Version = reader.GetVersion();
+        result->IsParkFile = true;
+        success = true;
+    }
+    catch (const std::exception& e)
+    {
+        log_verbose(e.what());
+    }
+    stream->SetPosition(originalPosition);
+    return success;
+}
+
 static bool TryClassifyAsS6(OpenRCT2::IStream* stream, ClassifiedFileInfo* result)
 {
     bool success = false;
@@ -181,5 +221,7 @@ uint32_t get_file_extension_type(const utf8* path)
         return FILE_EXTENSION_SV6;
     if (String::Equals(extension, ".td6", true))
         return FILE_EXTENSION_TD6;
+    if (String::Equals(extension, ".park", true))
+        return FILE_EXTENSION_PARK;
     return FILE_EXTENSION_UNKNOWN;
 }
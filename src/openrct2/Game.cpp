@@ -615,7 +615,7 @@ void game_unload_scripts()
  */
 void reset_all_sprite_quadrant_placements()
 {
-    for (size_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < GetEntityCapacity(); i++)
     {
         auto* spr = GetEntity(i);
         if (spr != nullptr && spr->sprite_identifier != SPRITE_IDENTIFIER_NULL)
@@ -700,7 +700,7 @@ static void limit_autosave_count(const size_t numberOfFilesToKeep, bool processL
     {
         platform_get_user_directory(filter, "save", sizeof(filter));
         safe_strcat_path(filter, "autosave", sizeof(filter));
-        safe_strcat_path(filter, "autosave_*.sv6", sizeof(filter));
+        safe_strcat_path(filter, "autosave_*.sv6;autosave_*.park", sizeof(filter));
     }
 
     // At first, count how many autosaves there are
@@ -755,8 +755,9 @@ static void limit_autosave_count(const size_t numberOfFilesToKeep, bool processL
 
 void game_autosave()
 {
+    // Saved games are autosaved as park files, these are faster to write and keep parks that outgrew the SV6 limits.
     const char* subDirectory = "save";
-    const char* fileExtension = ".sv6";
+    const char* fileExtension = ".park";
     uint32_t saveFlags = 0x80000000;
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
     {
@@ -774,6 +775,9 @@ void game_autosave()
         timeName, sizeof(timeName), "autosave_%04u-%02u-%02u_%02u-%02u-%02u%s", currentDate.year, currentDate.month,
         currentDate.day, currentTime.hour, currentTime.minute, currentTime.second, fileExtension);
 
+    // The previous autosave may still be written in the background, it must finish before old autosaves are removed.
+    scenario_save_wait();
+
     int32_t autosavesToKeep = gConfigGeneral.autosave_amount;
     limit_autosave_count(autosavesToKeep - 1, (gScreenFlags & SCREEN_FLAGS_EDITOR));
 
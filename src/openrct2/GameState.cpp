@@ -300,11 +300,15 @@ void GameState::UpdateLogic()
     ride_measurements_update();
     News::UpdateCurrentItem();
 
+    // Map animations also advance on-ride photos, wall animations and guests checking the time
     map_animation_invalidate_all();
-    vehicle_sounds_update();
-    peep_update_crowd_noise();
-    climate_update_sound();
-    editor_open_windows_for_current_step();
+    if (!gOpenRCT2Headless)
+    {
+        vehicle_sounds_update();
+        peep_update_crowd_noise();
+        climate_update_sound();
+        editor_open_windows_for_current_step();
+    }
 
     // Update windows
     // window_dispatch_update_all();
@@ -0,0 +1,164 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "GameStateHash.h"
+
+#include "Game.h"
+#include "localisation/Date.h"
+#include "management/Finance.h"
+#include "peep/Peep.h"
+#include "ride/Ride.h"
+#include "scenario/Scenario.h"
+#include "world/Map.h"
+#include "world/Park.h"
+#include "world/Sprite.h"
+
+#include <cstdio>
+#include <cstring>
+
+// MurmurHash64A, processes the data 8 bytes at a time.
+static uint64_t hash_bytes(const void* data, size_t length, uint64_t seed)
+{
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ull;
+    constexpr int32_t r = 47;
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t h = seed ^ (length * m);
+    for (; length >= 8; bytes += 8, length -= 8)
+    {
+        uint64_t k;
+        std::memcpy(&k, bytes, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    if (length > 0)
+    {
+        uint64_t k = 0;
+        std::memcpy(&k, bytes, length);
+        h ^= k;
+        h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+template<typename T> static void hash_value(uint64_t& hash, const T& value)
+{
+    hash = hash_bytes(&value, sizeof(value), hash);
+}
+
+std::string GameStateHash::ToString() const
+{
+    char buffer[3 * 16 + 3];
+    snprintf(
+        buffer, sizeof(buffer), "%016llx-%016llx-%016llx", static_cast<unsigned long long>(Entities),
+        static_cast<unsigned long long>(TileElements), static_cast<unsigned long long>(Park));
+    return buffer;
+}
+
+GameStateHash game_state_hash()
+{
+    GameStateHash result;
+    result.Entities = game_state_hash_entities();
+    result.TileElements = game_state_hash_tile_elements();
+    result.Park = game_state_hash_park();
+    return result;
+}
+
+uint64_t game_state_hash_entities()
+{
+    uint64_t result = 0;
+    const size_t capacity = GetEntityCapacity();
+    for (size_t i = 0; i < capacity; i++)
+    {
+        auto sprite = GetEntity(i);
+        if (sprite != nullptr && sprite->sprite_identifier != SPRITE_IDENTIFIER_NULL
+            && sprite->sprite_identifier != SPRITE_IDENTIFIER_MISC)
+        {
+            auto copy = sprite_get_state_copy(sprite);
+            result += hash_bytes(&copy, sizeof(copy), i);
+        }
+    }
+    return result;
+}
+
+uint64_t game_state_hash_tile_elements()
+{
+    constexpr uint8_t IgnoredFlags = TILE_ELEMENT_FLAG_GHOST | TILE_ELEMENT_FLAG_LAST_TILE;
+
+    uint64_t result = 0;
+    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+    {
+        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+        {
+            const TileElement* tileElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (tileElement == nullptr)
+                continue;
+
+            uint64_t tileHash = (static_cast<uint64_t>(y) << 8) | x;
+            do
+            {
+                if (tileElement->IsGhost())
+                    continue;
+
+                TileElement copy = *tileElement;
+                copy.Flags &= ~IgnoredFlags;
+                // Set by the ride construction window of each client while it shows the selected piece
+                if (copy.GetType() == TILE_ELEMENT_TYPE_TRACK)
+                    copy.AsTrack()->SetHighlight(false);
+                hash_value(tileHash, copy);
+            } while (!(tileElement++)->IsLastForTile());
+            result += tileHash;
+        }
+    }
+    return result;
+}
+
+uint64_t game_state_hash_park()
+{
+    uint64_t result = 0;
+    hash_value(result, gCurrentTicks);
+    hash_value(result, gDateMonthsElapsed);
+    hash_value(result, gDateMonthTicks);
+    hash_value(result, scenario_rand_state().s0);
+    hash_value(result, scenario_rand_state().s1);
+
+    hash_value(result, gCash);
+    hash_value(result, gBankLoan);
+    hash_value(result, gCurrentExpenditure);
+    hash_value(result, gCurrentProfit);
+    hash_value(result, gHistoricalProfit);
+    hash_value(result, gParkValue);
+    hash_value(result, gCompanyValue);
+    hash_value(result, gTotalAdmissions);
+    hash_value(result, gTotalIncomeFromAdmissions);
+    hash_value(result, gParkRating);
+    hash_value(result, gNumGuestsInPark);
+
+    for (const auto& ride : GetRideManager())
+    {
+        hash_value(result, ride.id);
+        hash_value(result, ride.type);
+        hash_value(result, ride.status);
+        hash_value(result, ride.lifecycle_flags);
+        hash_value(result, ride.excitement);
+        hash_value(result, ride.intensity);
+        hash_value(result, ride.nausea);
+        hash_value(result, ride.cur_num_customers);
+        hash_value(result, ride.num_riders);
+        hash_value(result, ride.total_customers);
+        hash_value(result, ride.price);
+    }
+    return result;
+}
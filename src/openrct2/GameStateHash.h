@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+
+#include <string>
+
+/**
+ * A hash of the game state used to detect desynchronisation. Unlike sprite_checksum it also covers the map and
+ * the park, each component is kept separate so a mismatch tells which part of the state went out of sync.
+ *
+ * Every component is recomputed from the full state on each call, nothing is maintained as entities and tile
+ * elements change. It is meant for the periodic checks, not for every tick.
+ */
+struct GameStateHash
+{
+    uint64_t Entities{};
+    uint64_t TileElements{};
+    uint64_t Park{};
+
+    std::string ToString() const;
+
+    bool operator==(const GameStateHash& other) const
+    {
+        return Entities == other.Entities && TileElements == other.TileElements && Park == other.Park;
+    }
+    bool operator!=(const GameStateHash& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+GameStateHash game_state_hash();
+
+/**
+ * Sum of the hashes of the individual entities, each seeded with its sprite index as the indices are part of the
+ * synchronised state. Misc sprites are left out like in sprite_checksum.
+ */
+uint64_t game_state_hash_entities();
+
+/**
+ * Hash of every tile element that is not a ghost. Ghosts are placed by each client on its own, as is the highlight
+ * of the track piece selected for construction, which is left out too.
+ */
+uint64_t game_state_hash_tile_elements();
+
+/**
+ * Hash of the date, random state, finances and the state of each ride.
+ */
+uint64_t game_state_hash_park();
@@ -0,0 +1,183 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "GameStateImage.h"
+
+#include "Context.h"
+#include "Game.h"
+#include "GameState.h"
+#include "core/DataSerialiser.h"
+#include "drawing/Drawing.h"
+#include "localisation/Date.h"
+#include "management/Award.h"
+#include "management/Finance.h"
+#include "management/Marketing.h"
+#include "management/NewsItem.h"
+#include "management/Research.h"
+#include "peep/Peep.h"
+#include "peep/Staff.h"
+#include "ride/RideRatings.h"
+#include "ride/ShopItem.h"
+#include "scenario/Scenario.h"
+#include "world/Banner.h"
+#include "world/Climate.h"
+#include "world/Entrance.h"
+#include "world/Map.h"
+#include "world/MapAnimation.h"
+#include "world/Park.h"
+#include "world/Sprite.h"
+
+using namespace OpenRCT2;
+
+static void game_state_image_serialise_banners(DataSerialiser& ds)
+{
+    for (BannerIndex i = 0; i < MAX_BANNERS; i++)
+    {
+        auto banner = GetBanner(i);
+        ds << DS_RAW(banner->type);
+        ds << DS_RAW(banner->flags);
+        ds << banner->text;
+        ds << DS_RAW(banner->colour);
+        ds << DS_RAW(banner->ride_index);
+        ds << DS_RAW(banner->text_colour);
+        ds << DS_RAW(banner->position);
+    }
+}
+
+static void game_state_image_serialise_park(DataSerialiser& ds)
+{
+    auto& park = GetContext()->GetGameState()->GetPark();
+    ds << park.Name;
+    ds << DS_RAW(gParkFlags);
+    ds << DS_RAW(gParkRating);
+    ds << DS_RAW(gParkEntranceFee);
+    ds << DS_RAW(gParkSize);
+    ds << DS_RAW(gLandPrice);
+    ds << DS_RAW(gConstructionRightsPrice);
+    ds << DS_RAW(gTotalAdmissions);
+    ds << DS_RAW(gTotalIncomeFromAdmissions);
+    ds << DS_RAW(gParkValue);
+    ds << DS_RAW(gCompanyValue);
+    ds << DS_RAW(gParkRatingCasualtyPenalty);
+    ds << DS_RAW(gParkRatingHistory);
+    ds << DS_RAW(gGuestsInParkHistory);
+    ds << DS_RAW(_guestGenerationProbability);
+    ds << DS_RAW(_suggestedGuestMaximum);
+    ds << DS_RAW(gParkEntrances);
+    ds << DS_RAW(gSamePriceThroughoutPark);
+    ds << DS_RAW(gTotalRideValueForMoney);
+    ds << DS_RAW(gCurrentAwards);
+    ds << DS_RAW(gMarketingCampaigns);
+
+    ds << DS_RAW(gInitialCash);
+    ds << DS_RAW(gCash);
+    ds << DS_RAW(gBankLoan);
+    ds << DS_RAW(gBankLoanInterestRate);
+    ds << DS_RAW(gMaxBankLoan);
+    ds << DS_RAW(gCurrentExpenditure);
+    ds << DS_RAW(gCurrentProfit);
+    ds << DS_RAW(gHistoricalProfit);
+    ds << DS_RAW(gWeeklyProfitAverageDividend);
+    ds << DS_RAW(gWeeklyProfitAverageDivisor);
+    ds << DS_RAW(gCashHistory);
+    ds << DS_RAW(gWeeklyProfitHistory);
+    ds << DS_RAW(gParkValueHistory);
+    ds << DS_RAW(gExpenditureTable);
+
+    ds << DS_RAW(gResearchFundingLevel);
+    ds << DS_RAW(gResearchPriorities);
+    ds << DS_RAW(gResearchProgress);
+    ds << DS_RAW(gResearchProgressStage);
+    ds << DS_RAW(gResearchExpectedMonth);
+    ds << DS_RAW(gResearchExpectedDay);
+    ds << DS_RAW(gResearchLastItem);
+    ds << DS_RAW(gResearchNextItem);
+    ds << DS_RAW(gResearchItemsUninvented);
+    ds << DS_RAW(gResearchItemsInvented);
+    ds << DS_RAW(gResearchUncompletedCategories);
+
+    ds << DS_RAW(gGuestChangeModifier);
+    ds << DS_RAW(gNumGuestsInPark);
+    ds << DS_RAW(gNumGuestsInParkLastWeek);
+    ds << DS_RAW(gNumGuestsHeadingForPark);
+    ds << DS_RAW(gGuestInitialCash);
+    ds << DS_RAW(gGuestInitialHappiness);
+    ds << DS_RAW(gGuestInitialHunger);
+    ds << DS_RAW(gGuestInitialThirst);
+    ds << DS_RAW(gNextGuestNumber);
+    ds << DS_RAW(gPeepWarningThrottle);
+    ds << DS_RAW(gStaffPatrolAreas);
+    ds << DS_RAW(gStaffModes);
+    ds << DS_RAW(gStaffHandymanColour);
+    ds << DS_RAW(gStaffMechanicColour);
+    ds << DS_RAW(gStaffSecurityColour);
+
+    ds << DS_RAW(gScenarioObjectiveType);
+    ds << DS_RAW(gScenarioObjectiveYear);
+    ds << DS_RAW(gScenarioObjectiveNumGuests);
+    ds << DS_RAW(gScenarioObjectiveCurrency);
+    ds << DS_RAW(gScenarioParkRatingWarningDays);
+    ds << DS_RAW(gScenarioCompletedCompanyValue);
+    ds << DS_RAW(gScenarioCompanyValueRecord);
+    ds << gScenarioCompletedBy;
+    ds << DS_RAW(gSavedAge);
+
+    ds << DS_RAW(gClimate);
+    ds << DS_RAW(gClimateCurrent);
+    ds << DS_RAW(gClimateNext);
+    ds << DS_RAW(gClimateUpdateTimer);
+    ds << DS_RAW(gNewsItems);
+}
+
+static void game_state_image_serialise(DataSerialiser& ds)
+{
+    ds << DS_RAW(gCurrentTicks);
+    ds << DS_RAW(gScenarioTicks);
+    ds << DS_RAW(gDateMonthsElapsed);
+    ds << DS_RAW(gDateMonthTicks);
+
+    // The engine is not trivially copyable, only its state is stored.
+    auto randState = scenario_rand_state();
+    ds << DS_RAW(randState);
+
+    map_serialise_state(ds);
+    sprite_serialise_state(ds);
+    game_state_image_serialise_banners(ds);
+
+    auto mapAnimations = GetMapAnimations();
+    ds << DS_RAW(mapAnimations);
+
+    ds << DS_RAW(gRideRatingsCalcData);
+    game_state_image_serialise_park(ds);
+
+    if (ds.IsLoading())
+    {
+        scenario_rand_seed(randState.s0, randState.s1);
+        SetMapAnimations(mapAnimations);
+        GetContext()->GetGameState()->GetDate() = Date(gDateMonthsElapsed, gDateMonthTicks);
+    }
+}
+
+void game_state_image_capture(GameStateImage& image)
+{
+    image.Tick = gCurrentTicks;
+    image.Data.SetPosition(0);
+    DataSerialiser ds(true, image.Data);
+    game_state_image_serialise(ds);
+    ride_copy_all(image.Rides);
+}
+
+void game_state_image_restore(GameStateImage& image)
+{
+    image.Data.SetPosition(0);
+    DataSerialiser ds(false, image.Data);
+    game_state_image_serialise(ds);
+    ride_restore_all(image.Rides);
+    gfx_invalidate_screen();
+}
@@ -0,0 +1,39 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+#include "core/MemoryStream.h"
+#include "ride/Ride.h"
+
+#include <vector>
+
+/**
+ * A copy of the game state kept in memory, e.g. to roll back to an earlier tick. The state is copied as it is stored
+ * instead of being converted to a save format, so an image can only be restored in the process that captured it and
+ * while the same objects are loaded.
+ */
+struct GameStateImage
+{
+    uint32_t Tick{};
+    OpenRCT2::MemoryStream Data;
+    std::vector<Ride> Rides;
+};
+
+/**
+ * Copies the map, entities, rides, park, finances and random state into the image. Capturing into the same image
+ * again reuses its memory.
+ */
+void game_state_image_capture(GameStateImage& image);
+
+/**
+ * Puts the state of the image back, the image can be restored again afterwards.
+ */
+void game_state_image_restore(GameStateImage& image);
@@ -13,15 +13,87 @@
 #include "peep/Peep.h"
 #include "world/Sprite.h"
 
+#include <algorithm>
+
 static constexpr size_t MaximumGameStateSnapshots = 32;
 static constexpr uint32_t InvalidTick = 0xFFFFFFFF;
 
+/**
+ * Number of bytes of the sprite stored by SerialiseSprites after its identifier, must be kept in sync with it.
+ */
+static size_t GetStoredSpriteSize(const rct_sprite& sprite)
+{
+    switch (sprite.generic.sprite_identifier)
+    {
+        case SPRITE_IDENTIFIER_VEHICLE:
+            return sizeof(Vehicle);
+        case SPRITE_IDENTIFIER_PEEP:
+            return sizeof(Peep);
+        case SPRITE_IDENTIFIER_LITTER:
+            return sizeof(Litter);
+        case SPRITE_IDENTIFIER_MISC:
+            switch (sprite.generic.type)
+            {
+                case SPRITE_MISC_MONEY_EFFECT:
+                    return sizeof(MoneyEffect);
+                case SPRITE_MISC_BALLOON:
+                    return sizeof(Balloon);
+                case SPRITE_MISC_DUCK:
+                    return sizeof(Duck);
+                case SPRITE_MISC_JUMPING_FOUNTAIN_WATER:
+                    return sizeof(JumpingFountain);
+                case SPRITE_MISC_STEAM_PARTICLE:
+                    return sizeof(SteamParticle);
+            }
+            break;
+    }
+    return 0;
+}
+
+/**
+ * Returns the sprite the way it reads back after being saved and loaded by SerialiseSprites, everything
+ * that is not stored is zero.
+ */
+static rct_sprite GetStoredSpriteState(const rct_sprite* sprite)
+{
+    rct_sprite state;
+    state.generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
+    if (sprite == nullptr || sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
+        return state;
+
+    std::memcpy(&state, sprite, GetStoredSpriteSize(*sprite));
+    state.generic.sprite_identifier = sprite->generic.sprite_identifier;
+    if (sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_MISC)
+    {
+        state.generic.type = sprite->generic.type;
+    }
+    return state;
+}
+
+/**
+ * Checks if the sprite still matches a state returned by GetStoredSpriteState, without making a copy of it.
+ */
+static bool IsStoredSpriteStateEqual(const rct_sprite* sprite, const rct_sprite& state)
+{
+    if (sprite == nullptr || sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
+        return state.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL;
+    if (sprite->generic.sprite_identifier != state.generic.sprite_identifier)
+        return false;
+    if (sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_MISC && sprite->generic.type != state.generic.type)
+        return false;
+    // Same identifier and type so the stored size is the same, the state is zero past it.
+    return std::memcmp(sprite, &state, GetStoredSpriteSize(*sprite)) == 0;
+}
+
 struct GameStateSnapshot_t
 {
     GameStateSnapshot_t& operator=(GameStateSnapshot_t&& mv) noexcept
     {
         tick = mv.tick;
         storedSprites = std::move(mv.storedSprites);
+        baseSprites = std::move(mv.baseSprites);
+        changedIndices = std::move(mv.changedIndices);
+        changedSprites = std::move(mv.changedSprites);
         return *this;
     }
 
@@ -31,6 +103,38 @@ struct GameStateSnapshot_t
     OpenRCT2::MemoryStream storedSprites;
     OpenRCT2::MemoryStream parkParameters;
 
+    // Captured snapshots share the sprites of a base capture and only hold the sprites that differ from it,
+    // storedSprites is only filled once the snapshot is serialised. Loaded snapshots have no base.
+    std::shared_ptr<const std::vector<rct_sprite>> baseSprites;
+    std::vector<uint32_t> changedIndices;
+    std::vector<rct_sprite> changedSprites;
+
+    bool IsDelta() const
+    {
+        return baseSprites != nullptr;
+    }
+
+    const rct_sprite& GetDeltaSprite(size_t index) const
+    {
+        auto it = std::lower_bound(changedIndices.begin(), changedIndices.end(), static_cast<uint32_t>(index));
+        if (it != changedIndices.end() && *it == index)
+        {
+            return changedSprites[it - changedIndices.begin()];
+        }
+        return (*baseSprites)[index];
+    }
+
+    /**
+     * Writes the sprites of a delta snapshot into storedSprites, so it can be serialised like any other snapshot.
+     */
+    void StoreDeltaSprites()
+    {
+        const auto& base = *baseSprites;
+        SerialiseSprites(
+            [this, &base](const size_t index) { return const_cast<rct_sprite*>(&GetDeltaSprite(index)); }, base.size(),
+            true);
+    }
+
     // Must pass a function that can access the sprite.
     void SerialiseSprites(std::function<rct_sprite*(const size_t)> getEntity, const size_t numSprites, bool saving)
     {
@@ -122,6 +226,9 @@ struct GameStateSnapshots final : public IGameStateSnapshots
     virtual void Reset() override final
     {
         _snapshots.clear();
+        _baseSprites = nullptr;
+        _previousBaseSprites.reset();
+        _capturesSinceBase = 0;
     }
 
     virtual GameStateSnapshot_t& CreateSnapshot() override final
@@ -140,10 +247,35 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
     virtual void Capture(GameStateSnapshot_t& snapshot) override final
     {
+        const size_t numSprites = GetEntityCapacity();
+        if (_baseSprites == nullptr || _baseSprites->size() != numSprites || _capturesSinceBase >= MaximumGameStateSnapshots)
+        {
+            TryCaptureBase(numSprites);
+        }
+        _capturesSinceBase++;
+
+        if (_baseSprites != nullptr && _baseSprites->size() == numSprites)
+        {
+            CaptureDelta(snapshot, numSprites);
+            if (snapshot.changedIndices.size() > numSprites / 4 && TryCaptureBase(numSprites))
+            {
+                // Most of the sprites changed, e.g. after loading a park, start over from the current state.
+                CaptureDelta(snapshot, numSprites);
+            }
+            if (snapshot.changedIndices.size() <= numSprites / 4)
+            {
+                return;
+            }
+        }
+
+        // No base that fits could be taken, store the sprites like a loaded snapshot.
+        snapshot.baseSprites = nullptr;
+        snapshot.changedIndices.clear();
+        snapshot.changedSprites.clear();
         snapshot.SerialiseSprites(
-            [](const size_t index) { return reinterpret_cast<rct_sprite*>(GetEntity(index)); }, MAX_SPRITES, true);
+            [](const size_t index) { return reinterpret_cast<rct_sprite*>(GetEntity(index)); }, numSprites, true);
 
-        // log_info("Snapshot size: %u bytes", static_cast<uint32_t>(snapshot.storedSprites.GetLength()));
+        // log_info("Snapshot delta: %u sprites", static_cast<uint32_t>(snapshot.changedIndices.size()));
     }
 
     virtual const GameStateSnapshot_t* GetLinkedSnapshot(uint32_t tick) const override final
@@ -158,6 +290,17 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
     virtual void SerialiseSnapshot(GameStateSnapshot_t& snapshot, DataSerialiser& ds) const override final
     {
+        if (ds.IsSaving() && snapshot.IsDelta())
+        {
+            snapshot.StoreDeltaSprites();
+        }
+        else if (ds.IsLoading())
+        {
+            snapshot.baseSprites = nullptr;
+            snapshot.changedIndices.clear();
+            snapshot.changedSprites.clear();
+        }
+
         ds << snapshot.tick;
         ds << snapshot.srand0;
         ds << snapshot.storedSprites;
@@ -175,6 +318,16 @@ struct GameStateSnapshots final : public IGameStateSnapshots
             sprite.generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
         }
 
+        if (snapshot.IsDelta())
+        {
+            std::copy(snapshot.baseSprites->begin(), snapshot.baseSprites->end(), spriteList.begin());
+            for (size_t i = 0; i < snapshot.changedIndices.size(); i++)
+            {
+                spriteList[snapshot.changedIndices[i]] = snapshot.changedSprites[i];
+            }
+            return spriteList;
+        }
+
         snapshot.SerialiseSprites([&spriteList](const size_t index) { return &spriteList[index]; }, MAX_SPRITES, false);
 
         return spriteList;
@@ -525,63 +678,102 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         }
     }
 
-    virtual GameStateCompareData_t Compare(const GameStateSnapshot_t& base, const GameStateSnapshot_t& cmp) const override final
+    GameStateSpriteChange_t CompareSprite(uint32_t index, const rct_sprite& spriteBase, const rct_sprite& spriteCmp) const
     {
-        GameStateCompareData_t res;
-        res.tick = base.tick;
-        res.srand0Left = base.srand0;
-        res.srand0Right = cmp.srand0;
+        GameStateSpriteChange_t changeData;
+        changeData.spriteIndex = index;
 
-        std::vector<rct_sprite> spritesBase = BuildSpriteList(const_cast<GameStateSnapshot_t&>(base));
-        std::vector<rct_sprite> spritesCmp = BuildSpriteList(const_cast<GameStateSnapshot_t&>(cmp));
+        changeData.spriteIdentifier = spriteBase.generic.sprite_identifier;
+        changeData.miscIdentifier = spriteBase.generic.type;
 
-        for (uint32_t i = 0; i < static_cast<uint32_t>(spritesBase.size()); i++)
+        if (spriteBase.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
+            && spriteCmp.generic.sprite_identifier != SPRITE_IDENTIFIER_NULL)
         {
-            GameStateSpriteChange_t changeData;
-            changeData.spriteIndex = i;
-
-            const rct_sprite& spriteBase = spritesBase[i];
-            const rct_sprite& spriteCmp = spritesCmp[i];
-
+            // Sprite was added.
+            changeData.changeType = GameStateSpriteChange_t::ADDED;
+            changeData.spriteIdentifier = spriteCmp.generic.sprite_identifier;
+        }
+        else if (
+            spriteBase.generic.sprite_identifier != SPRITE_IDENTIFIER_NULL
+            && spriteCmp.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
+        {
+            // Sprite was removed.
+            changeData.changeType = GameStateSpriteChange_t::REMOVED;
             changeData.spriteIdentifier = spriteBase.generic.sprite_identifier;
-            changeData.miscIdentifier = spriteBase.generic.type;
-
-            if (spriteBase.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
-                && spriteCmp.generic.sprite_identifier != SPRITE_IDENTIFIER_NULL)
-            {
-                // Sprite was added.
-                changeData.changeType = GameStateSpriteChange_t::ADDED;
-                changeData.spriteIdentifier = spriteCmp.generic.sprite_identifier;
-            }
-            else if (
-                spriteBase.generic.sprite_identifier != SPRITE_IDENTIFIER_NULL
-                && spriteCmp.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
-            {
-                // Sprite was removed.
-                changeData.changeType = GameStateSpriteChange_t::REMOVED;
-                changeData.spriteIdentifier = spriteBase.generic.sprite_identifier;
-            }
-            else if (
-                spriteBase.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
-                && spriteCmp.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
+        }
+        else if (
+            spriteBase.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
+            && spriteCmp.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
+        {
+            // Do nothing.
+            changeData.changeType = GameStateSpriteChange_t::EQUAL;
+        }
+        else
+        {
+            CompareSpriteData(spriteBase, spriteCmp, changeData);
+            if (changeData.diffs.size() == 0)
             {
-                // Do nothing.
                 changeData.changeType = GameStateSpriteChange_t::EQUAL;
             }
             else
             {
-                CompareSpriteData(spriteBase, spriteCmp, changeData);
-                if (changeData.diffs.size() == 0)
+                changeData.changeType = GameStateSpriteChange_t::MODIFIED;
+            }
+        }
+
+        return changeData;
+    }
+
+    virtual GameStateCompareData_t Compare(const GameStateSnapshot_t& base, const GameStateSnapshot_t& cmp) const override final
+    {
+        GameStateCompareData_t res;
+        res.tick = base.tick;
+        res.srand0Left = base.srand0;
+        res.srand0Right = cmp.srand0;
+
+        if (base.IsDelta() && base.baseSprites == cmp.baseSprites)
+        {
+            // Both captured against the same base, only the sprites either of them changed can differ.
+            const auto& baseSprites = *base.baseSprites;
+            std::vector<uint32_t> changedIndices;
+            std::set_union(
+                base.changedIndices.begin(), base.changedIndices.end(), cmp.changedIndices.begin(), cmp.changedIndices.end(),
+                std::back_inserter(changedIndices));
+
+            res.spriteChanges.reserve(MAX_SPRITES);
+            auto changedIt = changedIndices.begin();
+            for (uint32_t i = 0; i < MAX_SPRITES; i++)
+            {
+                if (changedIt != changedIndices.end() && *changedIt == i)
                 {
-                    changeData.changeType = GameStateSpriteChange_t::EQUAL;
+                    res.spriteChanges.push_back(CompareSprite(i, base.GetDeltaSprite(i), cmp.GetDeltaSprite(i)));
+                    changedIt++;
                 }
                 else
                 {
-                    changeData.changeType = GameStateSpriteChange_t::MODIFIED;
+                    GameStateSpriteChange_t changeData;
+                    changeData.spriteIndex = i;
+                    changeData.changeType = GameStateSpriteChange_t::EQUAL;
+                    changeData.spriteIdentifier = SPRITE_IDENTIFIER_NULL;
+                    changeData.miscIdentifier = 0;
+                    if (i < baseSprites.size())
+                    {
+                        changeData.spriteIdentifier = baseSprites[i].generic.sprite_identifier;
+                        changeData.miscIdentifier = baseSprites[i].generic.type;
+                    }
+                    res.spriteChanges.push_back(changeData);
                 }
             }
+            return res;
+        }
+
+        std::vector<rct_sprite> spritesBase = BuildSpriteList(const_cast<GameStateSnapshot_t&>(base));
+        std::vector<rct_sprite> spritesCmp = BuildSpriteList(const_cast<GameStateSnapshot_t&>(cmp));
 
-            res.spriteChanges.push_back(changeData);
+        res.spriteChanges.reserve(spritesBase.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(spritesBase.size()); i++)
+        {
+            res.spriteChanges.push_back(CompareSprite(i, spritesBase[i], spritesCmp[i]));
         }
 
         return res;
@@ -686,7 +878,51 @@ struct GameStateSnapshots final : public IGameStateSnapshots
     }
 
 private:
+    /**
+     * Takes a new base unless snapshots captured against the one before the current base are still alive.
+     */
+    bool TryCaptureBase(size_t numSprites)
+    {
+        if (!_previousBaseSprites.expired())
+        {
+            return false;
+        }
+
+        auto baseSprites = std::make_shared<std::vector<rct_sprite>>(numSprites);
+        for (size_t i = 0; i < numSprites; i++)
+        {
+            (*baseSprites)[i] = GetStoredSpriteState(reinterpret_cast<const rct_sprite*>(GetEntity(i)));
+        }
+        _previousBaseSprites = _baseSprites;
+        _baseSprites = std::move(baseSprites);
+        _capturesSinceBase = 0;
+        return true;
+    }
+
+    void CaptureDelta(GameStateSnapshot_t& snapshot, size_t numSprites)
+    {
+        const auto& baseSprites = *_baseSprites;
+        snapshot.baseSprites = _baseSprites;
+        snapshot.changedIndices.clear();
+        snapshot.changedSprites.clear();
+        for (size_t i = 0; i < numSprites; i++)
+        {
+            const auto* sprite = reinterpret_cast<const rct_sprite*>(GetEntity(i));
+            if (!IsStoredSpriteStateEqual(sprite, baseSprites[i]))
+            {
+                snapshot.changedIndices.push_back(static_cast<uint32_t>(i));
+                snapshot.changedSprites.push_back(GetStoredSpriteState(sprite));
+            }
+        }
+    }
+
     CircularBuffer<std::unique_ptr<GameStateSnapshot_t>, MaximumGameStateSnapshots> _snapshots;
+    // Shared by the snapshots captured since it was taken and replaced every MaximumGameStateSnapshots captures.
+    // The previous base is kept alive by the snapshots captured against it, a new base is only taken once those are
+    // gone so no more than two bases are ever alive.
+    std::shared_ptr<const std::vector<rct_sprite>> _baseSprites;
+    std::weak_ptr<const std::vector<rct_sprite>> _previousBaseSprites;
+    size_t _capturesSinceBase = 0;
 };
 
 std::unique_ptr<IGameStateSnapshots> CreateGameStateSnapshots()
@@ -0,0 +1,997 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ParkFile.h"
+
+#include "Context.h"
+#include "Game.h"
+#include "GameState.h"
+#include "ParkImporter.h"
+#include "Version.h"
+#include "core/DataSerialiser.h"
+#include "core/File.h"
+#include "core/FileStream.hpp"
+#include "core/Path.hpp"
+#include "core/TaskScheduler.h"
+#include "interface/Viewport.h"
+#include "localisation/Date.h"
+#include "management/Award.h"
+#include "management/Finance.h"
+#include "management/Marketing.h"
+#include "management/NewsItem.h"
+#include "management/Research.h"
+#include "object/ObjectLimits.h"
+#include "object/ObjectList.h"
+#include "peep/Peep.h"
+#include "peep/Staff.h"
+#include "ride/Ride.h"
+#include "ride/RideRatings.h"
+#include "scenario/Scenario.h"
+#include "scenario/ScenarioRepository.h"
+#include "util/Util.h"
+#include "world/Banner.h"
+#include "world/Climate.h"
+#include "world/Entrance.h"
+#include "world/Map.h"
+#include "world/MapAnimation.h"
+#include "world/Park.h"
+#include "world/Sprite.h"
+#include "zlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+using namespace OpenRCT2;
+
+// The chunks store these as raw memory, so their layout is part of the file format. Changing one of them has to come
+// with an increase of ParkFile::VERSION and its new size here. None of them hold a pointer or a member wider than four
+// bytes, so their layout is the same for 32 and 64 bit builds. Like SV6, the values are stored little endian.
+assert_struct_size(TileElement, 16);
+assert_struct_size(rct_sprite, 512);
+assert_struct_size(rct_object_entry, 16);
+assert_struct_size(rct_s6_info, 408);
+assert_struct_size(ClimateState, 8);
+assert_struct_size(Award, 4);
+assert_struct_size(MarketingCampaign, 6);
+assert_struct_size(ResearchItem, 8);
+assert_struct_size(News::ItemQueues, 16592);
+assert_struct_size(PeepSpawn, 16);
+assert_struct_size(CoordsXYZD, 16);
+assert_struct_size(MapAnimation, 16);
+assert_struct_size(RideRatingCalculationData, 92);
+assert_struct_size(RideStation, 56);
+assert_struct_size(RideMeasurement, 19216);
+
+void ParkFileWriter::AddChunk(uint32_t id, MemoryStream&& data)
+{
+    _chunks.push_back({ id, std::move(data) });
+}
+
+void ParkFileWriter::Save(IStream* stream, uint8_t type, bool parallel)
+{
+    struct EncodedChunk
+    {
+        ParkFile::ChunkEntry Entry;
+        std::vector<uint8_t> Compressed;
+    };
+
+    std::vector<EncodedChunk> encoded(_chunks.size());
+    auto encode = [this, &encoded](size_t i) {
+        const auto& chunk = _chunks[i];
+        auto& dst = encoded[i];
+        auto data = static_cast<const uint8_t*>(chunk.Data.GetData());
+        auto length = static_cast<size_t>(chunk.Data.GetLength());
+
+        dst.Entry.Id = chunk.Id;
+        dst.Entry.UncompressedLength = length;
+        dst.Entry.Compression = ParkFile::ChunkCompression::None;
+        if (length != 0)
+        {
+            auto compressed = util_zlib_deflate(data, length);
+            // Small or already dense chunks can grow, those are stored as they are.
+            if (compressed.has_value() && compressed->size() < length)
+            {
+                dst.Entry.Compression = ParkFile::ChunkCompression::Zlib;
+                dst.Compressed = std::move(*compressed);
+            }
+        }
+
+        const uint8_t* stored = dst.Entry.Compression == ParkFile::ChunkCompression::Zlib ? dst.Compressed.data() : data;
+        dst.Entry.Length = dst.Entry.Compression == ParkFile::ChunkCompression::Zlib ? dst.Compressed.size() : length;
+        dst.Entry.Checksum = crc32(0, stored, static_cast<uInt>(dst.Entry.Length));
+    };
+    if (parallel)
+    {
+        TaskScheduler::Get().ParallelFor(_chunks.size(), encode);
+    }
+    else
+    {
+        for (size_t i = 0; i < _chunks.size(); i++)
+        {
+            encode(i);
+        }
+    }
+
+    ParkFile::Header header{};
+    header.Magic = ParkFile::MAGIC;
+    header.TargetVersion = ParkFile::VERSION;
+    header.MinVersion = ParkFile::MIN_VERSION;
+    header.NumChunks = static_cast<uint32_t>(encoded.size());
+    header.Type = type;
+
+    uint64_t offset = sizeof(ParkFile::Header) + encoded.size() * sizeof(ParkFile::ChunkEntry);
+    for (auto& chunk : encoded)
+    {
+        chunk.Entry.Offset = offset;
+        offset += chunk.Entry.Length;
+    }
+
+    stream->WriteValue(header);
+    for (const auto& chunk : encoded)
+    {
+        stream->WriteValue(chunk.Entry);
+    }
+    for (size_t i = 0; i < encoded.size(); i++)
+    {
+        const auto& chunk = encoded[i];
+        if (chunk.Entry.Compression == ParkFile::ChunkCompression::Zlib)
+        {
+            stream->Write(chunk.Compressed.data(), chunk.Compressed.size());
+        }
+        else
+        {
+            stream->Write(_chunks[i].Data.GetData(), _chunks[i].Data.GetLength());
+        }
+    }
+}
+
+ParkFileReader::ParkFileReader(IStream* stream)
+    : _stream(stream)
+{
+    _basePosition = stream->GetPosition();
+    _header = stream->ReadValue<ParkFile::Header>();
+    if (_header.Magic != ParkFile::MAGIC)
+    {
+        throw IOException("Not a park file.");
+    }
+    if (_header.MinVersion > ParkFile::VERSION)
+    {
+        throw IOException("Park file was written by a newer version of OpenRCT2.");
+    }
+    if (_header.TargetVersion < ParkFile::MIN_VERSION)
+    {
+        throw IOException("Park file was written by an older version of OpenRCT2 that is no longer supported.");
+    }
+
+    const auto fileLength = stream->GetLength() - _basePosition;
+    const uint64_t tableEnd = sizeof(ParkFile::Header) + uint64_t{ _header.NumChunks } * sizeof(ParkFile::ChunkEntry);
+    if (tableEnd > fileLength)
+    {
+        throw IOException("Park file chunk table is truncated.");
+    }
+    _chunks.resize(_header.NumChunks);
+    for (auto& entry : _chunks)
+    {
+        entry = stream->ReadValue<ParkFile::ChunkEntry>();
+        if (entry.Offset < tableEnd || entry.Offset > fileLength || entry.Length > fileLength - entry.Offset)
+        {
+            throw IOException("Park file chunk lies outside of the file.");
+        }
+    }
+}
+
+uint8_t ParkFileReader::GetType() const
+{
+    return _header.Type;
+}
+
+uint32_t ParkFileReader::GetVersion() const
+{
+    return _header.TargetVersion;
+}
+
+bool ParkFileReader::HasChunk(uint32_t id) const
+{
+    return FindChunk(id) != nullptr;
+}
+
+uint64_t ParkFileReader::GetLength() const
+{
+    uint64_t length = sizeof(ParkFile::Header) + _chunks.size() * sizeof(ParkFile::ChunkEntry);
+    for (const auto& entry : _chunks)
+    {
+        length = std::max(length, entry.Offset + entry.Length);
+    }
+    return length;
+}
+
+MemoryStream ParkFileReader::ReadChunk(uint32_t id)
+{
+    const auto* entry = FindChunk(id);
+    if (entry == nullptr)
+    {
+        throw IOException("Park file has no chunk " + std::to_string(id) + ".");
+    }
+
+    std::vector<uint8_t> stored(static_cast<size_t>(entry->Length));
+    _stream->SetPosition(_basePosition + entry->Offset);
+    _stream->Read(stored.data(), stored.size());
+    if (crc32(0, stored.data(), static_cast<uInt>(stored.size())) != entry->Checksum)
+    {
+        throw IOException("Park file chunk " + std::to_string(id) + " is corrupt.");
+    }
+
+    switch (entry->Compression)
+    {
+        case ParkFile::ChunkCompression::None:
+        {
+            MemoryStream result;
+            result.Write(stored.data(), stored.size());
+            result.SetPosition(0);
+            return result;
+        }
+        case ParkFile::ChunkCompression::Zlib:
+        {
+            size_t length = static_cast<size_t>(entry->UncompressedLength);
+            if (length == 0)
+            {
+                break;
+            }
+            auto data = util_zlib_inflate(stored.data(), stored.size(), &length);
+            if (data == nullptr || length != entry->UncompressedLength)
+            {
+                std::free(data);
+                break;
+            }
+            return MemoryStream(data, length, MEMORY_ACCESS::READ | MEMORY_ACCESS::OWNER);
+        }
+    }
+    throw IOException("Park file chunk " + std::to_string(id) + " could not be decompressed.");
+}
+
+bool ParkFileReader::IsParkFile(IStream* stream)
+{
+    auto position = stream->GetPosition();
+    uint32_t magic = 0;
+    bool result = stream->TryRead(&magic, sizeof(magic)) == sizeof(magic) && magic == ParkFile::MAGIC;
+    stream->SetPosition(position);
+    return result;
+}
+
+const ParkFile::ChunkEntry* ParkFileReader::FindChunk(uint32_t id) const
+{
+    for (const auto& entry : _chunks)
+    {
+        if (entry.Id == id)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+static void park_file_serialise_authoring(DataSerialiser& ds)
+{
+    // Only informative, tells which build wrote the park
+    std::string engine = gVersionInfoFull;
+    ds << engine;
+}
+
+static void park_file_serialise_objects(DataSerialiser& ds, std::vector<rct_object_entry>& objects)
+{
+    auto count = static_cast<uint32_t>(objects.size());
+    ds << DS_RAW(count);
+    if (ds.IsLoading())
+    {
+        if (count != OBJECT_ENTRY_COUNT)
+        {
+            throw IOException("Park file has an unexpected number of objects.");
+        }
+        objects.resize(count);
+    }
+    for (auto& entry : objects)
+    {
+        ds << DS_RAW(entry);
+    }
+}
+
+static void park_file_serialise_scenario(DataSerialiser& ds)
+{
+    ds << DS_RAW(gS6Info);
+    ds << gScenarioName;
+    ds << gScenarioDetails;
+    ds << DS_RAW(gScenarioFileName);
+    ds << DS_RAW(gScenarioExpansionPacks);
+    ds << DS_RAW(gScenarioObjectiveType);
+    ds << DS_RAW(gScenarioObjectiveYear);
+    ds << DS_RAW(gScenarioObjectiveNumGuests);
+    ds << DS_RAW(gScenarioObjectiveCurrency);
+    ds << DS_RAW(gScenarioParkRatingWarningDays);
+    ds << DS_RAW(gScenarioCompletedCompanyValue);
+    ds << DS_RAW(gScenarioCompanyValueRecord);
+    ds << gScenarioCompletedBy;
+
+    if (ds.IsLoading())
+    {
+        gS6Info.name[sizeof(gS6Info.name) - 1] = '\0';
+        gS6Info.details[sizeof(gS6Info.details) - 1] = '\0';
+        gScenarioFileName[sizeof(gScenarioFileName) - 1] = '\0';
+    }
+}
+
+static void park_file_serialise_general(DataSerialiser& ds)
+{
+    ds << DS_RAW(gCurrentTicks);
+    ds << DS_RAW(gScenarioTicks);
+    ds << DS_RAW(gDateMonthsElapsed);
+    ds << DS_RAW(gDateMonthTicks);
+
+    auto randState = scenario_rand_state();
+    ds << DS_RAW(randState);
+
+    ds << DS_RAW(gSavedAge);
+    ds << DS_RAW(gSavedView);
+    auto savedViewZoom = static_cast<int8_t>(gSavedViewZoom);
+    ds << DS_RAW(savedViewZoom);
+    ds << DS_RAW(gSavedViewRotation);
+    ds << DS_RAW(gLastEntranceStyle);
+    ds << DS_RAW(gNextGuestNumber);
+    ds << DS_RAW(gRideRatingsCalcData);
+
+    auto mapAnimations = GetMapAnimations();
+    ds << DS_RAW(mapAnimations);
+
+    if (ds.IsLoading())
+    {
+        gSavedViewZoom = savedViewZoom;
+        scenario_rand_seed(randState.s0, randState.s1);
+        SetMapAnimations(mapAnimations);
+        GetContext()->GetGameState()->GetDate() = Date(gDateMonthsElapsed, gDateMonthTicks);
+        gCurrentRealTimeTicks = 0;
+    }
+}
+
+static void park_file_serialise_climate(DataSerialiser& ds)
+{
+    ds << DS_RAW(gClimate);
+    ds << DS_RAW(gClimateCurrent);
+    ds << DS_RAW(gClimateNext);
+    ds << DS_RAW(gClimateUpdateTimer);
+}
+
+static void park_file_serialise_park(DataSerialiser& ds)
+{
+    auto& park = GetContext()->GetGameState()->GetPark();
+    ds << park.Name;
+    ds << DS_RAW(gParkFlags);
+    ds << DS_RAW(gParkRating);
+    ds << DS_RAW(gParkEntranceFee);
+    ds << DS_RAW(gParkSize);
+    ds << DS_RAW(gLandPrice);
+    ds << DS_RAW(gConstructionRightsPrice);
+    ds << DS_RAW(gTotalAdmissions);
+    ds << DS_RAW(gTotalIncomeFromAdmissions);
+    ds << DS_RAW(gParkValue);
+    ds << DS_RAW(gCompanyValue);
+    ds << DS_RAW(gParkRatingCasualtyPenalty);
+    ds << DS_RAW(_guestGenerationProbability);
+    ds << DS_RAW(_suggestedGuestMaximum);
+    ds << DS_RAW(gParkEntrances);
+    ds << DS_RAW(gSamePriceThroughoutPark);
+    ds << DS_RAW(gTotalRideValueForMoney);
+    ds << DS_RAW(gCurrentAwards);
+    ds << DS_RAW(gMarketingCampaigns);
+
+    ds << DS_RAW(gGuestChangeModifier);
+    ds << DS_RAW(gNumGuestsInPark);
+    ds << DS_RAW(gNumGuestsInParkLastWeek);
+    ds << DS_RAW(gNumGuestsHeadingForPark);
+    ds << DS_RAW(gGuestInitialCash);
+    ds << DS_RAW(gGuestInitialHappiness);
+    ds << DS_RAW(gGuestInitialHunger);
+    ds << DS_RAW(gGuestInitialThirst);
+    ds << DS_RAW(gPeepWarningThrottle);
+    ds << DS_RAW(gStaffPatrolAreas);
+    ds << DS_RAW(gStaffModes);
+    ds << DS_RAW(gStaffHandymanColour);
+    ds << DS_RAW(gStaffMechanicColour);
+    ds << DS_RAW(gStaffSecurityColour);
+}
+
+static void park_file_serialise_finance(DataSerialiser& ds)
+{
+    ds << DS_RAW(gInitialCash);
+    ds << DS_RAW(gCash);
+    ds << DS_RAW(gBankLoan);
+    ds << DS_RAW(gBankLoanInterestRate);
+    ds << DS_RAW(gMaxBankLoan);
+    ds << DS_RAW(gCurrentExpenditure);
+    ds << DS_RAW(gCurrentProfit);
+    ds << DS_RAW(gHistoricalProfit);
+    ds << DS_RAW(gWeeklyProfitAverageDividend);
+    ds << DS_RAW(gWeeklyProfitAverageDivisor);
+    ds << DS_RAW(gExpenditureTable);
+}
+
+static void park_file_serialise_history(DataSerialiser& ds)
+{
+    ds << DS_RAW(gParkRatingHistory);
+    ds << DS_RAW(gGuestsInParkHistory);
+    ds << DS_RAW(gCashHistory);
+    ds << DS_RAW(gWeeklyProfitHistory);
+    ds << DS_RAW(gParkValueHistory);
+}
+
+static void park_file_serialise_research(DataSerialiser& ds)
+{
+    ds << DS_RAW(gResearchFundingLevel);
+    ds << DS_RAW(gResearchPriorities);
+    ds << DS_RAW(gResearchProgress);
+    ds << DS_RAW(gResearchProgressStage);
+    ds << DS_RAW(gResearchExpectedMonth);
+    ds << DS_RAW(gResearchExpectedDay);
+    ds << DS_RAW(gResearchLastItem);
+    ds << DS_RAW(gResearchNextItem);
+    ds << DS_RAW(gResearchItemsUninvented);
+    ds << DS_RAW(gResearchItemsInvented);
+    ds << DS_RAW(gResearchUncompletedCategories);
+
+    if (ds.IsLoading())
+    {
+        research_determine_first_of_type();
+    }
+}
+
+static void park_file_serialise_news(DataSerialiser& ds)
+{
+    ds << DS_RAW(gNewsItems);
+}
+
+/**
+ * The map must be the first chunk that is loaded, it resets the rest of the game state for the size it holds.
+ */
+static void park_file_serialise_map(DataSerialiser& ds)
+{
+    ds << DS_RAW(gMapSize);
+    if (ds.IsLoading())
+    {
+        if (gMapSize < MINIMUM_MAP_SIZE_TECHNICAL || gMapSize > MAXIMUM_MAP_SIZE_TECHNICAL)
+        {
+            throw IOException("Park file has an invalid map size.");
+        }
+        GetContext()->GetGameState()->InitAll(gMapSize);
+    }
+    ds << DS_RAW(gMapSizeUnits);
+    ds << DS_RAW(gMapSizeMinus2);
+    ds << DS_RAW(gMapSizeMaxXY);
+    ds << DS_RAW(gMapBaseZ);
+
+    // Only the elements in use are stored, they are expected to be reorganised so there are no gaps between them.
+    auto numElements = static_cast<uint32_t>(gNextFreeTileElement - gTileElements.data());
+    ds << DS_RAW(numElements);
+    if (ds.IsLoading())
+    {
+        if (numElements < MAX_TILE_TILE_ELEMENT_POINTERS || numElements > MAX_TILE_ELEMENTS)
+        {
+            throw IOException("Park file has an invalid number of tile elements.");
+        }
+        map_allocate_tile_elements(numElements + TILE_ELEMENT_SPARE_ROOM);
+        ds.GetStream().Read(gTileElements.data(), numElements * sizeof(TileElement));
+
+        // Every tile needs its own run of elements, otherwise the tile pointers would run past the elements read.
+        uint32_t numTiles = 0;
+        for (uint32_t i = 0; i < numElements; i++)
+        {
+            if (gTileElements[i].IsLastForTile())
+            {
+                numTiles++;
+            }
+        }
+        if (numTiles != MAX_TILE_TILE_ELEMENT_POINTERS || !gTileElements[numElements - 1].IsLastForTile())
+        {
+            throw IOException("Park file has a corrupt map.");
+        }
+        map_update_tile_pointers();
+    }
+    else
+    {
+        ds.GetStream().Write(gTileElements.data(), numElements * sizeof(TileElement));
+    }
+
+    ds << DS_RAW(gNextFreeTileElementPointerIndex);
+    ds << DS_RAW(gPeepSpawns);
+    ds << DS_RAW(gWidePathTileLoopX);
+    ds << DS_RAW(gWidePathTileLoopY);
+    ds << DS_RAW(gGrassSceneryTileLoopPosition);
+    ds << DS_RAW(gLandRemainingOwnershipSales);
+    ds << DS_RAW(gLandRemainingConstructionSales);
+}
+
+static void park_file_serialise_entities(DataSerialiser& ds)
+{
+    auto capacity = static_cast<uint32_t>(GetEntityCapacity());
+    ds << DS_RAW(capacity);
+    if (ds.IsLoading())
+    {
+        if (capacity > MAX_SPRITES)
+        {
+            throw IOException("Park file has too many entities.");
+        }
+        reset_sprite_list_with_capacity(capacity);
+        if (GetEntityCapacity() != capacity)
+        {
+            throw IOException("Park file has an invalid entity capacity.");
+        }
+    }
+
+    // Each entity is stored as a record of its memory, except for the name pointer of peeps which would make the
+    // record depend on the size of a pointer. The name is left out and the rest of the peep moves up to take its place,
+    // so every record has the same size. Peep names are stored in a table after the records instead.
+    constexpr size_t RecordSize = sizeof(rct_sprite) - sizeof(uint64_t);
+    rct_sprite layout;
+    const auto* layoutBase = reinterpret_cast<const uint8_t*>(&layout);
+    const size_t nameOffset = reinterpret_cast<const uint8_t*>(&layout.peep.Name) - layoutBase;
+    const size_t afterNameOffset = reinterpret_cast<const uint8_t*>(&layout.peep.NextLoc) - layoutBase;
+    static_assert(sizeof(Peep) - sizeof(char*) <= RecordSize, "Peeps must fit in an entity record");
+
+    std::vector<std::pair<uint16_t, std::string>> names;
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        auto* entity = reinterpret_cast<rct_sprite*>(GetEntity(i));
+        rct_sprite copy = *entity;
+        auto* copyBase = reinterpret_cast<uint8_t*>(&copy);
+        if (ds.IsSaving())
+        {
+            auto& stream = ds.GetStream();
+            if (copy.generic.Is<Peep>())
+            {
+                if (copy.peep.Name != nullptr)
+                {
+                    names.emplace_back(static_cast<uint16_t>(i), copy.peep.Name);
+                }
+                stream.Write(copyBase, nameOffset);
+                stream.Write(copyBase + afterNameOffset, RecordSize - nameOffset);
+            }
+            else
+            {
+                stream.Write(copyBase, RecordSize);
+            }
+        }
+        else
+        {
+            // The sprite identifier comes before the name, so the first part tells whether the record is a peep.
+            auto& stream = ds.GetStream();
+            stream.Read(copyBase, nameOffset);
+            if (copy.generic.Is<Peep>())
+            {
+                stream.Read(copyBase + afterNameOffset, RecordSize - nameOffset);
+                copy.peep.Name = nullptr;
+            }
+            else
+            {
+                stream.Read(copyBase + nameOffset, RecordSize - nameOffset);
+            }
+            *entity = copy;
+        }
+    }
+
+    ds << DS_RAW(gSpriteListHead);
+    ds << DS_RAW(gSpriteListCount);
+    ds << DS_RAW(gSpriteSpatialIndex);
+
+    auto numNames = static_cast<uint32_t>(names.size());
+    ds << DS_RAW(numNames);
+    if (ds.IsLoading())
+    {
+        if (numNames > capacity)
+        {
+            throw IOException("Park file has too many entity names.");
+        }
+        names.resize(numNames);
+    }
+    for (auto& [index, name] : names)
+    {
+        ds << DS_RAW(index);
+        ds << name;
+        if (ds.IsLoading())
+        {
+            auto* peep = TryGetEntity<Peep>(index);
+            if (peep != nullptr)
+            {
+                peep->SetName(name);
+            }
+        }
+    }
+
+    if (ds.IsLoading())
+    {
+        InvalidateEntityLists();
+    }
+}
+
+static void park_file_serialise_ride(DataSerialiser& ds, Ride& ride)
+{
+    ds << DS_RAW(ride.type);
+    ds << DS_RAW(ride.subtype);
+    ds << DS_RAW(ride.mode);
+    ds << DS_RAW(ride.colour_scheme_type);
+    ds << DS_RAW(ride.vehicle_colours);
+    ds << DS_RAW(ride.status);
+    ds << ride.custom_name;
+    ds << DS_RAW(ride.default_name_number);
+    ds << DS_RAW(ride.overall_view);
+    ds << DS_RAW(ride.vehicles);
+    ds << DS_RAW(ride.depart_flags);
+    ds << DS_RAW(ride.num_stations);
+    ds << DS_RAW(ride.num_vehicles);
+    ds << DS_RAW(ride.num_cars_per_train);
+    ds << DS_RAW(ride.proposed_num_vehicles);
+    ds << DS_RAW(ride.proposed_num_cars_per_train);
+    ds << DS_RAW(ride.max_trains);
+    ds << DS_RAW(ride.min_max_cars_per_train);
+    ds << DS_RAW(ride.min_waiting_time);
+    ds << DS_RAW(ride.max_waiting_time);
+    ds << DS_RAW(ride.operation_option);
+    ds << DS_RAW(ride.boat_hire_return_direction);
+    ds << DS_RAW(ride.boat_hire_return_position);
+    ds << DS_RAW(ride.special_track_elements);
+    ds << DS_RAW(ride.max_speed);
+    ds << DS_RAW(ride.average_speed);
+    ds << DS_RAW(ride.current_test_segment);
+    ds << DS_RAW(ride.average_speed_test_timeout);
+    ds << DS_RAW(ride.max_positive_vertical_g);
+    ds << DS_RAW(ride.max_negative_vertical_g);
+    ds << DS_RAW(ride.max_lateral_g);
+    ds << DS_RAW(ride.previous_vertical_g);
+    ds << DS_RAW(ride.previous_lateral_g);
+    ds << DS_RAW(ride.testing_flags);
+    ds << DS_RAW(ride.CurTestTrackLocation);
+    ds << DS_RAW(ride.turn_count_default);
+    ds << DS_RAW(ride.turn_count_banked);
+    ds << DS_RAW(ride.turn_count_sloped);
+    ds << DS_RAW(ride.drops);
+    ds << DS_RAW(ride.start_drop_height);
+    ds << DS_RAW(ride.highest_drop_height);
+    ds << DS_RAW(ride.sheltered_length);
+    ds << DS_RAW(ride.var_11C);
+    ds << DS_RAW(ride.num_sheltered_sections);
+    ds << DS_RAW(ride.cur_num_customers);
+    ds << DS_RAW(ride.num_customers_timeout);
+    ds << DS_RAW(ride.num_customers);
+    ds << DS_RAW(ride.price);
+    ds << DS_RAW(ride.ChairliftBullwheelLocation);
+    ds << DS_RAW(ride.ratings);
+    ds << DS_RAW(ride.value);
+    ds << DS_RAW(ride.chairlift_bullwheel_rotation);
+    ds << DS_RAW(ride.satisfaction);
+    ds << DS_RAW(ride.satisfaction_time_out);
+    ds << DS_RAW(ride.satisfaction_next);
+    ds << DS_RAW(ride.window_invalidate_flags);
+    ds << DS_RAW(ride.total_customers);
+    ds << DS_RAW(ride.total_profit);
+    ds << DS_RAW(ride.popularity);
+    ds << DS_RAW(ride.popularity_time_out);
+    ds << DS_RAW(ride.popularity_next);
+    ds << DS_RAW(ride.num_riders);
+    ds << DS_RAW(ride.music_tune_id);
+    ds << DS_RAW(ride.slide_in_use);
+    ds << DS_RAW(ride.slide_peep);
+    ds << DS_RAW(ride.slide_peep_t_shirt_colour);
+    ds << DS_RAW(ride.spiral_slide_progress);
+    ds << DS_RAW(ride.build_date);
+    ds << DS_RAW(ride.upkeep_cost);
+    ds << DS_RAW(ride.race_winner);
+    ds << DS_RAW(ride.music_position);
+    ds << DS_RAW(ride.breakdown_reason_pending);
+    ds << DS_RAW(ride.mechanic_status);
+    ds << DS_RAW(ride.mechanic);
+    ds << DS_RAW(ride.inspection_station);
+    ds << DS_RAW(ride.broken_vehicle);
+    ds << DS_RAW(ride.broken_car);
+    ds << DS_RAW(ride.breakdown_reason);
+    ds << DS_RAW(ride.reliability);
+    ds << DS_RAW(ride.unreliability_factor);
+    ds << DS_RAW(ride.downtime);
+    ds << DS_RAW(ride.inspection_interval);
+    ds << DS_RAW(ride.last_inspection);
+    ds << DS_RAW(ride.downtime_history);
+    ds << DS_RAW(ride.no_primary_items_sold);
+    ds << DS_RAW(ride.no_secondary_items_sold);
+    ds << DS_RAW(ride.breakdown_sound_modifier);
+    ds << DS_RAW(ride.not_fixed_timeout);
+    ds << DS_RAW(ride.last_crash_type);
+    ds << DS_RAW(ride.connected_message_throttle);
+    ds << DS_RAW(ride.income_per_hour);
+    ds << DS_RAW(ride.profit);
+    ds << DS_RAW(ride.track_colour);
+    ds << DS_RAW(ride.music);
+    ds << DS_RAW(ride.entrance_style);
+    ds << DS_RAW(ride.vehicle_change_timeout);
+    ds << DS_RAW(ride.num_block_brakes);
+    ds << DS_RAW(ride.lift_hill_speed);
+    ds << DS_RAW(ride.guests_favourite);
+    ds << DS_RAW(ride.lifecycle_flags);
+    ds << DS_RAW(ride.total_air_time);
+    ds << DS_RAW(ride.current_test_station);
+    ds << DS_RAW(ride.num_circuits);
+    ds << DS_RAW(ride.CableLiftLoc);
+    ds << DS_RAW(ride.cable_lift);
+    ds << DS_RAW(ride.stations);
+    ds << DS_RAW(ride.inversions);
+    ds << DS_RAW(ride.holes);
+    ds << DS_RAW(ride.sheltered_eighths);
+
+    uint8_t hasMeasurement = ride.measurement != nullptr;
+    ds << DS_RAW(hasMeasurement);
+    if (hasMeasurement)
+    {
+        if (ds.IsLoading())
+        {
+            ride.measurement = std::make_shared<RideMeasurement>();
+        }
+        ds << DS_RAW(*ride.measurement);
+    }
+}
+
+static void park_file_serialise_rides(DataSerialiser& ds)
+{
+    std::vector<Ride*> rides;
+    if (ds.IsSaving())
+    {
+        for (auto& ride : GetRideManager())
+        {
+            rides.push_back(&ride);
+        }
+    }
+
+    auto count = static_cast<uint32_t>(rides.size());
+    ds << DS_RAW(count);
+    if (ds.IsLoading() && count > MAX_RIDES)
+    {
+        throw IOException("Park file has too many rides.");
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ride_id_t id = ds.IsSaving() ? rides[i]->id : RIDE_ID_NULL;
+        ds << DS_RAW(id);
+        Ride* ride;
+        if (ds.IsLoading())
+        {
+            if (id >= MAX_RIDES)
+            {
+                throw IOException("Park file has an invalid ride id.");
+            }
+            ride = GetOrAllocateRide(id);
+            *ride = {};
+            ride->id = id;
+        }
+        else
+        {
+            ride = rides[i];
+        }
+        park_file_serialise_ride(ds, *ride);
+    }
+}
+
+static void park_file_serialise_banners(DataSerialiser& ds)
+{
+    for (BannerIndex i = 0; i < MAX_BANNERS; i++)
+    {
+        auto banner = GetBanner(i);
+        ds << DS_RAW(banner->type);
+        ds << DS_RAW(banner->flags);
+        ds << banner->text;
+        ds << DS_RAW(banner->colour);
+        ds << DS_RAW(banner->ride_index);
+        ds << DS_RAW(banner->text_colour);
+        ds << DS_RAW(banner->position);
+    }
+}
+
+static std::vector<rct_object_entry> park_file_get_loaded_objects()
+{
+    std::vector<rct_object_entry> objects(OBJECT_ENTRY_COUNT);
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        const rct_object_entry* entry = get_loaded_object_entry(i);
+        void* entryData = get_loaded_object_chunk(i);
+        if (entry == nullptr || entryData == nullptr || entryData == reinterpret_cast<void*>(-1))
+        {
+            std::memset(&objects[i], 0xFF, sizeof(rct_object_entry));
+        }
+        else
+        {
+            objects[i] = *entry;
+        }
+    }
+    return objects;
+}
+
+template<typename TFunc> void ParkFileExporter::WriteChunk(uint32_t id, TFunc func)
+{
+    MemoryStream data;
+    DataSerialiser ds(true, data);
+    func(ds);
+    _writer.AddChunk(id, std::move(data));
+}
+
+void ParkFileExporter::Export()
+{
+    int32_t regular_cycle = check_for_sprite_list_cycles(false);
+    openrct2_assert(regular_cycle == -1, "Sprite cycle exists in regular list %d", regular_cycle);
+    int32_t disjoint_sprites_count = fix_disjoint_sprites();
+    if (disjoint_sprites_count > 0)
+    {
+        log_error("Found %d disjoint null sprites", disjoint_sprites_count);
+    }
+
+    // Map elements must be reorganised prior to saving, only the elements in use are written
+    map_reorganise_elements();
+
+    auto objects = park_file_get_loaded_objects();
+    WriteChunk(ParkFile::ChunkId::AUTHORING, park_file_serialise_authoring);
+    WriteChunk(ParkFile::ChunkId::OBJECTS, [&objects](DataSerialiser& ds) { park_file_serialise_objects(ds, objects); });
+    WriteChunk(ParkFile::ChunkId::SCENARIO, park_file_serialise_scenario);
+    WriteChunk(ParkFile::ChunkId::GENERAL, park_file_serialise_general);
+    WriteChunk(ParkFile::ChunkId::CLIMATE, park_file_serialise_climate);
+    WriteChunk(ParkFile::ChunkId::PARK, park_file_serialise_park);
+    WriteChunk(ParkFile::ChunkId::FINANCE, park_file_serialise_finance);
+    WriteChunk(ParkFile::ChunkId::HISTORY, park_file_serialise_history);
+    WriteChunk(ParkFile::ChunkId::RESEARCH, park_file_serialise_research);
+    WriteChunk(ParkFile::ChunkId::NEWS, park_file_serialise_news);
+    WriteChunk(ParkFile::ChunkId::MAP, park_file_serialise_map);
+    WriteChunk(ParkFile::ChunkId::ENTITIES, park_file_serialise_entities);
+    WriteChunk(ParkFile::ChunkId::RIDES, park_file_serialise_rides);
+    WriteChunk(ParkFile::ChunkId::BANNERS, park_file_serialise_banners);
+}
+
+void ParkFileExporter::SaveGame(const utf8* path)
+{
+    auto fs = FileStream(path, FILE_MODE_WRITE);
+    SaveGame(&fs);
+}
+
+void ParkFileExporter::SaveGame(IStream* stream)
+{
+    _writer.Save(stream, S6_TYPE_SAVEDGAME, EncodeInParallel);
+}
+
+void ParkFileExporter::SaveScenario(const utf8* path)
+{
+    auto fs = FileStream(path, FILE_MODE_WRITE);
+    SaveScenario(&fs);
+}
+
+void ParkFileExporter::SaveScenario(IStream* stream)
+{
+    _writer.Save(stream, S6_TYPE_SCENARIO, EncodeInParallel);
+}
+
+/**
+ * Class to import native park files (*.park).
+ */
+class ParkFileImporter final : public IParkImporter
+{
+private:
+    // The reader only reads the chunks when they are imported, so the file is kept in memory until then.
+    std::vector<uint8_t> _data;
+    MemoryStream _stream;
+    std::unique_ptr<ParkFileReader> _reader;
+    std::string _path;
+
+public:
+    ParkLoadResult Load(const utf8* path) override
+    {
+        auto fs = FileStream(path, FILE_MODE_OPEN);
+        return LoadFromStream(&fs, false, false, path);
+    }
+
+    ParkLoadResult LoadSavedGame(const utf8* path, bool skipObjectCheck = false) override
+    {
+        auto fs = FileStream(path, FILE_MODE_OPEN);
+        return LoadFromStream(&fs, false, skipObjectCheck, path);
+    }
+
+    ParkLoadResult LoadScenario(const utf8* path, bool skipObjectCheck = false) override
+    {
+        auto fs = FileStream(path, FILE_MODE_OPEN);
+        return LoadFromStream(&fs, true, skipObjectCheck, path);
+    }
+
+    ParkLoadResult LoadFromStream(
+        IStream* stream, bool isScenario, [[maybe_unused]] bool skipObjectCheck = false,
+        const utf8* path = String::Empty) override
+    {
+        const auto position = stream->GetPosition();
+        _data.resize(static_cast<size_t>(stream->GetLength() - position));
+        stream->Read(_data.data(), _data.size());
+        _stream = MemoryStream(_data.data(), _data.size());
+        _reader = std::make_unique<ParkFileReader>(&_stream);
+
+        // Leave the stream after the park like the SV6 importer, the network sends more data after it.
+        stream->SetPosition(position + _reader->GetLength());
+        _path = path != nullptr ? path : "";
+
+        // Load cannot tell from the extension whether the park is a scenario, only a scenario load is checked.
+        if (isScenario && _reader->GetType() != S6_TYPE_SCENARIO)
+        {
+            throw std::runtime_error("Park is not a scenario.");
+        }
+
+        std::vector<rct_object_entry> objects;
+        ReadChunk(ParkFile::ChunkId::OBJECTS, [&objects](DataSerialiser& ds) { park_file_serialise_objects(ds, objects); });
+        return ParkLoadResult(std::move(objects));
+    }
+
+    bool GetDetails(scenario_index_entry* dst) override
+    {
+        *dst = {};
+        return false;
+    }
+
+    void Import() override
+    {
+        ReadChunk(ParkFile::ChunkId::MAP, park_file_serialise_map);
+        ReadChunk(ParkFile::ChunkId::ENTITIES, park_file_serialise_entities);
+        ReadOptionalChunk(ParkFile::ChunkId::SCENARIO, park_file_serialise_scenario);
+        ReadOptionalChunk(ParkFile::ChunkId::GENERAL, park_file_serialise_general);
+        ReadOptionalChunk(ParkFile::ChunkId::CLIMATE, park_file_serialise_climate);
+        ReadOptionalChunk(ParkFile::ChunkId::PARK, park_file_serialise_park);
+        ReadOptionalChunk(ParkFile::ChunkId::FINANCE, park_file_serialise_finance);
+        ReadOptionalChunk(ParkFile::ChunkId::HISTORY, park_file_serialise_history);
+        ReadOptionalChunk(ParkFile::ChunkId::RESEARCH, park_file_serialise_research);
+        ReadOptionalChunk(ParkFile::ChunkId::NEWS, park_file_serialise_news);
+        ReadOptionalChunk(ParkFile::ChunkId::RIDES, park_file_serialise_rides);
+        ReadOptionalChunk(ParkFile::ChunkId::BANNERS, park_file_serialise_banners);
+
+        if (_reader->GetType() == S6_TYPE_SCENARIO && !_path.empty())
+        {
+            // As with SC6, the scenario is known by the name of its file
+            String::Set(gScenarioFileName, sizeof(gScenarioFileName), Path::GetFileName(_path.c_str()));
+        }
+
+        // We try to fix the cycles on import, hence the 'true' parameter
+        check_for_sprite_list_cycles(true);
+        int32_t disjoint_sprites_count = fix_disjoint_sprites();
+        if (disjoint_sprites_count > 0)
+        {
+            log_error("Found %d disjoint null sprites", disjoint_sprites_count);
+        }
+    }
+
+private:
+    template<typename TFunc> void ReadChunk(uint32_t id, TFunc func)
+    {
+        auto data = _reader->ReadChunk(id);
+        DataSerialiser ds(false, data);
+        func(ds);
+
+        // Reading past the end already throws, a chunk with data left over was written with a different layout.
+        // Newer versions that can still be read may append to a chunk.
+        if (data.GetPosition() != data.GetLength() && _reader->GetVersion() <= ParkFile::VERSION)
+        {
+            throw IOException("Park file chunk has an unexpected size.");
+        }
+    }
+
+    template<typename TFunc> void ReadOptionalChunk(uint32_t id, TFunc func)
+    {
+        if (_reader->HasChunk(id))
+        {
+            ReadChunk(id, func);
+        }
+    }
+};
+
+std::unique_ptr<IParkImporter> ParkImporter::CreateParkFile()
+{
+    return std::make_unique<ParkFileImporter>();
+}
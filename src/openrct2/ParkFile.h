@@ -0,0 +1,160 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+#include "core/MemoryStream.h"
+
+#include <vector>
+
+namespace OpenRCT2
+{
+    struct IStream;
+}
+
+namespace ParkFile
+{
+    // "PARK" in little endian
+    constexpr uint32_t MAGIC = 0x4B524150;
+
+    // The version that is written, increase it whenever the contents of a chunk change. MIN_VERSION is the oldest
+    // version that is still able to read what is written, files written by an older version can not be read either.
+    constexpr uint32_t VERSION = 2;
+    constexpr uint32_t MIN_VERSION = 2;
+
+    namespace ChunkId
+    {
+        constexpr uint32_t AUTHORING = 0x01;
+        constexpr uint32_t OBJECTS = 0x02;
+        constexpr uint32_t SCENARIO = 0x03;
+        constexpr uint32_t GENERAL = 0x04;
+        constexpr uint32_t CLIMATE = 0x05;
+        constexpr uint32_t PARK = 0x06;
+        constexpr uint32_t FINANCE = 0x07;
+        constexpr uint32_t HISTORY = 0x08;
+        constexpr uint32_t RESEARCH = 0x09;
+        constexpr uint32_t NEWS = 0x0A;
+        constexpr uint32_t MAP = 0x10;
+        constexpr uint32_t ENTITIES = 0x11;
+        constexpr uint32_t RIDES = 0x12;
+        constexpr uint32_t BANNERS = 0x13;
+    } // namespace ChunkId
+
+    enum class ChunkCompression : uint32_t
+    {
+        None,
+        Zlib,
+    };
+
+#pragma pack(push, 1)
+    struct Header
+    {
+        uint32_t Magic;
+        uint32_t TargetVersion;
+        uint32_t MinVersion;
+        uint32_t NumChunks;
+        uint8_t Type; // S6_TYPE_SAVEDGAME or S6_TYPE_SCENARIO
+        uint8_t Pad[3];
+    };
+    assert_struct_size(Header, 20);
+
+    struct ChunkEntry
+    {
+        uint32_t Id;
+        ChunkCompression Compression;
+        uint64_t Offset; // From the start of the header
+        uint64_t Length;
+        uint64_t UncompressedLength;
+        uint32_t Checksum; // CRC32 of the stored bytes
+    };
+    assert_struct_size(ChunkEntry, 36);
+#pragma pack(pop)
+} // namespace ParkFile
+
+/**
+ * Writes a park file: a header, a table of the chunks and then the chunks themselves. Each chunk is compressed on its
+ * own, so a reader only has to decompress the chunks it is interested in.
+ */
+class ParkFileWriter final
+{
+public:
+    void AddChunk(uint32_t id, OpenRCT2::MemoryStream&& data);
+
+    /**
+     * Compresses the chunks, spreading the work across the task scheduler when parallel is set, and writes the file.
+     */
+    void Save(OpenRCT2::IStream* stream, uint8_t type, bool parallel);
+
+private:
+    struct Chunk
+    {
+        uint32_t Id;
+        OpenRCT2::MemoryStream Data;
+    };
+
+    std::vector<Chunk> _chunks;
+};
+
+/**
+ * Reads the header and chunk table of a park file. Chunks are only read, checked and decompressed when asked for, the
+ * stream has to stay open until then.
+ */
+class ParkFileReader final
+{
+public:
+    explicit ParkFileReader(OpenRCT2::IStream* stream);
+
+    uint8_t GetType() const;
+    uint32_t GetVersion() const;
+    bool HasChunk(uint32_t id) const;
+
+    /**
+     * The number of bytes from the header to the end of the last chunk, data that follows the park is not included.
+     */
+    uint64_t GetLength() const;
+    OpenRCT2::MemoryStream ReadChunk(uint32_t id);
+
+    /**
+     * Checks for the magic number without moving the stream.
+     */
+    static bool IsParkFile(OpenRCT2::IStream* stream);
+
+private:
+    OpenRCT2::IStream* const _stream;
+    uint64_t _basePosition = 0;
+    ParkFile::Header _header{};
+    std::vector<ParkFile::ChunkEntry> _chunks;
+
+    const ParkFile::ChunkEntry* FindChunk(uint32_t id) const;
+};
+
+/**
+ * Class to export parks as native park files (*.park). Unlike SV6, these hold the park the way the game stores it, so
+ * they are not limited to RCT2's number of tile elements and sprites.
+ */
+class ParkFileExporter final
+{
+public:
+    /**
+     * Whether the chunks are compressed on the task scheduler, see S6Exporter::EncodeInParallel.
+     */
+    bool EncodeInParallel = true;
+
+    void Export();
+    void SaveGame(const utf8* path);
+    void SaveGame(OpenRCT2::IStream* stream);
+    void SaveScenario(const utf8* path);
+    void SaveScenario(OpenRCT2::IStream* stream);
+
+private:
+    ParkFileWriter _writer;
+
+    template<typename TFunc> void WriteChunk(uint32_t id, TFunc func);
+};
@@ -27,6 +27,10 @@ namespace ParkImporter
         {
             parkImporter = CreateS4();
         }
+        else if (ExtensionIsParkFile(extension))
+        {
+            parkImporter = CreateParkFile();
+        }
         else
         {
             auto context = OpenRCT2::GetContext();
@@ -40,6 +44,11 @@ namespace ParkImporter
         return String::Equals(extension, ".sc4", true) || String::Equals(extension, ".sv4", true);
     }
 
+    bool ExtensionIsParkFile(const std::string& extension)
+    {
+        return String::Equals(extension, ".park", true);
+    }
+
     bool ExtensionIsScenario(const std::string& extension)
     {
         return String::Equals(extension, ".sc4", true) || String::Equals(extension, ".sc6", true);
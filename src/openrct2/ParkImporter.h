@@ -60,8 +60,10 @@ namespace ParkImporter
     std::unique_ptr<IParkImporter> Create(const std::string& hintPath);
     std::unique_ptr<IParkImporter> CreateS4();
     std::unique_ptr<IParkImporter> CreateS6(IObjectRepository& objectRepository);
+    std::unique_ptr<IParkImporter> CreateParkFile();
 
     bool ExtensionIsRCT1(const std::string& extension);
+    bool ExtensionIsParkFile(const std::string& extension);
     bool ExtensionIsScenario(const std::string& extension);
 } // namespace ParkImporter
 
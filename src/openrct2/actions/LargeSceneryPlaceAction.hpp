@@ -250,6 +250,8 @@ public:
             return std::make_unique<LargeSceneryPlaceActionResult>(GA_ERROR::NO_FREE_ELEMENTS);
         }
 
+        // The inserts of the later tiles may grow the element storage, the first element is kept by its index
+        size_t firstElementIndex = 0;
         uint8_t tileNum = 0;
         for (rct_large_scenery_tile* tile = sceneryEntry->large_scenery.tiles; tile->x_offset != -1; tile++, tileNum++)
         {
@@ -293,10 +295,11 @@ public:
 
             if (tileNum == 0)
             {
-                res->tileElement = newTileElement;
+                firstElementIndex = newTileElement - gTileElements.data();
             }
             map_invalidate_tile_full(curTile);
         }
+        res->tileElement = &gTileElements[firstElementIndex];
 
         // Allocate banner after all tiles to ensure banner id doesn't need to be freed.
         if (sceneryEntry->large_scenery.scrolling_mode != SCROLLING_MODE_NONE)
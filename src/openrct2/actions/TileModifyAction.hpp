@@ -265,6 +265,12 @@ private:
                 break;
         }
 
+        if (isExecuting)
+        {
+            // The tile inspector moves and edits elements directly.
+            tile_elements_changed_at(_loc);
+        }
+
         res->Position.x = _loc.x;
         res->Position.y = _loc.y;
         res->Position.z = tile_element_height(_loc);
@@ -0,0 +1,250 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../core/File.h"
+#    include "../core/MemoryStream.h"
+#    include "../object/Object.h"
+#    include "../platform/Platform2.h"
+#    include "../rct12/SawyerChunkReader.h"
+#    include "../rct12/SawyerChunkWriter.h"
+#    include "../scenario/Scenario.h"
+#    include "../util/SawyerCoding.h"
+#    include "../util/Util.h"
+
+#    include <algorithm>
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <cstring>
+#    include <string>
+#    include <vector>
+
+struct DecodedChunk
+{
+    SAWYER_ENCODING Encoding;
+    std::vector<uint8_t> Data;
+};
+
+/**
+ * Reads every chunk of an SV6 or SC6 file, skipping the packed objects.
+ */
+static std::vector<DecodedChunk> read_park_chunks(const char* path)
+{
+    std::vector<DecodedChunk> chunks;
+    try
+    {
+        auto bytes = File::ReadAllBytes(path);
+        OpenRCT2::MemoryStream stream(bytes.data(), bytes.size());
+        SawyerChunkReader reader(&stream);
+        auto readChunk = [&chunks, &reader]() {
+            auto chunk = reader.ReadChunk();
+            auto data = static_cast<const uint8_t*>(chunk->GetData());
+            chunks.push_back({ chunk->GetEncoding(), std::vector<uint8_t>(data, data + chunk->GetLength()) });
+            return chunk;
+        };
+
+        rct_s6_header header{};
+        auto headerChunk = readChunk();
+        std::memcpy(&header, headerChunk->GetData(), std::min(sizeof(header), headerChunk->GetLength()));
+        if (header.type == S6_TYPE_SCENARIO)
+        {
+            readChunk();
+        }
+        for (uint16_t i = 0; i < header.num_packed_objects; i++)
+        {
+            stream.Seek(sizeof(rct_object_entry), OpenRCT2::STREAM_SEEK_CURRENT);
+            reader.SkipChunk();
+        }
+        // The last four bytes are the checksum
+        while (stream.GetPosition() + 4 < stream.GetLength())
+        {
+            readChunk();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to read chunks of %s: %s", path, e.what());
+        chunks.clear();
+    }
+    return chunks;
+}
+
+static std::vector<std::vector<uint8_t>> encode_chunks(const std::vector<DecodedChunk>& chunks)
+{
+    std::vector<std::vector<uint8_t>> result;
+    for (const auto& chunk : chunks)
+    {
+        result.push_back(SawyerChunkWriter::EncodeChunk(chunk.Data.data(), chunk.Data.size(), chunk.Encoding));
+    }
+    return result;
+}
+
+/**
+ * Checks that the kernels produce the same file as the scalar kernels and read it back unchanged.
+ */
+static bool verify_kernels(const std::vector<DecodedChunk>& chunks, const SawyerCodingKernels* kernels)
+{
+    sawyercoding_set_kernels(sawyercoding_kernels_scalar());
+    auto expected = encode_chunks(chunks);
+    sawyercoding_set_kernels(kernels);
+    auto actual = encode_chunks(chunks);
+    bool result = expected == actual;
+    for (size_t i = 0; result && i < actual.size(); i++)
+    {
+        OpenRCT2::MemoryStream stream(actual[i].data(), actual[i].size());
+        auto chunk = SawyerChunkReader(&stream).ReadChunk();
+        auto data = static_cast<const uint8_t*>(chunk->GetData());
+        result = std::vector<uint8_t>(data, data + chunk->GetLength()) == chunks[i].Data;
+    }
+    sawyercoding_set_kernels(nullptr);
+    return result;
+}
+
+static size_t get_total_size(const std::vector<DecodedChunk>& chunks)
+{
+    size_t total = 0;
+    for (const auto& chunk : chunks)
+    {
+        total += chunk.Data.size();
+    }
+    return total;
+}
+
+static void BM_sawyercoding_encode(
+    benchmark::State& state, const std::vector<DecodedChunk> chunks, const SawyerCodingKernels* kernels)
+{
+    sawyercoding_set_kernels(kernels);
+    for (auto _ : state)
+    {
+        auto encoded = encode_chunks(chunks);
+        benchmark::DoNotOptimize(encoded);
+    }
+    sawyercoding_set_kernels(nullptr);
+    state.SetBytesProcessed(state.iterations() * get_total_size(chunks));
+}
+
+static void BM_sawyercoding_decode(
+    benchmark::State& state, const std::vector<DecodedChunk> chunks, const SawyerCodingKernels* kernels)
+{
+    OpenRCT2::MemoryStream stream;
+    for (const auto& encoded : encode_chunks(chunks))
+    {
+        stream.Write(encoded.data(), encoded.size());
+    }
+
+    sawyercoding_set_kernels(kernels);
+    for (auto _ : state)
+    {
+        stream.SetPosition(0);
+        SawyerChunkReader reader(&stream);
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            auto chunk = reader.ReadChunk();
+            benchmark::DoNotOptimize(chunk);
+        }
+    }
+    sawyercoding_set_kernels(nullptr);
+    state.SetBytesProcessed(state.iterations() * get_total_size(chunks));
+}
+
+static int cmdline_for_bench_sawyer_coding(int argc, const char** argv)
+{
+    std::vector<const SawyerCodingKernels*> kernelSets = { sawyercoding_kernels_scalar() };
+    if (sse41_available() && sawyercoding_kernels_sse4_1() != nullptr)
+    {
+        kernelSets.push_back(sawyercoding_kernels_sse4_1());
+    }
+    if (avx2_available() && sawyercoding_kernels_avx2() != nullptr)
+    {
+        kernelSets.push_back(sawyercoding_kernels_avx2());
+    }
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            auto chunks = read_park_chunks(argv[i]);
+            if (chunks.empty())
+            {
+                return -1;
+            }
+            auto name = std::string(argv[i]);
+            for (auto kernels : kernelSets)
+            {
+                if (!verify_kernels(chunks, kernels))
+                {
+                    log_error("%s kernels disagree with the scalar kernels for %s", kernels->Name, argv[i]);
+                    return -1;
+                }
+                benchmark::RegisterBenchmark(
+                    (name + "/encode/" + kernels->Name).c_str(), BM_sawyercoding_encode, chunks, kernels);
+                benchmark::RegisterBenchmark(
+                    (name + "/decode/" + kernels->Name).c_str(), BM_sawyercoding_decode, chunks, kernels);
+            }
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchSawyerCoding(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_sawyer_coding(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchSawyerCoding(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchSawyerCodingCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "<file> [<file>]... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] "
+        "[--benchmark_min_time=<min_time>] [--benchmark_repetitions=<num_repetitions>] "
+        "[--benchmark_report_aggregates_only={true|false}] [--benchmark_format=<console|json|csv>] "
+        "[--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] [--benchmark_color={auto|true|false}] "
+        "[--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchSawyerCoding),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchSawyerCoding), CommandTableEnd
+#endif // USE_BENCHMARK
+};
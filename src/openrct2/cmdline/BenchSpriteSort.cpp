@@ -32,44 +32,36 @@
 #    include <benchmark/benchmark.h>
 #    include <cstdint>
 #    include <iterator>
+#    include <string>
 #    include <vector>
 
-static void fixup_pointers(paint_session* s, size_t paint_session_entries, size_t paint_struct_entries, size_t quadrant_entries)
+static void fixup_pointers(std::vector<RecordedPaintSession>& s)
 {
-    for (size_t i = 0; i < paint_session_entries; i++)
+    for (auto& recorded : s)
     {
-        for (size_t j = 0; j < paint_struct_entries; j++)
+        auto& entries = recorded.Entries;
+        const auto nullIndex = entries.size();
+        auto fixup = [&entries, nullIndex](paint_struct*& ps) {
+            auto index = reinterpret_cast<uintptr_t>(ps);
+            ps = index == nullIndex ? nullptr : &entries[index].basic;
+        };
+        for (auto& entry : entries)
         {
-            if (s[i].PaintStructs[j].basic.next_quadrant_ps == (paint_struct*)paint_struct_entries)
-            {
-                s[i].PaintStructs[j].basic.next_quadrant_ps = nullptr;
-            }
-            else
-            {
-                auto nextQuadrantPs = reinterpret_cast<uintptr_t>(s[i].PaintStructs[j].basic.next_quadrant_ps);
-                s[i].PaintStructs[j].basic.next_quadrant_ps = &s[i].PaintStructs[nextQuadrantPs].basic;
-            }
+            fixup(entry.basic.next_quadrant_ps);
         }
-        for (size_t j = 0; j < quadrant_entries; j++)
+        for (auto& quad : recorded.Session.Quadrants)
         {
-            if (s[i].Quadrants[j] == (paint_struct*)quadrant_entries)
-            {
-                s[i].Quadrants[j] = nullptr;
-            }
-            else
-            {
-                s[i].Quadrants[j] = &s[i].PaintStructs[(size_t)s[i].Quadrants[j]].basic;
-            }
+            fixup(quad);
         }
     }
 }
 
-static std::vector<paint_session> extract_paint_session(const std::string parkFileName)
+static std::vector<RecordedPaintSession> extract_paint_session(const std::string parkFileName)
 {
     core_init();
     gOpenRCT2Headless = true;
     auto context = OpenRCT2::CreateContext();
-    std::vector<paint_session> sessions;
+    std::vector<RecordedPaintSession> sessions;
     log_info("Starting...");
     if (context->Initialise())
     {
@@ -132,42 +124,74 @@ static std::vector<paint_session> extract_paint_session(const std::string parkFi
     return sessions;
 }
 
+static std::vector<size_t> get_arranged_order(const RecordedPaintSession& recorded)
+{
+    std::vector<size_t> order;
+    for (auto ps = recorded.Session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        order.push_back(reinterpret_cast<const paint_entry*>(ps) - recorded.Entries.data());
+    }
+    return order;
+}
+
+/**
+ * Arranges every session with both methods and checks they give the same draw order, which draws the same pixels.
+ */
+static bool verify_arrange_methods(const std::vector<RecordedPaintSession>& inputSessions)
+{
+    bool result = true;
+    for (size_t i = 0; i < inputSessions.size(); i++)
+    {
+        std::vector<RecordedPaintSession> legacy(1, inputSessions[i]);
+        std::vector<RecordedPaintSession> indexed(1, inputSessions[i]);
+        fixup_pointers(legacy);
+        fixup_pointers(indexed);
+        paint_session_arrange(&legacy[0].Session, PaintArrangeMethod::Legacy);
+        paint_session_arrange(&indexed[0].Session, PaintArrangeMethod::Indexed);
+        if (get_arranged_order(legacy[0]) != get_arranged_order(indexed[0]))
+        {
+            log_error("Paint session %u is arranged differently by the indexed method.", static_cast<uint32_t>(i));
+            result = false;
+        }
+    }
+    return result;
+}
+
 // This function is based on benchgfx_render_screenshots
-static void BM_paint_session_arrange(benchmark::State& state, const std::vector<paint_session> inputSessions)
+static void BM_paint_session_arrange(
+    benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions, PaintArrangeMethod method)
 {
-    std::vector<paint_session> sessions = inputSessions;
+    std::vector<RecordedPaintSession> sessions = inputSessions;
     // Fixing up the pointers continuously is wasteful. Fix it up once for `sessions` and store a copy.
     // Keep in mind we need bit-exact copy, as the lists use pointers.
-    // Once sorted, just restore the copy with the original fixed-up version.
-    paint_session* local_s = new paint_session[std::size(sessions)];
-    fixup_pointers(&sessions[0], std::size(sessions), std::size(local_s->PaintStructs), std::size(local_s->Quadrants));
-    std::copy_n(sessions.cbegin(), std::size(sessions), local_s);
+    // Once sorted, just restore the copy with the original fixed-up version. Assigning the entry vectors
+    // keeps their storage, so the fixed-up pointers stay valid.
+    fixup_pointers(sessions);
+    std::vector<RecordedPaintSession> local_s = sessions;
     for (auto _ : state)
     {
         state.PauseTiming();
-        std::copy_n(local_s, std::size(sessions), sessions.begin());
+        std::copy_n(local_s.cbegin(), std::size(sessions), sessions.begin());
         state.ResumeTiming();
-        paint_session_arrange(&sessions[0]);
+        for (auto& recorded : sessions)
+        {
+            paint_session_arrange(&recorded.Session, method);
+        }
         benchmark::DoNotOptimize(sessions);
     }
     state.SetItemsProcessed(state.iterations() * std::size(sessions));
-    delete[] local_s;
 }
 
 static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
 {
     {
         // Register some basic "baseline" benchmark
-        std::vector<paint_session> sessions(1);
-        for (auto& ps : sessions[0].PaintStructs)
-        {
-            ps.basic.next_quadrant_ps = (paint_struct*)(std::size(sessions[0].PaintStructs));
-        }
-        for (auto& quad : sessions[0].Quadrants)
+        std::vector<RecordedPaintSession> sessions(1);
+        for (auto& quad : sessions[0].Session.Quadrants)
         {
-            quad = (paint_struct*)(std::size(sessions[0].Quadrants));
+            quad = reinterpret_cast<paint_struct*>(sessions[0].Entries.size());
         }
-        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions);
+        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions, PaintArrangeMethod::Legacy);
     }
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
@@ -183,9 +207,20 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
         if (Platform::FileExists(argv[i]))
         {
             // Register benchmark for sv6 if valid
-            std::vector<paint_session> sessions = extract_paint_session(argv[i]);
+            std::vector<RecordedPaintSession> sessions = extract_paint_session(argv[i]);
             if (!sessions.empty())
-                benchmark::RegisterBenchmark(argv[i], BM_paint_session_arrange, sessions);
+            {
+                if (!verify_arrange_methods(sessions))
+                {
+                    log_error("Arrange methods disagree for %s", argv[i]);
+                    return -1;
+                }
+                auto name = std::string(argv[i]);
+                benchmark::RegisterBenchmark(
+                    (name + "/legacy").c_str(), BM_paint_session_arrange, sessions, PaintArrangeMethod::Legacy);
+                benchmark::RegisterBenchmark(
+                    (name + "/indexed").c_str(), BM_paint_session_arrange, sessions, PaintArrangeMethod::Indexed);
+            }
         }
         else
         {
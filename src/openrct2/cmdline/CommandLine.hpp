@@ -118,7 +118,11 @@ namespace CommandLine
     extern const CommandLineCommand SpriteCommands[];
     extern const CommandLineCommand BenchGfxCommands[];
     extern const CommandLineCommand BenchSpriteSortCommands[];
+    extern const CommandLineCommand BenchSawyerCodingCommands[];
     extern const CommandLineCommand SimulateCommands[];
+#ifndef DISABLE_NETWORK
+    extern const CommandLineCommand LoadTestCommands[];
+#endif
 
     extern const CommandLineExample RootExamples[];
 
@@ -9,6 +9,7 @@
 
 #include "../FileClassifier.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
 #include "../ParkImporter.h"
 #include "../common.h"
 #include "../core/Console.hpp"
@@ -55,9 +56,10 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
     uint32_t destinationFileType = get_file_extension_type(destinationPath);
 
     // Validate target type
-    if (destinationFileType != FILE_EXTENSION_SC6 && destinationFileType != FILE_EXTENSION_SV6)
+    if (destinationFileType != FILE_EXTENSION_SC6 && destinationFileType != FILE_EXTENSION_SV6
+        && destinationFileType != FILE_EXTENSION_PARK)
     {
-        Console::Error::WriteLine("Only conversion to .SC6 or .SV4 is supported.");
+        Console::Error::WriteLine("Only conversion to .SC6, .SV6 or .PARK is supported.");
         return EXITCODE_FAIL;
     }
 
@@ -81,8 +83,15 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
                 return EXITCODE_FAIL;
             }
             break;
+        case FILE_EXTENSION_PARK:
+            if (destinationFileType == FILE_EXTENSION_PARK)
+            {
+                Console::Error::WriteLine("File is already an OpenRCT2 park.");
+                return EXITCODE_FAIL;
+            }
+            break;
         default:
-            Console::Error::WriteLine("Only conversion from .SC4, .SV4, .SC6 or .SV6 is supported.");
+            Console::Error::WriteLine("Only conversion from .SC4, .SV4, .SC6, .SV6 or .PARK is supported.");
             return EXITCODE_FAIL;
     }
 
@@ -116,20 +125,36 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
 
     try
     {
-        auto exporter = std::make_unique<S6Exporter>();
-
         // HACK remove the main window so it saves the park with the
         //      correct initial view
         window_close_by_class(WC_MAIN_WINDOW);
 
-        exporter->Export();
-        if (destinationFileType == FILE_EXTENSION_SC6)
+        if (destinationFileType == FILE_EXTENSION_PARK)
         {
-            exporter->SaveScenario(destinationPath);
+            auto exporter = std::make_unique<ParkFileExporter>();
+            exporter->Export();
+            // Park files hold scenarios and saved games alike, the source decides which it is
+            if (sourceFileType == FILE_EXTENSION_SC4 || sourceFileType == FILE_EXTENSION_SC6)
+            {
+                exporter->SaveScenario(destinationPath);
+            }
+            else
+            {
+                exporter->SaveGame(destinationPath);
+            }
         }
         else
         {
-            exporter->SaveGame(destinationPath);
+            auto exporter = std::make_unique<S6Exporter>();
+            exporter->Export();
+            if (destinationFileType == FILE_EXTENSION_SC6)
+            {
+                exporter->SaveScenario(destinationPath);
+            }
+            else
+            {
+                exporter->SaveGame(destinationPath);
+            }
         }
     }
     catch (const std::exception& ex)
@@ -162,6 +187,8 @@ static const utf8* GetFileTypeFriendlyName(uint32_t fileType)
             return "RollerCoaster Tycoon 2 scenario";
         case FILE_EXTENSION_SV6:
             return "RollerCoaster Tycoon 2 saved game";
+        case FILE_EXTENSION_PARK:
+            return "OpenRCT2 park";
     }
 
     assert(false);
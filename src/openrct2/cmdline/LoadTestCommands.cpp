@@ -0,0 +1,732 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "../Context.h"
+#    include "../Game.h"
+#    include "../GameState.h"
+#    include "../GameStateHash.h"
+#    include "../OpenRCT2.h"
+#    include "../ReplayManager.h"
+#    include "../config/Config.h"
+#    include "../core/Console.hpp"
+#    include "../core/Json.hpp"
+#    include "../core/String.hpp"
+#    include "../network/NetworkConnection.h"
+#    include "../network/NetworkGameActionBatch.h"
+#    include "../network/NetworkKey.h"
+#    include "../network/network.h"
+#    include "../platform/platform.h"
+#    include "CommandLine.hpp"
+
+#    include <algorithm>
+#    include <atomic>
+#    include <cerrno>
+#    include <chrono>
+#    include <cstdlib>
+#    include <map>
+#    include <memory>
+#    include <optional>
+#    include <string>
+#    include <thread>
+#    include <unordered_map>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+using LoadTestClock = std::chrono::steady_clock;
+
+static int32_t _port = 0;
+static bool _fast = false;
+static const char* _jsonPath = nullptr;
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition LoadTestOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_port,     NAC, "port", "port to run the server on, defaults to the configured port"      },
+    { CMDLINE_TYPE_SWITCH,  &_fast,     NAC, "fast", "run the ticks back to back instead of at the speed of the game" },
+    { CMDLINE_TYPE_STRING,  &_jsonPath, NAC, "json", "write a JSON report to the given path, - for stdout"            },
+    OptionTableEnd
+};
+
+static exitcode_t HandleLoadTest(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleLoadTestReplay(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::LoadTestCommands[]
+{
+    // Main commands
+    DefineCommand("",       "<park-file> <clients> <ticks>",    LoadTestOptions, HandleLoadTest      ),
+    DefineCommand("replay", "<parkrep-file> <clients> <ticks>", LoadTestOptions, HandleLoadTestReplay),
+    CommandTableEnd
+};
+// clang-format on
+
+// Clients that did not join by then are reported as failed
+constexpr auto JOIN_TIMEOUT = std::chrono::seconds(60);
+
+// Time given to the clients to receive the last ticks before they are stopped
+constexpr auto DRAIN_TIME = std::chrono::milliseconds(500);
+
+constexpr uint32_t HEARTBEAT_INTERVAL_MS = 3000;
+
+/**
+ * Speaks just enough of the client side of the protocol to join the server and follow the game, without loading the
+ * map or running the game. All clients are served by a thread of their own, so they do not touch the game state.
+ */
+class LoadTestClient final
+{
+public:
+    enum class State
+    {
+        Connecting,
+        Authenticating,
+        Downloading,
+        Joined,
+        Disconnected,
+    };
+
+    struct TickData
+    {
+        uint32_t Srand0{};
+        GameStateHash StateHash;
+        LoadTestClock::time_point ArrivalTime;
+    };
+
+    std::string Name;
+    NetworkConnection Connection;
+    std::atomic<State> CurrentState{ State::Connecting };
+    std::string Error;
+
+    LoadTestClock::time_point ConnectTime;
+    LoadTestClock::time_point MapRequestTime;
+    LoadTestClock::time_point JoinTime;
+    LoadTestClock::time_point EndTime;
+    uint32_t MapSize = 0;
+    uint64_t BytesReceivedAtJoin = 0;
+    uint64_t BytesReceivedAtEnd = 0;
+
+    std::map<uint32_t, TickData> Ticks;
+    uint32_t MissedTicks = 0;
+    uint32_t ActionsReceived = 0;
+
+    LoadTestClient(std::string name, NetworkKey& key)
+        : Name(std::move(name))
+        , _key(key)
+    {
+    }
+
+    void Connect(uint16_t port)
+    {
+        ConnectTime = LoadTestClock::now();
+        Connection.Socket = CreateTcpSocket();
+        Connection.Socket->ConnectAsync("127.0.0.1", port);
+    }
+
+    void Update()
+    {
+        auto state = CurrentState.load();
+        if (state == State::Disconnected)
+        {
+            return;
+        }
+
+        try
+        {
+            if (state == State::Connecting)
+            {
+                auto socketStatus = Connection.Socket->GetStatus();
+                if (socketStatus == SOCKET_STATUS_CLOSED)
+                {
+                    Fail(Connection.Socket->GetError() != nullptr ? Connection.Socket->GetError() : "Connection failed");
+                    return;
+                }
+                if (socketStatus != SOCKET_STATUS_CONNECTED)
+                {
+                    return;
+                }
+                CurrentState = State::Authenticating;
+                Connection.AuthStatus = NETWORK_AUTH_REQUESTED;
+                Connection.QueuePacket(NetworkPacket(NetworkCommand::Token));
+            }
+
+            int32_t status;
+            do
+            {
+                status = Connection.ReadPacket();
+                if (status == NETWORK_READPACKET_DISCONNECTED)
+                {
+                    Fail("Disconnected by the server");
+                    return;
+                }
+                if (status == NETWORK_READPACKET_SUCCESS)
+                {
+                    HandlePacket(Connection.InboundPacket);
+                    Connection.InboundPacket.Clear();
+                    if (CurrentState == State::Disconnected)
+                    {
+                        return;
+                    }
+                }
+            } while (status == NETWORK_READPACKET_MORE_DATA || status == NETWORK_READPACKET_SUCCESS);
+
+            uint32_t ticks = platform_get_ticks();
+            if (ticks - _lastHeartbeatTime >= HEARTBEAT_INTERVAL_MS)
+            {
+                _lastHeartbeatTime = ticks;
+                Connection.QueuePacket(NetworkPacket(NetworkCommand::Heartbeat));
+            }
+            Connection.SendQueuedPackets();
+        }
+        catch (const std::exception& e)
+        {
+            Fail(e.what());
+        }
+    }
+
+    void Stop()
+    {
+        EndTime = LoadTestClock::now();
+        BytesReceivedAtEnd = Connection.Stats.bytesReceived[NETWORK_STATISTICS_GROUP_TOTAL];
+        if (Connection.Socket != nullptr)
+        {
+            Connection.Socket->Disconnect();
+        }
+    }
+
+private:
+    NetworkKey& _key;
+    uint32_t _lastHeartbeatTime = 0;
+
+    void Fail(const std::string& error)
+    {
+        Error = error;
+        CurrentState = State::Disconnected;
+    }
+
+    void HandlePacket(NetworkPacket& packet)
+    {
+        switch (packet.GetCommand())
+        {
+            case NetworkCommand::Token:
+                HandleToken(packet);
+                break;
+            case NetworkCommand::Auth:
+                HandleAuth(packet);
+                break;
+            case NetworkCommand::ObjectsList:
+                HandleObjectsList(packet);
+                break;
+            case NetworkCommand::Map:
+                HandleMap(packet);
+                break;
+            case NetworkCommand::Tick:
+                HandleTick(packet);
+                break;
+            case NetworkCommand::Ping:
+                Connection.QueuePacket(NetworkPacket(NetworkCommand::Ping));
+                break;
+            case NetworkCommand::GameAction:
+                ActionsReceived++;
+                break;
+            case NetworkCommand::GameActionBatch:
+            {
+                std::vector<NetworkGameActionBatch::Action> actions;
+                if (!NetworkGameActionBatch::Read(packet, actions))
+                {
+                    Fail("Received malformed game action batch");
+                    return;
+                }
+                ActionsReceived += static_cast<uint32_t>(actions.size());
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void HandleToken(NetworkPacket& packet)
+    {
+        uint32_t challengeSize;
+        packet >> challengeSize;
+        const uint8_t* challenge = packet.Read(challengeSize);
+        std::vector<uint8_t> signature;
+        if (challenge == nullptr || !_key.Sign(challenge, challengeSize, signature))
+        {
+            Fail("Failed to sign the challenge of the server");
+            return;
+        }
+
+        NetworkPacket authPacket(NetworkCommand::Auth);
+        authPacket.WriteString(network_get_version().c_str());
+        authPacket.WriteString(Name.c_str());
+        authPacket.WriteString("");
+        authPacket.WriteString(_key.PublicKeyString().c_str());
+        authPacket << static_cast<uint32_t>(signature.size());
+        authPacket.Write(signature.data(), signature.size());
+        Connection.QueuePacket(std::move(authPacket));
+    }
+
+    void HandleAuth(NetworkPacket& packet)
+    {
+        uint32_t authStatus;
+        uint8_t playerId;
+        packet >> authStatus >> playerId;
+        if (authStatus != NETWORK_AUTH_OK)
+        {
+            Fail("Authentication failed with status " + std::to_string(authStatus));
+            return;
+        }
+        Connection.AuthStatus = NETWORK_AUTH_OK;
+    }
+
+    void HandleObjectsList(NetworkPacket& packet)
+    {
+        uint32_t index;
+        uint32_t totalObjects;
+        packet >> index >> totalObjects;
+        if (index + 1 < totalObjects)
+        {
+            return;
+        }
+
+        // Claim to have all objects and no earlier map, so the whole map is sent like to a new player
+        NetworkPacket mapRequest(NetworkCommand::MapRequest);
+        mapRequest << static_cast<uint32_t>(0);
+        mapRequest << static_cast<uint32_t>(0) << static_cast<uint32_t>(0) << static_cast<uint8_t>(0);
+        Connection.QueuePacket(std::move(mapRequest));
+        MapRequestTime = LoadTestClock::now();
+        CurrentState = State::Downloading;
+    }
+
+    void HandleMap(NetworkPacket& packet)
+    {
+        uint32_t mapId, baseId, size, offset;
+        uint8_t flags;
+        packet >> mapId >> flags >> baseId >> size >> offset;
+        size_t chunkSize = packet.Header.Size - packet.BytesRead;
+        MapSize = size;
+        if (offset + chunkSize >= size && (flags & NETWORK_MAP_FLAG_LAST))
+        {
+            JoinTime = LoadTestClock::now();
+            BytesReceivedAtJoin = Connection.Stats.bytesReceived[NETWORK_STATISTICS_GROUP_TOTAL];
+            CurrentState = State::Joined;
+        }
+    }
+
+    void HandleTick(NetworkPacket& packet)
+    {
+        uint32_t serverTick, flags;
+        TickData tickData;
+        packet >> serverTick >> tickData.Srand0 >> flags;
+        tickData.ArrivalTime = LoadTestClock::now();
+        if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
+        {
+            packet.ReadString();
+        }
+        if (flags & NETWORK_TICK_FLAG_STATE_HASH)
+        {
+            packet >> tickData.StateHash.Entities >> tickData.StateHash.TileElements >> tickData.StateHash.Park;
+        }
+
+        if (!Ticks.empty())
+        {
+            uint32_t lastTick = Ticks.rbegin()->first;
+            if (serverTick <= lastTick)
+            {
+                Fail("Received tick " + std::to_string(serverTick) + " after tick " + std::to_string(lastTick));
+                return;
+            }
+            MissedTicks += serverTick - lastTick - 1;
+        }
+        Ticks.emplace(serverTick, tickData);
+    }
+};
+
+struct LoadTestSummary
+{
+    double Average{};
+    double Percentile95{};
+    double Max{};
+};
+
+static LoadTestSummary Summarise(std::vector<double> values)
+{
+    LoadTestSummary summary;
+    if (!values.empty())
+    {
+        std::sort(values.begin(), values.end());
+        double total = 0;
+        for (auto value : values)
+        {
+            total += value;
+        }
+        summary.Average = total / values.size();
+        summary.Percentile95 = values[std::min(values.size() - 1, values.size() * 95 / 100)];
+        summary.Max = values.back();
+    }
+    return summary;
+}
+
+static double GetMilliseconds(LoadTestClock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+struct LoadTestResult
+{
+    uint32_t Clients{};
+    uint32_t ClientsJoined{};
+    uint32_t Ticks{};
+    LoadTestSummary TickTime;
+    LoadTestSummary TickLatency;
+    LoadTestSummary MapSendTime;
+    uint32_t MapSize{};
+    double BytesPerSecondPerClient{};
+    uint32_t ActionsReceived{};
+    // The clients only record what the server sent without simulating the game, so this measures whether every
+    // client received the same ticks rather than whether their game states stayed in sync.
+    uint32_t TicksCompared{};
+    uint32_t TicksMismatched{};
+    uint32_t TicksMissed{};
+    std::vector<std::string> Errors;
+
+    double GetTickMismatchRate() const
+    {
+        return TicksCompared > 0 ? static_cast<double>(TicksMismatched) / TicksCompared : 0;
+    }
+};
+
+static json_t* SummaryToJson(const LoadTestSummary& summary)
+{
+    json_t* jsonSummary = json_object();
+    json_object_set_new(jsonSummary, "average", json_real(summary.Average));
+    json_object_set_new(jsonSummary, "p95", json_real(summary.Percentile95));
+    json_object_set_new(jsonSummary, "max", json_real(summary.Max));
+    return jsonSummary;
+}
+
+static void WriteReport(const LoadTestResult& result)
+{
+    json_t* jsonReport = json_object();
+    json_object_set_new(jsonReport, "clients", json_integer(result.Clients));
+    json_object_set_new(jsonReport, "clientsJoined", json_integer(result.ClientsJoined));
+    json_object_set_new(jsonReport, "ticks", json_integer(result.Ticks));
+    json_object_set_new(jsonReport, "tickTimeMs", SummaryToJson(result.TickTime));
+    json_object_set_new(jsonReport, "tickLatencyMs", SummaryToJson(result.TickLatency));
+    json_object_set_new(jsonReport, "mapSendTimeMs", SummaryToJson(result.MapSendTime));
+    json_object_set_new(jsonReport, "mapSize", json_integer(result.MapSize));
+    json_object_set_new(jsonReport, "bytesPerSecondPerClient", json_real(result.BytesPerSecondPerClient));
+    json_object_set_new(jsonReport, "actionsReceived", json_integer(result.ActionsReceived));
+    json_object_set_new(jsonReport, "ticksMissed", json_integer(result.TicksMissed));
+    json_object_set_new(jsonReport, "tickMismatchRate", json_real(result.GetTickMismatchRate()));
+
+    json_t* jsonErrors = json_array();
+    for (const auto& error : result.Errors)
+    {
+        json_array_append_new(jsonErrors, json_string(error.c_str()));
+    }
+    json_object_set_new(jsonReport, "errors", jsonErrors);
+
+    if (String::Equals(_jsonPath, "-"))
+    {
+        char* jsonOutput = json_dumps(jsonReport, JSON_INDENT(4));
+        Console::WriteLine("%s", jsonOutput);
+        free(jsonOutput);
+    }
+    else
+    {
+        Json::WriteToFile(_jsonPath, jsonReport, JSON_INDENT(4));
+    }
+    json_decref(jsonReport);
+}
+
+static void PrintSummary(const char* name, const LoadTestSummary& summary)
+{
+    Console::WriteLine(
+        "%-20s avg %8.2f ms, p95 %8.2f ms, max %8.2f ms", name, summary.Average, summary.Percentile95, summary.Max);
+}
+
+static void PrintResult(const LoadTestResult& result)
+{
+    for (const auto& error : result.Errors)
+    {
+        Console::Error::WriteLine("%s", error.c_str());
+    }
+    Console::WriteLine("Clients joined: %u of %u", result.ClientsJoined, result.Clients);
+    PrintSummary("Server tick time", result.TickTime);
+    PrintSummary("Tick latency", result.TickLatency);
+    PrintSummary("Map send time", result.MapSendTime);
+    Console::WriteLine("Map size: %u bytes", result.MapSize);
+    Console::WriteLine("Bandwidth per client: %.0f bytes/s", result.BytesPerSecondPerClient);
+    Console::WriteLine("Game actions received: %u", result.ActionsReceived);
+    Console::WriteLine("Ticks missed: %u", result.TicksMissed);
+    Console::WriteLine(
+        "Tick mismatch rate: %.4f (%u of %u ticks)", result.GetTickMismatchRate(), result.TicksMismatched,
+        result.TicksCompared);
+}
+
+/**
+ * Compares what the clients received with each other, they all follow the same server so any difference in the
+ * state of a tick means packets got lost, reordered or corrupted on the way.
+ */
+static LoadTestResult EvaluateClients(
+    const std::vector<std::unique_ptr<LoadTestClient>>& clients, const std::map<uint32_t, LoadTestClock::time_point>& tickTimes)
+{
+    LoadTestResult result;
+    result.Clients = static_cast<uint32_t>(clients.size());
+
+    std::vector<double> tickLatencies;
+    std::vector<double> mapSendTimes;
+    double totalBytesPerSecond = 0;
+    std::unordered_map<uint32_t, const LoadTestClient::TickData*> referenceTicks;
+    for (const auto& client : clients)
+    {
+        if (!client->Error.empty())
+        {
+            result.Errors.push_back(client->Name + ": " + client->Error);
+        }
+        if (client->JoinTime == LoadTestClock::time_point())
+        {
+            continue;
+        }
+
+        result.ClientsJoined++;
+        result.MapSize = std::max(result.MapSize, client->MapSize);
+        result.ActionsReceived = std::max(result.ActionsReceived, client->ActionsReceived);
+        result.TicksMissed += client->MissedTicks;
+        mapSendTimes.push_back(GetMilliseconds(client->JoinTime - client->MapRequestTime));
+
+        auto seconds = std::chrono::duration<double>(client->EndTime - client->JoinTime).count();
+        if (seconds > 0)
+        {
+            totalBytesPerSecond += (client->BytesReceivedAtEnd - client->BytesReceivedAtJoin) / seconds;
+        }
+
+        for (const auto& tick : tickTimes)
+        {
+            auto it = client->Ticks.find(tick.first);
+            if (it == client->Ticks.end())
+            {
+                continue;
+            }
+
+            const auto& tickData = it->second;
+            tickLatencies.push_back(GetMilliseconds(tickData.ArrivalTime - tick.second));
+
+            auto reference = referenceTicks.emplace(tick.first, &tickData).first->second;
+            if (reference != &tickData)
+            {
+                result.TicksCompared++;
+                if (reference->Srand0 != tickData.Srand0 || !(reference->StateHash == tickData.StateHash))
+                {
+                    result.TicksMismatched++;
+                }
+            }
+        }
+    }
+
+    result.TickLatency = Summarise(tickLatencies);
+    result.MapSendTime = Summarise(mapSendTimes);
+    if (result.ClientsJoined > 0)
+    {
+        result.BytesPerSecondPerClient = totalBytesPerSecond / result.ClientsJoined;
+    }
+    return result;
+}
+
+/**
+ * Runs a server for the loaded park, connects the clients to it over the loopback interface and, once they joined,
+ * runs the given number of ticks. The replay, if one is played back, provides the game actions sent to the clients.
+ */
+static exitcode_t RunLoadTest(const char* path, bool isReplay, uint32_t numClients, uint32_t ticks)
+{
+    core_init();
+
+    gOpenRCT2Headless = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    // Only for this process, the configuration is not saved
+    gConfigNetwork.advertise = false;
+    gConfigNetwork.known_keys_only = false;
+    gConfigNetwork.maxplayers = std::max<int32_t>(gConfigNetwork.maxplayers, numClients + 1);
+    uint16_t port = static_cast<uint16_t>(_port != 0 ? _port : gConfigNetwork.default_port);
+
+    if (!isReplay && !context->LoadParkFromFile(path))
+    {
+        Console::Error::WriteLine("Unable to load park %s.", path);
+        return EXITCODE_FAIL;
+    }
+    if (!network_begin_server(port, "127.0.0.1"))
+    {
+        Console::Error::WriteLine("Unable to start the server on port %u.", port);
+        return EXITCODE_FAIL;
+    }
+    if (isReplay && !context->GetReplayManager()->StartPlayback(path))
+    {
+        Console::Error::WriteLine("Unable to play back %s.", path);
+        network_close();
+        return EXITCODE_FAIL;
+    }
+
+    // All clients sign with the same key, generating one per client would take longer than the test
+    NetworkKey key;
+    if (!key.Generate())
+    {
+        Console::Error::WriteLine("Unable to generate a key for the clients.");
+        network_close();
+        return EXITCODE_FAIL;
+    }
+
+    std::vector<std::unique_ptr<LoadTestClient>> clients;
+    for (uint32_t i = 0; i < numClients; i++)
+    {
+        clients.push_back(std::make_unique<LoadTestClient>("LoadTest" + std::to_string(i + 1), key));
+        clients.back()->Connect(port);
+    }
+
+    std::atomic_bool stopClients{ false };
+    std::thread clientThread([&clients, &stopClients]() {
+        while (!stopClients)
+        {
+            for (auto& client : clients)
+            {
+                client->Update();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (auto& client : clients)
+        {
+            client->Stop();
+        }
+    });
+
+    auto gameState = context->GetGameState();
+    auto nextTickTime = LoadTestClock::now();
+
+    // Keep the game running while the clients join, like a server would
+    if (_jsonPath == nullptr)
+    {
+        Console::WriteLine("Connecting %u clients to port %u...", numClients, port);
+    }
+    auto joinDeadline = LoadTestClock::now() + JOIN_TIMEOUT;
+    while (LoadTestClock::now() < joinDeadline)
+    {
+        bool allDone = std::all_of(clients.begin(), clients.end(), [](const std::unique_ptr<LoadTestClient>& client) {
+            auto state = client->CurrentState.load();
+            return state == LoadTestClient::State::Joined || state == LoadTestClient::State::Disconnected;
+        });
+        if (allDone)
+        {
+            break;
+        }
+        std::this_thread::sleep_until(nextTickTime);
+        nextTickTime += std::chrono::milliseconds(GAME_UPDATE_TIME_MS);
+        gameState->UpdateLogic();
+    }
+
+    if (_jsonPath == nullptr)
+    {
+        Console::WriteLine("Running %u ticks...", ticks);
+    }
+    std::map<uint32_t, LoadTestClock::time_point> tickTimes;
+    std::vector<double> tickDurations;
+    nextTickTime = LoadTestClock::now();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        if (!_fast)
+        {
+            std::this_thread::sleep_until(nextTickTime);
+            nextTickTime += std::chrono::milliseconds(GAME_UPDATE_TIME_MS);
+        }
+        auto startTime = LoadTestClock::now();
+        tickTimes.emplace(gCurrentTicks, startTime);
+        gameState->UpdateLogic();
+        tickDurations.push_back(GetMilliseconds(LoadTestClock::now() - startTime));
+    }
+
+    std::this_thread::sleep_for(DRAIN_TIME);
+    stopClients = true;
+    clientThread.join();
+    network_close();
+
+    auto result = EvaluateClients(clients, tickTimes);
+    result.Ticks = ticks;
+    result.TickTime = Summarise(tickDurations);
+    if (_jsonPath != nullptr)
+    {
+        WriteReport(result);
+    }
+    else
+    {
+        PrintResult(result);
+    }
+
+    bool passed = result.ClientsJoined == result.Clients && result.TicksMismatched == 0 && result.TicksMissed == 0;
+    return passed ? EXITCODE_OK : EXITCODE_FAIL;
+}
+
+/**
+ * Parses a number of clients or ticks, which has to be at least 1.
+ */
+static std::optional<uint32_t> ParseCount(const char* arg)
+{
+    if (*arg < '0' || *arg > '9')
+    {
+        return std::nullopt;
+    }
+    char* end;
+    errno = 0;
+    auto value = std::strtoull(arg, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value < 1 || value > UINT32_MAX)
+    {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(value);
+}
+
+static exitcode_t HandleLoadTestCommand(CommandLineArgEnumerator* argEnumerator, bool isReplay)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 3)
+    {
+        Console::Error::WriteLine("Missing arguments %s <clients> <ticks>.", isReplay ? "<parkrep-file>" : "<park-file>");
+        return EXITCODE_FAIL;
+    }
+
+    const char* inputPath = argv[0];
+    auto numClients = ParseCount(argv[1]);
+    auto ticks = ParseCount(argv[2]);
+    if (!numClients.has_value() || !ticks.has_value())
+    {
+        Console::Error::WriteLine("<clients> and <ticks> must be whole numbers of at least 1.");
+        return EXITCODE_FAIL;
+    }
+    return RunLoadTest(inputPath, isReplay, *numClients, *ticks);
+}
+
+static exitcode_t HandleLoadTest(CommandLineArgEnumerator* argEnumerator)
+{
+    return HandleLoadTestCommand(argEnumerator, false);
+}
+
+static exitcode_t HandleLoadTestReplay(CommandLineArgEnumerator* argEnumerator)
+{
+    return HandleLoadTestCommand(argEnumerator, true);
+}
+
+#endif // DISABLE_NETWORK
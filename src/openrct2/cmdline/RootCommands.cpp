@@ -136,11 +136,15 @@ const CommandLineCommand CommandLine::RootCommands[]
 #endif
 
     // Sub-commands
-    DefineSubCommand("screenshot",      CommandLine::ScreenshotCommands       ),
-    DefineSubCommand("sprite",          CommandLine::SpriteCommands           ),
-    DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
-    DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
-    DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
+    DefineSubCommand("screenshot",        CommandLine::ScreenshotCommands       ),
+    DefineSubCommand("sprite",            CommandLine::SpriteCommands           ),
+    DefineSubCommand("benchgfx",          CommandLine::BenchGfxCommands         ),
+    DefineSubCommand("benchspritesort",   CommandLine::BenchSpriteSortCommands  ),
+    DefineSubCommand("benchsawyercoding", CommandLine::BenchSawyerCodingCommands),
+    DefineSubCommand("simulate",          CommandLine::SimulateCommands         ),
+#ifndef DISABLE_NETWORK
+    DefineSubCommand("loadtest",          CommandLine::LoadTestCommands         ),
+#endif
     CommandTableEnd
 };
 
@@ -12,64 +12,211 @@
 #include "../GameState.h"
 #include "../OpenRCT2.h"
 #include "../core/Console.hpp"
-#include "../network/network.h"
+#include "../core/Json.hpp"
+#include "../core/String.hpp"
 #include "../platform/platform.h"
 #include "../world/Sprite.h"
 #include "CommandLine.hpp"
 
+#include <chrono>
 #include <cstdlib>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace OpenRCT2;
 
+static int32_t _checksumInterval = 0;
+static const char* _jsonPath = nullptr;
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition SimulateOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_checksumInterval, NAC, "checksum-interval", "record the sprite checksum every <ticks> ticks" },
+    { CMDLINE_TYPE_STRING,  &_jsonPath,         NAC, "json",              "write a JSON report to the given path, - for stdout" },
+    OptionTableEnd
+};
+
 static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleSimulateBatch(CommandLineArgEnumerator* argEnumerator);
 
-const CommandLineCommand CommandLine::SimulateCommands[]{ // Main commands
-                                                          DefineCommand("", "<ticks>", nullptr, HandleSimulate), CommandTableEnd
+const CommandLineCommand CommandLine::SimulateCommands[]
+{
+    // Main commands
+    DefineCommand("",      "<sv6-file> <ticks>",                 SimulateOptions, HandleSimulate     ),
+    DefineCommand("batch", "<ticks> <sv6-file> [<sv6-file> ...]", SimulateOptions, HandleSimulateBatch),
+    CommandTableEnd
 };
+// clang-format on
 
-static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
+struct SimulationResult
 {
-    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
-    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    std::string Path;
+    bool Loaded{};
+    uint32_t Ticks{};
+    double Seconds{};
+    std::vector<std::pair<uint32_t, std::string>> Checksums;
+    std::string FinalChecksum;
+};
 
-    if (argc < 2)
+/**
+ * Loads the park and runs the game logic for the given number of ticks. Only the time spent in
+ * GameState::UpdateLogic is measured, not loading the park or calculating the checksums.
+ */
+static SimulationResult SimulatePark(IContext& context, const char* path, uint32_t ticks)
+{
+    SimulationResult result;
+    result.Path = path;
+    result.Loaded = context.LoadParkFromFile(path);
+    if (!result.Loaded)
     {
-        Console::Error::WriteLine("Missing arguments <sv6-file> <ticks>.");
-        return EXITCODE_FAIL;
+        return result;
     }
 
-    core_init();
+    auto gameState = context.GetGameState();
+    std::chrono::duration<double> elapsed{};
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        gameState->UpdateLogic();
+        elapsed += std::chrono::high_resolution_clock::now() - startTime;
 
-    const char* inputPath = argv[0];
-    uint32_t ticks = atol(argv[1]);
+        if (_checksumInterval > 0 && (i + 1) % _checksumInterval == 0)
+        {
+            result.Checksums.emplace_back(i + 1, sprite_checksum().ToString());
+        }
+    }
+    result.Ticks = ticks;
+    result.Seconds = elapsed.count();
+    result.FinalChecksum = sprite_checksum().ToString();
+    return result;
+}
 
-    gOpenRCT2Headless = true;
+static double GetTicksPerSecond(const SimulationResult& result)
+{
+    return result.Seconds > 0 ? result.Ticks / result.Seconds : 0;
+}
+
+static void WriteReport(const std::vector<SimulationResult>& results)
+{
+    json_t* jsonParks = json_array();
+    for (const auto& result : results)
+    {
+        json_t* jsonPark = json_object();
+        json_object_set_new(jsonPark, "path", json_string(result.Path.c_str()));
+        json_object_set_new(jsonPark, "loaded", json_boolean(result.Loaded));
+        if (result.Loaded)
+        {
+            json_object_set_new(jsonPark, "ticks", json_integer(result.Ticks));
+            json_object_set_new(jsonPark, "seconds", json_real(result.Seconds));
+            json_object_set_new(jsonPark, "ticksPerSecond", json_real(GetTicksPerSecond(result)));
+
+            json_t* jsonChecksums = json_array();
+            for (const auto& checksum : result.Checksums)
+            {
+                json_t* jsonChecksum = json_object();
+                json_object_set_new(jsonChecksum, "tick", json_integer(checksum.first));
+                json_object_set_new(jsonChecksum, "checksum", json_string(checksum.second.c_str()));
+                json_array_append_new(jsonChecksums, jsonChecksum);
+            }
+            json_object_set_new(jsonPark, "checksums", jsonChecksums);
+            json_object_set_new(jsonPark, "finalChecksum", json_string(result.FinalChecksum.c_str()));
+        }
+        json_array_append_new(jsonParks, jsonPark);
+    }
+
+    json_t* jsonReport = json_object();
+    json_object_set_new(jsonReport, "parks", jsonParks);
+    if (String::Equals(_jsonPath, "-"))
+    {
+        char* jsonOutput = json_dumps(jsonReport, JSON_INDENT(4));
+        Console::WriteLine("%s", jsonOutput);
+        free(jsonOutput);
+    }
+    else
+    {
+        Json::WriteToFile(_jsonPath, jsonReport, JSON_INDENT(4));
+    }
+    json_decref(jsonReport);
+}
 
-#ifndef DISABLE_NETWORK
-    gNetworkStart = NETWORK_MODE_SERVER;
-#endif
+/**
+ * Runs the parks one after another in a single headless context. Presentation work such as sounds
+ * and windows is skipped by GameState::UpdateLogic when running headless. The parks can not run in
+ * parallel as the map, sprites and rides are process-wide; run several processes for that instead.
+ */
+static exitcode_t RunSimulation(const std::vector<const char*>& parkPaths, uint32_t ticks)
+{
+    core_init();
+
+    gOpenRCT2Headless = true;
 
     std::unique_ptr<IContext> context(CreateContext());
-    if (context->Initialise())
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    std::vector<SimulationResult> results;
+    bool allLoaded = true;
+    for (auto path : parkPaths)
     {
-        if (!context->LoadParkFromFile(inputPath))
+        if (_jsonPath == nullptr)
         {
-            return EXITCODE_FAIL;
+            Console::WriteLine("Running %d ticks of %s...", ticks, path);
         }
+        results.push_back(SimulatePark(*context, path, ticks));
 
-        Console::WriteLine("Running %d ticks...", ticks);
-        for (uint32_t i = 0; i < ticks; i++)
+        const auto& result = results.back();
+        allLoaded &= result.Loaded;
+        if (_jsonPath == nullptr && result.Loaded)
         {
-            context->GetGameState()->UpdateLogic();
+            for (const auto& checksum : result.Checksums)
+            {
+                Console::WriteLine("Tick %u: %s", checksum.first, checksum.second.c_str());
+            }
+            Console::WriteLine("Completed: %s", result.FinalChecksum.c_str());
+            Console::WriteLine("%.0f ticks/s", GetTicksPerSecond(result));
         }
-        Console::WriteLine("Completed: %s", sprite_checksum().ToString().c_str());
     }
-    else
+
+    if (_jsonPath != nullptr)
     {
-        Console::Error::WriteLine("Context initialization failed.");
+        WriteReport(results);
+    }
+    return allLoaded ? EXITCODE_OK : EXITCODE_FAIL;
+}
+
+static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 2)
+    {
+        Console::Error::WriteLine("Missing arguments <sv6-file> <ticks>.");
+        return EXITCODE_FAIL;
+    }
+
+    const char* inputPath = argv[0];
+    uint32_t ticks = atol(argv[1]);
+    return RunSimulation({ inputPath }, ticks);
+}
+
+static exitcode_t HandleSimulateBatch(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 2)
+    {
+        Console::Error::WriteLine("Missing arguments <ticks> <sv6-file>.");
         return EXITCODE_FAIL;
     }
 
-    return EXITCODE_OK;
+    uint32_t ticks = atol(argv[0]);
+    std::vector<const char*> parkPaths(argv + 1, argv + argc);
+    return RunSimulation(parkPaths, ticks);
 }
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "BinaryDelta.h"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace BinaryDelta
+{
+    enum : uint8_t
+    {
+        DELTA_OP_COPY,
+        DELTA_OP_INSERT,
+    };
+
+    // Ranges shorter than a block are never found in the base
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr uint32_t HASH_MULTIPLIER = 0x01000193;
+    static constexpr uint32_t FILTER_BITS = 1 << 20;
+
+    static uint32_t HashBlock(const uint8_t* data)
+    {
+        uint32_t hash = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+        {
+            hash = hash * HASH_MULTIPLIER + data[i];
+        }
+        return hash;
+    }
+
+    static constexpr uint32_t GetOutgoingFactor()
+    {
+        uint32_t factor = 1;
+        for (size_t i = 1; i < BLOCK_SIZE; i++)
+        {
+            factor *= HASH_MULTIPLIER;
+        }
+        return factor;
+    }
+
+    template<typename T> static void WriteValue(std::vector<uint8_t>& delta, T value)
+    {
+        auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        delta.insert(delta.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T> static bool ReadValue(const uint8_t*& data, const uint8_t* end, T& value)
+    {
+        if (static_cast<size_t>(end - data) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    static void WriteInsert(std::vector<uint8_t>& delta, const uint8_t* data, size_t length)
+    {
+        if (length != 0)
+        {
+            delta.push_back(DELTA_OP_INSERT);
+            WriteValue<uint32_t>(delta, static_cast<uint32_t>(length));
+            delta.insert(delta.end(), data, data + length);
+        }
+    }
+
+    static void WriteCopy(std::vector<uint8_t>& delta, size_t offset, size_t length)
+    {
+        delta.push_back(DELTA_OP_COPY);
+        WriteValue<uint32_t>(delta, static_cast<uint32_t>(offset));
+        WriteValue<uint32_t>(delta, static_cast<uint32_t>(length));
+    }
+
+    std::vector<uint8_t> Create(const uint8_t* base, size_t baseLength, const uint8_t* target, size_t targetLength)
+    {
+        std::vector<uint8_t> delta;
+        WriteValue<uint32_t>(delta, static_cast<uint32_t>(targetLength));
+
+        // Index the blocks of the base, the filter saves most of the lookups for blocks of the target that are new
+        std::unordered_map<uint32_t, size_t> blocks;
+        std::vector<bool> filter(FILTER_BITS);
+        blocks.reserve(baseLength / BLOCK_SIZE);
+        for (size_t offset = 0; offset + BLOCK_SIZE <= baseLength; offset += BLOCK_SIZE)
+        {
+            auto hash = HashBlock(base + offset);
+            blocks.emplace(hash, offset);
+            filter[hash % FILTER_BITS] = true;
+        }
+
+        // Slide a window over the target, when it matches a block of the base grow the match in both directions
+        constexpr uint32_t outgoingFactor = GetOutgoingFactor();
+        size_t literalStart = 0;
+        size_t pos = 0;
+        uint32_t hash = targetLength >= BLOCK_SIZE ? HashBlock(target) : 0;
+        while (pos + BLOCK_SIZE <= targetLength)
+        {
+            if (filter[hash % FILTER_BITS])
+            {
+                auto it = blocks.find(hash);
+                if (it != blocks.end() && std::memcmp(base + it->second, target + pos, BLOCK_SIZE) == 0)
+                {
+                    size_t baseStart = it->second;
+                    size_t targetStart = pos;
+                    while (targetStart > literalStart && baseStart > 0 && base[baseStart - 1] == target[targetStart - 1])
+                    {
+                        baseStart--;
+                        targetStart--;
+                    }
+                    size_t length = pos - targetStart + BLOCK_SIZE;
+                    while (baseStart + length < baseLength && targetStart + length < targetLength
+                           && base[baseStart + length] == target[targetStart + length])
+                    {
+                        length++;
+                    }
+
+                    WriteInsert(delta, target + literalStart, targetStart - literalStart);
+                    WriteCopy(delta, baseStart, length);
+                    pos = targetStart + length;
+                    literalStart = pos;
+                    if (pos + BLOCK_SIZE <= targetLength)
+                    {
+                        hash = HashBlock(target + pos);
+                    }
+                    continue;
+                }
+            }
+
+            if (pos + BLOCK_SIZE < targetLength)
+            {
+                hash = (hash - target[pos] * outgoingFactor) * HASH_MULTIPLIER + target[pos + BLOCK_SIZE];
+            }
+            pos++;
+        }
+        WriteInsert(delta, target + literalStart, targetLength - literalStart);
+        return delta;
+    }
+
+    std::optional<std::vector<uint8_t>> Apply(
+        const uint8_t* base, size_t baseLength, const uint8_t* delta, size_t deltaLength, size_t maxTargetLength)
+    {
+        const uint8_t* data = delta;
+        const uint8_t* end = delta + deltaLength;
+        uint32_t targetLength;
+        if (!ReadValue(data, end, targetLength) || targetLength > maxTargetLength)
+        {
+            return std::nullopt;
+        }
+
+        std::vector<uint8_t> target;
+        target.reserve(targetLength);
+        while (data < end)
+        {
+            uint8_t op = *data++;
+            if (op == DELTA_OP_COPY)
+            {
+                uint32_t offset, length;
+                if (!ReadValue(data, end, offset) || !ReadValue(data, end, length) || offset > baseLength
+                    || length > baseLength - offset || length > targetLength - target.size())
+                {
+                    return std::nullopt;
+                }
+                target.insert(target.end(), base + offset, base + offset + length);
+            }
+            else if (op == DELTA_OP_INSERT)
+            {
+                uint32_t length;
+                if (!ReadValue(data, end, length) || length > static_cast<size_t>(end - data)
+                    || length > targetLength - target.size())
+                {
+                    return std::nullopt;
+                }
+                target.insert(target.end(), data, data + length);
+                data += length;
+            }
+            else
+            {
+                return std::nullopt;
+            }
+        }
+
+        if (target.size() != targetLength)
+        {
+            return std::nullopt;
+        }
+        return target;
+    }
+} // namespace BinaryDelta
@@ -0,0 +1,32 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <optional>
+#include <vector>
+
+/**
+ * Binary deltas between two buffers. A delta is a list of operations that either copy a range of the base buffer or
+ * insert new bytes, ranges of the target that moved around in the base are still found. The deltas are not compressed,
+ * the inserted bytes are left as they are so the caller can compress the whole delta.
+ */
+namespace BinaryDelta
+{
+    std::vector<uint8_t> Create(const uint8_t* base, size_t baseLength, const uint8_t* target, size_t targetLength);
+
+    /**
+     * Rebuilds the target from the base and a delta created against it. Returns nothing if the delta is malformed,
+     * reaches outside of the base or describes a target longer than maxTargetLength.
+     */
+    std::optional<std::vector<uint8_t>> Apply(
+        const uint8_t* base, size_t baseLength, const uint8_t* delta, size_t deltaLength, size_t maxTargetLength);
+} // namespace BinaryDelta
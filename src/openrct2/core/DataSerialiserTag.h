@@ -40,3 +40,32 @@ template<typename T> inline DataSerialiserTag<T> CreateDataSerialiserTag(const c
 }
 
 #define DS_TAG(var) CreateDataSerialiserTag(#var, var)
+
+/**
+ * Serialises the memory of a trivially copyable value, or of the elements of a vector of them, as is. Nothing is byte
+ * swapped and the layout is that of the structures in this build, so this is only meant for data read back by the same
+ * process, e.g. GameStateImage, or by builds that agree on the layout, e.g. the chunks of versioned park files.
+ */
+template<typename T> class DataSerialiserRaw
+{
+public:
+    explicit DataSerialiserRaw(T& data)
+        : _data(data)
+    {
+    }
+
+    T& Data() const
+    {
+        return _data;
+    }
+
+private:
+    T& _data;
+};
+
+template<typename T> inline DataSerialiserRaw<T> CreateDataSerialiserRaw(T& data)
+{
+    return DataSerialiserRaw<T>(data);
+}
+
+#define DS_RAW(var) CreateDataSerialiserRaw(var)
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 
 template<typename T> struct DataSerializerTraits
 {
@@ -706,3 +707,54 @@ template<> struct DataSerializerTraits<rct_vehicle_colour>
         stream->Write(msg, strlen(msg));
     }
 };
+
+template<typename T> struct DataSerializerTraits<DataSerialiserRaw<T>>
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be serialised as raw memory");
+
+    static void encode(OpenRCT2::IStream* stream, const DataSerialiserRaw<T>& raw)
+    {
+        stream->Write(&raw.Data(), sizeof(T));
+    }
+    static void decode(OpenRCT2::IStream* stream, DataSerialiserRaw<T>& raw)
+    {
+        stream->Read(&raw.Data(), sizeof(T));
+    }
+    static void log(OpenRCT2::IStream* stream, const DataSerialiserRaw<T>& raw)
+    {
+        char msg[64] = {};
+        snprintf(msg, sizeof(msg), "raw(%u bytes)", static_cast<uint32_t>(sizeof(T)));
+        stream->Write(msg, strlen(msg));
+    }
+};
+
+template<typename _Ty> struct DataSerializerTraits<DataSerialiserRaw<std::vector<_Ty>>>
+{
+    static_assert(std::is_trivially_copyable_v<_Ty>, "Only trivially copyable values can be serialised as raw memory");
+
+    static void encode(OpenRCT2::IStream* stream, const DataSerialiserRaw<std::vector<_Ty>>& raw)
+    {
+        const auto& val = raw.Data();
+        uint32_t len = static_cast<uint32_t>(val.size());
+        stream->Write(&len);
+        stream->Write(val.data(), len * sizeof(_Ty));
+    }
+    static void decode(OpenRCT2::IStream* stream, DataSerialiserRaw<std::vector<_Ty>>& raw)
+    {
+        auto& val = raw.Data();
+        uint32_t len;
+        stream->Read(&len);
+        if (len > (stream->GetLength() - stream->GetPosition()) / sizeof(_Ty))
+        {
+            throw std::runtime_error("Invalid size, can't decode");
+        }
+        val.resize(len);
+        stream->Read(val.data(), len * sizeof(_Ty));
+    }
+    static void log(OpenRCT2::IStream* stream, const DataSerialiserRaw<std::vector<_Ty>>& raw)
+    {
+        char msg[64] = {};
+        snprintf(msg, sizeof(msg), "raw(%u elements)", static_cast<uint32_t>(raw.Data().size()));
+        stream->Write(msg, strlen(msg));
+    }
+};
@@ -14,8 +14,8 @@
 #include "File.h"
 #include "FileScanner.h"
 #include "FileStream.hpp"
-#include "JobPool.hpp"
 #include "Path.hpp"
+#include "TaskScheduler.h"
 
 #include <chrono>
 #include <list>
@@ -25,7 +25,7 @@
 
 template<typename TItem> class FileIndex
 {
-private:
+public:
     struct DirectoryStats
     {
         uint32_t TotalFiles = 0;
@@ -46,6 +46,7 @@ private:
         }
     };
 
+private:
     struct FileIndexHeader
     {
         uint32_t HeaderSize = sizeof(FileIndexHeader);
@@ -122,24 +123,9 @@ public:
         return items;
     }
 
-protected:
-    /**
-     * Loads the given file and creates the item representing the data to store in the index.
-     * TODO Use std::optional when C++17 is available.
-     */
-    virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
-
-    /**
-     * Serialises an index item to the given stream.
-     */
-    virtual void Serialise(OpenRCT2::IStream* stream, const TItem& item) const abstract;
-
     /**
-     * Deserialises an index item from the given stream.
+     * Queries the directories for the files to index and the statistics an index file is checked against.
      */
-    virtual TItem Deserialise(OpenRCT2::IStream* stream) const abstract;
-
-private:
     ScanResult Scan() const
     {
         DirectoryStats stats{};
@@ -170,32 +156,11 @@ private:
         return ScanResult(stats, files);
     }
 
-    void BuildRange(
-        int32_t language, const ScanResult& scanResult, size_t rangeStart, size_t rangeEnd, std::vector<TItem>& items,
-        std::atomic<size_t>& processed, std::mutex& printLock) const
-    {
-        items.reserve(rangeEnd - rangeStart);
-        for (size_t i = rangeStart; i < rangeEnd; i++)
-        {
-            const auto& filePath = scanResult.Files.at(i);
-
-            if (_log_levels[static_cast<uint8_t>(DiagnosticLevel::Verbose)])
-            {
-                std::lock_guard<std::mutex> lock(printLock);
-                log_verbose("FileIndex:Indexing '%s'", filePath.c_str());
-            }
-
-            auto item = Create(language, filePath);
-            if (std::get<0>(item))
-            {
-                items.push_back(std::get<1>(item));
-            }
-
-            processed++;
-        }
-    }
-
-    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult) const
+    /**
+     * Creates the items for the scanned files without writing the index file, for indexes that store the items in a
+     * format of their own.
+     */
+    std::vector<TItem> BuildItems(int32_t language, const ScanResult& scanResult) const
     {
         std::vector<TItem> allItems;
         Console::WriteLine("Building %s (%zu items)", _name.c_str(), scanResult.Files.size());
@@ -205,7 +170,7 @@ private:
         const size_t totalCount = scanResult.Files.size();
         if (totalCount > 0)
         {
-            JobPool jobPool;
+            OpenRCT2::TaskGroup jobs;
             std::mutex printLock; // For verbose prints.
 
             std::list<std::vector<TItem>> containers;
@@ -228,14 +193,14 @@ private:
 
                 auto& items = containers.emplace_back();
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                jobs.Run([&, rangeStart, rangeEnd = rangeStart + stepSize]() {
+                    BuildRange(language, scanResult, rangeStart, rangeEnd, items, processed, printLock);
+                });
 
                 reportProgress();
             }
 
-            jobPool.Join(reportProgress);
+            jobs.Wait(reportProgress);
 
             for (auto&& itr : containers)
             {
@@ -243,8 +208,6 @@ private:
             }
         }
 
-        WriteIndexFile(language, scanResult.Stats, allItems);
-
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration<float>(endTime - startTime);
         Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
@@ -252,6 +215,56 @@ private:
         return allItems;
     }
 
+protected:
+    /**
+     * Loads the given file and creates the item representing the data to store in the index.
+     * TODO Use std::optional when C++17 is available.
+     */
+    virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
+
+    /**
+     * Serialises an index item to the given stream.
+     */
+    virtual void Serialise(OpenRCT2::IStream* stream, const TItem& item) const abstract;
+
+    /**
+     * Deserialises an index item from the given stream.
+     */
+    virtual TItem Deserialise(OpenRCT2::IStream* stream) const abstract;
+
+private:
+    void BuildRange(
+        int32_t language, const ScanResult& scanResult, size_t rangeStart, size_t rangeEnd, std::vector<TItem>& items,
+        std::atomic<size_t>& processed, std::mutex& printLock) const
+    {
+        items.reserve(rangeEnd - rangeStart);
+        for (size_t i = rangeStart; i < rangeEnd; i++)
+        {
+            const auto& filePath = scanResult.Files.at(i);
+
+            if (_log_levels[static_cast<uint8_t>(DiagnosticLevel::Verbose)])
+            {
+                std::lock_guard<std::mutex> lock(printLock);
+                log_verbose("FileIndex:Indexing '%s'", filePath.c_str());
+            }
+
+            auto item = Create(language, filePath);
+            if (std::get<0>(item))
+            {
+                items.push_back(std::get<1>(item));
+            }
+
+            processed++;
+        }
+    }
+
+    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult) const
+    {
+        auto items = BuildItems(language, scanResult);
+        WriteIndexFile(language, scanResult.Stats, items);
+        return items;
+    }
+
     std::tuple<bool, std::vector<TItem>> ReadIndexFile(int32_t language, const DirectoryStats& stats) const
     {
         bool loadedItems = false;
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include "IStream.hpp"
+#include "MemoryMappedFile.h"
+#include "String.hpp"
+
+#ifdef _WIN32
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path)
+{
+    auto pathW = String::ToWideChar(path);
+    auto hFile = CreateFileW(
+        pathW.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        throw IOException("Unable to open " + path);
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(hFile, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(hFile);
+        throw IOException("Unable to get the size of " + path);
+    }
+
+    // Files without content can not be mapped
+    _length = static_cast<size_t>(fileSize.QuadPart);
+    if (_length > 0)
+    {
+        // The view keeps the mapping and the file open on its own
+        auto hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (hMapping != nullptr)
+        {
+            _data = static_cast<const uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(hMapping);
+        }
+        if (_data == nullptr)
+        {
+            CloseHandle(hFile);
+            throw IOException("Unable to map " + path);
+        }
+    }
+    CloseHandle(hFile);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw IOException("Unable to open " + path);
+    }
+
+    struct stat statInfo
+    {
+    };
+    if (fstat(fd, &statInfo) != 0 || static_cast<uint64_t>(statInfo.st_size) > SIZE_MAX)
+    {
+        close(fd);
+        throw IOException("Unable to get the size of " + path);
+    }
+
+    // Files without content can not be mapped
+    _length = static_cast<size_t>(statInfo.st_size);
+    if (_length > 0)
+    {
+        // The mapping keeps the file open on its own
+        void* data = mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            throw IOException("Unable to map " + path);
+        }
+        _data = static_cast<const uint8_t*>(data);
+    }
+    close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (_data != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(_data), _length);
+    }
+}
+
+#endif
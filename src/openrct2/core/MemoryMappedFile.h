@@ -0,0 +1,45 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <string>
+
+/**
+ * A file mapped into memory for reading. Its pages are only read from the disk once they are accessed, so reading a
+ * few parts of a large file costs no more than those parts.
+ */
+class MemoryMappedFile final
+{
+private:
+    const uint8_t* _data = nullptr;
+    size_t _length = 0;
+
+public:
+    /**
+     * Maps the whole file, throws an IOException if it can not be opened or mapped.
+     */
+    explicit MemoryMappedFile(const std::string& path);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    const uint8_t* GetData() const
+    {
+        return _data;
+    }
+
+    size_t GetLength() const
+    {
+        return _length;
+    }
+};
@@ -69,8 +69,18 @@ namespace OpenRCT2
 
     MemoryStream& MemoryStream::operator=(MemoryStream&& mv) noexcept
     {
+        if (this == &mv)
+        {
+            return *this;
+        }
+        if (_access & MEMORY_ACCESS::OWNER)
+        {
+            Memory::Free(_data);
+        }
+
         _access = mv._access;
         _dataCapacity = mv._dataCapacity;
+        _dataSize = mv._dataSize;
         _data = mv._data;
         _position = mv._position;
 
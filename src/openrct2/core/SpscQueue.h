@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+/**
+ * Unbounded lock-free queue for handing items from one thread to another. Push may only be called from one thread and
+ * TryPop from one other thread.
+ */
+template<typename T> class SpscQueue
+{
+private:
+    struct Node
+    {
+        T Value{};
+        std::atomic<Node*> Next{ nullptr };
+    };
+
+    // _head is a node whose value was taken already, the items start at the node after it
+    Node* _head;
+    Node* _tail;
+
+public:
+    SpscQueue()
+        : _head(new Node())
+        , _tail(_head)
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue()
+    {
+        while (_head != nullptr)
+        {
+            auto next = _head->Next.load(std::memory_order_relaxed);
+            delete _head;
+            _head = next;
+        }
+    }
+
+    void Push(T&& value)
+    {
+        auto node = new Node();
+        node->Value = std::move(value);
+        _tail->Next.store(node, std::memory_order_release);
+        _tail = node;
+    }
+
+    bool TryPop(T& value)
+    {
+        auto next = _head->Next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+        value = std::move(next->Value);
+        delete _head;
+        _head = next;
+        return true;
+    }
+};
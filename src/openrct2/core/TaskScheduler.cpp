@@ -0,0 +1,348 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TaskScheduler.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace OpenRCT2;
+
+static constexpr size_t WORKER_SPIN_COUNT = 64;
+static constexpr size_t NOT_A_WORKER = SIZE_MAX;
+
+// Index of the worker owned by the current thread, NOT_A_WORKER for every other thread.
+static thread_local size_t _currentWorkerIndex = NOT_A_WORKER;
+static thread_local const TaskScheduler* _currentWorkerScheduler = nullptr;
+
+struct alignas(64) TaskScheduler::Worker
+{
+    std::thread Thread;
+    std::mutex Mutex;
+
+    // Ring buffer of tasks, grown on demand so that steady state queueing does not allocate.
+    std::vector<Task> Ring;
+    size_t Head = 0;
+    size_t Count = 0;
+
+    std::atomic<uint64_t> Executed{ 0 };
+    std::atomic<uint64_t> Stolen{ 0 };
+    std::atomic<uint64_t> Submitted{ 0 };
+    std::atomic<uint64_t> Sleeps{ 0 };
+
+    void PushBack(Task&& task)
+    {
+        if (Count == Ring.size())
+        {
+            std::vector<Task> grown(std::max<size_t>(64, Ring.size() * 2));
+            for (size_t i = 0; i < Count; i++)
+            {
+                grown[i] = std::move(Ring[(Head + i) % Ring.size()]);
+            }
+            Ring = std::move(grown);
+            Head = 0;
+        }
+        Ring[(Head + Count) % Ring.size()] = std::move(task);
+        Count++;
+    }
+
+    bool PopBack(Task& outTask)
+    {
+        if (Count == 0)
+            return false;
+        Count--;
+        outTask = std::move(Ring[(Head + Count) % Ring.size()]);
+        return true;
+    }
+
+    bool PopFront(Task& outTask)
+    {
+        if (Count == 0)
+            return false;
+        outTask = std::move(Ring[Head]);
+        Head = (Head + 1) % Ring.size();
+        Count--;
+        return true;
+    }
+};
+
+TaskScheduler& TaskScheduler::Get()
+{
+    // The calling thread always takes part in the work, so leave one core for it.
+    static TaskScheduler instance(std::max<size_t>(1, std::thread::hardware_concurrency()) - 1);
+    return instance;
+}
+
+TaskScheduler::TaskScheduler(size_t workerCount)
+    : _external(std::make_unique<Worker>())
+{
+    _workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        _workers[i]->Thread = std::thread(&TaskScheduler::WorkerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _shouldStop = true;
+    }
+    _sleepCond.notify_all();
+    for (auto& worker : _workers)
+    {
+        if (worker->Thread.joinable())
+        {
+            worker->Thread.join();
+        }
+    }
+}
+
+std::vector<TaskSchedulerStats> TaskScheduler::GetStats() const
+{
+    std::vector<TaskSchedulerStats> result;
+    result.reserve(_workers.size() + 1);
+    auto append = [&result](const Worker& worker) {
+        auto& stats = result.emplace_back();
+        stats.Executed = worker.Executed.load(std::memory_order_relaxed);
+        stats.Stolen = worker.Stolen.load(std::memory_order_relaxed);
+        stats.Submitted = worker.Submitted.load(std::memory_order_relaxed);
+        stats.Sleeps = worker.Sleeps.load(std::memory_order_relaxed);
+    };
+    for (const auto& worker : _workers)
+    {
+        append(*worker);
+    }
+    append(*_external);
+    return result;
+}
+
+void TaskScheduler::ResetStats()
+{
+    auto reset = [](Worker& worker) {
+        worker.Executed = 0;
+        worker.Stolen = 0;
+        worker.Submitted = 0;
+        worker.Sleeps = 0;
+    };
+    for (auto& worker : _workers)
+    {
+        reset(*worker);
+    }
+    reset(*_external);
+}
+
+void TaskScheduler::Submit(TaskFunction&& fn, TaskGroup* group)
+{
+    Task task{ std::move(fn), group };
+    if (_workers.empty())
+    {
+        // No workers, run synchronously.
+        ExecuteTask(task, *_external);
+        return;
+    }
+
+    Worker* target;
+    if (_currentWorkerScheduler == this && _currentWorkerIndex != NOT_A_WORKER)
+    {
+        target = _workers[_currentWorkerIndex].get();
+    }
+    else
+    {
+        target = _workers[_nextQueue.fetch_add(1, std::memory_order_relaxed) % _workers.size()].get();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(target->Mutex);
+        target->PushBack(std::move(task));
+    }
+    target->Submitted.fetch_add(1, std::memory_order_relaxed);
+
+    _queued.fetch_add(1);
+    if (_sleeping.load() != 0)
+    {
+        // Taking the lock guarantees the sleeper is either waiting or will see the new task.
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _sleepCond.notify_one();
+    }
+}
+
+bool TaskScheduler::RunPendingTask()
+{
+    if (_queued.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+
+    Task task;
+    if (_currentWorkerScheduler == this && _currentWorkerIndex != NOT_A_WORKER)
+    {
+        auto& self = *_workers[_currentWorkerIndex];
+        if (TryPopTask(self, task))
+        {
+            ExecuteTask(task, self);
+            return true;
+        }
+        return false;
+    }
+
+    if (TrySteal(_nextQueue.load(std::memory_order_relaxed), task))
+    {
+        ExecuteTask(task, *_external);
+        return true;
+    }
+    return false;
+}
+
+bool TaskScheduler::TryPopTask(Worker& self, Task& outTask)
+{
+    {
+        std::lock_guard<std::mutex> lock(self.Mutex);
+        if (self.PopBack(outTask))
+        {
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    if (TrySteal(_currentWorkerIndex + 1, outTask))
+    {
+        self.Stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool TaskScheduler::TrySteal(size_t startIndex, Task& outTask)
+{
+    const size_t count = _workers.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        auto& victim = *_workers[(startIndex + i) % count];
+        std::unique_lock<std::mutex> lock(victim.Mutex, std::try_to_lock);
+        if (lock.owns_lock() && victim.PopFront(outTask))
+        {
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::ExecuteTask(Task& task, Worker& stats)
+{
+    std::exception_ptr error;
+    try
+    {
+        task.Fn();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    task.Fn.Reset();
+    stats.Executed.fetch_add(1, std::memory_order_relaxed);
+    if (task.Group != nullptr)
+    {
+        task.Group->OnTaskFinished(error);
+    }
+}
+
+void TaskScheduler::WorkerLoop(size_t index)
+{
+    _currentWorkerIndex = index;
+    _currentWorkerScheduler = this;
+
+    auto& self = *_workers[index];
+    size_t spins = 0;
+    Task task;
+    while (!_shouldStop)
+    {
+        if (TryPopTask(self, task))
+        {
+            ExecuteTask(task, self);
+            spins = 0;
+            continue;
+        }
+
+        if (spins++ < WORKER_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleeping++;
+        if (_queued.load() == 0 && !_shouldStop)
+        {
+            self.Sleeps.fetch_add(1, std::memory_order_relaxed);
+            _sleepCond.wait(lock, [this]() { return _shouldStop || _queued.load() != 0; });
+        }
+        _sleeping--;
+        spins = 0;
+    }
+}
+
+void TaskGroup::Wait(const std::function<void()>& reportFn)
+{
+    using namespace std::chrono_literals;
+
+    auto lastReport = std::chrono::steady_clock::now();
+    while (_pending.load(std::memory_order_acquire) != 0)
+    {
+        if (!_scheduler.RunPendingTask())
+        {
+            // The remaining tasks are being executed by other threads.
+            std::this_thread::yield();
+        }
+
+        if (reportFn != nullptr)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastReport >= 50ms)
+            {
+                reportFn();
+                lastReport = now;
+            }
+        }
+    }
+
+    if (reportFn != nullptr)
+    {
+        reportFn();
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        std::swap(error, _error);
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::OnTaskFinished(std::exception_ptr error)
+{
+    if (error)
+    {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (!_error)
+        {
+            _error = error;
+        }
+    }
+    _pending.fetch_sub(1, std::memory_order_acq_rel);
+}
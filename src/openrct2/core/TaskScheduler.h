@@ -0,0 +1,334 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace OpenRCT2
+{
+    /**
+     * Move-only callable with inline storage for small closures so that queueing a task
+     * does not allocate. Closures larger than the inline buffer fall back to the heap.
+     */
+    class TaskFunction
+    {
+    public:
+        static constexpr size_t InlineSize = 64;
+
+    private:
+        using InvokeFn = void (*)(void* storage);
+        using MoveFn = void (*)(void* dst, void* src);
+        using DestroyFn = void (*)(void* storage);
+
+        struct Ops
+        {
+            InvokeFn Invoke;
+            MoveFn Move;
+            DestroyFn Destroy;
+        };
+
+        template<typename TFunc> struct InlineOps
+        {
+            static void Invoke(void* storage)
+            {
+                (*static_cast<TFunc*>(storage))();
+            }
+            static void Move(void* dst, void* src)
+            {
+                new (dst) TFunc(std::move(*static_cast<TFunc*>(src)));
+                static_cast<TFunc*>(src)->~TFunc();
+            }
+            static void Destroy(void* storage)
+            {
+                static_cast<TFunc*>(storage)->~TFunc();
+            }
+            static constexpr Ops Table = { Invoke, Move, Destroy };
+        };
+
+        template<typename TFunc> struct HeapOps
+        {
+            static void Invoke(void* storage)
+            {
+                (**static_cast<TFunc**>(storage))();
+            }
+            static void Move(void* dst, void* src)
+            {
+                *static_cast<TFunc**>(dst) = *static_cast<TFunc**>(src);
+                *static_cast<TFunc**>(src) = nullptr;
+            }
+            static void Destroy(void* storage)
+            {
+                delete *static_cast<TFunc**>(storage);
+            }
+            static constexpr Ops Table = { Invoke, Move, Destroy };
+        };
+
+        alignas(std::max_align_t) unsigned char _storage[InlineSize];
+        const Ops* _ops = nullptr;
+
+    public:
+        TaskFunction() = default;
+
+        template<
+            typename TFunc, typename TDecayed = std::decay_t<TFunc>,
+            typename = std::enable_if_t<!std::is_same_v<TDecayed, TaskFunction>>>
+        TaskFunction(TFunc&& fn)
+        {
+            if constexpr (
+                sizeof(TDecayed) <= InlineSize && alignof(TDecayed) <= alignof(std::max_align_t)
+                && std::is_nothrow_move_constructible_v<TDecayed>)
+            {
+                new (_storage) TDecayed(std::forward<TFunc>(fn));
+                _ops = &InlineOps<TDecayed>::Table;
+            }
+            else
+            {
+                *reinterpret_cast<TDecayed**>(_storage) = new TDecayed(std::forward<TFunc>(fn));
+                _ops = &HeapOps<TDecayed>::Table;
+            }
+        }
+
+        TaskFunction(TaskFunction&& other) noexcept
+        {
+            if (other._ops != nullptr)
+            {
+                other._ops->Move(_storage, other._storage);
+                _ops = other._ops;
+                other._ops = nullptr;
+            }
+        }
+
+        TaskFunction& operator=(TaskFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                if (other._ops != nullptr)
+                {
+                    other._ops->Move(_storage, other._storage);
+                    _ops = other._ops;
+                    other._ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        TaskFunction(const TaskFunction&) = delete;
+        TaskFunction& operator=(const TaskFunction&) = delete;
+
+        ~TaskFunction()
+        {
+            Reset();
+        }
+
+        explicit operator bool() const
+        {
+            return _ops != nullptr;
+        }
+
+        void operator()()
+        {
+            _ops->Invoke(_storage);
+        }
+
+        void Reset()
+        {
+            if (_ops != nullptr)
+            {
+                _ops->Destroy(_storage);
+                _ops = nullptr;
+            }
+        }
+    };
+
+    class TaskGroup;
+
+    struct TaskSchedulerStats
+    {
+        uint64_t Executed{};
+        uint64_t Stolen{};
+        uint64_t Submitted{};
+        uint64_t Sleeps{};
+    };
+
+    /**
+     * Process-wide work-stealing scheduler. Every worker owns a deque: it pushes and pops
+     * its own work from the back and steals from the front of the other workers' deques
+     * when it runs dry. Threads that are not workers distribute submitted tasks across the
+     * worker deques and help execute pending tasks while they wait on a TaskGroup.
+     */
+    class TaskScheduler
+    {
+    private:
+        struct Task
+        {
+            TaskFunction Fn;
+            TaskGroup* Group{};
+        };
+
+        struct Worker;
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::unique_ptr<Worker> _external;
+        std::atomic<size_t> _queued{ 0 };
+        std::atomic<size_t> _sleeping{ 0 };
+        std::atomic<size_t> _nextQueue{ 0 };
+        std::atomic_bool _shouldStop{ false };
+        std::mutex _sleepMutex;
+        std::condition_variable _sleepCond;
+
+    public:
+        /**
+         * Returns the shared scheduler, starting the worker threads on first use.
+         */
+        static TaskScheduler& Get();
+
+        explicit TaskScheduler(size_t workerCount);
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        size_t GetWorkerCount() const
+        {
+            return _workers.size();
+        }
+
+        /**
+         * Returns the statistics of each worker. The last entry accumulates the tasks that
+         * were executed by non-worker threads while waiting on a TaskGroup.
+         */
+        std::vector<TaskSchedulerStats> GetStats() const;
+        void ResetStats();
+
+        void Submit(TaskFunction&& fn, TaskGroup* group);
+
+        /**
+         * Executes a single pending task on the calling thread.
+         * @returns true if a task was executed, false if there was nothing to do.
+         */
+        bool RunPendingTask();
+
+        /**
+         * Invokes func(i) for every i in [0, count). The range is split into chunks of at
+         * least grainSize items, and the calling thread takes part in the work.
+         */
+        template<typename TFunc> void ParallelFor(size_t count, TFunc&& func, size_t grainSize = 1);
+
+    private:
+        bool TryPopTask(Worker& self, Task& outTask);
+        bool TrySteal(size_t startIndex, Task& outTask);
+        void ExecuteTask(Task& task, Worker& stats);
+        void WorkerLoop(size_t index);
+    };
+
+    /**
+     * Fork/join handle: tasks are forked with Run and joined with Wait. The first
+     * exception thrown by a task is rethrown from Wait.
+     */
+    class TaskGroup
+    {
+        friend class TaskScheduler;
+
+    private:
+        TaskScheduler& _scheduler;
+        std::atomic<size_t> _pending{ 0 };
+        std::mutex _errorMutex;
+        std::exception_ptr _error;
+
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::Get())
+            : _scheduler(scheduler)
+        {
+        }
+
+        ~TaskGroup()
+        {
+            // Tasks reference the group, it must never go out of scope with work in flight.
+            while (_pending.load(std::memory_order_acquire) != 0)
+            {
+                _scheduler.RunPendingTask();
+            }
+        }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template<typename TFunc> void Run(TFunc&& fn)
+        {
+            _pending.fetch_add(1, std::memory_order_relaxed);
+            _scheduler.Submit(TaskFunction(std::forward<TFunc>(fn)), this);
+        }
+
+        bool IsDone() const
+        {
+            return _pending.load(std::memory_order_acquire) == 0;
+        }
+
+        /**
+         * Blocks until every task of the group has finished, executing pending tasks on
+         * the calling thread in the meantime.
+         * @param reportFn optional callback invoked periodically while waiting.
+         */
+        void Wait(const std::function<void()>& reportFn = nullptr);
+
+    private:
+        void OnTaskFinished(std::exception_ptr error);
+    };
+
+    template<typename TFunc> void TaskScheduler::ParallelFor(size_t count, TFunc&& func, size_t grainSize)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Over-split a little so that stealing can balance uneven items.
+        const size_t maxChunks = (GetWorkerCount() + 1) * 4;
+        const size_t chunkSize = std::max<size_t>(std::max<size_t>(grainSize, 1), (count + maxChunks - 1) / maxChunks);
+        if (chunkSize >= count || GetWorkerCount() == 0)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                func(i);
+            }
+            return;
+        }
+
+        TaskGroup group(*this);
+        for (size_t begin = chunkSize; begin < count; begin += chunkSize)
+        {
+            const size_t end = std::min(count, begin + chunkSize);
+            group.Run([&func, begin, end]() {
+                for (size_t i = begin; i < end; i++)
+                {
+                    func(i);
+                }
+            });
+        }
+        for (size_t i = 0; i < chunkSize; i++)
+        {
+            func(i);
+        }
+        group.Wait();
+    }
+} // namespace OpenRCT2
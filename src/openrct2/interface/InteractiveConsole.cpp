@@ -39,6 +39,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
+#include "../paint/Paint.h"
 #include "../peep/Staff.h"
 #include "../platform/platform.h"
 #include "../ride/Ride.h"
@@ -692,6 +693,12 @@ static int32_t cc_get(InteractiveConsole& console, const arguments_t& argv)
         {
             console.WriteFormatLine("current_rotation %d", get_current_rotation());
         }
+        else if (argv[0] == "paint_arrange_method")
+        {
+            console.WriteFormatLine(
+                "paint_arrange_method %d  (%s)", static_cast<int32_t>(gPaintArrangeMethod),
+                gPaintArrangeMethod == PaintArrangeMethod::Indexed ? "indexed" : "legacy");
+        }
 #ifndef NO_TTF
         else if (argv[0] == "enable_hinting")
         {
@@ -1008,6 +1015,18 @@ static int32_t cc_set(InteractiveConsole& console, const arguments_t& argv)
             }
             console.Execute("get current_rotation");
         }
+        else if (argv[0] == "paint_arrange_method" && invalidArguments(&invalidArgs, int_valid[0]))
+        {
+            if (int_val[0] < 0 || int_val[0] > 1)
+            {
+                console.WriteLineError("Invalid argument. Valid methods are 0 (legacy) and 1 (indexed).");
+            }
+            else
+            {
+                gPaintArrangeMethod = static_cast<PaintArrangeMethod>(int_val[0]);
+            }
+            console.Execute("get paint_arrange_method");
+        }
 #ifndef NO_TTF
         else if (argv[0] == "enable_hinting" && invalidArguments(&invalidArgs, int_valid[0]))
         {
@@ -1217,7 +1236,7 @@ static int32_t cc_remove_park_fences(InteractiveConsole& console, [[maybe_unused
 static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     map_reorganise_elements();
-    int32_t tileElementCount = gNextFreeTileElement - gTileElements - 1;
+    int32_t tileElementCount = gNextFreeTileElement - gTileElements.data() - 1;
 
     int32_t rideCount = ride_get_count();
     int32_t spriteCount = 0;
@@ -1568,7 +1587,7 @@ static int32_t cc_mp_desync(InteractiveConsole& console, const arguments_t& argv
 
     std::vector<Peep*> peeps;
 
-    for (int i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < GetEntityCapacity(); i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite == nullptr || sprite->sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -1728,6 +1747,7 @@ static constexpr const utf8* console_variable_table[] = {
     "cheat_disable_clearance_checks",
     "cheat_disable_support_limits",
     "current_rotation",
+    "paint_arrange_method",
 };
 static constexpr const utf8* console_window_table[] = {
     "object_selection",
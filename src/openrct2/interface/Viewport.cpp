@@ -15,7 +15,7 @@
 #include "../OpenRCT2.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
-#include "../core/JobPool.hpp"
+#include "../core/TaskScheduler.h"
 #include "../drawing/Drawing.h"
 #include "../paint/Paint.h"
 #include "../peep/Staff.h"
@@ -43,8 +43,6 @@ uint8_t gShowConstuctionRightsRefCount;
 rct_viewport g_viewport_list[MAX_VIEWPORT_COUNT];
 rct_viewport* g_music_tracking_viewport;
 
-static std::unique_ptr<JobPool> _paintJobs;
-
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
 uint8_t gSavedViewRotation;
@@ -790,7 +788,7 @@ void viewport_update_smart_vehicle_follow(rct_window* window)
  */
 void viewport_render(
     rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom,
-    std::vector<paint_session>* sessions)
+    std::vector<RecordedPaintSession>* sessions)
 {
     if (right <= viewport->pos.x)
         return;
@@ -831,30 +829,56 @@ void viewport_render(
 #endif
 }
 
-static void record_session(const paint_session* session, std::vector<paint_session>* recorded_sessions, size_t record_index)
+static void record_session(
+    const paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
     // Perform a deep copy of the paint session, use relative offsets.
     // This is done to extract the session for benchmark.
     // Place the copied session at provided record_index, so the caller can decide which columns/paint sessions to copy; there
     // is no column information embedded in the session itself.
-    (*recorded_sessions)[record_index] = (*session);
-    paint_session* session_copy = &recorded_sessions->at(record_index);
-
-    // Mind the offset needs to be calculated against the original `session`, not `session_copy`
-    for (auto& ps : session_copy->PaintStructs)
+    auto& recorded = (*recorded_sessions)[record_index];
+    recorded.Session = *session;
+    recorded.Session.PaintEntryChunks = nullptr;
+    recorded.Session.CurrentPaintEntryChunk = nullptr;
+    recorded.Session.NextFreePaintStruct = nullptr;
+    recorded.Session.EndOfPaintStructArray = nullptr;
+
+    // Flatten the chunks, remembering where each one starts in the flat array.
+    std::vector<std::pair<const PaintEntryChunk*, size_t>> chunkOffsets;
+    const size_t entryCount = paint_session_get_entry_count(session);
+    recorded.Entries.clear();
+    recorded.Entries.reserve(entryCount);
+    for (auto chunk = session->PaintEntryChunks; chunk != nullptr && recorded.Entries.size() < entryCount; chunk = chunk->Next)
+    {
+        chunkOffsets.emplace_back(chunk, recorded.Entries.size());
+        auto count = std::min(PaintEntryChunk::Capacity, entryCount - recorded.Entries.size());
+        recorded.Entries.insert(recorded.Entries.end(), chunk->Entries, chunk->Entries + count);
+    }
+
+    // Mind the offset needs to be calculated against the original `session`, not the copy
+    const size_t nullIndex = recorded.Entries.size();
+    auto toIndex = [&chunkOffsets, nullIndex](const paint_struct* ps) -> paint_struct* {
+        const auto* entry = reinterpret_cast<const paint_entry*>(ps);
+        for (const auto& [chunk, offset] : chunkOffsets)
+        {
+            if (entry >= chunk->Entries && entry < chunk->Entries + PaintEntryChunk::Capacity)
+            {
+                return reinterpret_cast<paint_struct*>(offset + (entry - chunk->Entries));
+            }
+        }
+        return reinterpret_cast<paint_struct*>(nullIndex);
+    };
+    for (auto& ps : recorded.Entries)
     {
-        ps.basic.next_quadrant_ps = reinterpret_cast<paint_struct*>(
-            ps.basic.next_quadrant_ps ? int(ps.basic.next_quadrant_ps - &session->PaintStructs[0].basic)
-                                      : std::size(session->PaintStructs));
+        ps.basic.next_quadrant_ps = toIndex(ps.basic.next_quadrant_ps);
     }
-    for (auto& quad : session_copy->Quadrants)
+    for (auto& quad : recorded.Session.Quadrants)
     {
-        quad = reinterpret_cast<paint_struct*>(
-            quad ? int(quad - &session->PaintStructs[0].basic) : std::size(session->Quadrants));
+        quad = toIndex(quad);
     }
 }
 
-static void viewport_fill_column(paint_session* session, std::vector<paint_session>* recorded_sessions, size_t record_index)
+static void viewport_fill_column(paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
     paint_session_generate(session);
     if (recorded_sessions != nullptr)
@@ -907,7 +931,7 @@ static void viewport_paint_column(paint_session* session)
  */
 void viewport_paint(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
-    std::vector<paint_session>* recorded_sessions)
+    std::vector<RecordedPaintSession>* recorded_sessions)
 {
     uint32_t viewFlags = viewport->flags;
     uint16_t width = right - left;
@@ -946,13 +970,10 @@ void viewport_paint(
     std::vector<paint_session*> columns;
 
     bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
-    {
-        _paintJobs = std::make_unique<JobPool>();
-    }
-    else if (useMultithreading == false && _paintJobs != nullptr)
+    std::optional<TaskGroup> paintJobs;
+    if (useMultithreading)
     {
-        _paintJobs.reset();
+        paintJobs.emplace();
     }
 
     // Create space to record sessions and keep track which index is being drawn
@@ -991,7 +1012,7 @@ void viewport_paint(
 
         if (useMultithreading)
         {
-            _paintJobs->AddTask(
+            paintJobs->Run(
                 [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
         }
         else
@@ -1002,7 +1023,7 @@ void viewport_paint(
 
     if (useMultithreading)
     {
-        _paintJobs->Join();
+        paintJobs->Wait();
     }
 
     for (auto&& column : columns)
@@ -33,7 +33,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "26"
+#define NETWORK_STREAM_VERSION "30"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -43,9 +43,23 @@ static int32_t _pickup_peep_old_x = LOCATION_NULL;
 // with uint16_t and needs some spare room for other data in the packet.
 static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 
+// Header in front of zlib compressed maps
+static constexpr char MAP_COMPRESSED_HEADER[] = "open2_sv6_zlib";
+
+// Maps sent to clients are kept for a while, so clients joining in the same tick share them and clients that join
+// again can resume their download or only get the changes since.
+static constexpr size_t MAP_CACHE_SIZE = 4;
+static constexpr uint32_t MAP_CACHE_LIFETIME = 5 * 60 * 1000;
+
+// No map is larger than the park file of a park that grew to the limits of the tile elements and sprites, with room
+// for the rest of the park. Sizes sent by the server are checked against it before anything is allocated for them.
+static constexpr size_t MAP_MAX_SIZE = size_t{ MAX_TILE_ELEMENTS } * sizeof(TileElement) + MAX_SPRITES * sizeof(rct_sprite)
+    + 16 * 1024 * 1024;
+
 #ifndef DISABLE_NETWORK
 
 #    include "../Cheats.h"
+#    include "../ParkFile.h"
 #    include "../ParkImporter.h"
 #    include "../Version.h"
 #    include "../actions/GameAction.h"
@@ -56,6 +70,7 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include "../core/MemoryStream.h"
 #    include "../core/Nullable.hpp"
 #    include "../core/Path.hpp"
+#    include "../core/BinaryDelta.h"
 #    include "../core/String.hpp"
 #    include "../interface/Chat.h"
 #    include "../interface/Window.h"
@@ -76,6 +91,7 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include "NetworkServerAdvertiser.h"
 #    include "NetworkUser.h"
 #    include "Socket.h"
+#    include "zlib.h"
 
 #    include <algorithm>
 #    include <array>
@@ -112,6 +128,7 @@ NetworkBase::NetworkBase()
     client_command_handlers[NetworkCommand::Map] = &NetworkBase::Client_Handle_MAP;
     client_command_handlers[NetworkCommand::Chat] = &NetworkBase::Client_Handle_CHAT;
     client_command_handlers[NetworkCommand::GameAction] = &NetworkBase::Client_Handle_GAME_ACTION;
+    client_command_handlers[NetworkCommand::GameActionBatch] = &NetworkBase::Client_Handle_GAME_ACTION_BATCH;
     client_command_handlers[NetworkCommand::Tick] = &NetworkBase::Client_Handle_TICK;
     client_command_handlers[NetworkCommand::PlayerList] = &NetworkBase::Client_Handle_PLAYERLIST;
     client_command_handlers[NetworkCommand::PlayerInfo] = &NetworkBase::Client_Handle_PLAYERINFO;
@@ -130,6 +147,7 @@ NetworkBase::NetworkBase()
     server_command_handlers[NetworkCommand::Auth] = &NetworkBase::Server_Handle_AUTH;
     server_command_handlers[NetworkCommand::Chat] = &NetworkBase::Server_Handle_CHAT;
     server_command_handlers[NetworkCommand::GameAction] = &NetworkBase::Server_Handle_GAME_ACTION;
+    server_command_handlers[NetworkCommand::GameActionBatch] = &NetworkBase::Server_Handle_GAME_ACTION_BATCH;
     server_command_handlers[NetworkCommand::Ping] = &NetworkBase::Server_Handle_PING;
     server_command_handlers[NetworkCommand::GameInfo] = &NetworkBase::Server_Handle_GAMEINFO;
     server_command_handlers[NetworkCommand::Token] = &NetworkBase::Server_Handle_TOKEN;
@@ -196,6 +214,8 @@ void NetworkBase::Close()
         CloseConnection();
 
         client_connection_list.clear();
+        _ioThread.reset();
+        _gameActionBatch.Clear();
         GameActions::ClearQueue();
         GameActions::ResumeQueue();
         player_list.clear();
@@ -203,6 +223,7 @@ void NetworkBase::Close()
         _serverTickData.clear();
         _pendingPlayerLists.clear();
         _pendingPlayerInfo.clear();
+        _clientMapTransferring = false;
 
         gfx_invalidate_screen();
 
@@ -406,6 +427,13 @@ bool NetworkBase::BeginServer(uint16_t port, const std::string& address)
     _serverState.gamestateSnapshotsEnabled = gConfigNetwork.desync_debugging;
     _advertiser = CreateServerAdvertiser(listening_port);
 
+    // Serve the sockets of the clients from a thread of their own where supported, instead of polling each of them
+    _ioThread = NetworkIOThread::Create();
+    if (_ioThread != nullptr)
+    {
+        log_verbose("Serving clients from the network thread");
+    }
+
     game_load_scripts();
 
     return true;
@@ -466,6 +494,9 @@ void NetworkBase::Update()
     _currentDeltaTime = std::max<uint32_t>(ticks - _lastUpdateTime, 1);
     _lastUpdateTime = ticks;
 
+    // Actions sent while the game is paused or a client waits for the server are not flushed at the end of a tick
+    SendGameActions();
+
     switch (GetMode())
     {
         case NETWORK_MODE_SERVER:
@@ -490,6 +521,7 @@ void NetworkBase::Update()
 
 void NetworkBase::Flush()
 {
+    SendGameActions();
     if (GetMode() == NETWORK_MODE_CLIENT)
     {
         _serverConnection->SendQueuedPackets();
@@ -721,8 +753,10 @@ const char* NetworkBase::FormatChat(NetworkPlayer* fromplayer, const char* text)
     return formatted;
 }
 
-void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, bool gameCmd)
+void NetworkBase::SendPacketToClients(NetworkPacket&& packet, bool front, bool gameCmd)
 {
+    // Encode the packet once, all connections share the same buffer
+    auto buffer = NetworkPacketBuffer::Create(std::move(packet));
     for (auto& client_connection : client_connection_list)
     {
         if (client_connection->IsDisconnected)
@@ -742,8 +776,27 @@ void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, b
                 continue;
             }
         }
-        auto packetCopy = packet;
-        client_connection->QueuePacket(std::move(packetCopy), front);
+        client_connection->QueuePacket(buffer, front);
+    }
+}
+
+void NetworkBase::SendGameActions()
+{
+    if (_gameActionBatch.IsEmpty())
+    {
+        return;
+    }
+
+    for (auto& packet : _gameActionBatch.TakePackets())
+    {
+        if (GetMode() == NETWORK_MODE_SERVER)
+        {
+            SendPacketToClients(std::move(packet));
+        }
+        else if (_serverConnection != nullptr)
+        {
+            _serverConnection->QueuePacket(std::move(packet));
+        }
     }
 }
 
@@ -766,6 +819,18 @@ bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
         return false;
     }
 
+    if (storedTick.stateHash.has_value())
+    {
+        const auto stateHash = game_state_hash();
+        if (stateHash != *storedTick.stateHash)
+        {
+            log_info(
+                "State hash mismatch, client = %s, server = %s", stateHash.ToString().c_str(),
+                storedTick.stateHash->ToString().c_str());
+            return false;
+        }
+    }
+
     if (!storedTick.spriteHash.empty())
     {
         rct_sprite_checksum checksum = sprite_checksum();
@@ -1247,6 +1312,21 @@ void NetworkBase::Client_Send_MAPREQUEST(const std::vector<std::string>& objects
         log_verbose("client requests object %s", object.c_str());
         packet.Write(reinterpret_cast<const uint8_t*>(object.c_str()), 8);
     }
+
+    // Let the server know which map we still have, so it can resume the download or send only what changed
+    NetworkMapBase clientMap;
+    if (!_lastMap.empty())
+    {
+        clientMap.id = _lastMapId;
+        clientMap.length = static_cast<uint32_t>(_lastMap.size());
+        clientMap.complete = true;
+    }
+    else if (_mapDownload.Received != 0 && !(_mapDownload.Flags & NETWORK_MAP_FLAG_DELTA))
+    {
+        clientMap.id = _mapDownload.Id;
+        clientMap.length = static_cast<uint32_t>(_mapDownload.Received);
+    }
+    packet << clientMap.id << clientMap.length << static_cast<uint8_t>(clientMap.complete);
     _serverConnection->QueuePacket(std::move(packet));
 }
 
@@ -1373,8 +1453,11 @@ void NetworkBase::Server_Send_AUTH(NetworkConnection& connection)
     }
 }
 
-void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
+void NetworkBase::Server_Send_MAP(NetworkConnection* connection, const NetworkMapBase& clientMap)
 {
+    // The map includes the effects of the pending actions, they must be sent before it
+    SendGameActions();
+
     std::vector<const ObjectRepositoryItem*> objects;
     if (connection)
     {
@@ -1387,11 +1470,13 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         auto context = GetContext();
         auto& objManager = context->GetObjectManager();
         objects = objManager.GetPackableObjects();
+
+        // A new park has been loaded, maps cached for this tick are no longer valid
+        _mapRevision++;
     }
 
-    size_t out_size;
-    uint8_t* header = save_for_network(out_size, objects);
-    if (header == nullptr)
+    auto map = GetMapForTransfer(objects);
+    if (map == nullptr)
     {
         if (connection)
         {
@@ -1400,76 +1485,150 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         }
         return;
     }
-    size_t chunksize = CHUNK_SIZE;
-    for (size_t i = 0; i < out_size; i += chunksize)
+
+    auto cachedMap = clientMap.id != 0 ? FindCachedMap(clientMap.id) : nullptr;
+    if (connection != nullptr && cachedMap != nullptr)
     {
-        size_t datasize = std::min(chunksize, out_size - i);
+        if (clientMap.complete)
+        {
+            auto delta = GetMapDelta(*map, *cachedMap);
+            if (delta != nullptr && delta->size() < map->Compressed.size())
+            {
+                log_verbose("Sending map as a delta of %u bytes", delta->size());
+                SendMapData(connection, map->Id, NETWORK_MAP_FLAG_DELTA | NETWORK_MAP_FLAG_LAST, cachedMap->Id, *delta, 0);
+                return;
+            }
+        }
+        else if (clientMap.length != 0 && clientMap.length < cachedMap->Compressed.size())
+        {
+            // Resume the interrupted download, followed by the changes made since if the map is no longer current
+            if (cachedMap == map)
+            {
+                log_verbose("Resuming map download at %u bytes", clientMap.length);
+                SendMapData(connection, map->Id, NETWORK_MAP_FLAG_LAST, 0, map->Compressed, clientMap.length);
+                return;
+            }
+            auto delta = GetMapDelta(*map, *cachedMap);
+            if (delta != nullptr)
+            {
+                log_verbose("Resuming map download at %u bytes, followed by a delta", clientMap.length);
+                SendMapData(connection, cachedMap->Id, 0, 0, cachedMap->Compressed, clientMap.length);
+                SendMapData(connection, map->Id, NETWORK_MAP_FLAG_DELTA | NETWORK_MAP_FLAG_LAST, cachedMap->Id, *delta, 0);
+                return;
+            }
+        }
+    }
+    SendMapData(connection, map->Id, NETWORK_MAP_FLAG_LAST, 0, map->Compressed, 0);
+}
+
+void NetworkBase::SendMapData(
+    NetworkConnection* connection, uint32_t mapId, uint8_t flags, uint32_t baseId, const std::vector<uint8_t>& data,
+    size_t offset)
+{
+    for (size_t i = offset; i < data.size(); i += CHUNK_SIZE)
+    {
+        size_t datasize = std::min<size_t>(CHUNK_SIZE, data.size() - i);
         NetworkPacket packet(NetworkCommand::Map);
-        packet << static_cast<uint32_t>(out_size) << static_cast<uint32_t>(i);
-        packet.Write(&header[i], datasize);
+        packet << mapId << flags << baseId << static_cast<uint32_t>(data.size()) << static_cast<uint32_t>(i);
+        packet.Write(&data[i], datasize);
         if (connection)
         {
             connection->QueuePacket(std::move(packet));
         }
         else
         {
-            SendPacketToClients(packet);
+            SendPacketToClients(std::move(packet));
         }
     }
-    free(header);
 }
 
-uint8_t* NetworkBase::save_for_network(size_t& out_size, const std::vector<const ObjectRepositoryItem*>& objects) const
+std::shared_ptr<NetworkBase::CachedMap> NetworkBase::GetMapForTransfer(const std::vector<const ObjectRepositoryItem*>& objects)
 {
-    uint8_t* header = nullptr;
-    out_size = 0;
+    // Clients joining in the same tick share the map, unless an action changed it in the meantime
+    for (const auto& map : _mapCache)
+    {
+        if (map->Tick == gCurrentTicks && map->Revision == _mapRevision && map->Objects == objects)
+        {
+            return map;
+        }
+    }
+
     bool RLEState = gUseRLE;
     gUseRLE = false;
-
     auto ms = OpenRCT2::MemoryStream();
-    if (!SaveMap(&ms, objects))
+    bool saved = SaveMap(&ms, objects);
+    gUseRLE = RLEState;
+    if (!saved)
     {
         log_warning("Failed to export map.");
         return nullptr;
     }
-    gUseRLE = RLEState;
 
-    const void* data = ms.GetData();
-    int32_t size = ms.GetLength();
+    auto data = static_cast<const uint8_t*>(ms.GetData());
+    size_t size = ms.GetLength();
+    uint32_t id = crc32(0, data, static_cast<uInt>(size));
 
-    auto compressed = util_zlib_deflate(static_cast<const uint8_t*>(data), size);
-    if (compressed != std::nullopt)
+    // While the game is paused the map does not change from one tick to the next
+    auto map = FindCachedMap(id);
+    if (map == nullptr)
     {
-        out_size = compressed->size();
-        header = reinterpret_cast<uint8_t*>(_strdup("open2_sv6_zlib"));
-        size_t header_len = strlen(reinterpret_cast<char*>(header)) + 1; // account for null terminator
-        header = static_cast<uint8_t*>(realloc(header, header_len + out_size));
-        if (header == nullptr)
+        map = std::make_shared<CachedMap>();
+        map->Id = id;
+        map->Data.assign(data, data + size);
+
+        auto compressed = util_zlib_deflate(data, size);
+        if (compressed != std::nullopt)
         {
-            log_error("Failed to allocate %u bytes.", header_len + out_size);
+            map->Compressed.assign(MAP_COMPRESSED_HEADER, MAP_COMPRESSED_HEADER + sizeof(MAP_COMPRESSED_HEADER));
+            map->Compressed.insert(map->Compressed.end(), compressed->begin(), compressed->end());
+            log_verbose("Sending map of size %u bytes, compressed to %u bytes", size, map->Compressed.size());
         }
         else
         {
-            std::memcpy(&header[header_len], compressed->data(), out_size);
-            out_size += header_len;
-            log_verbose("Sending map of size %u bytes, compressed to %u bytes", size, out_size);
+            log_warning("Failed to compress the data, falling back to non-compressed sv6.");
+            map->Compressed = map->Data;
         }
-    }
-    else
-    {
-        log_warning("Failed to compress the data, falling back to non-compressed sv6.");
-        header = static_cast<uint8_t*>(malloc(size));
-        if (header == nullptr)
+
+        auto now = platform_get_ticks();
+        _mapCache.erase(
+            std::remove_if(
+                _mapCache.begin(), _mapCache.end(),
+                [now](const std::shared_ptr<CachedMap>& cached) { return now - cached->CreatedTime > MAP_CACHE_LIFETIME; }),
+            _mapCache.end());
+        while (_mapCache.size() >= MAP_CACHE_SIZE)
         {
-            log_error("Failed to allocate %u bytes.", size);
+            _mapCache.pop_front();
         }
-        else
+        map->CreatedTime = now;
+        _mapCache.push_back(map);
+    }
+    map->Tick = gCurrentTicks;
+    map->Revision = _mapRevision;
+    map->Objects = objects;
+    return map;
+}
+
+std::shared_ptr<NetworkBase::CachedMap> NetworkBase::FindCachedMap(uint32_t id) const
+{
+    auto it = std::find_if(
+        _mapCache.begin(), _mapCache.end(), [id](const std::shared_ptr<CachedMap>& map) { return map->Id == id; });
+    return it != _mapCache.end() ? *it : nullptr;
+}
+
+const std::vector<uint8_t>* NetworkBase::GetMapDelta(CachedMap& map, const CachedMap& base)
+{
+    auto it = map.Deltas.find(base.Id);
+    if (it == map.Deltas.end())
+    {
+        auto delta = BinaryDelta::Create(base.Data.data(), base.Data.size(), map.Data.data(), map.Data.size());
+        auto compressed = util_zlib_deflate(delta.data(), delta.size());
+        if (compressed == std::nullopt)
         {
-            out_size = size;
-            std::memcpy(header, data, size);
+            return nullptr;
         }
+        it = map.Deltas.emplace(base.Id, std::move(*compressed)).first;
     }
-    return header;
+    return &it->second;
 }
 
 void NetworkBase::Client_Send_CHAT(const char* text)
@@ -1487,16 +1646,17 @@ void NetworkBase::Server_Send_CHAT(const char* text, const std::vector<uint8_t>&
     if (playerIds.empty())
     {
         // Empty players / default value means send to all players
-        SendPacketToClients(packet);
+        SendPacketToClients(std::move(packet));
     }
     else
     {
+        auto buffer = NetworkPacketBuffer::Create(std::move(packet));
         for (auto playerId : playerIds)
         {
             auto conn = GetPlayerConnection(playerId);
             if (conn != nullptr && !conn->IsDisconnected)
             {
-                conn->QueuePacket(packet);
+                conn->QueuePacket(buffer);
             }
         }
     }
@@ -1504,8 +1664,6 @@ void NetworkBase::Server_Send_CHAT(const char* text, const std::vector<uint8_t>&
 
 void NetworkBase::Client_Send_GAME_ACTION(const GameAction* action)
 {
-    NetworkPacket packet(NetworkCommand::GameAction);
-
     uint32_t networkId = 0;
     networkId = ++_actionId;
 
@@ -1519,20 +1677,20 @@ void NetworkBase::Client_Send_GAME_ACTION(const GameAction* action)
     DataSerialiser stream(true);
     action->Serialise(stream);
 
-    packet << gCurrentTicks << action->GetType() << stream;
-    _serverConnection->QueuePacket(std::move(packet));
+    const auto& data = stream.GetStream();
+    _gameActionBatch.Add(gCurrentTicks, action->GetType(), data.GetData(), static_cast<size_t>(data.GetLength()));
 }
 
 void NetworkBase::Server_Send_GAME_ACTION(const GameAction* action)
 {
-    NetworkPacket packet(NetworkCommand::GameAction);
-
     DataSerialiser stream(true);
     action->Serialise(stream);
 
-    packet << gCurrentTicks << action->GetType() << stream;
+    const auto& data = stream.GetStream();
+    _gameActionBatch.Add(gCurrentTicks, action->GetType(), data.GetData(), static_cast<size_t>(data.GetLength()));
 
-    SendPacketToClients(packet);
+    // Actions can change the map without the tick advancing, e.g. while the game is paused
+    _mapRevision++;
 }
 
 void NetworkBase::Server_Send_TICK()
@@ -1540,15 +1698,15 @@ void NetworkBase::Server_Send_TICK()
     NetworkPacket packet(NetworkCommand::Tick);
     packet << gCurrentTicks << scenario_rand_state().s0;
     uint32_t flags = 0;
-    // Simple counter which limits how often a sprite checksum gets sent.
-    // This can get somewhat expensive, so we don't want to push it every tick in release,
+    // Simple counter which limits how often a sprite checksum and the state hash get sent.
+    // Both walk the whole game state, so we don't want to push them every tick in release,
     // but debug version can check more often.
     static int32_t checksum_counter = 0;
     checksum_counter++;
     if (checksum_counter >= 100)
     {
         checksum_counter = 0;
-        flags |= NETWORK_TICK_FLAG_CHECKSUMS;
+        flags |= NETWORK_TICK_FLAG_CHECKSUMS | NETWORK_TICK_FLAG_STATE_HASH;
     }
     // Send flags always, so we can understand packet structure on the other end,
     // and allow for some expansion.
@@ -1558,8 +1716,13 @@ void NetworkBase::Server_Send_TICK()
         rct_sprite_checksum checksum = sprite_checksum();
         packet.WriteString(checksum.ToString().c_str());
     }
+    if (flags & NETWORK_TICK_FLAG_STATE_HASH)
+    {
+        const auto stateHash = game_state_hash();
+        packet << stateHash.Entities << stateHash.TileElements << stateHash.Park;
+    }
 
-    SendPacketToClients(packet);
+    SendPacketToClients(std::move(packet));
 }
 
 void NetworkBase::Server_Send_PLAYERINFO(int32_t playerId)
@@ -1572,7 +1735,7 @@ void NetworkBase::Server_Send_PLAYERINFO(int32_t playerId)
         return;
 
     player->Write(packet);
-    SendPacketToClients(packet);
+    SendPacketToClients(std::move(packet));
 }
 
 void NetworkBase::Server_Send_PLAYERLIST()
@@ -1583,7 +1746,7 @@ void NetworkBase::Server_Send_PLAYERLIST()
     {
         player->Write(packet);
     }
-    SendPacketToClients(packet);
+    SendPacketToClients(std::move(packet));
 }
 
 void NetworkBase::Client_Send_PING()
@@ -1600,7 +1763,7 @@ void NetworkBase::Server_Send_PING()
     {
         client_connection->PingTime = platform_get_ticks();
     }
-    SendPacketToClients(packet, true);
+    SendPacketToClients(std::move(packet), true);
 }
 
 void NetworkBase::Server_Send_PINGLIST()
@@ -1611,7 +1774,7 @@ void NetworkBase::Server_Send_PINGLIST()
     {
         packet << player->Id << player->Ping;
     }
-    SendPacketToClients(packet);
+    SendPacketToClients(std::move(packet));
 }
 
 void NetworkBase::Server_Send_SETDISCONNECTMSG(NetworkConnection& connection, const char* msg)
@@ -1679,7 +1842,7 @@ void NetworkBase::Server_Send_EVENT_PLAYER_JOINED(const char* playerName)
     NetworkPacket packet(NetworkCommand::Event);
     packet << static_cast<uint16_t>(SERVER_EVENT_PLAYER_JOINED);
     packet.WriteString(playerName);
-    SendPacketToClients(packet);
+    SendPacketToClients(std::move(packet));
 }
 
 void NetworkBase::Server_Send_EVENT_PLAYER_DISCONNECTED(const char* playerName, const char* reason)
@@ -1688,7 +1851,7 @@ void NetworkBase::Server_Send_EVENT_PLAYER_DISCONNECTED(const char* playerName,
     packet << static_cast<uint16_t>(SERVER_EVENT_PLAYER_DISCONNECTED);
     packet.WriteString(playerName);
     packet.WriteString(reason);
-    SendPacketToClients(packet);
+    SendPacketToClients(std::move(packet));
 }
 
 bool NetworkBase::ProcessConnection(NetworkConnection& connection)
@@ -1977,6 +2140,10 @@ void NetworkBase::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
+    if (_ioThread != nullptr)
+    {
+        connection->AttachToNetworkThread(*_ioThread);
+    }
 
     client_connection_list.push_back(std::move(connection));
 }
@@ -2523,8 +2690,13 @@ void NetworkBase::Server_Handle_MAPREQUEST(NetworkConnection& connection, Networ
         }
     }
 
+    NetworkMapBase clientMap;
+    uint8_t complete;
+    packet >> clientMap.id >> clientMap.length >> complete;
+    clientMap.complete = complete != 0;
+
     const char* player_name = static_cast<const char*>(connection.Player->Name.c_str());
-    Server_Send_MAP(&connection);
+    Server_Send_MAP(&connection, clientMap);
     Server_Send_EVENT_PLAYER_JOINED(player_name);
     Server_Send_GROUPLIST(connection);
 }
@@ -2645,14 +2817,15 @@ void NetworkBase::Server_Handle_AUTH(NetworkConnection& connection, NetworkPacke
 
 void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
 {
-    uint32_t size, offset;
-    packet >> size >> offset;
+    uint32_t mapId, baseId, size, offset;
+    uint8_t flags;
+    packet >> mapId >> flags >> baseId >> size >> offset;
     int32_t chunksize = static_cast<int32_t>(packet.Header.Size - packet.BytesRead);
     if (chunksize <= 0)
     {
         return;
     }
-    if (offset == 0)
+    if (!_clientMapTransferring)
     {
         // Start of a new map load, clear the queue now as we have to buffer them
         // until the map is fully loaded.
@@ -2661,11 +2834,36 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
 
         _serverTickData.clear();
         _clientMapLoaded = false;
+        _clientMapTransferring = true;
     }
-    if (size > chunk_buffer.size())
+
+    // A download that was interrupted continues where it left off, anything else starts a new one
+    bool isDelta = (flags & NETWORK_MAP_FLAG_DELTA) != 0;
+    bool isSameDownload = _mapDownload.Id == mapId && _mapDownload.BaseId == baseId
+        && ((_mapDownload.Flags & NETWORK_MAP_FLAG_DELTA) != 0) == isDelta && _mapDownload.Data.size() == size;
+    if (size > MAP_MAX_SIZE)
     {
-        chunk_buffer.resize(size);
+        log_warning("Received a map that is too large.");
+        _mapDownload = {};
+        Close();
+        return;
+    }
+    if (offset == 0 || !isSameDownload)
+    {
+        _mapDownload = {};
+        _mapDownload.Id = mapId;
+        _mapDownload.BaseId = baseId;
+        _mapDownload.Data.resize(size);
+    }
+    if (offset != _mapDownload.Received || offset + chunksize > size)
+    {
+        log_warning("Received map data out of order.");
+        _mapDownload = {};
+        Close();
+        return;
     }
+    _mapDownload.Flags = flags;
+
     char str_downloading_map[256];
     uint32_t downloading_map_args[2] = {
         (offset + chunksize) / 1024,
@@ -2678,68 +2876,126 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
     intent.putExtra(INTENT_EXTRA_CALLBACK, []() -> void { gNetwork.Close(); });
     context_open_intent(&intent);
 
-    std::memcpy(&chunk_buffer[offset], const_cast<void*>(static_cast<const void*>(packet.Read(chunksize))), chunksize);
-    if (offset + chunksize == size)
+    std::memcpy(&_mapDownload.Data[offset], packet.Read(chunksize), chunksize);
+    _mapDownload.Received += chunksize;
+    if (_mapDownload.Received < size)
     {
-        // Allow queue processing of game actions again.
-        GameActions::ResumeQueue();
+        return;
+    }
 
-        context_force_close_window_by_class(WC_NETWORK_STATUS);
-        bool has_to_free = false;
-        uint8_t* data = &chunk_buffer[0];
-        size_t data_size = size;
-        // zlib-compressed
-        if (strcmp("open2_sv6_zlib", reinterpret_cast<char*>(&chunk_buffer[0])) == 0)
-        {
-            log_verbose("Received zlib-compressed sv6 map");
-            has_to_free = true;
-            size_t header_len = strlen("open2_sv6_zlib") + 1;
-            data = util_zlib_inflate(&chunk_buffer[header_len], size - header_len, &data_size);
-            if (data == nullptr)
-            {
-                log_warning("Failed to decompress data sent from server.");
-                Close();
-                return;
-            }
-        }
-        else
+    if (!CompleteMapDownload())
+    {
+        _lastMap.clear();
+        Close();
+        return;
+    }
+    if (!(flags & NETWORK_MAP_FLAG_LAST))
+    {
+        // The server sends the changes made to this map since next
+        return;
+    }
+
+    // Allow queue processing of game actions again.
+    GameActions::ResumeQueue();
+    _clientMapTransferring = false;
+
+    context_force_close_window_by_class(WC_NETWORK_STATUS);
+    auto ms = MemoryStream(_lastMap.data(), _lastMap.size());
+    if (LoadMap(&ms))
+    {
+        game_load_init();
+        game_load_scripts();
+        _serverState.tick = gCurrentTicks;
+        // window_network_status_open("Loaded new map from network");
+        _serverState.state = NETWORK_SERVER_STATE_OK;
+        _clientMapLoaded = true;
+        gFirstTimeSaving = true;
+
+        // Notify user he is now online and which shortcut key enables chat
+        network_chat_show_connected_message();
+
+        // Fix invalid vehicle sprite sizes, thus preventing visual corruption of sprites
+        fix_invalid_vehicle_sprite_sizes();
+
+        // NOTE: Game actions are normally processed before processing the player list.
+        // Given that during map load game actions are buffered we have to process the
+        // player list first to have valid players for the queued game actions.
+        ProcessPlayerList();
+    }
+    else
+    {
+        _lastMap.clear();
+
+        // Something went wrong, game is not loaded. Return to main screen.
+        auto loadOrQuitAction = LoadOrQuitAction(LoadOrQuitModes::OpenSavePrompt, PM_SAVE_BEFORE_QUIT);
+        GameActions::Execute(&loadOrQuitAction);
+    }
+}
+
+/**
+ * Turns the finished download into the map it describes, decompressing it and applying it to the last map if it is a
+ * delta.
+ */
+bool NetworkBase::CompleteMapDownload()
+{
+    auto download = std::move(_mapDownload);
+    _mapDownload = {};
+
+    std::vector<uint8_t> map;
+    if (download.Flags & NETWORK_MAP_FLAG_DELTA)
+    {
+        if (_lastMap.empty() || _lastMapId != download.BaseId)
         {
-            log_verbose("Assuming received map is in plain sv6 format");
+            log_warning("Received a delta against a map we do not have.");
+            return false;
         }
-
-        auto ms = MemoryStream(data, data_size);
-        if (LoadMap(&ms))
+        size_t deltaSize;
+        uint8_t* delta = util_zlib_inflate(download.Data.data(), download.Data.size(), &deltaSize);
+        if (delta == nullptr)
         {
-            game_load_init();
-            game_load_scripts();
-            _serverState.tick = gCurrentTicks;
-            // window_network_status_open("Loaded new map from network");
-            _serverState.state = NETWORK_SERVER_STATE_OK;
-            _clientMapLoaded = true;
-            gFirstTimeSaving = true;
-
-            // Notify user he is now online and which shortcut key enables chat
-            network_chat_show_connected_message();
-
-            // Fix invalid vehicle sprite sizes, thus preventing visual corruption of sprites
-            fix_invalid_vehicle_sprite_sizes();
-
-            // NOTE: Game actions are normally processed before processing the player list.
-            // Given that during map load game actions are buffered we have to process the
-            // player list first to have valid players for the queued game actions.
-            ProcessPlayerList();
+            log_warning("Failed to decompress data sent from server.");
+            return false;
         }
-        else
+        auto result = BinaryDelta::Apply(_lastMap.data(), _lastMap.size(), delta, deltaSize, MAP_MAX_SIZE);
+        free(delta);
+        if (result == std::nullopt)
         {
-            // Something went wrong, game is not loaded. Return to main screen.
-            auto loadOrQuitAction = LoadOrQuitAction(LoadOrQuitModes::OpenSavePrompt, PM_SAVE_BEFORE_QUIT);
-            GameActions::Execute(&loadOrQuitAction);
+            log_warning("Failed to apply the map delta sent from server.");
+            return false;
         }
-        if (has_to_free)
+        log_verbose("Received map delta of %u bytes", download.Data.size());
+        map = std::move(*result);
+    }
+    else if (
+        download.Data.size() >= sizeof(MAP_COMPRESSED_HEADER)
+        && std::memcmp(download.Data.data(), MAP_COMPRESSED_HEADER, sizeof(MAP_COMPRESSED_HEADER)) == 0)
+    {
+        log_verbose("Received zlib-compressed sv6 map");
+        size_t dataSize;
+        uint8_t* data = util_zlib_inflate(
+            &download.Data[sizeof(MAP_COMPRESSED_HEADER)], download.Data.size() - sizeof(MAP_COMPRESSED_HEADER), &dataSize);
+        if (data == nullptr)
         {
-            free(data);
+            log_warning("Failed to decompress data sent from server.");
+            return false;
         }
+        map.assign(data, data + dataSize);
+        free(data);
     }
+    else
+    {
+        log_verbose("Assuming received map is in plain sv6 format");
+        map = std::move(download.Data);
+    }
+
+    if (crc32(0, map.data(), static_cast<uInt>(map.size())) != download.Id)
+    {
+        log_warning("Map sent from server does not match its checksum.");
+        return false;
+    }
+    _lastMap = std::move(map);
+    _lastMapId = download.Id;
+    return true;
 }
 
 bool NetworkBase::LoadMap(IStream* stream)
@@ -2749,16 +3005,34 @@ bool NetworkBase::LoadMap(IStream* stream)
     {
         auto context = GetContext();
         auto& objManager = context->GetObjectManager();
-        auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
+        const bool isParkFile = ParkFileReader::IsParkFile(stream);
+        auto importer = isParkFile ? ParkImporter::CreateParkFile() : ParkImporter::CreateS6(context->GetObjectRepository());
         auto loadResult = importer->LoadFromStream(stream, false);
+        if (isParkFile)
+        {
+            // The custom objects missing on this client follow the park file, see SaveMap
+            const auto numObjects = stream->ReadValue<uint32_t>();
+            if (numObjects > OBJECT_ENTRY_COUNT)
+            {
+                throw std::runtime_error("Too many packed objects.");
+            }
+            auto& objRepo = context->GetObjectRepository();
+            for (uint32_t i = 0; i < numObjects; i++)
+            {
+                objRepo.ExportPackedObject(stream);
+            }
+        }
         objManager.LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
         importer->Import();
 
         sprite_position_tween_reset();
         AutoCreateMapAnimations();
 
-        // Read checksum
-        [[maybe_unused]] uint32_t checksum = stream->ReadValue<uint32_t>();
+        if (!isParkFile)
+        {
+            // Read checksum
+            [[maybe_unused]] uint32_t checksum = stream->ReadValue<uint32_t>();
+        }
 
         // Read other data not in normal save files
         gGamePaused = stream->ReadValue<uint32_t>();
@@ -2804,10 +3078,27 @@ bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectReposit
     viewport_set_saved_view();
     try
     {
-        auto s6exporter = std::make_unique<S6Exporter>();
-        s6exporter->ExportObjectsList = objects;
-        s6exporter->Export();
-        s6exporter->SaveGame(stream);
+        // An SV6 leaves out the free sprites past its limit, clients would then create sprites at other indices. Parks
+        // that grew beyond it are sent as park files, which hold the storage as it is but do not pack objects, so the
+        // custom objects the client is missing are packed after the park file instead.
+        if (GetEntityCapacity() > RCT2_MAX_SPRITES || gNextFreeTileElement > gTileElements.data() + RCT2_MAX_TILE_ELEMENTS)
+        {
+            auto exporter = std::make_unique<ParkFileExporter>();
+            exporter->Export();
+            exporter->SaveGame(stream);
+
+            std::vector<const ObjectRepositoryItem*> customObjects;
+            std::copy_if(objects.begin(), objects.end(), std::back_inserter(customObjects), IsObjectCustom);
+            stream->WriteValue<uint32_t>(static_cast<uint32_t>(customObjects.size()));
+            GetContext()->GetObjectRepository().WritePackedObjects(stream, customObjects);
+        }
+        else
+        {
+            auto s6exporter = std::make_unique<S6Exporter>();
+            s6exporter->ExportObjectsList = objects;
+            s6exporter->Export();
+            s6exporter->SaveGame(stream);
+        }
 
         // Write other data not in normal save files
         stream->WriteValue<uint32_t>(gGamePaused);
@@ -2926,9 +3217,28 @@ void NetworkBase::Client_Handle_GAME_ACTION([[maybe_unused]] NetworkConnection&
     uint32_t actionType;
     packet >> tick >> actionType;
 
-    MemoryStream stream;
     const size_t size = packet.Header.Size - packet.BytesRead;
-    stream.WriteArray(packet.Read(size), size);
+    Client_Enqueue_GAME_ACTION(tick, actionType, packet.Read(size), size);
+}
+
+void NetworkBase::Client_Handle_GAME_ACTION_BATCH([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
+{
+    std::vector<NetworkGameActionBatch::Action> actions;
+    if (!NetworkGameActionBatch::Read(packet, actions))
+    {
+        log_error("Received malformed game action batch");
+        return;
+    }
+    for (const auto& action : actions)
+    {
+        Client_Enqueue_GAME_ACTION(action.Tick, action.Type, action.Data.data(), action.Data.size());
+    }
+}
+
+void NetworkBase::Client_Enqueue_GAME_ACTION(uint32_t tick, uint32_t actionType, const uint8_t* data, size_t size)
+{
+    MemoryStream stream;
+    stream.WriteArray(data, size);
     stream.SetPosition(0);
 
     DataSerialiser ds(false, stream);
@@ -2960,15 +3270,35 @@ void NetworkBase::Server_Handle_GAME_ACTION(NetworkConnection& connection, Netwo
 {
     uint32_t tick;
     uint32_t actionType;
+    packet >> tick >> actionType;
 
+    const size_t size = packet.Header.Size - packet.BytesRead;
+    Server_Enqueue_GAME_ACTION(connection, tick, actionType, packet.Read(size), size);
+}
+
+void NetworkBase::Server_Handle_GAME_ACTION_BATCH(NetworkConnection& connection, NetworkPacket& packet)
+{
+    std::vector<NetworkGameActionBatch::Action> actions;
+    if (!NetworkGameActionBatch::Read(packet, actions))
+    {
+        log_warning("Received malformed game action batch");
+        return;
+    }
+    for (const auto& action : actions)
+    {
+        Server_Enqueue_GAME_ACTION(connection, action.Tick, action.Type, action.Data.data(), action.Data.size());
+    }
+}
+
+void NetworkBase::Server_Enqueue_GAME_ACTION(
+    NetworkConnection& connection, uint32_t tick, uint32_t actionType, const uint8_t* data, size_t size)
+{
     NetworkPlayer* player = connection.Player;
     if (player == nullptr)
     {
         return;
     }
 
-    packet >> tick >> actionType;
-
     // Don't let clients send pause or quit
     if (actionType == GAME_COMMAND_TOGGLE_PAUSE || actionType == GAME_COMMAND_LOAD_OR_QUIT)
     {
@@ -3017,8 +3347,7 @@ void NetworkBase::Server_Handle_GAME_ACTION(NetworkConnection& connection, Netwo
     }
 
     DataSerialiser stream(false);
-    const size_t size = packet.Header.Size - packet.BytesRead;
-    stream.GetStream().WriteArray(packet.Read(size), size);
+    stream.GetStream().WriteArray(data, size);
     stream.GetStream().SetPosition(0);
 
     ga->Serialise(stream);
@@ -3048,6 +3377,12 @@ void NetworkBase::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connect
             tickData.spriteHash = text;
         }
     }
+    if (flags & NETWORK_TICK_FLAG_STATE_HASH)
+    {
+        GameStateHash stateHash;
+        packet >> stateHash.Entities >> stateHash.TileElements >> stateHash.Park;
+        tickData.stateHash = stateHash;
+    }
 
     // Don't let the history grow too much.
     while (_serverTickData.size() >= 100)
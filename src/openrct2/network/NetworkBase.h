@@ -1,14 +1,19 @@
 #pragma once
 
+#include "../GameStateHash.h"
 #include "../actions/GameAction.h"
 #include "NetworkConnection.h"
+#include "NetworkGameActionBatch.h"
 #include "NetworkGroup.h"
+#include "NetworkIOThread.h"
 #include "NetworkPlayer.h"
 #include "NetworkServerAdvertiser.h"
 #include "NetworkTypes.h"
 #include "NetworkUser.h"
 
+#include <deque>
 #include <fstream>
+#include <optional>
 
 #ifndef DISABLE_NETWORK
 
@@ -69,13 +74,12 @@ public: // Server
     void UpdateServer();
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
     bool SaveMap(OpenRCT2::IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
-    uint8_t* save_for_network(size_t& out_size, const std::vector<const ObjectRepositoryItem*>& objects) const;
     std::string MakePlayerNameUnique(const std::string& name);
 
     // Packet dispatchers.
     void Server_Send_AUTH(NetworkConnection& connection);
     void Server_Send_TOKEN(NetworkConnection& connection);
-    void Server_Send_MAP(NetworkConnection* connection = nullptr);
+    void Server_Send_MAP(NetworkConnection* connection = nullptr, const NetworkMapBase& clientMap = {});
     void Server_Send_CHAT(const char* text, const std::vector<uint8_t>& playerIds = {});
     void Server_Send_GAME_ACTION(const GameAction* action);
     void Server_Send_TICK();
@@ -99,6 +103,9 @@ public: // Server
     void Server_Client_Joined(const char* name, const std::string& keyhash, NetworkConnection& connection);
     void Server_Handle_CHAT(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPacket& packet);
+    void Server_Handle_GAME_ACTION_BATCH(NetworkConnection& connection, NetworkPacket& packet);
+    void Server_Enqueue_GAME_ACTION(
+        NetworkConnection& connection, uint32_t tick, uint32_t actionType, const uint8_t* data, size_t size);
     void Server_Handle_PING(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_GAMEINFO(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_TOKEN(NetworkConnection& connection, NetworkPacket& packet);
@@ -113,7 +120,8 @@ public: // Client
     void ProcessPlayerInfo();
     void ProcessDisconnectedClients();
     static const char* FormatChat(NetworkPlayer* fromplayer, const char* text);
-    void SendPacketToClients(const NetworkPacket& packet, bool front = false, bool gameCmd = false);
+    void SendPacketToClients(NetworkPacket&& packet, bool front = false, bool gameCmd = false);
+    void SendGameActions();
     bool CheckSRAND(uint32_t tick, uint32_t srand0);
     bool CheckDesynchronizaton();
     void RequestStateSnapshot();
@@ -140,6 +148,8 @@ public: // Client
     void Client_Handle_MAP(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_CHAT(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_Handle_GAME_ACTION_BATCH(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_Enqueue_GAME_ACTION(uint32_t tick, uint32_t actionType, const uint8_t* data, size_t size);
     void Client_Handle_TICK(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_PLAYERINFO(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_PLAYERLIST(NetworkConnection& connection, NetworkPacket& packet);
@@ -174,8 +184,8 @@ private: // Common Data
     using CommandHandler = void (NetworkBase::*)(NetworkConnection& connection, NetworkPacket& packet);
 
     std::shared_ptr<OpenRCT2::IPlatformEnvironment> _env;
-    std::vector<uint8_t> chunk_buffer;
     std::ofstream _chat_log_fs;
+    NetworkGameActionBatch _gameActionBatch; // Sent at the end of the tick, or before the next update
     uint32_t _lastUpdateTime = 0;
     uint32_t _currentDeltaTime = 0;
     int32_t mode = NETWORK_MODE_NONE;
@@ -185,13 +195,35 @@ private: // Common Data
     bool wsa_initialized = false;
 
 private: // Server Data
+    struct CachedMap
+    {
+        uint32_t Id; // CRC32 of Data
+        uint32_t Tick;
+        uint32_t Revision;
+        uint32_t CreatedTime;
+        std::vector<const ObjectRepositoryItem*> Objects;
+        std::vector<uint8_t> Data;
+        std::vector<uint8_t> Compressed;
+        std::map<uint32_t, std::vector<uint8_t>> Deltas; // Compressed, by the id of the base
+    };
+
+    std::shared_ptr<CachedMap> GetMapForTransfer(const std::vector<const ObjectRepositoryItem*>& objects);
+    std::shared_ptr<CachedMap> FindCachedMap(uint32_t id) const;
+    const std::vector<uint8_t>* GetMapDelta(CachedMap& map, const CachedMap& base);
+    void SendMapData(
+        NetworkConnection* connection, uint32_t mapId, uint8_t flags, uint32_t baseId, const std::vector<uint8_t>& data,
+        size_t offset);
+
     std::unordered_map<NetworkCommand, CommandHandler> server_command_handlers;
     std::unique_ptr<ITcpSocket> _listenSocket;
     std::unique_ptr<INetworkServerAdvertiser> _advertiser;
+    std::unique_ptr<NetworkIOThread> _ioThread; // Must outlive the connections attached to it
     std::list<std::unique_ptr<NetworkConnection>> client_connection_list;
     std::string _serverLogPath;
     std::string _serverLogFilenameFormat = "%Y%m%d-%H%M%S.txt";
     std::ofstream _server_log_fs;
+    std::deque<std::shared_ptr<CachedMap>> _mapCache;
+    uint32_t _mapRevision = 0;
     uint16_t listening_port = 0;
     bool _playerListInvalidated = false;
 
@@ -206,8 +238,20 @@ private: // Client Data
         uint32_t srand0;
         uint32_t tick;
         std::string spriteHash;
+        std::optional<GameStateHash> stateHash;
     };
 
+    struct MapDownload
+    {
+        uint32_t Id = 0;
+        uint32_t BaseId = 0;
+        uint8_t Flags = 0;
+        std::vector<uint8_t> Data;
+        size_t Received = 0;
+    };
+
+    bool CompleteMapDownload();
+
     std::unordered_map<NetworkCommand, CommandHandler> client_command_handlers;
     std::unique_ptr<NetworkConnection> _serverConnection;
     std::map<uint32_t, PlayerListUpdate> _pendingPlayerLists;
@@ -219,6 +263,9 @@ private: // Client Data
     std::string _chatLogFilenameFormat = "%Y%m%d-%H%M%S.txt";
     std::string _password;
     OpenRCT2::MemoryStream _serverGameState;
+    MapDownload _mapDownload;
+    std::vector<uint8_t> _lastMap; // Kept after leaving the server, to only download the changes when joining again
+    uint32_t _lastMapId = 0;
     NetworkServerState_t _serverState;
     uint32_t _lastSentHeartbeat = 0;
     uint32_t last_ping_sent_time = 0;
@@ -230,6 +277,7 @@ private: // Client Data
     SOCKET_STATUS _lastConnectStatus = SOCKET_STATUS_CLOSED;
     bool _requireReconnect = false;
     bool _clientMapLoaded = false;
+    bool _clientMapTransferring = false;
 };
 
 #endif // DISABLE_NETWORK
@@ -14,9 +14,12 @@
 #    include "../core/String.hpp"
 #    include "../localisation/Localisation.h"
 #    include "../platform/platform.h"
+#    include "NetworkIOThread.h"
 #    include "Socket.h"
 #    include "network.h"
 
+#    include <array>
+
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
 constexpr size_t NetworkBufferSize = 1024;
 
@@ -27,20 +30,86 @@ NetworkConnection::NetworkConnection()
 
 NetworkConnection::~NetworkConnection()
 {
+    if (_ioThread != nullptr)
+    {
+        _ioThread->Remove(*this);
+    }
     delete[] _lastDisconnectReason;
 }
 
+void NetworkConnection::AttachToNetworkThread(NetworkIOThread& ioThread)
+{
+    _ioThread = &ioThread;
+    ioThread.Add(*this);
+}
+
 int32_t NetworkConnection::ReadPacket()
+{
+    if (_ioThread != nullptr)
+    {
+        if (!_receivedPackets.TryPop(InboundPacket))
+        {
+            // The network thread can queue its last packets and fail between the pop and reading the flag, those
+            // packets are still handled before the connection is reported as closed.
+            if (!_receiveFailed)
+            {
+                return NETWORK_READPACKET_NO_DATA;
+            }
+            if (!_receivedPackets.TryPop(InboundPacket))
+            {
+                return NETWORK_READPACKET_DISCONNECTED;
+            }
+        }
+        RecordPacketStats(InboundPacket.GetCommand(), sizeof(PacketHeader) + InboundPacket.Data.size(), false);
+        return NETWORK_READPACKET_SUCCESS;
+    }
+
+    int32_t status = ReceivePacket(InboundPacket);
+    if (status == NETWORK_READPACKET_SUCCESS)
+    {
+        RecordPacketStats(InboundPacket.GetCommand(), sizeof(PacketHeader) + InboundPacket.Data.size(), false);
+    }
+    return status;
+}
+
+bool NetworkConnection::ReceivePackets()
+{
+    try
+    {
+        int32_t status;
+        do
+        {
+            status = ReceivePacket(_receivingPacket);
+            if (status == NETWORK_READPACKET_SUCCESS)
+            {
+                _receivedPackets.Push(std::move(_receivingPacket));
+                _receivingPacket = NetworkPacket();
+            }
+        } while (status == NETWORK_READPACKET_SUCCESS || status == NETWORK_READPACKET_MORE_DATA);
+
+        if (status == NETWORK_READPACKET_DISCONNECTED)
+        {
+            _receiveFailed = true;
+        }
+    }
+    catch (const std::exception&)
+    {
+        _receiveFailed = true;
+    }
+    return !_receiveFailed;
+}
+
+int32_t NetworkConnection::ReceivePacket(NetworkPacket& packet)
 {
     size_t bytesRead = 0;
 
     // Read packet header.
-    auto& header = InboundPacket.Header;
-    if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+    auto& header = packet.Header;
+    if (packet.BytesTransferred < sizeof(packet.Header))
     {
-        const size_t missingLength = sizeof(header) - InboundPacket.BytesTransferred;
+        const size_t missingLength = sizeof(header) - packet.BytesTransferred;
 
-        uint8_t* buffer = reinterpret_cast<uint8_t*>(&InboundPacket.Header);
+        uint8_t* buffer = reinterpret_cast<uint8_t*>(&packet.Header);
 
         NETWORK_READPACKET status = Socket->ReceiveData(buffer, missingLength, &bytesRead);
         if (status != NETWORK_READPACKET_SUCCESS)
@@ -48,8 +117,8 @@ int32_t NetworkConnection::ReadPacket()
             return status;
         }
 
-        InboundPacket.BytesTransferred += bytesRead;
-        if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+        packet.BytesTransferred += bytesRead;
+        if (packet.BytesTransferred < sizeof(packet.Header))
         {
             // If still not enough data for header, keep waiting.
             return NETWORK_READPACKET_MORE_DATA;
@@ -68,7 +137,7 @@ int32_t NetworkConnection::ReadPacket()
 
     // Read packet body.
     {
-        const size_t missingLength = header.Size - (InboundPacket.BytesTransferred - sizeof(header));
+        const size_t missingLength = header.Size - (packet.BytesTransferred - sizeof(header));
 
         uint8_t buffer[NetworkBufferSize];
 
@@ -80,17 +149,15 @@ int32_t NetworkConnection::ReadPacket()
                 return status;
             }
 
-            InboundPacket.BytesTransferred += bytesRead;
-            InboundPacket.Write(buffer, bytesRead);
+            packet.BytesTransferred += bytesRead;
+            packet.Write(buffer, bytesRead);
         }
 
-        if (InboundPacket.Data.size() == header.Size)
+        if (packet.Data.size() == header.Size)
         {
             // Received complete packet.
             _lastPacketTime = platform_get_ticks();
 
-            RecordPacketStats(InboundPacket, false);
-
             return NETWORK_READPACKET_SUCCESS;
         }
     }
@@ -98,42 +165,80 @@ int32_t NetworkConnection::ReadPacket()
     return NETWORK_READPACKET_MORE_DATA;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+bool NetworkConnection::WritePackets(std::deque<OutboundPacket>& packets, bool recordStats)
 {
-    auto header = packet.Header;
-
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
+    constexpr size_t maxPackets = SOCKET_MAX_SEND_BUFFERS / 2;
+    while (!packets.empty())
+    {
+        // Gather the header and data of the first few packets, without what was sent of the first one already
+        std::array<SocketBuffer, SOCKET_MAX_SEND_BUFFERS> buffers;
+        size_t numPackets = std::min(packets.size(), maxPackets);
+        size_t numBuffers = 0;
+        size_t totalSize = 0;
+        for (size_t i = 0; i < numPackets; i++)
+        {
+            const auto& packet = packets[i];
+            const auto& buffer = *packet.Buffer;
+            size_t skip = packet.BytesTransferred;
+            if (skip < sizeof(PacketHeader))
+            {
+                buffers[numBuffers++] = { reinterpret_cast<const uint8_t*>(&buffer.WireHeader) + skip,
+                                          sizeof(PacketHeader) - skip };
+                skip = 0;
+            }
+            else
+            {
+                skip -= sizeof(PacketHeader);
+            }
+            if (skip < buffer.Data.size())
+            {
+                buffers[numBuffers++] = { buffer.Data.data() + skip, buffer.Data.size() - skip };
+            }
+            totalSize += buffer.GetSize() - packet.BytesTransferred;
+        }
 
-    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
-    // Previously the Id field was not part of the header rather part of the body.
-    header.Size += sizeof(header.Id);
-    header.Size = Convert::HostToNetwork(header.Size);
-    header.Id = ByteSwapBE(header.Id);
+        size_t sent = Socket->SendData(buffers.data(), numBuffers);
+        bool sentAll = sent == totalSize;
 
-    buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
-    buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
+        // Drop the packets that were sent completely and remember how far the next one got
+        while (sent > 0)
+        {
+            auto& packet = packets.front();
+            size_t remaining = packet.Buffer->GetSize() - packet.BytesTransferred;
+            if (sent < remaining)
+            {
+                packet.BytesTransferred += sent;
+                break;
+            }
+            sent -= remaining;
+            if (recordStats)
+            {
+                RecordPacketStats(packet.Buffer->Command, packet.Buffer->GetSize(), true);
+            }
+            packets.pop_front();
+        }
 
-    size_t bufferSize = buffer.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer.data() + packet.BytesTransferred, bufferSize);
-    if (sent > 0)
-    {
-        packet.BytesTransferred += sent;
+        if (!sentAll)
+        {
+            return false;
+        }
     }
+    return true;
+}
 
-    bool sendComplete = packet.BytesTransferred == buffer.size();
-    if (sendComplete)
+void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
+{
+    if (AuthStatus == NETWORK_AUTH_OK || !packet.CommandRequiresAuth())
     {
-        RecordPacketStats(packet, true);
+        QueuePacket(NetworkPacketBuffer::Create(std::move(packet)), front);
     }
-    return sendComplete;
 }
 
-void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
+void NetworkConnection::QueuePacket(const std::shared_ptr<const NetworkPacketBuffer>& buffer, bool front)
 {
-    if (AuthStatus == NETWORK_AUTH_OK || !packet.CommandRequiresAuth())
+    if (AuthStatus == NETWORK_AUTH_OK || !NetworkPacket::CommandRequiresAuth(buffer->Command))
     {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
+        OutboundPacket packet{ buffer };
         if (front)
         {
             // If the first packet was already partially sent add new packet to second position
@@ -157,9 +262,41 @@ void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
 
 void NetworkConnection::SendQueuedPackets()
 {
-    while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
+    if (_ioThread != nullptr)
+    {
+        if (!_outboundPackets.empty())
+        {
+            for (auto& packet : _outboundPackets)
+            {
+                RecordPacketStats(packet.Buffer->Command, packet.Buffer->GetSize(), true);
+                _packetsToSend.Push(std::move(packet));
+            }
+            _outboundPackets.clear();
+            _ioThread->NotifyPacketsQueued(*this);
+        }
+        return;
+    }
+
+    WritePackets(_outboundPackets, true);
+}
+
+bool NetworkConnection::SendPackets()
+{
+    OutboundPacket packet;
+    while (_packetsToSend.TryPop(packet))
+    {
+        _sendingPackets.push_back(std::move(packet));
+    }
+
+    try
+    {
+        return WritePackets(_sendingPackets, false);
+    }
+    catch (const std::exception&)
     {
-        _outboundPackets.pop_front();
+        // The connection is gone, the game thread finds out when reading from it
+        _sendingPackets.clear();
+        return true;
     }
 }
 
@@ -207,12 +344,12 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
     SetLastDisconnectReason(buffer);
 }
 
-void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
+void NetworkConnection::RecordPacketStats(NetworkCommand command, size_t size, bool sending)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
+    uint32_t packetSize = static_cast<uint32_t>(size);
     uint32_t trafficGroup;
 
-    switch (packet.GetCommand())
+    switch (command)
     {
         case NetworkCommand::GameAction:
             trafficGroup = NETWORK_STATISTICS_GROUP_COMMANDS;
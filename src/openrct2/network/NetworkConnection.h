@@ -11,15 +11,18 @@
 
 #ifndef DISABLE_NETWORK
 #    include "../common.h"
+#    include "../core/SpscQueue.h"
 #    include "NetworkKey.h"
 #    include "NetworkPacket.h"
 #    include "NetworkTypes.h"
 #    include "Socket.h"
 
+#    include <atomic>
 #    include <deque>
 #    include <memory>
 #    include <vector>
 
+class NetworkIOThread;
 class NetworkPlayer;
 struct ObjectRepositoryItem;
 
@@ -40,15 +43,27 @@ public:
     NetworkConnection();
     ~NetworkConnection();
 
+    /**
+     * Hands the socket over to the network thread. ReadPacket then takes the packets it received and
+     * SendQueuedPackets hands the queued packets to it.
+     */
+    void AttachToNetworkThread(NetworkIOThread& ioThread);
+
     int32_t ReadPacket();
     void QueuePacket(NetworkPacket&& packet, bool front = false);
-    void QueuePacket(const NetworkPacket& packet, bool front = false)
-    {
-        auto copy = packet;
-        return QueuePacket(std::move(copy), front);
-    }
+
+    /**
+     * Queues a packet that may be queued for other connections as well, the buffer is shared rather than copied.
+     */
+    void QueuePacket(const std::shared_ptr<const NetworkPacketBuffer>& buffer, bool front = false);
 
     void SendQueuedPackets();
+
+    // Called on the network thread. ReceivePackets returns false once the connection is closed, SendPackets returns
+    // false when the socket did not take all packets.
+    bool ReceivePackets();
+    bool SendPackets();
+
     void ResetLastPacketTime();
     bool ReceivedPacketRecently();
 
@@ -57,12 +72,30 @@ public:
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
 private:
-    std::deque<NetworkPacket> _outboundPackets;
-    uint32_t _lastPacketTime = 0;
+    // Each connection tracks how much of a shared packet it has sent itself
+    struct OutboundPacket
+    {
+        std::shared_ptr<const NetworkPacketBuffer> Buffer;
+        size_t BytesTransferred = 0;
+    };
+
+    std::deque<OutboundPacket> _outboundPackets;
+    std::atomic<uint32_t> _lastPacketTime{ 0 };
     utf8* _lastDisconnectReason = nullptr;
 
-    void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    // Packets handed between the game thread and the network thread
+    NetworkIOThread* _ioThread = nullptr;
+    SpscQueue<NetworkPacket> _receivedPackets;
+    SpscQueue<OutboundPacket> _packetsToSend;
+    std::atomic_bool _receiveFailed{ false };
+
+    // Only used by the network thread
+    NetworkPacket _receivingPacket;
+    std::deque<OutboundPacket> _sendingPackets;
+
+    void RecordPacketStats(NetworkCommand command, size_t size, bool sending);
+    int32_t ReceivePacket(NetworkPacket& packet);
+    bool WritePackets(std::deque<OutboundPacket>& packets, bool recordStats);
 };
 
 #endif // DISABLE_NETWORK
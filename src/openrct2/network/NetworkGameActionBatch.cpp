@@ -0,0 +1,226 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkGameActionBatch.h"
+
+#    include "../util/Util.h"
+#    include "zlib.h"
+
+#    include <unordered_map>
+#    include <vector>
+
+enum : uint8_t
+{
+    BATCH_FLAG_COMPRESSED = 1 << 0,
+};
+
+enum : uint8_t
+{
+    ACTION_ENCODING_RAW,
+    ACTION_ENCODING_DELTA,
+};
+
+// Keeps the uncompressed payload readable through a NetworkPacket, whose size is limited to 16 bits
+constexpr size_t MAX_PAYLOAD_SIZE = 32 * 1024;
+
+// Smaller payloads do not gain enough from compression to be worth it
+constexpr size_t MIN_COMPRESS_SIZE = 256;
+
+// Tick, type, encoding and length
+constexpr size_t ACTION_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t);
+
+bool NetworkGameActionBatch::IsEmpty() const
+{
+    return _actions.empty();
+}
+
+void NetworkGameActionBatch::Add(uint32_t tick, uint32_t type, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    _actions.push_back({ tick, type, std::vector<uint8_t>(bytes, bytes + size) });
+}
+
+void NetworkGameActionBatch::Clear()
+{
+    _actions.clear();
+}
+
+std::vector<NetworkPacket> NetworkGameActionBatch::TakePackets()
+{
+    std::vector<NetworkPacket> packets;
+    size_t begin = 0;
+    while (begin < _actions.size())
+    {
+        // Fill the packet up to the payload limit, it always takes at least one action
+        size_t end = begin + 1;
+        size_t payloadSize = sizeof(uint16_t) + ACTION_HEADER_SIZE + _actions[begin].Data.size();
+        while (end < _actions.size() && payloadSize + ACTION_HEADER_SIZE + _actions[end].Data.size() <= MAX_PAYLOAD_SIZE)
+        {
+            payloadSize += ACTION_HEADER_SIZE + _actions[end].Data.size();
+            end++;
+        }
+
+        if (end - begin == 1)
+        {
+            const auto& action = _actions[begin];
+            NetworkPacket packet(NetworkCommand::GameAction);
+            packet << action.Tick << action.Type;
+            packet.Write(action.Data.data(), action.Data.size());
+            packets.push_back(std::move(packet));
+        }
+        else
+        {
+            packets.push_back(CreateBatchPacket(begin, end));
+        }
+        begin = end;
+    }
+    _actions.clear();
+    return packets;
+}
+
+NetworkPacket NetworkGameActionBatch::CreateBatchPacket(size_t begin, size_t end) const
+{
+    // The payload is written through a packet as well so it uses the same byte order
+    NetworkPacket payload;
+    payload << static_cast<uint16_t>(end - begin);
+
+    std::unordered_map<uint32_t, const Action*> previousOfType;
+    for (size_t i = begin; i < end; i++)
+    {
+        const auto& action = _actions[i];
+        payload << action.Tick << action.Type;
+
+        // Consecutive actions of a tool mostly differ in a few coordinates, the differences compress a lot better
+        auto previous = previousOfType[action.Type];
+        if (previous != nullptr && previous->Data.size() == action.Data.size())
+        {
+            std::vector<uint8_t> delta(action.Data.size());
+            for (size_t j = 0; j < delta.size(); j++)
+            {
+                delta[j] = static_cast<uint8_t>(action.Data[j] - previous->Data[j]);
+            }
+            payload << static_cast<uint8_t>(ACTION_ENCODING_DELTA) << static_cast<uint32_t>(delta.size());
+            payload.Write(delta.data(), delta.size());
+        }
+        else
+        {
+            payload << static_cast<uint8_t>(ACTION_ENCODING_RAW) << static_cast<uint32_t>(action.Data.size());
+            payload.Write(action.Data.data(), action.Data.size());
+        }
+        previousOfType[action.Type] = &action;
+    }
+
+    NetworkPacket packet(NetworkCommand::GameActionBatch);
+    if (payload.Data.size() >= MIN_COMPRESS_SIZE)
+    {
+        auto compressed = util_zlib_deflate(payload.Data.data(), payload.Data.size());
+        if (compressed.has_value() && compressed->size() < payload.Data.size())
+        {
+            packet << static_cast<uint8_t>(BATCH_FLAG_COMPRESSED) << static_cast<uint32_t>(payload.Data.size());
+            packet.Write(compressed->data(), compressed->size());
+            return packet;
+        }
+    }
+    packet << static_cast<uint8_t>(0) << static_cast<uint32_t>(payload.Data.size());
+    packet.Write(payload.Data.data(), payload.Data.size());
+    return packet;
+}
+
+bool NetworkGameActionBatch::Read(NetworkPacket& packet, std::vector<Action>& actions)
+{
+    uint8_t flags;
+    uint32_t payloadSize;
+    if (packet.Header.Size - packet.BytesRead < sizeof(flags) + sizeof(payloadSize))
+    {
+        return false;
+    }
+    packet >> flags >> payloadSize;
+    if (payloadSize > MAX_PAYLOAD_SIZE)
+    {
+        return false;
+    }
+
+    const size_t size = packet.Header.Size - packet.BytesRead;
+    auto data = size > 0 ? packet.Read(size) : nullptr;
+    NetworkPacket payload;
+    if (flags & BATCH_FLAG_COMPRESSED)
+    {
+        // The payload size is already known, anything that does not inflate to exactly that size is rejected
+        // before it can make the buffer grow.
+        std::vector<uint8_t> inflated(payloadSize);
+        uLongf inflatedSize = static_cast<uLongf>(inflated.size());
+        if (data == nullptr || payloadSize == 0
+            || uncompress(inflated.data(), &inflatedSize, data, static_cast<uLong>(size)) != Z_OK)
+        {
+            return false;
+        }
+        payload.Write(inflated.data(), inflatedSize);
+    }
+    else if (data != nullptr)
+    {
+        payload.Write(data, size);
+    }
+    if (payload.Data.size() != payloadSize)
+    {
+        return false;
+    }
+    payload.Header.Size = static_cast<uint16_t>(payload.Data.size());
+
+    uint16_t count;
+    payload >> count;
+    const size_t firstAction = actions.size();
+    std::unordered_map<uint32_t, size_t> previousOfType;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (payload.Header.Size - payload.BytesRead < ACTION_HEADER_SIZE)
+        {
+            return false;
+        }
+
+        Action action;
+        uint8_t encoding;
+        uint32_t length;
+        payload >> action.Tick >> action.Type >> encoding >> length;
+        if (length > payload.Header.Size - payload.BytesRead)
+        {
+            return false;
+        }
+        if (length > 0)
+        {
+            auto bytes = payload.Read(length);
+            action.Data.assign(bytes, bytes + length);
+        }
+
+        if (encoding == ACTION_ENCODING_DELTA)
+        {
+            auto it = previousOfType.find(action.Type);
+            if (it == previousOfType.end() || actions[it->second].Data.size() != length)
+            {
+                return false;
+            }
+            const auto& previous = actions[it->second].Data;
+            for (size_t j = 0; j < length; j++)
+            {
+                action.Data[j] += previous[j];
+            }
+        }
+        else if (encoding != ACTION_ENCODING_RAW)
+        {
+            return false;
+        }
+
+        previousOfType[action.Type] = firstAction + i;
+        actions.push_back(std::move(action));
+    }
+    return true;
+}
+
+#endif // DISABLE_NETWORK
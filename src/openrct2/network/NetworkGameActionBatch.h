@@ -0,0 +1,55 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+
+#    include "../common.h"
+#    include "NetworkPacket.h"
+
+#    include <vector>
+
+/**
+ * Collects the game actions sent during a tick, so that tools placing hundreds of them at once send a few packets
+ * rather than one per action. The parameters of an action are delta encoded against the previous action of the same
+ * type and larger batches are compressed.
+ */
+class NetworkGameActionBatch final
+{
+public:
+    struct Action
+    {
+        uint32_t Tick = 0;
+        uint32_t Type = 0;
+        std::vector<uint8_t> Data;
+    };
+
+    bool IsEmpty() const;
+    void Add(uint32_t tick, uint32_t type, const void* data, size_t size);
+    void Clear();
+
+    /**
+     * Creates the packets for the collected actions and clears the batch. A single action is sent as a plain
+     * NetworkCommand::GameAction packet.
+     */
+    std::vector<NetworkPacket> TakePackets();
+
+    /**
+     * Reads the actions of a NetworkCommand::GameActionBatch packet, returns false if the packet is malformed.
+     */
+    static bool Read(NetworkPacket& packet, std::vector<Action>& actions);
+
+private:
+    std::vector<Action> _actions;
+
+    NetworkPacket CreateBatchPacket(size_t begin, size_t end) const;
+};
+
+#endif // DISABLE_NETWORK
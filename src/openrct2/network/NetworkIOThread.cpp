@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkIOThread.h"
+
+#    include "NetworkConnection.h"
+#    include "Socket.h"
+
+#    include <array>
+
+// Wake up regularly even without events, so a missed wake up can not stall the thread
+constexpr int32_t POLL_TIMEOUT_MS = 1000;
+
+std::unique_ptr<NetworkIOThread> NetworkIOThread::Create()
+{
+    auto poller = CreateSocketPoller();
+    if (poller == nullptr)
+    {
+        return nullptr;
+    }
+    return std::make_unique<NetworkIOThread>(std::move(poller));
+}
+
+NetworkIOThread::NetworkIOThread(std::unique_ptr<ISocketPoller>&& poller)
+    : _poller(std::move(poller))
+{
+    _thread = std::thread([this]() { Run(); });
+}
+
+NetworkIOThread::~NetworkIOThread()
+{
+    _shouldStop = true;
+    _poller->Wake();
+    _thread.join();
+}
+
+void NetworkIOThread::Add(NetworkConnection& connection)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _connections.emplace(&connection, ConnectionState());
+    _poller->Add(*connection.Socket, &connection);
+}
+
+void NetworkIOThread::Remove(NetworkConnection& connection)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _connections.find(&connection);
+    if (it != _connections.end())
+    {
+        if (!it->second.Closed)
+        {
+            _poller->Remove(*connection.Socket);
+        }
+        _connections.erase(it);
+    }
+}
+
+void NetworkIOThread::NotifyPacketsQueued(NetworkConnection& connection)
+{
+    _connectionsToSend.Push(&connection);
+
+    // Only wake the thread for the first connection since it last looked
+    if (!_notified.exchange(true))
+    {
+        _poller->Wake();
+    }
+}
+
+void NetworkIOThread::Run()
+{
+    std::array<SocketPollEvent, 64> events;
+    while (!_shouldStop)
+    {
+        size_t numEvents = _poller->Wait(events.data(), events.size(), POLL_TIMEOUT_MS);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < numEvents; i++)
+        {
+            // Connections removed while waiting are skipped
+            auto it = _connections.find(static_cast<NetworkConnection*>(events[i].UserData));
+            if (it == _connections.end())
+            {
+                continue;
+            }
+            if (events[i].Readable)
+            {
+                Receive(*it);
+            }
+            if (events[i].Writable)
+            {
+                Send(*it);
+            }
+        }
+
+        // Acquires the pushes of every notify that found the flag set and skipped the wake, so they are drained below
+        _notified.exchange(false, std::memory_order_acq_rel);
+        NetworkConnection* connection;
+        while (_connectionsToSend.TryPop(connection))
+        {
+            auto it = _connections.find(connection);
+            if (it != _connections.end())
+            {
+                Send(*it);
+            }
+        }
+    }
+}
+
+void NetworkIOThread::Receive(ConnectionMap::value_type& connection)
+{
+    auto& state = connection.second;
+    if (!state.Closed && !connection.first->ReceivePackets())
+    {
+        // Stop polling the socket, it would keep reporting the closed connection until the game thread removes it
+        state.Closed = true;
+        _poller->Remove(*connection.first->Socket);
+    }
+}
+
+void NetworkIOThread::Send(ConnectionMap::value_type& connection)
+{
+    auto& state = connection.second;
+    if (state.Closed)
+    {
+        return;
+    }
+
+    // Wait for the socket to become writable again if it did not take everything
+    bool watchWritable = !connection.first->SendPackets();
+    if (watchWritable != state.WatchWritable)
+    {
+        state.WatchWritable = watchWritable;
+        _poller->SetWatchWritable(*connection.first->Socket, connection.first, watchWritable);
+    }
+}
+
+#endif // DISABLE_NETWORK
@@ -0,0 +1,78 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+
+#    include "../common.h"
+#    include "../core/SpscQueue.h"
+
+#    include <atomic>
+#    include <memory>
+#    include <mutex>
+#    include <thread>
+#    include <unordered_map>
+
+class NetworkConnection;
+struct ISocketPoller;
+
+/**
+ * Reads and writes the sockets of the connections attached to it on a thread of its own, waiting for all of them at
+ * once. The game thread only takes the received packets and hands over the packets to send, see NetworkConnection.
+ */
+class NetworkIOThread final
+{
+public:
+    /**
+     * Returns nullptr when the platform has no socket poller, the connections are then polled by the game thread.
+     */
+    static std::unique_ptr<NetworkIOThread> Create();
+
+    explicit NetworkIOThread(std::unique_ptr<ISocketPoller>&& poller);
+    ~NetworkIOThread();
+
+    void Add(NetworkConnection& connection);
+
+    /**
+     * Once this returns, the network thread no longer touches the connection.
+     */
+    void Remove(NetworkConnection& connection);
+
+    /**
+     * Called from the game thread after packets were handed over to the connection.
+     */
+    void NotifyPacketsQueued(NetworkConnection& connection);
+
+private:
+    struct ConnectionState
+    {
+        bool WatchWritable = false;
+        bool Closed = false;
+    };
+
+    using ConnectionMap = std::unordered_map<NetworkConnection*, ConnectionState>;
+
+    std::unique_ptr<ISocketPoller> _poller;
+
+    // Held by the network thread while it services connections, so they can not be removed at the same time
+    std::mutex _mutex;
+    ConnectionMap _connections;
+
+    SpscQueue<NetworkConnection*> _connectionsToSend;
+    std::atomic_bool _notified{ false };
+    std::atomic_bool _shouldStop{ false };
+    std::thread _thread;
+
+    void Run();
+    void Receive(ConnectionMap::value_type& connection);
+    void Send(ConnectionMap::value_type& connection);
+};
+
+#endif // DISABLE_NETWORK
@@ -12,6 +12,7 @@
 #    include "NetworkPacket.h"
 
 #    include "NetworkTypes.h"
+#    include "Socket.h"
 
 #    include <memory>
 
@@ -44,7 +45,12 @@ void NetworkPacket::Clear()
 
 bool NetworkPacket::CommandRequiresAuth()
 {
-    switch (GetCommand())
+    return CommandRequiresAuth(GetCommand());
+}
+
+bool NetworkPacket::CommandRequiresAuth(NetworkCommand command)
+{
+    switch (command)
     {
         case NetworkCommand::Ping:
         case NetworkCommand::Auth:
@@ -59,6 +65,19 @@ bool NetworkPacket::CommandRequiresAuth()
     }
 }
 
+std::shared_ptr<const NetworkPacketBuffer> NetworkPacketBuffer::Create(NetworkPacket&& packet)
+{
+    auto buffer = std::make_shared<NetworkPacketBuffer>();
+    buffer->Command = packet.GetCommand();
+
+    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
+    // Previously the Id field was not part of the header rather part of the body.
+    buffer->WireHeader.Size = Convert::HostToNetwork(static_cast<uint16_t>(packet.Data.size() + sizeof(PacketHeader::Id)));
+    buffer->WireHeader.Id = ByteSwapBE(buffer->Command);
+    buffer->Data = std::move(packet.Data);
+    return buffer;
+}
+
 void NetworkPacket::Write(const void* bytes, size_t size)
 {
     const uint8_t* src = reinterpret_cast<const uint8_t*>(bytes);
@@ -37,6 +37,7 @@ struct NetworkPacket final
 
     void Clear();
     bool CommandRequiresAuth();
+    static bool CommandRequiresAuth(NetworkCommand command);
 
     const uint8_t* Read(size_t size);
     const utf8* ReadString();
@@ -79,3 +80,24 @@ public:
     size_t BytesTransferred = 0;
     size_t BytesRead = 0;
 };
+
+/**
+ * A packet as it is sent over the wire. It is immutable once created, so a packet sent to several connections is only
+ * encoded once and shared by their send queues.
+ */
+struct NetworkPacketBuffer final
+{
+    NetworkCommand Command = NetworkCommand::Invalid;
+    PacketHeader WireHeader{};
+    std::vector<uint8_t> Data;
+
+    /**
+     * Takes over the data of the packet.
+     */
+    static std::shared_ptr<const NetworkPacketBuffer> Create(NetworkPacket&& packet);
+
+    size_t GetSize() const
+    {
+        return sizeof(WireHeader) + Data.size();
+    }
+};
@@ -22,6 +22,7 @@ enum
 enum
 {
     NETWORK_TICK_FLAG_CHECKSUMS = 1 << 0,
+    NETWORK_TICK_FLAG_STATE_HASH = 1 << 1,
 };
 
 enum
@@ -82,6 +83,7 @@ enum class NetworkCommand : uint32_t
     GameState,
     Scripts,
     Heartbeat,
+    GameActionBatch,
     Max,
     Invalid = static_cast<uint32_t>(-1),
 };
@@ -103,6 +105,22 @@ struct NetworkServerState_t
     bool gamestateSnapshotsEnabled = false;
 };
 
+enum NETWORK_MAP_FLAGS : uint8_t
+{
+    // The data is a compressed delta against a map the client already has
+    NETWORK_MAP_FLAG_DELTA = 1 << 0,
+    // The map is loaded once the data is complete, otherwise a delta against it follows
+    NETWORK_MAP_FLAG_LAST = 1 << 1,
+};
+
+// A map a client has from an earlier download, sent along with the map request.
+struct NetworkMapBase
+{
+    uint32_t id = 0;
+    uint32_t length = 0; // Bytes received of an interrupted download
+    bool complete = false;
+};
+
 // Structure is used for networking specific fields with meaning,
 // this structure can be used in combination with DataSerialiser
 // to provide extra details with template specialization.
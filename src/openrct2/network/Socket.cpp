@@ -9,6 +9,8 @@
 
 #ifndef DISABLE_NETWORK
 
+#    include <algorithm>
+#    include <array>
 #    include <atomic>
 #    include <chrono>
 #    include <cmath>
@@ -48,6 +50,12 @@
     #include <netinet/tcp.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+    #if defined(__linux__)
+        #include <sys/epoll.h>
+        #include <sys/eventfd.h>
+    #endif // defined(__linux__)
     #include "../common.h"
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
@@ -494,6 +502,46 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const SocketBuffer* buffers, size_t count) override
+    {
+        if (_status != SOCKET_STATUS_CONNECTED)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+        count = std::min(count, SOCKET_MAX_SEND_BUFFERS);
+#    ifdef _WIN32
+        std::array<WSABUF, SOCKET_MAX_SEND_BUFFERS> wsaBuffers;
+        for (size_t i = 0; i < count; i++)
+        {
+            wsaBuffers[i].buf = const_cast<char*>(static_cast<const char*>(buffers[i].Data));
+            wsaBuffers[i].len = static_cast<ULONG>(buffers[i].Size);
+        }
+        DWORD sentBytes = 0;
+        if (WSASend(_socket, wsaBuffers.data(), static_cast<DWORD>(count), &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR)
+        {
+            return 0;
+        }
+        return sentBytes;
+#    else
+        std::array<iovec, SOCKET_MAX_SEND_BUFFERS> iov;
+        for (size_t i = 0; i < count; i++)
+        {
+            iov[i].iov_base = const_cast<void*>(buffers[i].Data);
+            iov[i].iov_len = buffers[i].Size;
+        }
+        msghdr message{};
+        message.msg_iov = iov.data();
+        message.msg_iovlen = count;
+        auto sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+        if (sentBytes == SOCKET_ERROR)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(sentBytes);
+#    endif // _WIN32
+    }
+
     NETWORK_READPACKET ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SOCKET_STATUS_CONNECTED)
@@ -557,6 +605,11 @@ public:
         return _ipAddress;
     }
 
+    SOCKET GetHandle() const
+    {
+        return _socket;
+    }
+
 private:
     explicit TcpSocket(SOCKET socket, const std::string& hostName, const std::string& ipAddress)
     {
@@ -852,6 +905,126 @@ std::unique_ptr<IUdpSocket> CreateUdpSocket()
     return std::make_unique<UdpSocket>();
 }
 
+#    ifdef __linux__
+class SocketPoller final : public ISocketPoller
+{
+private:
+    static constexpr size_t MAX_EVENTS = 64;
+
+    int32_t _epoll = -1;
+    int32_t _wakeEvent = -1;
+
+public:
+    SocketPoller()
+    {
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+        _wakeEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_epoll == -1 || _wakeEvent == -1)
+        {
+            Dispose();
+            throw SocketException("Unable to create socket poller.");
+        }
+
+        // The wake event is the only one without user data
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;
+        epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeEvent, &ev);
+    }
+
+    ~SocketPoller() override
+    {
+        Dispose();
+    }
+
+    void Add(ITcpSocket& socket, void* userData) override
+    {
+        Control(EPOLL_CTL_ADD, socket, userData, false);
+    }
+
+    void Remove(ITcpSocket& socket) override
+    {
+        Control(EPOLL_CTL_DEL, socket, nullptr, false);
+    }
+
+    void SetWatchWritable(ITcpSocket& socket, void* userData, bool watch) override
+    {
+        Control(EPOLL_CTL_MOD, socket, userData, watch);
+    }
+
+    size_t Wait(SocketPollEvent* events, size_t maxEvents, int32_t timeoutMs) override
+    {
+        std::array<epoll_event, MAX_EVENTS> epollEvents;
+        int32_t count = epoll_wait(_epoll, epollEvents.data(), static_cast<int32_t>(std::min(maxEvents, MAX_EVENTS)), timeoutMs);
+
+        size_t numEvents = 0;
+        for (int32_t i = 0; i < count; i++)
+        {
+            const auto& ev = epollEvents[i];
+            if (ev.data.ptr == nullptr)
+            {
+                uint64_t value;
+                [[maybe_unused]] auto readBytes = read(_wakeEvent, &value, sizeof(value));
+                continue;
+            }
+            events[numEvents].UserData = ev.data.ptr;
+            events[numEvents].Readable = (ev.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+            events[numEvents].Writable = (ev.events & EPOLLOUT) != 0;
+            numEvents++;
+        }
+        return numEvents;
+    }
+
+    void Wake() override
+    {
+        uint64_t value = 1;
+        [[maybe_unused]] auto writtenBytes = write(_wakeEvent, &value, sizeof(value));
+    }
+
+private:
+    void Control(int32_t operation, ITcpSocket& socket, void* userData, bool watchWritable)
+    {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        if (watchWritable)
+        {
+            ev.events |= EPOLLOUT;
+        }
+        ev.data.ptr = userData;
+        epoll_ctl(_epoll, operation, static_cast<TcpSocket&>(socket).GetHandle(), &ev);
+    }
+
+    void Dispose()
+    {
+        if (_wakeEvent != -1)
+        {
+            close(_wakeEvent);
+            _wakeEvent = -1;
+        }
+        if (_epoll != -1)
+        {
+            close(_epoll);
+            _epoll = -1;
+        }
+    }
+};
+#    endif // __linux__
+
+std::unique_ptr<ISocketPoller> CreateSocketPoller()
+{
+#    ifdef __linux__
+    try
+    {
+        return std::make_unique<SocketPoller>();
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("%s", e.what());
+    }
+#    endif // __linux__
+    return nullptr;
+}
+
 #    ifdef _WIN32
 static std::vector<INTERFACE_INFO> GetNetworkInterfaces()
 {
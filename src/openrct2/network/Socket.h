@@ -44,6 +44,18 @@ struct INetworkEndpoint
     virtual std::string GetHostname() const abstract;
 };
 
+// The most buffers ITcpSocket::SendData sends at once
+constexpr size_t SOCKET_MAX_SEND_BUFFERS = 64;
+
+/**
+ * A range of bytes to send, several of them can be sent with a single call.
+ */
+struct SocketBuffer
+{
+    const void* Data;
+    size_t Size;
+};
+
 /**
  * Represents a TCP socket / connection or listener.
  */
@@ -65,12 +77,42 @@ public:
     virtual void ConnectAsync(const std::string& address, uint16_t port) abstract;
 
     virtual size_t SendData(const void* buffer, size_t size) abstract;
+    /**
+     * Sends the buffers one after another with a single system call, returns how many bytes the socket took.
+     */
+    virtual size_t SendData(const SocketBuffer* buffers, size_t count) abstract;
     virtual NETWORK_READPACKET ReceiveData(void* buffer, size_t size, size_t* sizeReceived) abstract;
 
     virtual void Disconnect() abstract;
     virtual void Close() abstract;
 };
 
+struct SocketPollEvent
+{
+    void* UserData;
+    bool Readable; // Also set when the connection was closed or failed
+    bool Writable;
+};
+
+/**
+ * Waits for events on many TCP sockets at once, so a single thread can serve all of them.
+ */
+struct ISocketPoller
+{
+public:
+    virtual ~ISocketPoller() = default;
+
+    virtual void Add(ITcpSocket& socket, void* userData) abstract;
+    virtual void Remove(ITcpSocket& socket) abstract;
+    virtual void SetWatchWritable(ITcpSocket& socket, void* userData, bool watch) abstract;
+
+    /**
+     * Waits until a socket is ready or Wake is called, returns the number of events written.
+     */
+    virtual size_t Wait(SocketPollEvent* events, size_t maxEvents, int32_t timeoutMs) abstract;
+    virtual void Wake() abstract;
+};
+
 /**
  * Represents a UDP socket / listener.
  */
@@ -98,6 +140,8 @@ bool InitialiseWSA();
 void DisposeWSA();
 std::unique_ptr<ITcpSocket> CreateTcpSocket();
 std::unique_ptr<IUdpSocket> CreateUdpSocket();
+// Returns nullptr on platforms without a poller, sockets have to be polled one by one there
+std::unique_ptr<ISocketPoller> CreateSocketPoller();
 std::vector<std::unique_ptr<INetworkEndpoint>> GetBroadcastAddresses();
 
 namespace Convert
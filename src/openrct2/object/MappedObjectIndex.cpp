@@ -0,0 +1,322 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MappedObjectIndex.h"
+
+#include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/FileStream.hpp"
+#include "../core/MemoryMappedFile.h"
+#include "../core/Path.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+static constexpr uint32_t MAGIC_NUMBER = 0x4D44494F; // OIDM
+
+// Increment this to force a rebuild of the index
+static constexpr uint16_t VERSION = 1;
+
+static constexpr uint32_t BUCKET_EMPTY = UINT32_MAX;
+
+static uint32_t GetEntryHash(const rct_object_entry& entry)
+{
+    // FNV-1a over the name, which is all an object is looked up by
+    uint32_t hash = 2166136261;
+    for (auto ch : entry.name)
+    {
+        hash ^= static_cast<uint8_t>(ch);
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+static bool StatsEqual(const MappedObjectIndex::DirectoryStats& a, const MappedObjectIndex::DirectoryStats& b)
+{
+    return a.TotalFiles == b.TotalFiles && a.TotalFileSize == b.TotalFileSize
+        && a.FileDateModifiedChecksum == b.FileDateModifiedChecksum && a.PathChecksum == b.PathChecksum;
+}
+
+/**
+ * Collects the strings and lists of the records, strings shared by several objects such as authors are stored once.
+ */
+class ObjectIndexDataWriter final
+{
+private:
+    std::vector<uint8_t> _data;
+    std::unordered_map<std::string, uint32_t> _strings;
+
+public:
+    const std::vector<uint8_t>& GetData() const
+    {
+        return _data;
+    }
+
+    uint32_t WriteString(const std::string& value)
+    {
+        auto it = _strings.find(value);
+        if (it != _strings.end())
+        {
+            return it->second;
+        }
+        auto offset = WriteBytes(value.c_str(), value.size() + 1);
+        _strings.emplace(value, offset);
+        return offset;
+    }
+
+    uint32_t WriteBytes(const void* data, size_t size)
+    {
+        auto offset = static_cast<uint32_t>(_data.size());
+        auto bytes = static_cast<const uint8_t*>(data);
+        _data.insert(_data.end(), bytes, bytes + size);
+        return offset;
+    }
+};
+
+MappedObjectIndex::MappedObjectIndex() = default;
+MappedObjectIndex::~MappedObjectIndex() = default;
+
+void MappedObjectIndex::Write(
+    const std::string& path, int32_t language, const DirectoryStats& stats, const std::vector<ObjectRepositoryItem>& items)
+{
+    // Twice as many buckets as items keeps the chains short
+    uint32_t numBuckets = 1;
+    while (numBuckets < items.size() * 2)
+    {
+        numBuckets *= 2;
+    }
+
+    std::vector<Record> records(items.size());
+    std::vector<uint32_t> buckets(numBuckets, BUCKET_EMPTY);
+    ObjectIndexDataWriter dataWriter;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const auto& item = items[i];
+        auto& record = records[i];
+        record.ObjectEntry = item.ObjectEntry;
+        record.Path = dataWriter.WriteString(item.Path);
+        record.Name = dataWriter.WriteString(item.Name);
+
+        std::vector<uint32_t> authors;
+        for (const auto& author : item.Authors)
+        {
+            authors.push_back(dataWriter.WriteString(author));
+        }
+        record.NumAuthors = static_cast<uint8_t>(std::min<size_t>(authors.size(), UINT8_MAX));
+        record.Authors = dataWriter.WriteBytes(authors.data(), record.NumAuthors * sizeof(uint32_t));
+
+        record.NumSources = static_cast<uint8_t>(std::min<size_t>(item.Sources.size(), UINT8_MAX));
+        record.Sources = dataWriter.WriteBytes(item.Sources.data(), record.NumSources);
+
+        const auto& entries = item.SceneryGroupInfo.Entries;
+        record.NumSceneryGroupEntries = static_cast<uint16_t>(std::min<size_t>(entries.size(), UINT16_MAX));
+        record.SceneryGroupEntries = dataWriter.WriteBytes(
+            entries.data(), record.NumSceneryGroupEntries * sizeof(rct_object_entry));
+
+        record.RideFlags = item.RideInfo.RideFlags;
+        std::copy_n(item.RideInfo.RideCategory, MAX_CATEGORIES_PER_RIDE, record.RideCategory);
+        std::copy_n(item.RideInfo.RideType, MAX_RIDE_TYPES_PER_RIDE_ENTRY, record.RideType);
+
+        auto& bucket = buckets[GetEntryHash(item.ObjectEntry) & (numBuckets - 1)];
+        record.NextInBucket = bucket;
+        bucket = static_cast<uint32_t>(i);
+    }
+
+    Header header;
+    header.MagicNumber = MAGIC_NUMBER;
+    header.Version = VERSION;
+    header.LanguageId = static_cast<uint16_t>(language);
+    header.Stats = stats;
+    header.NumItems = static_cast<uint32_t>(items.size());
+    header.NumBuckets = numBuckets;
+    header.DataSize = static_cast<uint32_t>(dataWriter.GetData().size());
+
+    // Write a new file and move it over the old one, which may still be mapped by another instance of the game
+    log_verbose("MappedObjectIndex:Writing index: '%s'", path.c_str());
+    Path::CreateDirectory(Path::GetDirectory(path));
+    auto tempPath = path + ".tmp";
+    {
+        auto fs = OpenRCT2::FileStream(tempPath, OpenRCT2::FILE_MODE_WRITE);
+        fs.WriteValue(header);
+        if (!records.empty())
+        {
+            fs.Write(records.data(), records.size() * sizeof(Record));
+        }
+        fs.Write(buckets.data(), buckets.size() * sizeof(uint32_t));
+        if (!dataWriter.GetData().empty())
+        {
+            fs.Write(dataWriter.GetData().data(), dataWriter.GetData().size());
+        }
+    }
+    if (File::Exists(path))
+    {
+        File::Delete(path);
+    }
+    if (!File::Move(tempPath, path))
+    {
+        File::Delete(tempPath);
+        throw IOException("Unable to replace " + path);
+    }
+}
+
+bool MappedObjectIndex::Open(const std::string& path, int32_t language, const DirectoryStats& stats)
+{
+    Close();
+    if (!File::Exists(path))
+    {
+        return false;
+    }
+
+    try
+    {
+        log_verbose("MappedObjectIndex:Loading index: '%s'", path.c_str());
+        auto file = std::make_unique<MemoryMappedFile>(path);
+        if (file->GetLength() < sizeof(Header))
+        {
+            throw IOException("Index is truncated.");
+        }
+
+        Header header;
+        std::memcpy(&header, file->GetData(), sizeof(Header));
+        if (header.MagicNumber != MAGIC_NUMBER || header.Version != VERSION || header.LanguageId != language
+            || !StatsEqual(header.Stats, stats))
+        {
+            Console::WriteLine("object index out of date");
+            return false;
+        }
+
+        uint64_t expectedLength = sizeof(Header) + static_cast<uint64_t>(header.NumItems) * sizeof(Record)
+            + static_cast<uint64_t>(header.NumBuckets) * sizeof(uint32_t) + header.DataSize;
+        if (header.NumBuckets == 0 || (header.NumBuckets & (header.NumBuckets - 1)) != 0
+            || file->GetLength() != expectedLength)
+        {
+            throw IOException("Index is corrupt.");
+        }
+
+        _header = header;
+        _records = file->GetData() + sizeof(Header);
+        _buckets = _records + header.NumItems * sizeof(Record);
+        _data = _buckets + header.NumBuckets * sizeof(uint32_t);
+        _file = std::move(file);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to load index: '%s'.", path.c_str());
+        Console::Error::WriteLine("%s", e.what());
+        return false;
+    }
+}
+
+void MappedObjectIndex::Close()
+{
+    _file = nullptr;
+    _header = {};
+    _records = nullptr;
+    _buckets = nullptr;
+    _data = nullptr;
+}
+
+size_t MappedObjectIndex::GetNumItems() const
+{
+    return _header.NumItems;
+}
+
+std::optional<size_t> MappedObjectIndex::Find(const rct_object_entry& entry) const
+{
+    if (_file == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    uint32_t index;
+    auto bucket = GetEntryHash(entry) & (_header.NumBuckets - 1);
+    std::memcpy(&index, _buckets + bucket * sizeof(uint32_t), sizeof(uint32_t));
+
+    // A chain can not be longer than the number of items, unless the index is corrupt
+    for (uint32_t i = 0; i < _header.NumItems && index < _header.NumItems; i++)
+    {
+        auto record = GetRecord(index);
+        if (std::memcmp(record.ObjectEntry.name, entry.name, sizeof(entry.name)) == 0)
+        {
+            return index;
+        }
+        index = record.NextInBucket;
+    }
+    return std::nullopt;
+}
+
+void MappedObjectIndex::ReadItem(size_t index, ObjectRepositoryItem& item) const
+{
+    auto record = GetRecord(index);
+    item.Id = index;
+    item.ObjectEntry = record.ObjectEntry;
+    item.Path = GetString(record.Path);
+    item.Name = GetString(record.Name);
+
+    // Lists that do not fit in the data are left empty
+    item.Authors.clear();
+    if (IsInData(record.Authors, record.NumAuthors * sizeof(uint32_t)))
+    {
+        for (size_t i = 0; i < record.NumAuthors; i++)
+        {
+            uint32_t author;
+            std::memcpy(&author, _data + record.Authors + i * sizeof(uint32_t), sizeof(uint32_t));
+            item.Authors.push_back(GetString(author));
+        }
+    }
+
+    item.Sources.clear();
+    if (IsInData(record.Sources, record.NumSources))
+    {
+        item.Sources.assign(_data + record.Sources, _data + record.Sources + record.NumSources);
+    }
+
+    item.SceneryGroupInfo.Entries.clear();
+    if (record.NumSceneryGroupEntries > 0
+        && IsInData(record.SceneryGroupEntries, record.NumSceneryGroupEntries * sizeof(rct_object_entry)))
+    {
+        item.SceneryGroupInfo.Entries.resize(record.NumSceneryGroupEntries);
+        std::memcpy(
+            item.SceneryGroupInfo.Entries.data(), _data + record.SceneryGroupEntries,
+            record.NumSceneryGroupEntries * sizeof(rct_object_entry));
+    }
+
+    item.RideInfo.RideFlags = record.RideFlags;
+    std::copy_n(record.RideCategory, MAX_CATEGORIES_PER_RIDE, item.RideInfo.RideCategory);
+    std::copy_n(record.RideType, MAX_RIDE_TYPES_PER_RIDE_ENTRY, item.RideInfo.RideType);
+}
+
+MappedObjectIndex::Record MappedObjectIndex::GetRecord(size_t index) const
+{
+    Record record;
+    std::memcpy(&record, _records + index * sizeof(Record), sizeof(Record));
+    return record;
+}
+
+std::string MappedObjectIndex::GetString(uint32_t offset) const
+{
+    if (offset >= _header.DataSize)
+    {
+        return {};
+    }
+    auto str = reinterpret_cast<const char*>(_data + offset);
+    auto end = static_cast<const char*>(std::memchr(str, '\0', _header.DataSize - offset));
+    if (end == nullptr)
+    {
+        return {};
+    }
+    return std::string(str, end);
+}
+
+bool MappedObjectIndex::IsInData(uint32_t offset, size_t size) const
+{
+    return offset <= _header.DataSize && size <= _header.DataSize - offset;
+}
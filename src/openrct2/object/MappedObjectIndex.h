@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../core/FileIndex.hpp"
+#include "ObjectRepository.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class MemoryMappedFile;
+
+/**
+ * The object index in a flat format that is read in place from a memory mapped file. Objects are looked up through
+ * hash buckets stored in the file, so opening the index only reads its header and an item is only read when it is
+ * needed.
+ */
+class MappedObjectIndex final
+{
+public:
+    using DirectoryStats = FileIndex<ObjectRepositoryItem>::DirectoryStats;
+
+private:
+    struct Header
+    {
+        uint32_t MagicNumber = 0;
+        uint16_t Version = 0;
+        uint16_t LanguageId = 0;
+        DirectoryStats Stats;
+        uint32_t NumItems = 0;
+        uint32_t NumBuckets = 0;
+        uint32_t DataSize = 0;
+    };
+
+    // Strings and lists are stored as offsets into the data that follows the records and buckets
+    struct Record
+    {
+        rct_object_entry ObjectEntry;
+        uint32_t NextInBucket;
+        uint32_t Path;
+        uint32_t Name;
+        uint32_t Authors;
+        uint32_t Sources;
+        uint32_t SceneryGroupEntries;
+        uint16_t NumSceneryGroupEntries;
+        uint8_t NumAuthors;
+        uint8_t NumSources;
+        uint8_t RideFlags;
+        uint8_t RideCategory[MAX_CATEGORIES_PER_RIDE];
+        uint8_t RideType[MAX_RIDE_TYPES_PER_RIDE_ENTRY];
+    };
+
+    std::unique_ptr<MemoryMappedFile> _file;
+    Header _header;
+    const uint8_t* _records = nullptr;
+    const uint8_t* _buckets = nullptr;
+    const uint8_t* _data = nullptr;
+
+public:
+    MappedObjectIndex();
+    ~MappedObjectIndex();
+
+    /**
+     * Writes an index of the given items, an item is found by its position in the list.
+     */
+    static void Write(
+        const std::string& path, int32_t language, const DirectoryStats& stats, const std::vector<ObjectRepositoryItem>& items);
+
+    /**
+     * Opens the index if it exists and was written for the given language and directories.
+     */
+    bool Open(const std::string& path, int32_t language, const DirectoryStats& stats);
+    void Close();
+
+    size_t GetNumItems() const;
+    std::optional<size_t> Find(const rct_object_entry& entry) const;
+
+    /**
+     * Reads an item from the index, the object loaded for the item is kept.
+     */
+    void ReadItem(size_t index, ObjectRepositoryItem& item) const;
+
+private:
+    Record GetRecord(size_t index) const;
+    std::string GetString(uint32_t offset) const;
+    bool IsInData(uint32_t offset, size_t size) const;
+};
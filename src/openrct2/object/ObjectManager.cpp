@@ -13,7 +13,9 @@
 #include "../ParkImporter.h"
 #include "../core/Console.hpp"
 #include "../core/Memory.hpp"
+#include "../core/TaskScheduler.h"
 #include "../localisation/StringIds.h"
+#include "../paint/PaintCache.h"
 #include "FootpathItemObject.h"
 #include "LargeSceneryObject.h"
 #include "Object.h"
@@ -28,7 +30,6 @@
 #include <array>
 #include <memory>
 #include <mutex>
-#include <thread>
 #include <unordered_set>
 
 class ObjectManager final : public IObjectManager
@@ -201,17 +202,28 @@ public:
 
     std::vector<const ObjectRepositoryItem*> GetPackableObjects() override
     {
+        // Only look up the loaded objects, the repository only reads the items of other objects when they are needed
         std::vector<const ObjectRepositoryItem*> objects;
-        size_t numObjects = _objectRepository.GetNumObjects();
-        for (size_t i = 0; i < numObjects; i++)
+        for (auto loadedObject : _loadedObjects)
         {
-            const ObjectRepositoryItem* item = &_objectRepository.GetObjects()[i];
-            if (item->LoadedObject != nullptr && IsObjectCustom(item) && item->LoadedObject->GetLegacyData() != nullptr
-                && !item->LoadedObject->IsJsonObject())
+            if (loadedObject == nullptr)
+            {
+                continue;
+            }
+
+            const ObjectRepositoryItem* item = _objectRepository.FindObject(loadedObject->GetObjectEntry());
+            if (item != nullptr && item->LoadedObject == loadedObject && IsObjectCustom(item)
+                && loadedObject->GetLegacyData() != nullptr && !loadedObject->IsJsonObject())
             {
                 objects.push_back(item);
             }
         }
+
+        // Keep the order of the repository, an object can be loaded in several slots
+        std::sort(objects.begin(), objects.end(), [](const ObjectRepositoryItem* a, const ObjectRepositoryItem* b) {
+            return a->Id < b->Id;
+        });
+        objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
         return objects;
     }
 
@@ -452,6 +464,9 @@ private:
         // HACK Scenery window will lose its tabs after changing the scenery group indexing
         //      for now just close it, but it will be better to later tell it to invalidate the tabs
         window_close_by_class(WC_SCENERY);
+
+        // Cached tile paint refers to the images of the objects that were loaded before.
+        paint_cache_invalidate_all();
     }
 
     ObjectEntryIndex GetPrimarySceneryGroupEntryIndex(Object* loadedObject)
@@ -555,26 +570,7 @@ private:
 
     template<typename T, typename TFunc> static void ParallelFor(const std::vector<T>& items, TFunc func)
     {
-        auto partitions = std::thread::hardware_concurrency();
-        auto partitionSize = (items.size() + (partitions - 1)) / partitions;
-        std::vector<std::thread> threads;
-        for (size_t n = 0; n < partitions; n++)
-        {
-            auto begin = n * partitionSize;
-            auto end = std::min(items.size(), begin + partitionSize);
-            threads.emplace_back(
-                [func](size_t pbegin, size_t pend) {
-                    for (size_t i = pbegin; i < pend; i++)
-                    {
-                        func(i);
-                    }
-                },
-                begin, end);
-        }
-        for (auto& t : threads)
-        {
-            t.join();
-        }
+        OpenRCT2::TaskScheduler::Get().ParallelFor(items.size(), func);
     }
 
     std::vector<Object*> LoadObjects(std::vector<const ObjectRepositoryItem*>& requiredObjects, size_t* outNewObjectsLoaded)
@@ -31,6 +31,7 @@
 #include "../scenario/ScenarioRepository.h"
 #include "../util/SawyerCoding.h"
 #include "../util/Util.h"
+#include "MappedObjectIndex.h"
 #include "Object.h"
 #include "ObjectFactory.h"
 #include "ObjectList.h"
@@ -39,6 +40,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -227,9 +229,15 @@ class ObjectRepository final : public IObjectRepository
 {
     std::shared_ptr<IPlatformEnvironment> const _env;
     ObjectFileIndex const _fileIndex;
-    std::vector<ObjectRepositoryItem> _items;
+    MappedObjectIndex _index;
     ObjectEntryMap _itemMap;
 
+    // Items of an opened index are only read from it once they are used
+    mutable std::vector<ObjectRepositoryItem> _items;
+    mutable std::vector<bool> _itemsRead;
+    mutable bool _allItemsRead = false;
+    mutable std::mutex _itemsMutex;
+
 public:
     explicit ObjectRepository(const std::shared_ptr<IPlatformEnvironment>& env)
         : _env(env)
@@ -245,16 +253,21 @@ public:
     void LoadOrConstruct(int32_t language) override
     {
         ClearItems();
-        auto items = _fileIndex.LoadOrBuild(language);
-        AddItems(items);
-        SortItems();
+        auto scanResult = _fileIndex.Scan();
+        if (_index.Open(GetIndexPath(), language, scanResult.Stats))
+        {
+            _items.resize(_index.GetNumItems());
+            _itemsRead.resize(_items.size(), false);
+        }
+        else
+        {
+            BuildIndex(language, scanResult);
+        }
     }
 
     void Construct(int32_t language) override
     {
-        auto items = _fileIndex.Rebuild(language);
-        AddItems(items);
-        SortItems();
+        BuildIndex(language, _fileIndex.Scan());
     }
 
     size_t GetNumObjects() const override
@@ -264,6 +277,15 @@ public:
 
     const ObjectRepositoryItem* GetObjects() const override
     {
+        std::lock_guard<std::mutex> lock(_itemsMutex);
+        if (!_allItemsRead)
+        {
+            for (size_t i = 0; i < _items.size(); i++)
+            {
+                ReadItem(i);
+            }
+            _allItemsRead = true;
+        }
         return _items.data();
     }
 
@@ -271,13 +293,7 @@ public:
     {
         rct_object_entry entry = {};
         entry.SetName(legacyIdentifier);
-
-        auto kvp = _itemMap.find(entry);
-        if (kvp != _itemMap.end())
-        {
-            return &_items[kvp->second];
-        }
-        return nullptr;
+        return FindObject(&entry);
     }
 
     const ObjectRepositoryItem* FindObject(const rct_object_entry* objectEntry) const override final
@@ -287,6 +303,14 @@ public:
         {
             return &_items[kvp->second];
         }
+
+        auto index = _index.Find(*objectEntry);
+        if (index.has_value())
+        {
+            std::lock_guard<std::mutex> lock(_itemsMutex);
+            ReadItem(*index);
+            return &_items[*index];
+        }
         return nullptr;
     }
 
@@ -406,9 +430,45 @@ public:
     }
 
 private:
+    std::string GetIndexPath() const
+    {
+        return _env->GetFilePath(PATHID::CACHE_OBJECTS);
+    }
+
+    void BuildIndex(int32_t language, const ObjectFileIndex::ScanResult& scanResult)
+    {
+        ClearItems();
+        auto items = _fileIndex.BuildItems(language, scanResult);
+        AddItems(items);
+        SortItems();
+
+        auto indexPath = GetIndexPath();
+        try
+        {
+            MappedObjectIndex::Write(indexPath, language, scanResult.Stats, _items);
+        }
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("Unable to save index: '%s'.", indexPath.c_str());
+            Console::Error::WriteLine("%s", e.what());
+        }
+    }
+
+    void ReadItem(size_t index) const
+    {
+        if (!_itemsRead[index])
+        {
+            _index.ReadItem(index, _items[index]);
+            _itemsRead[index] = true;
+        }
+    }
+
     void ClearItems()
     {
+        _index.Close();
         _items.clear();
+        _itemsRead.clear();
+        _allItemsRead = false;
         _itemMap.clear();
     }
 
@@ -458,6 +518,7 @@ private:
             auto copy = item;
             copy.Id = index;
             _items.push_back(copy);
+            _itemsRead.push_back(true);
             _itemMap[item.ObjectEntry] = index;
             return true;
         }
@@ -16,12 +16,16 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/LocalisationService.h"
 #include "../paint/Painter.h"
+#include "PaintCache.h"
 #include "sprite/Paint.Sprite.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -49,6 +53,7 @@ static constexpr const uint8_t BoundBoxDebugColours[] = {
 bool gShowDirtyVisuals;
 bool gPaintBoundingBoxes;
 bool gPaintBlockedTiles;
+PaintArrangeMethod gPaintArrangeMethod = PaintArrangeMethod::Indexed;
 
 static void paint_attached_ps(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t viewFlags);
 static void paint_ps_image_with_bounding_boxes(
@@ -56,6 +61,93 @@ static void paint_ps_image_with_bounding_boxes(
 static void paint_ps_image(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t imageId, int16_t x, int16_t y);
 static uint32_t paint_ps_colourify_image(uint32_t imageId, uint8_t spriteType, uint32_t viewFlags);
 
+namespace
+{
+    /**
+     * Shared pool of paint entry chunks. Sessions keep their chunks across frames and only come
+     * here when a column needs more entries than it has ever needed before.
+     */
+    class PaintEntryPool
+    {
+    private:
+        std::mutex _mutex;
+        std::vector<std::unique_ptr<PaintEntryChunk>> _chunks;
+        PaintEntryChunk* _freeChunks = nullptr;
+
+    public:
+        PaintEntryChunk* Allocate()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            PaintEntryChunk* chunk = _freeChunks;
+            if (chunk != nullptr)
+            {
+                _freeChunks = chunk->Next;
+            }
+            else
+            {
+                chunk = _chunks.emplace_back(std::make_unique<PaintEntryChunk>()).get();
+            }
+            chunk->Next = nullptr;
+            return chunk;
+        }
+
+        void Release(PaintEntryChunk* first)
+        {
+            if (first == nullptr)
+                return;
+
+            auto last = first;
+            while (last->Next != nullptr)
+            {
+                last = last->Next;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            last->Next = _freeChunks;
+            _freeChunks = first;
+        }
+    };
+} // namespace
+
+static PaintEntryPool& GetPaintEntryPool()
+{
+    static PaintEntryPool pool;
+    return pool;
+}
+
+/**
+ * Returns the next free entry of the session, moving on to the next chunk (or taking a new one
+ * from the pool) when the current chunk is full. The entry is only committed once the caller
+ * increments NextFreePaintStruct.
+ */
+static paint_entry* paint_session_next_free_entry(paint_session* session)
+{
+    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    {
+        PaintEntryChunk* chunk;
+        if (session->CurrentPaintEntryChunk == nullptr)
+        {
+            if (session->PaintEntryChunks == nullptr)
+            {
+                session->PaintEntryChunks = GetPaintEntryPool().Allocate();
+            }
+            chunk = session->PaintEntryChunks;
+        }
+        else
+        {
+            if (session->CurrentPaintEntryChunk->Next == nullptr)
+            {
+                session->CurrentPaintEntryChunk->Next = GetPaintEntryPool().Allocate();
+            }
+            chunk = session->CurrentPaintEntryChunk->Next;
+        }
+        session->CurrentPaintEntryChunk = chunk;
+        session->NextFreePaintStruct = chunk->Entries;
+        session->EndOfPaintStructArray = chunk->Entries + PaintEntryChunk::Capacity;
+    }
+    return session->NextFreePaintStruct;
+}
+
 static void paint_session_add_ps_to_quadrant(paint_session* session, paint_struct* ps, int32_t positionHash)
 {
     uint32_t paintQuadrantIndex = std::clamp(positionHash / 32, 0, MAX_PAINT_QUADRANTS - 1);
@@ -73,15 +165,13 @@ static void paint_session_add_ps_to_quadrant(paint_session* session, paint_struc
 static paint_struct* sub_9819_c(
     paint_session* session, uint32_t image_id, const CoordsXYZ& offset, CoordsXYZ boundBoxSize, CoordsXYZ boundBoxOffset)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-        return nullptr;
     auto g1 = gfx_get_g1_element(image_id & 0x7FFFF);
     if (g1 == nullptr)
     {
         return nullptr;
     }
 
-    paint_struct* ps = &session->NextFreePaintStruct->basic;
+    paint_struct* ps = &paint_session_next_free_entry(session)->basic;
     ps->image_id = image_id;
 
     uint8_t swappedRotation = (session->CurrentRotation * 3) % 4; // swaps 1 and 3
@@ -168,6 +258,7 @@ void paint_session_generate(paint_session* session)
     uint16_t num_vertical_quadrants = (dpi->height + 2128) >> 5;
 
     session->CurrentRotation = get_current_rotation();
+    paint_cache_begin_session(session);
     switch (get_current_rotation())
     {
         case 0:
@@ -313,6 +404,62 @@ template<> bool check_bounding_box<3>(const paint_struct_bound_box& initialBBox,
     return false;
 }
 
+/**
+ * Sorts the flagged structs following ps: every struct flagged PAINT_QUADRANT_FLAG_IDENTICAL is compared against
+ * all the structs after it up to the first one flagged PAINT_QUADRANT_FLAG_BIGGER.
+ */
+template<uint8_t _TRotation> static void paint_arrange_structs_sort(paint_struct* ps)
+{
+    paint_struct* ps_next;
+    paint_struct* ps_temp;
+    while (true)
+    {
+        while (true)
+        {
+            ps_next = ps->next_quadrant_ps;
+            if (ps_next == nullptr)
+                return;
+            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
+                return;
+            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL)
+                break;
+            ps = ps_next;
+        }
+
+        ps_next->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
+        ps_temp = ps;
+
+        const paint_struct_bound_box& initialBBox = ps_next->bounds;
+
+        while (true)
+        {
+            ps = ps_next;
+            ps_next = ps_next->next_quadrant_ps;
+            if (ps_next == nullptr)
+                break;
+            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
+                break;
+            if (!(ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT))
+                continue;
+
+            const paint_struct_bound_box& currentBBox = ps_next->bounds;
+
+            const bool compareResult = check_bounding_box<_TRotation>(initialBBox, currentBBox);
+
+            if (compareResult)
+            {
+                ps->next_quadrant_ps = ps_next->next_quadrant_ps;
+                paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
+                ps_temp->next_quadrant_ps = ps_next;
+                ps_next->next_quadrant_ps = ps_temp2;
+                ps_next = ps;
+            }
+        }
+
+        ps = ps_temp;
+    }
+}
+
 template<uint8_t _TRotation>
 static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
 {
@@ -349,68 +496,381 @@ static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next
             ps->quadrant_flags = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
         }
     } while (ps->quadrant_index <= quadrantIndex + 1);
-    ps = ps_temp;
 
+    paint_arrange_structs_sort<_TRotation>(ps_temp);
+    return ps_cache;
+}
+
+static paint_struct* paint_arrange_structs_helper(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation)
+{
+    switch (rotation)
+    {
+        case 0:
+            return paint_arrange_structs_helper_rotation<0>(ps_next, quadrantIndex, flag);
+        case 1:
+            return paint_arrange_structs_helper_rotation<1>(ps_next, quadrantIndex, flag);
+        case 2:
+            return paint_arrange_structs_helper_rotation<2>(ps_next, quadrantIndex, flag);
+        case 3:
+            return paint_arrange_structs_helper_rotation<3>(ps_next, quadrantIndex, flag);
+    }
+    return nullptr;
+}
+
+namespace
+{
+    /**
+     * Point used by the indexed arranger. The axes are oriented so that every struct the legacy scan moves in
+     * front of an initial struct has a key that is less than or equal to the initial struct's query point on all axes.
+     */
+    struct PaintArrangePoint
+    {
+        int32_t U;
+        int32_t V;
+        int32_t Z;
+    };
+
+    struct PaintArrangeTreeNode
+    {
+        PaintArrangePoint Min;
+        // Upper bound of the labels in the subtree, labels only decrease between two rebuilds of this value.
+        uint64_t MaxLabel;
+        uint32_t Begin;
+        uint32_t End;
+        uint32_t Left;
+        uint32_t Right;
+    };
+
+    /**
+     * Working set of paint_arrange_structs_helper_indexed. Holds the structs of the quadrant pair being sorted,
+     * linked by index so they can be reordered without touching the structs until the pass is done.
+     */
+    struct PaintArrangeScratch
+    {
+        static constexpr uint32_t LeafSize = 8;
+        static constexpr size_t MinTreeSize = 64;
+        static constexpr uint64_t LabelSpacing = 1ULL << 32;
+
+        std::vector<paint_struct*> Structs;
+        std::vector<PaintArrangePoint> Keys;
+        std::vector<uint32_t> Next;
+        std::vector<uint32_t> Prev;
+        // Labels grow along the list, comparing them tells which of two structs comes first.
+        std::vector<uint64_t> Labels;
+        // Structs flagged PAINT_QUADRANT_FLAG_NEXT, ordered by the tree.
+        std::vector<uint32_t> Candidates;
+        std::vector<PaintArrangeTreeNode> Tree;
+        std::vector<uint32_t> Found;
+    };
+} // namespace
+
+static PaintArrangeScratch& GetPaintArrangeScratch()
+{
+    // Columns of a viewport are arranged in parallel.
+    static thread_local PaintArrangeScratch scratch;
+    return scratch;
+}
+
+template<uint8_t TRotation> static PaintArrangePoint paint_arrange_key(const paint_struct_bound_box& bbox)
+{
+    const int32_t x = bbox.x;
+    const int32_t y = bbox.y;
+    return { (TRotation == 1 || TRotation == 2) ? -x : x, TRotation >= 2 ? -y : y, bbox.z };
+}
+
+template<uint8_t TRotation> static PaintArrangePoint paint_arrange_query(const paint_struct_bound_box& bbox)
+{
+    // check_bounding_box<TRotation> only passes when the key of the current box is within this point.
+    const int32_t xEnd = bbox.x_end;
+    const int32_t yEnd = bbox.y_end;
+    return { (TRotation == 1 || TRotation == 2) ? -(xEnd + 1) : xEnd, TRotation >= 2 ? -(yEnd + 1) : yEnd, bbox.z_end };
+}
+
+static int32_t paint_arrange_axis(const PaintArrangePoint& point, uint32_t axis)
+{
+    return axis == 0 ? point.U : (axis == 1 ? point.V : point.Z);
+}
+
+static uint32_t paint_arrange_build_tree(PaintArrangeScratch& scratch, uint32_t begin, uint32_t end, uint32_t depth)
+{
+    const auto& keys = scratch.Keys;
+    PaintArrangeTreeNode node{};
+    node.Min = keys[scratch.Candidates[begin]];
+    for (uint32_t i = begin + 1; i < end; i++)
+    {
+        const auto& key = keys[scratch.Candidates[i]];
+        node.Min.U = std::min(node.Min.U, key.U);
+        node.Min.V = std::min(node.Min.V, key.V);
+        node.Min.Z = std::min(node.Min.Z, key.Z);
+    }
+    node.Begin = begin;
+    node.End = end;
+    node.Left = UINT32_MAX;
+    node.Right = UINT32_MAX;
+
+    const auto nodeIndex = static_cast<uint32_t>(scratch.Tree.size());
+    scratch.Tree.push_back(node);
+    if (end - begin > PaintArrangeScratch::LeafSize)
+    {
+        const uint32_t axis = depth % 3;
+        const uint32_t mid = begin + (end - begin) / 2;
+        auto first = scratch.Candidates.begin();
+        std::nth_element(first + begin, first + mid, first + end, [&keys, axis](uint32_t a, uint32_t b) {
+            return paint_arrange_axis(keys[a], axis) < paint_arrange_axis(keys[b], axis);
+        });
+        const uint32_t left = paint_arrange_build_tree(scratch, begin, mid, depth + 1);
+        const uint32_t right = paint_arrange_build_tree(scratch, mid, end, depth + 1);
+        scratch.Tree[nodeIndex].Left = left;
+        scratch.Tree[nodeIndex].Right = right;
+    }
+    return nodeIndex;
+}
+
+static void paint_arrange_update_max_labels(PaintArrangeScratch& scratch)
+{
+    // Children are always stored after their parent.
+    for (auto it = scratch.Tree.rbegin(); it != scratch.Tree.rend(); ++it)
+    {
+        auto& node = *it;
+        if (node.Left == UINT32_MAX)
+        {
+            node.MaxLabel = 0;
+            for (uint32_t i = node.Begin; i < node.End; i++)
+            {
+                node.MaxLabel = std::max(node.MaxLabel, scratch.Labels[scratch.Candidates[i]]);
+            }
+        }
+        else
+        {
+            node.MaxLabel = std::max(scratch.Tree[node.Left].MaxLabel, scratch.Tree[node.Right].MaxLabel);
+        }
+    }
+}
+
+static void paint_arrange_relabel(PaintArrangeScratch& scratch, uint32_t head, uint32_t tail)
+{
+    uint64_t label = 0;
+    for (uint32_t i = head; i != tail; i = scratch.Next[i])
+    {
+        scratch.Labels[i] = label;
+        label += PaintArrangeScratch::LabelSpacing;
+    }
+    paint_arrange_update_max_labels(scratch);
+}
+
+/**
+ * Collects the candidates after the initial struct in the list that check_bounding_box<TRotation> would move in
+ * front of it, in list order.
+ */
+template<uint8_t TRotation> static void paint_arrange_find_moves(PaintArrangeScratch& scratch, uint32_t initial)
+{
+    scratch.Found.clear();
+    const paint_struct_bound_box& initialBBox = scratch.Structs[initial]->bounds;
+    if (scratch.Tree.empty())
+    {
+        // Few candidates, scanning the list is cheaper than maintaining the tree.
+        const uint32_t tail = static_cast<uint32_t>(scratch.Structs.size()) + 1;
+        for (uint32_t i = scratch.Next[initial]; i != tail; i = scratch.Next[i])
+        {
+            const paint_struct* ps = scratch.Structs[i];
+            if ((ps->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT) && check_bounding_box<TRotation>(initialBBox, ps->bounds))
+            {
+                scratch.Found.push_back(i);
+            }
+        }
+        return;
+    }
+
+    const auto query = paint_arrange_query<TRotation>(initialBBox);
+    const uint64_t initialLabel = scratch.Labels[initial];
+
+    uint32_t stack[64];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize != 0)
+    {
+        const auto& node = scratch.Tree[stack[--stackSize]];
+        if (node.MaxLabel <= initialLabel || node.Min.U > query.U || node.Min.V > query.V || node.Min.Z > query.Z)
+            continue;
+
+        if (node.Left != UINT32_MAX)
+        {
+            stack[stackSize++] = node.Right;
+            stack[stackSize++] = node.Left;
+            continue;
+        }
+
+        for (uint32_t i = node.Begin; i < node.End; i++)
+        {
+            const uint32_t candidate = scratch.Candidates[i];
+            if (scratch.Labels[candidate] > initialLabel
+                && check_bounding_box<TRotation>(initialBBox, scratch.Structs[candidate]->bounds))
+            {
+                scratch.Found.push_back(candidate);
+            }
+        }
+    }
+
+    std::sort(scratch.Found.begin(), scratch.Found.end(), [&scratch](uint32_t a, uint32_t b) {
+        return scratch.Labels[a] < scratch.Labels[b];
+    });
+}
+
+/**
+ * Same result as paint_arrange_structs_helper_rotation. Instead of comparing every initial struct against all the
+ * structs following it, the structs flagged PAINT_QUADRANT_FLAG_NEXT are put in a k-d tree on their bounding box
+ * and only those that can pass check_bounding_box are visited.
+ */
+template<uint8_t TRotation>
+static paint_struct* paint_arrange_structs_helper_rotation_indexed(
+    paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, PaintArrangeScratch& scratch)
+{
+    paint_struct* ps;
+    do
+    {
+        ps = ps_next;
+        ps_next = ps_next->next_quadrant_ps;
+        if (ps_next == nullptr)
+            return ps;
+    } while (quadrantIndex > ps_next->quadrant_index);
+
+    paint_struct* ps_cache = ps;
+
+    // Flag the structs like the legacy helper, the ones before the first PAINT_QUADRANT_FLAG_BIGGER are sorted.
+    scratch.Structs.clear();
     while (true)
     {
-        while (true)
+        ps = ps->next_quadrant_ps;
+        if (ps == nullptr)
+            break;
+
+        if (ps->quadrant_index > quadrantIndex + 1)
         {
-            ps_next = ps->next_quadrant_ps;
-            if (ps_next == nullptr)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL)
-                break;
-            ps = ps_next;
+            ps->quadrant_flags = PAINT_QUADRANT_FLAG_BIGGER;
+            break;
+        }
+        else if (ps->quadrant_index == quadrantIndex + 1)
+        {
+            ps->quadrant_flags = PAINT_QUADRANT_FLAG_NEXT | PAINT_QUADRANT_FLAG_IDENTICAL;
+        }
+        else if (ps->quadrant_index == quadrantIndex)
+        {
+            ps->quadrant_flags = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
         }
+        scratch.Structs.push_back(ps);
+    }
+    paint_struct* ps_end = ps;
 
-        ps_next->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
-        ps_temp = ps;
+    const auto count = static_cast<uint32_t>(scratch.Structs.size());
+    if (count <= PaintArrangeScratch::MinTreeSize)
+    {
+        paint_arrange_structs_sort<TRotation>(ps_cache);
+        return ps_cache;
+    }
 
-        const paint_struct_bound_box& initialBBox = ps_next->bounds;
+    const uint32_t head = count;
+    const uint32_t tail = count + 1;
+    scratch.Keys.resize(count);
+    scratch.Next.resize(count + 2);
+    scratch.Prev.resize(count + 2);
+    scratch.Labels.resize(count + 2);
+    scratch.Candidates.clear();
+    scratch.Next[head] = count == 0 ? tail : 0;
+    scratch.Prev[tail] = count == 0 ? head : count - 1;
+    scratch.Labels[head] = 0;
+    scratch.Labels[tail] = UINT64_MAX;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        scratch.Next[i] = i + 1 == count ? tail : i + 1;
+        scratch.Prev[i] = i == 0 ? head : i - 1;
+        scratch.Labels[i] = (i + 1) * PaintArrangeScratch::LabelSpacing;
+        scratch.Keys[i] = paint_arrange_key<TRotation>(scratch.Structs[i]->bounds);
+        if (scratch.Structs[i]->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT)
+        {
+            scratch.Candidates.push_back(i);
+        }
+    }
 
-        while (true)
+    scratch.Tree.clear();
+    if (scratch.Candidates.size() > PaintArrangeScratch::MinTreeSize)
+    {
+        paint_arrange_build_tree(scratch, 0, static_cast<uint32_t>(scratch.Candidates.size()), 0);
+        paint_arrange_update_max_labels(scratch);
+    }
+
+    uint32_t current = head;
+    while (true)
+    {
+        uint32_t initial = scratch.Next[current];
+        while (initial != tail && !(scratch.Structs[initial]->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL))
         {
-            ps = ps_next;
-            ps_next = ps_next->next_quadrant_ps;
-            if (ps_next == nullptr)
-                break;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                break;
-            if (!(ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT))
-                continue;
+            current = initial;
+            initial = scratch.Next[initial];
+        }
+        if (initial == tail)
+            break;
 
-            const paint_struct_bound_box& currentBBox = ps_next->bounds;
+        scratch.Structs[initial]->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
 
-            const bool compareResult = check_bounding_box<_TRotation>(initialBBox, currentBBox);
+        paint_arrange_find_moves<TRotation>(scratch, initial);
+        if (!scratch.Found.empty())
+        {
+            // Each struct found is inserted directly after current, so they end up in reverse order.
+            for (uint32_t moved : scratch.Found)
+            {
+                scratch.Next[scratch.Prev[moved]] = scratch.Next[moved];
+                scratch.Prev[scratch.Next[moved]] = scratch.Prev[moved];
+
+                const uint32_t after = scratch.Next[current];
+                scratch.Next[current] = moved;
+                scratch.Prev[moved] = current;
+                scratch.Next[moved] = after;
+                scratch.Prev[after] = moved;
+            }
 
-            if (compareResult)
+            const uint64_t low = scratch.Labels[current];
+            const uint64_t high = scratch.Labels[initial];
+            const auto movedCount = static_cast<uint64_t>(scratch.Found.size());
+            if (high - low > movedCount)
             {
-                ps->next_quadrant_ps = ps_next->next_quadrant_ps;
-                paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
-                ps_temp->next_quadrant_ps = ps_next;
-                ps_next->next_quadrant_ps = ps_temp2;
-                ps_next = ps;
+                const uint64_t step = (high - low) / (movedCount + 1);
+                uint64_t label = low;
+                for (uint32_t i = scratch.Next[current]; i != initial; i = scratch.Next[i])
+                {
+                    label += step;
+                    scratch.Labels[i] = label;
+                }
+            }
+            else
+            {
+                paint_arrange_relabel(scratch, head, tail);
             }
         }
+    }
 
-        ps = ps_temp;
+    ps = ps_cache;
+    for (uint32_t i = scratch.Next[head]; i != tail; i = scratch.Next[i])
+    {
+        ps->next_quadrant_ps = scratch.Structs[i];
+        ps = scratch.Structs[i];
     }
+    ps->next_quadrant_ps = ps_end;
+    return ps_cache;
 }
 
-static paint_struct* paint_arrange_structs_helper(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation)
+static paint_struct* paint_arrange_structs_helper_indexed(
+    paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation, PaintArrangeScratch& scratch)
 {
     switch (rotation)
     {
         case 0:
-            return paint_arrange_structs_helper_rotation<0>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation_indexed<0>(ps_next, quadrantIndex, flag, scratch);
         case 1:
-            return paint_arrange_structs_helper_rotation<1>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation_indexed<1>(ps_next, quadrantIndex, flag, scratch);
         case 2:
-            return paint_arrange_structs_helper_rotation<2>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation_indexed<2>(ps_next, quadrantIndex, flag, scratch);
         case 3:
-            return paint_arrange_structs_helper_rotation<3>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation_indexed<3>(ps_next, quadrantIndex, flag, scratch);
     }
     return nullptr;
 }
@@ -420,6 +880,11 @@ static paint_struct* paint_arrange_structs_helper(paint_struct* ps_next, uint16_
  *  rct2: 0x00688217
  */
 void paint_session_arrange(paint_session* session)
+{
+    paint_session_arrange(session, gPaintArrangeMethod);
+}
+
+void paint_session_arrange(paint_session* session, PaintArrangeMethod method)
 {
     paint_struct* psHead = &session->PaintHead;
 
@@ -444,13 +909,29 @@ void paint_session_arrange(paint_session* session)
             }
         } while (++quadrantIndex <= session->QuadrantFrontIndex);
 
-        paint_struct* ps_cache = paint_arrange_structs_helper(
-            psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT, session->CurrentRotation);
+        if (method == PaintArrangeMethod::Indexed)
+        {
+            auto& scratch = GetPaintArrangeScratch();
+            paint_struct* ps_cache = paint_arrange_structs_helper_indexed(
+                psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT, session->CurrentRotation, scratch);
 
-        quadrantIndex = session->QuadrantBackIndex;
-        while (++quadrantIndex < session->QuadrantFrontIndex)
+            quadrantIndex = session->QuadrantBackIndex;
+            while (++quadrantIndex < session->QuadrantFrontIndex)
+            {
+                ps_cache = paint_arrange_structs_helper_indexed(
+                    ps_cache, quadrantIndex & 0xFFFF, 0, session->CurrentRotation, scratch);
+            }
+        }
+        else
         {
-            ps_cache = paint_arrange_structs_helper(ps_cache, quadrantIndex & 0xFFFF, 0, session->CurrentRotation);
+            paint_struct* ps_cache = paint_arrange_structs_helper(
+                psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT, session->CurrentRotation);
+
+            quadrantIndex = session->QuadrantBackIndex;
+            while (++quadrantIndex < session->QuadrantFrontIndex)
+            {
+                ps_cache = paint_arrange_structs_helper(ps_cache, quadrantIndex & 0xFFFF, 0, session->CurrentRotation);
+            }
         }
     }
 }
@@ -691,6 +1172,40 @@ void paint_session_free([[maybe_unused]] paint_session* session)
     GetContext()->GetPainter()->ReleaseSession(session);
 }
 
+/**
+ * Rewinds the session to its first chunk, keeping the chunks it already owns for reuse.
+ */
+void paint_session_reset_entries(paint_session* session)
+{
+    session->CurrentPaintEntryChunk = nullptr;
+    session->NextFreePaintStruct = nullptr;
+    session->EndOfPaintStructArray = nullptr;
+}
+
+/**
+ * Returns all chunks owned by the session to the shared pool.
+ */
+void paint_session_release_entries(paint_session* session)
+{
+    GetPaintEntryPool().Release(session->PaintEntryChunks);
+    session->PaintEntryChunks = nullptr;
+    paint_session_reset_entries(session);
+}
+
+size_t paint_session_get_entry_count(const paint_session* session)
+{
+    size_t count = 0;
+    for (auto chunk = session->PaintEntryChunks; chunk != nullptr; chunk = chunk->Next)
+    {
+        if (chunk == session->CurrentPaintEntryChunk)
+        {
+            return count + (session->NextFreePaintStruct - chunk->Entries);
+        }
+        count += PaintEntryChunk::Capacity;
+    }
+    return 0;
+}
+
 /**
  *  rct2: 0x006861AC, 0x00686337, 0x006864D0, 0x0068666B, 0x0098196C
  *
@@ -707,24 +1222,28 @@ paint_struct* sub_98196C(
     paint_session* session, uint32_t image_id, int8_t x_offset, int8_t y_offset, int16_t bound_box_length_x,
     int16_t bound_box_length_y, int8_t bound_box_length_z, int16_t z_offset)
 {
+    if (session->CacheRecorder != nullptr)
+    {
+        return paint_cache_record_struct(
+            session,
+            PaintCacheOp::Struct(
+                PaintCacheOpType::Sub98196C, image_id, x_offset, y_offset, bound_box_length_x, bound_box_length_y,
+                bound_box_length_z, z_offset));
+    }
+
     assert(static_cast<uint16_t>(bound_box_length_x) == static_cast<int16_t>(bound_box_length_x));
     assert(static_cast<uint16_t>(bound_box_length_y) == static_cast<int16_t>(bound_box_length_y));
 
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
 
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-    {
-        return nullptr;
-    }
-
     auto g1Element = gfx_get_g1_element(image_id & 0x7FFFF);
     if (g1Element == nullptr)
     {
         return nullptr;
     }
 
-    paint_struct* ps = &session->NextFreePaintStruct->basic;
+    paint_struct* ps = &paint_session_next_free_entry(session)->basic;
     ps->image_id = image_id;
 
     CoordsXYZ coord_3d = {
@@ -858,6 +1377,15 @@ paint_struct* sub_98197C(
     int16_t bound_box_length_y, int8_t bound_box_length_z, int16_t z_offset, int16_t bound_box_offset_x,
     int16_t bound_box_offset_y, int16_t bound_box_offset_z)
 {
+    if (session->CacheRecorder != nullptr)
+    {
+        return paint_cache_record_struct(
+            session,
+            PaintCacheOp::Struct(
+                PaintCacheOpType::Sub98197C, image_id, x_offset, y_offset, bound_box_length_x, bound_box_length_y,
+                bound_box_length_z, z_offset, bound_box_offset_x, bound_box_offset_y, bound_box_offset_z));
+    }
+
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
 
@@ -916,6 +1444,15 @@ paint_struct* sub_98198C(
     int16_t bound_box_length_y, int8_t bound_box_length_z, int16_t z_offset, int16_t bound_box_offset_x,
     int16_t bound_box_offset_y, int16_t bound_box_offset_z)
 {
+    if (session->CacheRecorder != nullptr)
+    {
+        return paint_cache_record_struct(
+            session,
+            PaintCacheOp::Struct(
+                PaintCacheOpType::Sub98198C, image_id, x_offset, y_offset, bound_box_length_x, bound_box_length_y,
+                bound_box_length_z, z_offset, bound_box_offset_x, bound_box_offset_y, bound_box_offset_z));
+    }
+
     assert(static_cast<uint16_t>(bound_box_length_x) == static_cast<int16_t>(bound_box_length_x));
     assert(static_cast<uint16_t>(bound_box_length_y) == static_cast<int16_t>(bound_box_length_y));
 
@@ -958,6 +1495,15 @@ paint_struct* sub_98199C(
     int16_t bound_box_length_y, int8_t bound_box_length_z, int16_t z_offset, int16_t bound_box_offset_x,
     int16_t bound_box_offset_y, int16_t bound_box_offset_z)
 {
+    if (session->CacheRecorder != nullptr)
+    {
+        return paint_cache_record_struct(
+            session,
+            PaintCacheOp::Struct(
+                PaintCacheOpType::Sub98199C, image_id, x_offset, y_offset, bound_box_length_x, bound_box_length_y,
+                bound_box_length_z, z_offset, bound_box_offset_x, bound_box_offset_y, bound_box_offset_z));
+    }
+
     assert(static_cast<uint16_t>(bound_box_length_x) == static_cast<int16_t>(bound_box_length_x));
     assert(static_cast<uint16_t>(bound_box_length_y) == static_cast<int16_t>(bound_box_length_y));
 
@@ -996,16 +1542,18 @@ paint_struct* sub_98199C(
  */
 bool paint_attach_to_previous_attach(paint_session* session, uint32_t image_id, int16_t x, int16_t y)
 {
-    if (session->UnkF1AD2C == nullptr)
+    if (session->CacheRecorder != nullptr)
     {
-        return paint_attach_to_previous_ps(session, image_id, x, y);
+        return paint_cache_record_attach(
+            session, PaintCacheOp::Attach(PaintCacheOpType::AttachToPreviousAttach, image_id, x, y));
     }
 
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    if (session->UnkF1AD2C == nullptr)
     {
-        return false;
+        return paint_attach_to_previous_ps(session, image_id, x, y);
     }
-    attached_paint_struct* ps = &session->NextFreePaintStruct->attached;
+
+    attached_paint_struct* ps = &paint_session_next_free_entry(session)->attached;
     ps->image_id = image_id;
     ps->x = x;
     ps->y = y;
@@ -1033,11 +1581,12 @@ bool paint_attach_to_previous_attach(paint_session* session, uint32_t image_id,
  */
 bool paint_attach_to_previous_ps(paint_session* session, uint32_t image_id, int16_t x, int16_t y)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    if (session->CacheRecorder != nullptr)
     {
-        return false;
+        return paint_cache_record_attach(session, PaintCacheOp::Attach(PaintCacheOpType::AttachToPreviousPS, image_id, x, y));
     }
-    attached_paint_struct* ps = &session->NextFreePaintStruct->attached;
+
+    attached_paint_struct* ps = &paint_session_next_free_entry(session)->attached;
 
     ps->image_id = image_id;
     ps->x = x;
@@ -1076,12 +1625,7 @@ void paint_floating_money_effect(
     paint_session* session, money32 amount, rct_string_id string_id, int16_t y, int16_t z, int8_t y_offsets[], int16_t offset_x,
     uint32_t rotation)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-    {
-        return;
-    }
-
-    paint_string_struct* ps = &session->NextFreePaintStruct->string;
+    paint_string_struct* ps = &paint_session_next_free_entry(session)->string;
     ps->string_id = string_id;
     ps->next = nullptr;
     ps->args[0] = amount;
@@ -14,6 +14,10 @@
 #include "../interface/Colour.h"
 #include "../world/Location.hpp"
 
+#include <vector>
+
+struct PaintCacheLayer;
+struct PaintCacheRecorder;
 struct TileElement;
 enum ViewportInteractionItem : uint8_t;
 
@@ -131,20 +135,44 @@ struct tunnel_entry
     uint8_t type;
 };
 
+/**
+ * How paint_session_arrange sorts the structs of neighbouring quadrants. Both methods give the same draw order.
+ */
+enum class PaintArrangeMethod : uint8_t
+{
+    // Compares every struct against all the structs following it, as RCT2 did.
+    Legacy,
+    // Looks up the structs that have to be moved in a k-d tree built for each quadrant pair.
+    Indexed,
+};
+
 #define MAX_PAINT_QUADRANTS 512
 #define TUNNEL_MAX_COUNT 65
 
+/**
+ * Fixed block of paint entries. Sessions chain as many chunks as they need, chunks are
+ * handed out by a shared pool and returned to it when the session is released.
+ */
+struct PaintEntryChunk
+{
+    static constexpr size_t Capacity = 256;
+
+    PaintEntryChunk* Next;
+    paint_entry Entries[Capacity];
+};
+
 struct paint_session
 {
     rct_drawpixelinfo DPI;
-    paint_entry PaintStructs[4000];
+    PaintEntryChunk* PaintEntryChunks;
+    PaintEntryChunk* CurrentPaintEntryChunk;
     paint_struct* Quadrants[MAX_PAINT_QUADRANTS];
     paint_struct PaintHead;
     uint32_t ViewFlags;
     uint32_t QuadrantBackIndex;
     uint32_t QuadrantFrontIndex;
     const void* CurrentlyDrawnItem;
-    paint_entry* EndOfPaintStructArray;
+    paint_entry* EndOfPaintStructArray; // End of the current chunk
     paint_entry* NextFreePaintStruct;
     CoordsXY SpritePosition;
     paint_struct* LastRootPS;
@@ -169,6 +197,20 @@ struct paint_session
     uint8_t Unk141E9DB;
     uint16_t WaterHeight;
     uint32_t TrackColours[4];
+    PaintCacheLayer* CacheLayer;
+    // Set while a tile is painted for the paint cache, paint calls are recorded instead of only being made.
+    PaintCacheRecorder* CacheRecorder;
+};
+
+/**
+ * Copy of a paint session with its entries flattened into a single array. Pointers between
+ * entries (next_quadrant_ps and Quadrants) are stored as indices into Entries, Entries.size()
+ * standing for nullptr, so that the copy can be relocated.
+ */
+struct RecordedPaintSession
+{
+    paint_session Session;
+    std::vector<paint_entry> Entries;
 };
 
 extern paint_session gPaintSession;
@@ -183,6 +225,7 @@ extern CoordsXY gClipSelectionB;
 extern bool gShowDirtyVisuals;
 extern bool gPaintBoundingBoxes;
 extern bool gPaintBlockedTiles;
+extern PaintArrangeMethod gPaintArrangeMethod;
 extern bool gPaintWidePathsAsGhost;
 
 paint_struct* sub_98196C(
@@ -223,8 +266,12 @@ void paint_floating_money_effect(
 
 paint_session* paint_session_alloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void paint_session_free(paint_session* session);
+void paint_session_reset_entries(paint_session* session);
+void paint_session_release_entries(paint_session* session);
+size_t paint_session_get_entry_count(const paint_session* session);
 void paint_session_generate(paint_session* session);
 void paint_session_arrange(paint_session* session);
+void paint_session_arrange(paint_session* session, PaintArrangeMethod method);
 void paint_draw_structs(paint_session* session);
 void paint_draw_money_structs(rct_drawpixelinfo* dpi, paint_string_struct* ps);
 
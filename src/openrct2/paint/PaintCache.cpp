@@ -0,0 +1,712 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PaintCache.h"
+
+#include "../Cheats.h"
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../drawing/LightFX.h"
+#include "../interface/Viewport.h"
+#include "../peep/Staff.h"
+#include "../ride/TrackDesign.h"
+#include "../world/Banner.h"
+#include "../world/Footpath.h"
+#include "../world/Map.h"
+#include "../world/Scenery.h"
+#include "../world/SmallScenery.h"
+#include "../world/Sprite.h"
+#include "Paint.h"
+#include "tile_element/Paint.TileElement.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+static constexpr size_t PAINT_CACHE_MAX_LAYERS = 4;
+static constexpr size_t PAINT_CACHE_LOCK_STRIPES = 64;
+// Upper bound on the number of ops a layer keeps, roughly 64 MiB.
+static constexpr size_t PAINT_CACHE_MAX_OPS = 1 << 20;
+
+/**
+ * Global state the static element paint functions read. A change of any of these selects (or resets)
+ * another layer of the cache rather than invalidating tiles.
+ */
+struct PaintCacheContext
+{
+    uint32_t ViewFlags{};
+    uint8_t Rotation{};
+    int8_t ZoomLevel{};
+    uint8_t ScreenFlags{};
+    bool SandboxMode{};
+    bool TrackDesignSaveMode{};
+    ride_id_t TrackDesignSaveRideIndex{};
+    bool LandscapeSmoothing{};
+    bool PaintBlockedTiles{};
+    bool PaintWidePathsAsGhost{};
+    int16_t HeightMarkerOffset{};
+    uint8_t ClipHeight{};
+    CoordsXY ClipSelectionA;
+    CoordsXY ClipSelectionB;
+
+    bool operator==(const PaintCacheContext& other) const
+    {
+        return ViewFlags == other.ViewFlags && Rotation == other.Rotation && ZoomLevel == other.ZoomLevel
+            && ScreenFlags == other.ScreenFlags && SandboxMode == other.SandboxMode
+            && TrackDesignSaveMode == other.TrackDesignSaveMode && TrackDesignSaveRideIndex == other.TrackDesignSaveRideIndex
+            && LandscapeSmoothing == other.LandscapeSmoothing && PaintBlockedTiles == other.PaintBlockedTiles
+            && PaintWidePathsAsGhost == other.PaintWidePathsAsGhost && HeightMarkerOffset == other.HeightMarkerOffset
+            && ClipHeight == other.ClipHeight && ClipSelectionA == other.ClipSelectionA
+            && ClipSelectionB == other.ClipSelectionB;
+    }
+};
+
+struct PaintCacheTile
+{
+    // The tile is only valid while this matches the generation of its layer.
+    uint32_t Generation{};
+    uint64_t Fingerprint{};
+    const TileElement* FirstElement{};
+    // Tiles that made calls which can not be replayed are remembered so they are not recorded every frame.
+    bool Replayable{};
+    bool Completed{};
+
+    // Session state after painting the tile.
+    CoordsXY SpritePosition;
+    CoordsXY MapPosition;
+    ViewportInteractionItem InteractionType{};
+    const void* CurrentlyDrawnItem{};
+    const TileElement* SurfaceElement{};
+    bool DidPassSurface{};
+
+    std::vector<PaintCacheOp> Ops;
+};
+
+struct PaintCacheLayer
+{
+    PaintCacheContext Context;
+    uint32_t Generation = 1;
+    uint64_t LastUsed{};
+    std::atomic<size_t> OpCount{ 0 };
+    std::vector<PaintCacheTile> Tiles;
+};
+
+/**
+ * Collects the ops of a tile painted into the scratch session.
+ */
+struct PaintCacheRecorder
+{
+    // LastRootPS and UnkF1AD2C of the scratch session point here when the tile starts.
+    paint_struct TileStartRoot{};
+    attached_paint_struct TileStartAttached{};
+
+    std::vector<PaintCacheOp> Ops;
+    std::vector<paint_entry*> Results;
+    std::vector<paint_struct*> LastRootAfter;
+    bool Failed{};
+};
+
+namespace
+{
+    class PaintCache
+    {
+    private:
+        std::mutex _layersMutex;
+        std::array<std::unique_ptr<PaintCacheLayer>, PAINT_CACHE_MAX_LAYERS> _layers;
+        uint64_t _useCounter{};
+        std::array<std::mutex, PAINT_CACHE_LOCK_STRIPES> _tileMutexes;
+
+    public:
+        /**
+         * Returns the layer for the given context, recycling the least recently used one if there is none.
+         * Viewports are painted one after the other, so a layer is never recycled while a session uses it.
+         */
+        PaintCacheLayer* GetLayer(const PaintCacheContext& context)
+        {
+            std::lock_guard<std::mutex> lock(_layersMutex);
+            PaintCacheLayer* candidate = nullptr;
+            for (auto& layer : _layers)
+            {
+                if (layer == nullptr)
+                {
+                    layer = std::make_unique<PaintCacheLayer>();
+                    layer->Tiles.resize(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL);
+                    layer->Context = context;
+                    candidate = layer.get();
+                    break;
+                }
+                if (layer->Context == context)
+                {
+                    candidate = layer.get();
+                    break;
+                }
+                if (candidate == nullptr || layer->LastUsed < candidate->LastUsed)
+                {
+                    candidate = layer.get();
+                }
+            }
+
+            if (!(candidate->Context == context))
+            {
+                candidate->Context = context;
+                candidate->Generation++;
+            }
+            candidate->LastUsed = ++_useCounter;
+            return candidate;
+        }
+
+        std::mutex& GetTileMutex(size_t tileIndex)
+        {
+            return _tileMutexes[tileIndex % PAINT_CACHE_LOCK_STRIPES];
+        }
+
+        void InvalidateTile(size_t tileIndex)
+        {
+            std::lock_guard<std::mutex> lock(_layersMutex);
+            std::lock_guard<std::mutex> tileLock(GetTileMutex(tileIndex));
+            for (auto& layer : _layers)
+            {
+                if (layer != nullptr)
+                {
+                    layer->Tiles[tileIndex].Generation = 0;
+                }
+            }
+        }
+
+        void InvalidateAll()
+        {
+            std::lock_guard<std::mutex> lock(_layersMutex);
+            for (auto& layer : _layers)
+            {
+                if (layer != nullptr)
+                {
+                    // Only ever called between frames, release the ops as well.
+                    for (auto& tile : layer->Tiles)
+                    {
+                        tile.Generation = 0;
+                        tile.Ops = {};
+                    }
+                    layer->OpCount = 0;
+                }
+            }
+        }
+    };
+} // namespace
+
+static PaintCache& GetPaintCache()
+{
+    static PaintCache cache;
+    return cache;
+}
+
+PaintCacheOp PaintCacheOp::Struct(
+    PaintCacheOpType type, uint32_t imageId, int8_t xOffset, int8_t yOffset, int16_t boundBoxLengthX, int16_t boundBoxLengthY,
+    int8_t boundBoxLengthZ, int16_t zOffset, int16_t boundBoxOffsetX, int16_t boundBoxOffsetY, int16_t boundBoxOffsetZ)
+{
+    PaintCacheOp op{};
+    op.Type = type;
+    op.ImageId = imageId;
+    op.XOffset = xOffset;
+    op.YOffset = yOffset;
+    op.BoundBoxLengthX = boundBoxLengthX;
+    op.BoundBoxLengthY = boundBoxLengthY;
+    op.BoundBoxLengthZ = boundBoxLengthZ;
+    op.ZOffset = zOffset;
+    op.BoundBoxOffsetX = boundBoxOffsetX;
+    op.BoundBoxOffsetY = boundBoxOffsetY;
+    op.BoundBoxOffsetZ = boundBoxOffsetZ;
+    return op;
+}
+
+PaintCacheOp PaintCacheOp::Attach(PaintCacheOpType type, uint32_t imageId, int16_t x, int16_t y)
+{
+    PaintCacheOp op{};
+    op.Type = type;
+    op.ImageId = imageId;
+    op.X = x;
+    op.Y = y;
+    return op;
+}
+
+static bool paint_cache_op_is_attach(PaintCacheOpType type)
+{
+    return type == PaintCacheOpType::AttachToPreviousAttach || type == PaintCacheOpType::AttachToPreviousPS;
+}
+
+/**
+ * Issues the call described by op, returning the entry it added to the session or nullptr.
+ */
+static paint_entry* paint_cache_invoke(paint_session* session, const PaintCacheOp& op)
+{
+    paint_struct* ps = nullptr;
+    switch (op.Type)
+    {
+        case PaintCacheOpType::Sub98196C:
+            ps = sub_98196C(
+                session, op.ImageId, op.XOffset, op.YOffset, op.BoundBoxLengthX, op.BoundBoxLengthY, op.BoundBoxLengthZ,
+                op.ZOffset);
+            break;
+        case PaintCacheOpType::Sub98197C:
+            ps = sub_98197C(
+                session, op.ImageId, op.XOffset, op.YOffset, op.BoundBoxLengthX, op.BoundBoxLengthY, op.BoundBoxLengthZ,
+                op.ZOffset, op.BoundBoxOffsetX, op.BoundBoxOffsetY, op.BoundBoxOffsetZ);
+            break;
+        case PaintCacheOpType::Sub98198C:
+            ps = sub_98198C(
+                session, op.ImageId, op.XOffset, op.YOffset, op.BoundBoxLengthX, op.BoundBoxLengthY, op.BoundBoxLengthZ,
+                op.ZOffset, op.BoundBoxOffsetX, op.BoundBoxOffsetY, op.BoundBoxOffsetZ);
+            break;
+        case PaintCacheOpType::Sub98199C:
+            ps = sub_98199C(
+                session, op.ImageId, op.XOffset, op.YOffset, op.BoundBoxLengthX, op.BoundBoxLengthY, op.BoundBoxLengthZ,
+                op.ZOffset, op.BoundBoxOffsetX, op.BoundBoxOffsetY, op.BoundBoxOffsetZ);
+            break;
+        case PaintCacheOpType::AttachToPreviousAttach:
+            if (paint_attach_to_previous_attach(session, op.ImageId, op.X, op.Y))
+            {
+                return reinterpret_cast<paint_entry*>(session->UnkF1AD2C);
+            }
+            return nullptr;
+        case PaintCacheOpType::AttachToPreviousPS:
+            if (paint_attach_to_previous_ps(session, op.ImageId, op.X, op.Y))
+            {
+                return reinterpret_cast<paint_entry*>(session->UnkF1AD2C);
+            }
+            return nullptr;
+        case PaintCacheOpType::SetLastRootPS:
+            break;
+    }
+    return reinterpret_cast<paint_entry*>(ps);
+}
+
+/**
+ * Records a SetLastRootPS op if the caller changed LastRootPS since the previous op.
+ */
+static void paint_cache_record_last_root(paint_session* session, PaintCacheRecorder& recorder)
+{
+    paint_struct* expected = recorder.LastRootAfter.empty() ? &recorder.TileStartRoot : recorder.LastRootAfter.back();
+    if (session->LastRootPS == expected)
+        return;
+
+    int32_t lastRootOp = -2;
+    if (session->LastRootPS == &recorder.TileStartRoot)
+    {
+        lastRootOp = -1;
+    }
+    else
+    {
+        for (size_t i = recorder.LastRootAfter.size(); i > 0; i--)
+        {
+            if (recorder.LastRootAfter[i - 1] == session->LastRootPS)
+            {
+                lastRootOp = static_cast<int32_t>(i - 1);
+                break;
+            }
+        }
+    }
+
+    if (lastRootOp == -2)
+    {
+        // Not a struct of this tile, the tile can not be replayed.
+        recorder.Failed = true;
+        return;
+    }
+
+    auto& op = recorder.Ops.emplace_back();
+    op.Type = PaintCacheOpType::SetLastRootPS;
+    op.LastRootOp = lastRootOp;
+    recorder.Results.push_back(nullptr);
+    recorder.LastRootAfter.push_back(session->LastRootPS);
+}
+
+static paint_entry* paint_cache_record(paint_session* session, const PaintCacheOp& op)
+{
+    auto recorder = session->CacheRecorder;
+    paint_cache_record_last_root(session, *recorder);
+
+    auto& recorded = recorder->Ops.emplace_back(op);
+    recorded.InteractionType = session->InteractionType;
+    recorded.SpritePosition = session->SpritePosition;
+    recorded.MapPosition = session->MapPosition;
+    recorded.CurrentlyDrawnItem = session->CurrentlyDrawnItem;
+
+    // Nested calls, such as sub_98199C falling back to sub_98197C, are part of this op.
+    session->CacheRecorder = nullptr;
+    paint_entry* result = paint_cache_invoke(session, recorded);
+    session->CacheRecorder = recorder;
+
+    recorder->Results.push_back(result);
+    recorder->LastRootAfter.push_back(session->LastRootPS);
+    return result;
+}
+
+paint_struct* paint_cache_record_struct(paint_session* session, const PaintCacheOp& op)
+{
+    return reinterpret_cast<paint_struct*>(paint_cache_record(session, op));
+}
+
+bool paint_cache_record_attach(paint_session* session, const PaintCacheOp& op)
+{
+    return paint_cache_record(session, op) != nullptr;
+}
+
+static PaintCacheContext paint_cache_get_context(const paint_session* session)
+{
+    PaintCacheContext context;
+    context.ViewFlags = session->ViewFlags;
+    context.Rotation = session->CurrentRotation;
+    context.ZoomLevel = static_cast<int8_t>(session->DPI.zoom_level);
+    context.ScreenFlags = gScreenFlags;
+    context.SandboxMode = gCheatsSandboxMode;
+    context.TrackDesignSaveMode = gTrackDesignSaveMode;
+    context.TrackDesignSaveRideIndex = gTrackDesignSaveRideIndex;
+    context.LandscapeSmoothing = gConfigGeneral.landscape_smoothing;
+    context.PaintBlockedTiles = gPaintBlockedTiles;
+    context.PaintWidePathsAsGhost = gPaintWidePathsAsGhost;
+    context.HeightMarkerOffset = get_height_marker_offset();
+    if (session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW)
+    {
+        context.ClipHeight = gClipHeight;
+        context.ClipSelectionA = gClipSelectionA;
+        context.ClipSelectionB = gClipSelectionB;
+    }
+    return context;
+}
+
+/**
+ * Whether any of the tile paint functions currently draws overlays that change without the map changing.
+ */
+static bool paint_cache_is_bypassed(const paint_session* session)
+{
+    if (!gConfigGeneral.paint_cache)
+        return true;
+    if (gMapSelectFlags & MAP_SELECT_FLAG_ENABLE_CONSTRUCT)
+        return true;
+    if (gStaffDrawPatrolAreas != SPRITE_INDEX_NULL)
+        return true;
+    if (gShowSupportSegmentHeights)
+        return true;
+    if (lightfx_is_available())
+        return true;
+    // Peep spawns are drawn with the surface.
+    if ((session->ViewFlags & VIEWPORT_FLAG_LAND_OWNERSHIP) && ((gScreenFlags & SCREEN_FLAGS_SCENARIO_EDITOR) || gCheatsSandboxMode))
+        return true;
+    return false;
+}
+
+/**
+ * Static elements are those whose paint only depends on the element itself, its neighbouring surfaces
+ * and the cache context: no animation, scrolling text or ride data.
+ */
+static bool paint_cache_is_element_static(const TileElement* tileElement)
+{
+    switch (tileElement->GetType())
+    {
+        case TILE_ELEMENT_TYPE_SURFACE:
+            return true;
+        case TILE_ELEMENT_TYPE_PATH:
+            return !tileElement->AsPath()->HasQueueBanner();
+        case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+        {
+            auto entry = tileElement->AsSmallScenery()->GetEntry();
+            return entry != nullptr && !scenery_small_entry_has_flag(entry, SMALL_SCENERY_FLAG_ANIMATED);
+        }
+        case TILE_ELEMENT_TYPE_WALL:
+        {
+            auto entry = tileElement->AsWall()->GetEntry();
+            return entry != nullptr && !(entry->wall.flags & WALL_SCENERY_IS_DOOR)
+                && !(entry->wall.flags2 & WALL_SCENERY_2_ANIMATED) && entry->wall.scrolling_mode == SCROLLING_MODE_NONE;
+        }
+        case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+        {
+            auto entry = tileElement->AsLargeScenery()->GetEntry();
+            return entry != nullptr && entry->large_scenery.scrolling_mode == SCROLLING_MODE_NONE
+                && !(entry->large_scenery.flags & LARGE_SCENERY_FLAG_3D_TEXT);
+        }
+        default:
+            return false;
+    }
+}
+
+static uint64_t paint_cache_hash(uint64_t hash, const void* data, size_t length)
+{
+    // FNV-1a
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Hashes the elements of the tile and the surfaces of its neighbours, which the surface paints
+ * its edges against. Returns false if the tile contains an element that can not be cached.
+ */
+static bool paint_cache_get_fingerprint(const CoordsXY& mapPosition, const TileElement* firstElement, uint64_t& fingerprint)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    const TileElement* tileElement = firstElement;
+    do
+    {
+        if (!paint_cache_is_element_static(tileElement))
+            return false;
+        hash = paint_cache_hash(hash, tileElement, sizeof(TileElement));
+    } while (!(tileElement++)->IsLastForTile());
+
+    static constexpr const CoordsXY neighbourOffsets[] = { { 32, 0 }, { -32, 0 }, { 0, 32 }, { 0, -32 } };
+    for (const auto& offset : neighbourOffsets)
+    {
+        auto position = mapPosition + offset;
+        const SurfaceElement* surfaceElement = nullptr;
+        if (map_is_location_valid(position))
+        {
+            surfaceElement = map_get_surface_element_at(position);
+        }
+        if (surfaceElement != nullptr)
+        {
+            hash = paint_cache_hash(hash, surfaceElement, sizeof(TileElement));
+        }
+        else
+        {
+            hash = paint_cache_hash(hash, &surfaceElement, sizeof(surfaceElement));
+        }
+    }
+
+    fingerprint = hash;
+    return true;
+}
+
+/**
+ * Paints the tile into the scratch session, which does not cull anything, and stores the calls made.
+ * @returns false if the tile made a call that can not be replayed.
+ */
+static bool paint_cache_record_tile(paint_session* session, TileElement* firstElement, PaintCacheTile& tile)
+{
+    static thread_local PaintCacheRecorder recorder;
+    recorder.Ops.clear();
+    recorder.Results.clear();
+    recorder.LastRootAfter.clear();
+    recorder.Failed = false;
+
+    // The chunks of the scratch session are owned by the entry pool, nothing to release on thread exit.
+    static thread_local paint_session scratch{};
+    PaintEntryChunk* chunks = scratch.PaintEntryChunks;
+    scratch = *session;
+    scratch.PaintEntryChunks = chunks;
+    paint_session_reset_entries(&scratch);
+
+    // Large enough for anything on the map to be inside.
+    scratch.DPI.x = -16384;
+    scratch.DPI.y = -16384;
+    scratch.DPI.width = 32767;
+    scratch.DPI.height = 32767;
+    scratch.LastRootPS = &recorder.TileStartRoot;
+    scratch.UnkF1AD2C = &recorder.TileStartAttached;
+    scratch.PSStringHead = nullptr;
+    scratch.LastPSString = nullptr;
+    scratch.CacheRecorder = &recorder;
+
+    tile.Completed = tile_element_paint_elements(&scratch, firstElement);
+    scratch.CacheRecorder = nullptr;
+    paint_cache_record_last_root(&scratch, recorder);
+
+    if (recorder.Failed || scratch.PSStringHead != nullptr || scratch.WoodenSupportsPrependTo != nullptr)
+        return false;
+
+    for (size_t i = 0; i < recorder.Ops.size(); i++)
+    {
+        auto& op = recorder.Ops[i];
+        const paint_entry* result = recorder.Results[i];
+        if (result == nullptr)
+            continue;
+
+        if (paint_cache_op_is_attach(op.Type))
+        {
+            op.ResultColour = result->attached.colour_image_id;
+            op.ResultFlags = result->attached.flags;
+        }
+        else
+        {
+            op.ResultColour = result->basic.tertiary_colour;
+            op.ResultFlags = result->basic.flags;
+        }
+    }
+
+    tile.Ops.assign(recorder.Ops.begin(), recorder.Ops.end());
+    tile.SpritePosition = scratch.SpritePosition;
+    tile.MapPosition = scratch.MapPosition;
+    tile.InteractionType = scratch.InteractionType;
+    tile.CurrentlyDrawnItem = scratch.CurrentlyDrawnItem;
+    tile.SurfaceElement = scratch.SurfaceElement;
+    tile.DidPassSurface = scratch.DidPassSurface;
+    return true;
+}
+
+/**
+ * Issues the calls recorded for the tile against the real session, so that culling and the linking
+ * of the structs happen exactly as if the elements had been painted.
+ */
+static void paint_cache_replay_tile(paint_session* session, const PaintCacheTile& tile)
+{
+    static thread_local std::vector<paint_struct*> lastRootAfter;
+    lastRootAfter.resize(tile.Ops.size());
+
+    paint_struct* tileStartRoot = session->LastRootPS;
+    for (size_t i = 0; i < tile.Ops.size(); i++)
+    {
+        const auto& op = tile.Ops[i];
+        if (op.Type == PaintCacheOpType::SetLastRootPS)
+        {
+            session->LastRootPS = op.LastRootOp < 0 ? tileStartRoot : lastRootAfter[op.LastRootOp];
+            lastRootAfter[i] = session->LastRootPS;
+            continue;
+        }
+
+        session->InteractionType = op.InteractionType;
+        session->SpritePosition = op.SpritePosition;
+        session->MapPosition = op.MapPosition;
+        session->CurrentlyDrawnItem = op.CurrentlyDrawnItem;
+
+        paint_entry* result = paint_cache_invoke(session, op);
+        if (result != nullptr)
+        {
+            if (paint_cache_op_is_attach(op.Type))
+            {
+                result->attached.colour_image_id = op.ResultColour;
+                result->attached.flags = op.ResultFlags;
+            }
+            else
+            {
+                result->basic.tertiary_colour = op.ResultColour;
+                result->basic.flags = op.ResultFlags;
+            }
+        }
+        lastRootAfter[i] = session->LastRootPS;
+    }
+
+    session->SpritePosition = tile.SpritePosition;
+    session->MapPosition = tile.MapPosition;
+    session->InteractionType = tile.InteractionType;
+    session->CurrentlyDrawnItem = tile.CurrentlyDrawnItem;
+    session->SurfaceElement = tile.SurfaceElement;
+    session->DidPassSurface = tile.DidPassSurface;
+}
+
+void paint_cache_begin_session(paint_session* session)
+{
+    session->CacheLayer = nullptr;
+    if (!paint_cache_is_bypassed(session))
+    {
+        session->CacheLayer = GetPaintCache().GetLayer(paint_cache_get_context(session));
+    }
+}
+
+bool paint_cache_paint_tile_elements(paint_session* session, TileElement* firstElement)
+{
+    PaintCacheLayer* layer = session->CacheLayer;
+    if (layer == nullptr || session->Unk141E9DB != 0 || session->WoodenSupportsPrependTo != nullptr)
+    {
+        return tile_element_paint_elements(session, firstElement);
+    }
+
+    const CoordsXY mapPosition = session->MapPosition;
+    if ((gMapSelectFlags & MAP_SELECT_FLAG_ENABLE) && mapPosition.x >= gMapSelectPositionA.x
+        && mapPosition.x <= gMapSelectPositionB.x && mapPosition.y >= gMapSelectPositionA.y
+        && mapPosition.y <= gMapSelectPositionB.y)
+    {
+        // The selection is drawn onto the surface.
+        return tile_element_paint_elements(session, firstElement);
+    }
+
+    uint64_t fingerprint;
+    if (!paint_cache_get_fingerprint(mapPosition, firstElement, fingerprint))
+    {
+        return tile_element_paint_elements(session, firstElement);
+    }
+
+    const size_t tileIndex = (mapPosition.x / COORDS_XY_STEP) + (mapPosition.y / COORDS_XY_STEP) * MAXIMUM_MAP_SIZE_TECHNICAL;
+    auto& cache = GetPaintCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.GetTileMutex(tileIndex));
+        const auto& tile = layer->Tiles[tileIndex];
+        if (tile.Generation == layer->Generation && tile.Fingerprint == fingerprint && tile.FirstElement == firstElement)
+        {
+            if (!tile.Replayable)
+            {
+                return tile_element_paint_elements(session, firstElement);
+            }
+            paint_cache_replay_tile(session, tile);
+            return tile.Completed;
+        }
+    }
+
+    static thread_local PaintCacheTile recorded;
+    recorded.Replayable = paint_cache_record_tile(session, firstElement, recorded);
+    bool completed;
+    if (recorded.Replayable)
+    {
+        paint_cache_replay_tile(session, recorded);
+        completed = recorded.Completed;
+    }
+    else
+    {
+        recorded.Ops.clear();
+        completed = tile_element_paint_elements(session, firstElement);
+    }
+
+    std::lock_guard<std::mutex> lock(cache.GetTileMutex(tileIndex));
+    auto& tile = layer->Tiles[tileIndex];
+    const size_t opCount = layer->OpCount.load(std::memory_order_relaxed);
+    if (opCount - tile.Ops.size() + recorded.Ops.size() <= PAINT_CACHE_MAX_OPS)
+    {
+        layer->OpCount.fetch_add(recorded.Ops.size() - tile.Ops.size(), std::memory_order_relaxed);
+        tile.Generation = layer->Generation;
+        tile.Fingerprint = fingerprint;
+        tile.FirstElement = firstElement;
+        tile.Replayable = recorded.Replayable;
+        tile.Completed = recorded.Completed;
+        tile.SpritePosition = recorded.SpritePosition;
+        tile.MapPosition = recorded.MapPosition;
+        tile.InteractionType = recorded.InteractionType;
+        tile.CurrentlyDrawnItem = recorded.CurrentlyDrawnItem;
+        tile.SurfaceElement = recorded.SurfaceElement;
+        tile.DidPassSurface = recorded.DidPassSurface;
+        tile.Ops.swap(recorded.Ops);
+    }
+    return completed;
+}
+
+void paint_cache_invalidate_tile(const CoordsXY& mapCoords)
+{
+    if (!map_is_location_valid(mapCoords))
+        return;
+
+    GetPaintCache().InvalidateTile(
+        (mapCoords.x / COORDS_XY_STEP) + (mapCoords.y / COORDS_XY_STEP) * MAXIMUM_MAP_SIZE_TECHNICAL);
+}
+
+void paint_cache_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs)
+{
+    for (int32_t y = mins.y; y <= maxs.y; y += COORDS_XY_STEP)
+    {
+        for (int32_t x = mins.x; x <= maxs.x; x += COORDS_XY_STEP)
+        {
+            paint_cache_invalidate_tile({ x, y });
+        }
+    }
+}
+
+void paint_cache_invalidate_all()
+{
+    GetPaintCache().InvalidateAll();
+}
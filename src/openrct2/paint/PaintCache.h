@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+
+struct paint_session;
+struct paint_struct;
+struct TileElement;
+enum ViewportInteractionItem : uint8_t;
+
+enum class PaintCacheOpType : uint8_t
+{
+    Sub98196C,
+    Sub98197C,
+    Sub98198C,
+    Sub98199C,
+    AttachToPreviousAttach,
+    AttachToPreviousPS,
+    SetLastRootPS,
+};
+
+/**
+ * A call made to one of the paint struct functions while painting a tile. Besides the arguments it
+ * holds the session state the call reads and the colour / flags the caller ended up giving the struct.
+ */
+struct PaintCacheOp
+{
+    PaintCacheOpType Type;
+    ViewportInteractionItem InteractionType;
+    int8_t XOffset;
+    int8_t YOffset;
+    int8_t BoundBoxLengthZ;
+    uint8_t ResultFlags;
+    int16_t BoundBoxLengthX;
+    int16_t BoundBoxLengthY;
+    int16_t ZOffset;
+    int16_t BoundBoxOffsetX;
+    int16_t BoundBoxOffsetY;
+    int16_t BoundBoxOffsetZ;
+    int16_t X;
+    int16_t Y;
+    // Index of the op after which LastRootPS had the value restored by SetLastRootPS, -1 for the value the tile started with.
+    int32_t LastRootOp;
+    uint32_t ImageId;
+    uint32_t ResultColour;
+    CoordsXY SpritePosition;
+    CoordsXY MapPosition;
+    const void* CurrentlyDrawnItem;
+
+    static PaintCacheOp Struct(
+        PaintCacheOpType type, uint32_t imageId, int8_t xOffset, int8_t yOffset, int16_t boundBoxLengthX,
+        int16_t boundBoxLengthY, int8_t boundBoxLengthZ, int16_t zOffset, int16_t boundBoxOffsetX = 0,
+        int16_t boundBoxOffsetY = 0, int16_t boundBoxOffsetZ = 0);
+    static PaintCacheOp Attach(PaintCacheOpType type, uint32_t imageId, int16_t x, int16_t y);
+};
+
+/**
+ * Hooks used by the paint struct functions while a tile is being recorded, see paint_session::CacheRecorder.
+ */
+paint_struct* paint_cache_record_struct(paint_session* session, const PaintCacheOp& op);
+bool paint_cache_record_attach(paint_session* session, const PaintCacheOp& op);
+
+/**
+ * Selects the cache matching the view settings of the session. Called once before generating a session.
+ */
+void paint_cache_begin_session(paint_session* session);
+
+/**
+ * Paints the elements of the tile at session->MapPosition. Tiles that only contain static elements
+ * are painted once into a scratch session to record the paint calls they make, later frames replay
+ * these calls until the tile is invalidated, instead of running the element paint functions again.
+ * @returns false when painting stopped at a corrupt element, see tile_element_paint_elements.
+ */
+bool paint_cache_paint_tile_elements(paint_session* session, TileElement* firstElement);
+
+void paint_cache_invalidate_tile(const CoordsXY& mapCoords);
+void paint_cache_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs);
+void paint_cache_invalidate_all();
@@ -34,6 +34,14 @@ Painter::Painter(const std::shared_ptr<IUiContext>& uiContext)
 {
 }
 
+Painter::~Painter()
+{
+    for (auto& session : _paintSessionPool)
+    {
+        paint_session_release_entries(session.get());
+    }
+}
+
 void Painter::Paint(IDrawingEngine& de)
 {
     auto dpi = de.GetDrawingPixelInfo();
@@ -161,8 +169,7 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     }
 
     session->DPI = *dpi;
-    session->EndOfPaintStructArray = &session->PaintStructs[4000 - 1];
-    session->NextFreePaintStruct = session->PaintStructs;
+    paint_session_reset_entries(session);
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
     session->ViewFlags = viewFlags;
@@ -177,6 +184,8 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     session->WoodenSupportsPrependTo = nullptr;
     session->CurrentlyDrawnItem = nullptr;
     session->SurfaceElement = nullptr;
+    session->CacheLayer = nullptr;
+    session->CacheRecorder = nullptr;
 
     return session;
 }
@@ -44,6 +44,7 @@ namespace OpenRCT2
 
         public:
             explicit Painter(const std::shared_ptr<Ui::IUiContext>& uiContext);
+            ~Painter();
             void Paint(Drawing::IDrawingEngine& de);
 
             paint_session* CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags);
@@ -26,6 +26,7 @@
 #include "../../world/Sprite.h"
 #include "../../world/Surface.h"
 #include "../Paint.h"
+#include "../PaintCache.h"
 #include "../Supports.h"
 #include "../VirtualFloor.h"
 #include "Paint.Surface.h"
@@ -130,6 +131,104 @@ static void blank_tiles_paint(paint_session* session, int32_t x, int32_t y)
 
 bool gShowSupportSegmentHeights = false;
 
+/**
+ * Paints the elements of the tile starting at tile_element, in order.
+ * @returns false if painting stopped early on a corrupt element.
+ */
+bool tile_element_paint_elements(paint_session* session, TileElement* tile_element)
+{
+    uint8_t rotation = session->CurrentRotation;
+    int32_t previousBaseZ = 0;
+    do
+    {
+        // Only paint tile_elements below the clip height.
+        if ((session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW) && (tile_element->GetBaseZ() > gClipHeight * COORDS_Z_STEP))
+            continue;
+
+        Direction direction = tile_element->GetDirectionWithOffset(rotation);
+        int32_t baseZ = tile_element->GetBaseZ();
+
+        // If we are on a new baseZ level, look through elements on the
+        //  same baseZ and store any types might be relevant to others
+        if (baseZ != previousBaseZ)
+        {
+            previousBaseZ = baseZ;
+            session->PathElementOnSameHeight = nullptr;
+            session->TrackElementOnSameHeight = nullptr;
+            TileElement* tile_element_sub_iterator = tile_element;
+            while (!(tile_element_sub_iterator++)->IsLastForTile())
+            {
+                if (tile_element_sub_iterator->GetBaseZ() != tile_element->GetBaseZ())
+                {
+                    break;
+                }
+                switch (tile_element_sub_iterator->GetType())
+                {
+                    case TILE_ELEMENT_TYPE_PATH:
+                        session->PathElementOnSameHeight = tile_element_sub_iterator;
+                        break;
+                    case TILE_ELEMENT_TYPE_TRACK:
+                        session->TrackElementOnSameHeight = tile_element_sub_iterator;
+                        break;
+                    case TILE_ELEMENT_TYPE_CORRUPT:
+                        // To preserve regular behaviour, make an element hidden by
+                        //  corruption also invisible to this method.
+                        if (tile_element->IsLastForTile())
+                        {
+                            break;
+                        }
+                        tile_element_sub_iterator++;
+                        break;
+                }
+            }
+        }
+
+        CoordsXY mapPosition = session->MapPosition;
+        session->CurrentlyDrawnItem = tile_element;
+        // Setup the painting of for example: the underground, signs, rides, scenery, etc.
+        switch (tile_element->GetType())
+        {
+            case TILE_ELEMENT_TYPE_SURFACE:
+                surface_paint(session, direction, baseZ, tile_element);
+                break;
+            case TILE_ELEMENT_TYPE_PATH:
+                path_paint(session, baseZ, tile_element);
+                break;
+            case TILE_ELEMENT_TYPE_TRACK:
+                track_paint(session, direction, baseZ, tile_element);
+                break;
+            case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+                scenery_paint(session, direction, baseZ, tile_element);
+                break;
+            case TILE_ELEMENT_TYPE_ENTRANCE:
+                entrance_paint(session, direction, baseZ, tile_element);
+                break;
+            case TILE_ELEMENT_TYPE_WALL:
+                fence_paint(session, direction, baseZ, tile_element);
+                break;
+            case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+                large_scenery_paint(session, direction, baseZ, tile_element);
+                break;
+            case TILE_ELEMENT_TYPE_BANNER:
+                banner_paint(session, direction, baseZ, tile_element);
+                break;
+            // A corrupt element inserted by OpenRCT2 itself, which skips the drawing of the next element only.
+            case TILE_ELEMENT_TYPE_CORRUPT:
+                if (tile_element->IsLastForTile())
+                    return false;
+                tile_element++;
+                break;
+            default:
+                // An undefined map element is most likely a corrupt element inserted by 8 cars' MOM feature to skip drawing of
+                // all elements after it.
+                return false;
+        }
+        session->MapPosition = mapPosition;
+    } while (!(tile_element++)->IsLastForTile());
+
+    return true;
+}
+
 /**
  *
  *  rct2: 0x0068B3FB
@@ -241,93 +340,20 @@ static void sub_68B3FB(paint_session* session, int32_t x, int32_t y)
     session->SpritePosition.x = x;
     session->SpritePosition.y = y;
     session->DidPassSurface = false;
-    int32_t previousBaseZ = 0;
-    do
-    {
-        // Only paint tile_elements below the clip height.
-        if ((session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW) && (tile_element->GetBaseZ() > gClipHeight * COORDS_Z_STEP))
-            continue;
-
-        Direction direction = tile_element->GetDirectionWithOffset(rotation);
-        int32_t baseZ = tile_element->GetBaseZ();
-
-        // If we are on a new baseZ level, look through elements on the
-        //  same baseZ and store any types might be relevant to others
-        if (baseZ != previousBaseZ)
-        {
-            previousBaseZ = baseZ;
-            session->PathElementOnSameHeight = nullptr;
-            session->TrackElementOnSameHeight = nullptr;
-            TileElement* tile_element_sub_iterator = tile_element;
-            while (!(tile_element_sub_iterator++)->IsLastForTile())
-            {
-                if (tile_element_sub_iterator->GetBaseZ() != tile_element->GetBaseZ())
-                {
-                    break;
-                }
-                switch (tile_element_sub_iterator->GetType())
-                {
-                    case TILE_ELEMENT_TYPE_PATH:
-                        session->PathElementOnSameHeight = tile_element_sub_iterator;
-                        break;
-                    case TILE_ELEMENT_TYPE_TRACK:
-                        session->TrackElementOnSameHeight = tile_element_sub_iterator;
-                        break;
-                    case TILE_ELEMENT_TYPE_CORRUPT:
-                        // To preserve regular behaviour, make an element hidden by
-                        //  corruption also invisible to this method.
-                        if (tile_element->IsLastForTile())
-                        {
-                            break;
-                        }
-                        tile_element_sub_iterator++;
-                        break;
-                }
-            }
-        }
 
-        CoordsXY mapPosition = session->MapPosition;
-        session->CurrentlyDrawnItem = tile_element;
-        // Setup the painting of for example: the underground, signs, rides, scenery, etc.
-        switch (tile_element->GetType())
-        {
-            case TILE_ELEMENT_TYPE_SURFACE:
-                surface_paint(session, direction, baseZ, tile_element);
-                break;
-            case TILE_ELEMENT_TYPE_PATH:
-                path_paint(session, baseZ, tile_element);
-                break;
-            case TILE_ELEMENT_TYPE_TRACK:
-                track_paint(session, direction, baseZ, tile_element);
-                break;
-            case TILE_ELEMENT_TYPE_SMALL_SCENERY:
-                scenery_paint(session, direction, baseZ, tile_element);
-                break;
-            case TILE_ELEMENT_TYPE_ENTRANCE:
-                entrance_paint(session, direction, baseZ, tile_element);
-                break;
-            case TILE_ELEMENT_TYPE_WALL:
-                fence_paint(session, direction, baseZ, tile_element);
-                break;
-            case TILE_ELEMENT_TYPE_LARGE_SCENERY:
-                large_scenery_paint(session, direction, baseZ, tile_element);
-                break;
-            case TILE_ELEMENT_TYPE_BANNER:
-                banner_paint(session, direction, baseZ, tile_element);
-                break;
-            // A corrupt element inserted by OpenRCT2 itself, which skips the drawing of the next element only.
-            case TILE_ELEMENT_TYPE_CORRUPT:
-                if (tile_element->IsLastForTile())
-                    return;
-                tile_element++;
-                break;
-            default:
-                // An undefined map element is most likely a corrupt element inserted by 8 cars' MOM feature to skip drawing of
-                // all elements after it.
-                return;
-        }
-        session->MapPosition = mapPosition;
-    } while (!(tile_element++)->IsLastForTile());
+    bool completed;
+#ifndef __TESTPAINT__
+    if (!partOfVirtualFloor)
+    {
+        completed = paint_cache_paint_tile_elements(session, tile_element);
+    }
+    else
+#endif // __TESTPAINT__
+    {
+        completed = tile_element_paint_elements(session, tile_element);
+    }
+    if (!completed)
+        return;
 
 #ifndef __TESTPAINT__
     if (gConfigGeneral.virtual_floor_style != VIRTUAL_FLOOR_STYLE_OFF && partOfVirtualFloor)
@@ -341,6 +367,9 @@ static void sub_68B3FB(paint_session* session, int32_t x, int32_t y)
         return;
     }
 
+    while (!(tile_element++)->IsLastForTile())
+        ;
+
     if ((tile_element - 1)->GetType() == TILE_ELEMENT_TYPE_SURFACE)
     {
         return;
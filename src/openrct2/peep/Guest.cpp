@@ -1911,6 +1911,102 @@ Ride* Guest::FindBestRideToGoOn()
     return mostExcitingRide;
 }
 
+/** Size in tiles of the map blocks nearby rides are indexed by. */
+static constexpr int32_t RideBlockSize = 8;
+static constexpr int32_t RideBlocksPerRow = MAXIMUM_MAP_SIZE_TECHNICAL / RideBlockSize;
+
+struct RideBlockTrackTile
+{
+    uint8_t X;
+    uint8_t Y;
+    ride_id_t RideIndex;
+};
+
+/**
+ * The rides that have track within a block of the map. Blocks on the edge of the area a guest can see
+ * are only partly visible, so the tiles holding track are kept as well.
+ */
+struct RideBlock
+{
+    uint32_t Revision;
+    bool IsValid;
+    std::vector<ride_id_t> Rides;
+    std::vector<RideBlockTrackTile> TrackTiles;
+};
+
+static std::vector<RideBlock> _rideBlocks(RideBlocksPerRow * RideBlocksPerRow);
+static std::bitset<MAX_RIDES> _tallRides;
+static bool _tallRidesValid;
+static uint32_t _tallRidesTick;
+static uint32_t _tallRidesRevision;
+
+/**
+ * Returns the block, rebuilding it if the tile elements changed since it was built. Only the blocks guests look at
+ * are rebuilt, a change in one corner of the park does not cost a scan of the whole map.
+ */
+static const RideBlock& ride_block_get(int32_t blockX, int32_t blockY)
+{
+    auto& block = _rideBlocks[blockY * RideBlocksPerRow + blockX];
+    if (block.IsValid && block.Revision == gTileElementsRevision)
+        return block;
+
+    block.IsValid = true;
+    block.Revision = gTileElementsRevision;
+    block.Rides.clear();
+    block.TrackTiles.clear();
+    for (int32_t y = blockY * RideBlockSize; y < (blockY + 1) * RideBlockSize; y++)
+    {
+        for (int32_t x = blockX * RideBlockSize; x < (blockX + 1) * RideBlockSize; x++)
+        {
+            auto tileElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (tileElement == nullptr)
+                continue;
+
+            do
+            {
+                if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
+                    continue;
+
+                auto rideIndex = tileElement->AsTrack()->GetRideIndex();
+                auto& trackTiles = block.TrackTiles;
+                if (trackTiles.empty() || trackTiles.back().X != x || trackTiles.back().Y != y
+                    || trackTiles.back().RideIndex != rideIndex)
+                {
+                    block.TrackTiles.push_back({ static_cast<uint8_t>(x), static_cast<uint8_t>(y), rideIndex });
+                }
+                if (std::find(block.Rides.begin(), block.Rides.end(), rideIndex) == block.Rides.end())
+                {
+                    block.Rides.push_back(rideIndex);
+                }
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+    return block;
+}
+
+/**
+ * The rides guests always take into consideration. Ratings, drop heights and the rides themselves only change
+ * outside of the guest updates, so the set is worked out once per tick.
+ */
+static const std::bitset<MAX_RIDES>& ride_get_tall_rides()
+{
+    if (_tallRidesValid && _tallRidesTick == gCurrentTicks && _tallRidesRevision == gTileElementsRevision)
+        return _tallRides;
+
+    _tallRides.reset();
+    _tallRidesValid = true;
+    _tallRidesTick = gCurrentTicks;
+    _tallRidesRevision = gTileElementsRevision;
+    for (auto& ride : GetRideManager())
+    {
+        if (ride.highest_drop_height > 66 || ride.excitement >= RIDE_RATING(8, 00))
+        {
+            _tallRides[ride.id] = true;
+        }
+    }
+    return _tallRides;
+}
+
 std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
 {
     std::bitset<MAX_RIDES> rideConsideration;
@@ -1932,39 +2028,44 @@ std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
     else
     {
         // Take nearby rides into consideration
-        constexpr auto radius = 10 * 32;
-        int32_t cx = floor2(x, 32);
-        int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
+        constexpr auto radius = 10;
+        const auto centre = TileCoordsXY{ CoordsXY{ x, y } };
+        const int32_t minX = std::max(centre.x - radius, 0);
+        const int32_t minY = std::max(centre.y - radius, 0);
+        const int32_t maxX = std::min(centre.x + radius, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+        const int32_t maxY = std::min(centre.y + radius, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+        if (minX <= maxX && minY <= maxY)
+        {
+            for (int32_t blockY = minY / RideBlockSize; blockY <= maxY / RideBlockSize; blockY++)
             {
-                if (map_is_location_valid({ tileX, tileY }))
+                for (int32_t blockX = minX / RideBlockSize; blockX <= maxX / RideBlockSize; blockX++)
                 {
-                    auto tileElement = map_get_first_element_at({ tileX, tileY });
-                    if (tileElement != nullptr)
+                    const auto& block = ride_block_get(blockX, blockY);
+                    const bool isInside = blockX * RideBlockSize >= minX && blockY * RideBlockSize >= minY
+                        && (blockX + 1) * RideBlockSize - 1 <= maxX && (blockY + 1) * RideBlockSize - 1 <= maxY;
+                    if (isInside)
                     {
-                        do
+                        for (auto rideIndex : block.Rides)
                         {
-                            if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
+                            rideConsideration[rideIndex] = true;
+                        }
+                    }
+                    else
+                    {
+                        for (const auto& trackTile : block.TrackTiles)
+                        {
+                            if (trackTile.X >= minX && trackTile.X <= maxX && trackTile.Y >= minY && trackTile.Y <= maxY)
                             {
-                                auto rideIndex = tileElement->AsTrack()->GetRideIndex();
-                                rideConsideration[rideIndex] = true;
+                                rideConsideration[trackTile.RideIndex] = true;
                             }
-                        } while (!(tileElement++)->IsLastForTile());
+                        }
                     }
                 }
             }
         }
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
-        for (auto& ride : GetRideManager())
-        {
-            if (ride.highest_drop_height > 66 || ride.excitement >= RIDE_RATING(8, 00))
-            {
-                rideConsideration[ride.id] = true;
-            }
-        }
+        rideConsideration |= ride_get_tall_rides();
     }
 
     return rideConsideration;
@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include "../core/Guard.hpp"
+#include "../core/TaskScheduler.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -18,26 +19,18 @@
 #include "Peep.h"
 #include "Staff.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-static bool _peepPathFindIsStaff;
-static int8_t _peepPathFindNumJunctions;
-static int8_t _peepPathFindMaxJunctions;
-static int32_t _peepPathFindTilesChecked;
-static uint8_t _peepPathFindFewestNumSteps;
+bool gPeepPathFindUseCorridors = true;
 
 static int32_t guest_surface_path_finding(Peep* peep);
 
-/* A junction history for the peep pathfinding heuristic search
- * The magic number 16 is the largest value returned by
- * peep_pathfind_get_max_number_junctions() which should eventually
- * be declared properly. */
-static struct
-{
-    TileCoordsXYZ location;
-    Direction direction;
-} _peepPathFindHistory[16];
-
 enum
 {
     PATH_SEARCH_DEAD_END,
@@ -55,6 +48,88 @@ enum
     PATH_SEARCH_FAILED
 };
 
+/**
+ * A run of plain thin path tiles: each tile has a single path element with exactly two edges that is neither wide
+ * nor a queue, and no other element the heuristic search could walk onto or that could block an edge. The search
+ * can only walk straight through such tiles without updating its result, so it steps over the whole run at once.
+ */
+struct PathCorridor
+{
+    // Number of tiles in the corridor, 0 if the tile it was looked up for is not plain thin path.
+    uint8_t Length;
+    Direction ExitEdge;
+    // The last tile of the corridor, z is the height the search leaves it at.
+    TileCoordsXYZ Last;
+    TileElement* LastElement;
+    TileCoordsXY Min;
+    TileCoordsXY Max;
+
+    bool Contains(int32_t x, int32_t y) const
+    {
+        return x >= Min.x && x <= Max.x && y >= Min.y && y <= Max.y;
+    }
+};
+
+/**
+ * Everything the heuristic search of a guest depends on besides the map: the junction it starts from, the goal,
+ * the edges left to try, the search limits and the junctions the guest remembers. Guests heading for the same
+ * goal through the same junctions, e.g. when the park closes, share the result of one search.
+ */
+using PathSearchKey = std::array<uint8_t, 34>;
+
+// Keeps the results of a busy park's decisions without letting the cache grow without limit.
+constexpr size_t MaxPathSearchResults = 1 << 16;
+
+struct PathSearchKeyHash
+{
+    size_t operator()(const PathSearchKey& key) const
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (auto b : key)
+        {
+            hash = (hash ^ b) * 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+/**
+ * The path finding state of one thread: the goal the caller gave, the limits and junction history of the search in
+ * progress and the corridors and results kept between searches. Searches on different threads do not share any of
+ * it, the state is looked up once per search and passed along from there.
+ */
+struct PathFindState
+{
+    TileCoordsXYZ Goal;
+    ride_id_t QueueRideIndex;
+    bool IgnoreForeignQueues;
+    // Used to allow walking through no entry banners
+    bool IsStaff;
+    int8_t NumJunctions;
+    int8_t MaxJunctions;
+    int32_t TilesChecked;
+    uint8_t FewestNumSteps;
+
+    /* A junction history for the peep pathfinding heuristic search
+     * The magic number 16 is the largest value returned by
+     * peep_pathfind_get_max_number_junctions() which should eventually
+     * be declared properly. */
+    struct
+    {
+        TileCoordsXYZ location;
+        Direction direction;
+    } History[16];
+
+    std::unordered_map<uint64_t, PathCorridor> Corridors;
+    uint32_t CorridorsRevision;
+    std::unordered_map<PathSearchKey, Direction, PathSearchKeyHash> SearchResults;
+    uint32_t SearchResultsRevision;
+    // Collects the searches made while preparing the path decisions of guests, see guest_path_finding_prepare_all.
+    std::vector<std::pair<PathSearchKey, Direction>>* PreparedSearches;
+};
+
+static thread_local PathFindState _pathFindState;
+
 static TileElement* get_banner_on_path(TileElement* path_element)
 {
     // This is an improved version of original.
@@ -80,9 +155,9 @@ static TileElement* get_banner_on_path(TileElement* path_element)
     return nullptr;
 }
 
-static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
+static int32_t banner_clear_path_edges(const PathFindState& state, PathElement* pathElement, int32_t edges)
 {
-    if (_peepPathFindIsStaff)
+    if (state.IsStaff)
         return edges;
     TileElement* bannerElement = get_banner_on_path(reinterpret_cast<TileElement*>(pathElement));
     if (bannerElement != nullptr)
@@ -98,9 +173,9 @@ static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
 /**
  * Gets the connected edges of a path that are permitted (i.e. no 'no entry' signs)
  */
-static int32_t path_get_permitted_edges(PathElement* pathElement)
+static int32_t path_get_permitted_edges(const PathFindState& state, PathElement* pathElement)
 {
-    return banner_clear_path_edges(pathElement, pathElement->GetEdgesAndCorners()) & 0x0F;
+    return banner_clear_path_edges(state, pathElement, pathElement->GetEdgesAndCorners()) & 0x0F;
 }
 
 /**
@@ -340,7 +415,7 @@ static uint8_t footpath_element_dest_in_dir(
                 if (tileElement->AsPath()->IsWide())
                     return PATH_SEARCH_WIDE;
 
-                uint8_t edges = path_get_permitted_edges(tileElement->AsPath());
+                uint8_t edges = path_get_permitted_edges(_pathFindState, tileElement->AsPath());
                 edges &= ~(1 << direction_reverse(chosenDirection));
                 loc.z = tileElement->base_height;
 
@@ -518,6 +593,135 @@ static int32_t CalculateHeuristicPathingScore(const TileCoordsXYZ& loc1, const T
     return xDelta + yDelta + zDelta;
 }
 
+/**
+ * Returns the path element of loc if it is a plain thin path tile, entered at height loc.z in direction edge, see
+ * PathCorridor.
+ */
+static TileElement* path_corridor_get_element(const TileCoordsXYZ& loc, Direction edge)
+{
+    TileElement* tileElement = map_get_first_element_at(loc.ToCoordsXY());
+    if (tileElement == nullptr)
+        return nullptr;
+
+    TileElement* pathElement = nullptr;
+    do
+    {
+        switch (tileElement->GetType())
+        {
+            case TILE_ELEMENT_TYPE_PATH:
+                if (tileElement->IsGhost())
+                    break;
+                if (pathElement != nullptr)
+                    return nullptr;
+                pathElement = tileElement;
+                break;
+            case TILE_ELEMENT_TYPE_TRACK:
+            case TILE_ELEMENT_TYPE_ENTRANCE:
+                if (!tileElement->IsGhost())
+                    return nullptr;
+                break;
+            case TILE_ELEMENT_TYPE_BANNER:
+                // No entry signs, which staff ignore.
+                return nullptr;
+        }
+    } while (!(tileElement++)->IsLastForTile());
+
+    if (pathElement == nullptr || !is_valid_path_z_and_direction(pathElement, loc.z, edge))
+        return nullptr;
+
+    auto path = pathElement->AsPath();
+    if (path->IsWide() || path->IsQueue() || bitcount(path->GetEdges()) != 2)
+        return nullptr;
+
+    // The search would branch if the path does not connect back to the tile it came from.
+    if (bitcount(path->GetEdges() & ~(1 << direction_reverse(edge))) != 1)
+        return nullptr;
+
+    return pathElement;
+}
+
+/**
+ * Drops the corridors that run through or end next to a tile changed since they were found, or all of them if the
+ * changed tiles are not known.
+ */
+static void path_corridors_update(PathFindState& state)
+{
+    std::vector<TileCoordsXY> changedTiles;
+    if (!tile_elements_get_changed_tiles(state.CorridorsRevision, changedTiles))
+    {
+        state.Corridors.clear();
+    }
+    else
+    {
+        for (auto it = state.Corridors.begin(); it != state.Corridors.end();)
+        {
+            const auto& corridor = it->second;
+            // The tile after the last one of the corridor decides where it ends.
+            bool isChanged = std::any_of(changedTiles.begin(), changedTiles.end(), [&corridor](const TileCoordsXY& tile) {
+                return tile.x >= corridor.Min.x - 1 && tile.x <= corridor.Max.x + 1 && tile.y >= corridor.Min.y - 1
+                    && tile.y <= corridor.Max.y + 1;
+            });
+            it = isChanged ? state.Corridors.erase(it) : std::next(it);
+        }
+    }
+    state.CorridorsRevision = gTileElementsRevision;
+}
+
+/**
+ * Returns the corridor that starts at loc when entered in direction edge. Corridors are found on first use and
+ * kept until a tile they depend on changes.
+ */
+static const PathCorridor& path_corridor_get(PathFindState& state, const TileCoordsXYZ& loc, Direction edge)
+{
+    // Longer corridors would always reach the step limit of the search.
+    constexpr uint8_t MaxCorridorLength = 199;
+
+    if (state.CorridorsRevision != gTileElementsRevision)
+    {
+        path_corridors_update(state);
+    }
+
+    const uint64_t key = static_cast<uint64_t>(loc.x & 0xFFFF) | (static_cast<uint64_t>(loc.y & 0xFFFF) << 16)
+        | (static_cast<uint64_t>(loc.z & 0xFFFF) << 32) | (static_cast<uint64_t>(edge) << 48);
+    auto [it, inserted] = state.Corridors.try_emplace(key);
+    auto& corridor = it->second;
+    if (!inserted)
+        return corridor;
+
+    corridor.Length = 0;
+    corridor.Min = { loc.x, loc.y };
+    corridor.Max = { loc.x, loc.y };
+
+    TileCoordsXYZ current = loc;
+    Direction direction = edge;
+    while (corridor.Length < MaxCorridorLength)
+    {
+        TileElement* pathElement = path_corridor_get_element(current, direction);
+        if (pathElement == nullptr)
+            break;
+
+        auto path = pathElement->AsPath();
+        Direction exitEdge = bitscanforward(path->GetEdges() & ~(1 << direction_reverse(direction)));
+        uint8_t height = pathElement->base_height;
+        if (path->IsSloped() && path->GetSlopeDirection() == exitEdge)
+        {
+            height += 2;
+        }
+
+        corridor.Length++;
+        corridor.ExitEdge = exitEdge;
+        corridor.Last = { current.x, current.y, height };
+        corridor.LastElement = pathElement;
+        corridor.Min = { std::min(corridor.Min.x, current.x), std::min(corridor.Min.y, current.y) };
+        corridor.Max = { std::max(corridor.Max.x, current.x), std::max(corridor.Max.y, current.y) };
+
+        current = corridor.Last;
+        current += TileDirectionDelta[exitEdge];
+        direction = exitEdge;
+    }
+    return corridor;
+}
+
 /**
  * Searches for the tile with the best heuristic score within the search limits
  * starting from the given tile x,y,z and going in the given direction test_edge.
@@ -564,9 +768,9 @@ static int32_t CalculateHeuristicPathingScore(const TileCoordsXYZ& loc1, const T
  *
  * The parameters/variables that limit the search space are:
  *   - counter (param) - number of steps walked in the current search path;
- *   - _peepPathFindTilesChecked (variable) - cumulative number of tiles that can be
+ *   - state.TilesChecked (search state) - cumulative number of tiles that can be
  *     checked in the entire search;
- *   - _peepPathFindNumJunctions (variable) - number of thin junctions that can be
+ *   - state.NumJunctions (search state) - number of thin junctions that can be
  *     checked in a single search path;
  *
  * Other global variables/state that affect the search space are:
@@ -575,9 +779,9 @@ static int32_t CalculateHeuristicPathingScore(const TileCoordsXYZ& loc1, const T
  *     wide path. This means peeps heading for a destination will only leave
  *     thin paths if walking 1 tile onto a wide path is closer than following
  *     non-wide paths;
- *   - gPeepPathFindIgnoreForeignQueues
- *   - gPeepPathFindQueueRideIndex - the ride the peep is heading for
- *   - _peepPathFindHistory - the search path telemetry consisting of the
+ *   - state.IgnoreForeignQueues
+ *   - state.QueueRideIndex - the ride the peep is heading for
+ *   - state.History - the search path telemetry consisting of the
  *     starting point and all thin junctions with directions navigated
  *     in the current search path - also used to detect path loops.
  *
@@ -595,8 +799,8 @@ static int32_t CalculateHeuristicPathingScore(const TileCoordsXYZ& loc1, const T
  *  rct2: 0x0069A997
  */
 static void peep_pathfind_heuristic_search(
-    TileCoordsXYZ loc, Peep* peep, TileElement* currentTileElement, bool inPatrolArea, uint8_t counter, uint16_t* endScore,
-    Direction test_edge, uint8_t* endJunctions, TileCoordsXYZ junctionList[16], uint8_t directionList[16],
+    PathFindState& state, TileCoordsXYZ loc, Peep* peep, TileElement* currentTileElement, bool inPatrolArea, uint8_t counter,
+    uint16_t* endScore, Direction test_edge, uint8_t* endJunctions, TileCoordsXYZ junctionList[16], uint8_t directionList[16],
     TileCoordsXYZ* endXYZ, uint8_t* endSteps)
 {
     uint8_t searchResult = PATH_SEARCH_FAILED;
@@ -606,14 +810,33 @@ static void peep_pathfind_heuristic_search(
 
     loc += TileDirectionDelta[test_edge];
 
+    /* Step over a corridor of plain thin path at once when none of its tiles
+     * can end the search path: the goal and the start of the search are not
+     * in it and no search limit is reached in it. Mechanics check their
+     * patrol area on every tile, so they always walk tile by tile. */
+    if (gPeepPathFindUseCorridors && !(peep->AssignedPeepType == PeepType::Staff && peep->StaffType == STAFF_TYPE_MECHANIC))
+    {
+        const auto& corridor = path_corridor_get(state, loc, test_edge);
+        if (corridor.Length != 0 && counter + corridor.Length < 200 && state.TilesChecked > corridor.Length
+            && !corridor.Contains(state.Goal.x, state.Goal.y)
+            && !corridor.Contains(state.History[0].location.x, state.History[0].location.y))
+        {
+            state.TilesChecked -= corridor.Length;
+            peep_pathfind_heuristic_search(
+                state, corridor.Last, peep, corridor.LastElement, inPatrolArea, counter + corridor.Length, endScore,
+                corridor.ExitEdge, endJunctions, junctionList, directionList, endXYZ, endSteps);
+            return;
+        }
+    }
+
     ++counter;
-    _peepPathFindTilesChecked--;
+    state.TilesChecked--;
 
     /* If this is where the search started this is a search loop and the
      * current search path ends here.
      * Return without updating the parameters (best result so far). */
-    if ((_peepPathFindHistory[0].location.x == static_cast<uint8_t>(loc.x))
-        && (_peepPathFindHistory[0].location.y == static_cast<uint8_t>(loc.y)) && (_peepPathFindHistory[0].location.z == loc.z))
+    if ((state.History[0].location.x == static_cast<uint8_t>(loc.x))
+        && (state.History[0].location.y == static_cast<uint8_t>(loc.y)) && (state.History[0].location.z == loc.z))
     {
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
         if (gPathFindDebug)
@@ -759,9 +982,9 @@ static void peep_pathfind_heuristic_search(
                 else
                 { // numEdges == 2
                     if (tileElement->AsPath()->IsQueue()
-                        && tileElement->AsPath()->GetRideIndex() != gPeepPathFindQueueRideIndex)
+                        && tileElement->AsPath()->GetRideIndex() != state.QueueRideIndex)
                     {
-                        if (gPeepPathFindIgnoreForeignQueues && (tileElement->AsPath()->GetRideIndex() != 0xFF))
+                        if (state.IgnoreForeignQueues && (tileElement->AsPath()->GetRideIndex() != 0xFF))
                         {
                             // Path is a queue we aren't interested in
                             /* The rideIndex will be useful for
@@ -796,7 +1019,7 @@ static void peep_pathfind_heuristic_search(
          * Ignore for now. */
 
         // Calculate the heuristic score of this map element.
-        uint16_t new_score = CalculateHeuristicPathingScore(loc, gPeepPathFindGoalPosition);
+        uint16_t new_score = CalculateHeuristicPathingScore(loc, state.Goal);
 
         /* If this map element is the search goal the current search path ends here. */
         if (new_score == 0)
@@ -811,14 +1034,14 @@ static void peep_pathfind_heuristic_search(
                 // Update the end x,y,z
                 *endXYZ = loc;
                 // Update the telemetry
-                *endJunctions = _peepPathFindMaxJunctions - _peepPathFindNumJunctions;
+                *endJunctions = state.MaxJunctions - state.NumJunctions;
                 for (uint8_t junctInd = 0; junctInd < *endJunctions; junctInd++)
                 {
-                    uint8_t histIdx = _peepPathFindMaxJunctions - junctInd;
-                    junctionList[junctInd].x = _peepPathFindHistory[histIdx].location.x;
-                    junctionList[junctInd].y = _peepPathFindHistory[histIdx].location.y;
-                    junctionList[junctInd].z = _peepPathFindHistory[histIdx].location.z;
-                    directionList[junctInd] = _peepPathFindHistory[histIdx].direction;
+                    uint8_t histIdx = state.MaxJunctions - junctInd;
+                    junctionList[junctInd].x = state.History[histIdx].location.x;
+                    junctionList[junctInd].y = state.History[histIdx].location.y;
+                    junctionList[junctInd].z = state.History[histIdx].location.z;
+                    directionList[junctInd] = state.History[histIdx].direction;
                 }
             }
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
@@ -869,14 +1092,14 @@ static void peep_pathfind_heuristic_search(
                 // Update the end x,y,z
                 *endXYZ = loc;
                 // Update the telemetry
-                *endJunctions = _peepPathFindMaxJunctions - _peepPathFindNumJunctions;
+                *endJunctions = state.MaxJunctions - state.NumJunctions;
                 for (uint8_t junctInd = 0; junctInd < *endJunctions; junctInd++)
                 {
-                    uint8_t histIdx = _peepPathFindMaxJunctions - junctInd;
-                    junctionList[junctInd].x = _peepPathFindHistory[histIdx].location.x;
-                    junctionList[junctInd].y = _peepPathFindHistory[histIdx].location.y;
-                    junctionList[junctInd].z = _peepPathFindHistory[histIdx].location.z;
-                    directionList[junctInd] = _peepPathFindHistory[histIdx].direction;
+                    uint8_t histIdx = state.MaxJunctions - junctInd;
+                    junctionList[junctInd].x = state.History[histIdx].location.x;
+                    junctionList[junctInd].y = state.History[histIdx].location.y;
+                    junctionList[junctInd].z = state.History[histIdx].location.z;
+                    directionList[junctInd] = state.History[histIdx].direction;
                 }
             }
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
@@ -892,7 +1115,7 @@ static void peep_pathfind_heuristic_search(
 
         /* Get all the permitted_edges of the map element. */
         Guard::Assert(tileElement->AsPath() != nullptr);
-        uint8_t edges = path_get_permitted_edges(tileElement->AsPath());
+        uint8_t edges = path_get_permitted_edges(state, tileElement->AsPath());
 
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
         if (gPathFindDebug)
@@ -923,7 +1146,7 @@ static void peep_pathfind_heuristic_search(
 
         /* Check if either of the search limits has been reached:
          * - max number of steps or max tiles checked. */
-        if (counter >= 200 || _peepPathFindTilesChecked <= 0)
+        if (counter >= 200 || state.TilesChecked <= 0)
         {
             /* The current search ends here.
              * The path continues, so the goal could still be reachable from here.
@@ -937,14 +1160,14 @@ static void peep_pathfind_heuristic_search(
                 // Update the end x,y,z
                 *endXYZ = loc;
                 // Update the telemetry
-                *endJunctions = _peepPathFindMaxJunctions - _peepPathFindNumJunctions;
+                *endJunctions = state.MaxJunctions - state.NumJunctions;
                 for (uint8_t junctInd = 0; junctInd < *endJunctions; junctInd++)
                 {
-                    uint8_t histIdx = _peepPathFindMaxJunctions - junctInd;
-                    junctionList[junctInd].x = _peepPathFindHistory[histIdx].location.x;
-                    junctionList[junctInd].y = _peepPathFindHistory[histIdx].location.y;
-                    junctionList[junctInd].z = _peepPathFindHistory[histIdx].location.z;
-                    directionList[junctInd] = _peepPathFindHistory[histIdx].direction;
+                    uint8_t histIdx = state.MaxJunctions - junctInd;
+                    junctionList[junctInd].x = state.History[histIdx].location.x;
+                    junctionList[junctInd].y = state.History[histIdx].location.y;
+                    junctionList[junctInd].z = state.History[histIdx].location.z;
+                    directionList[junctInd] = state.History[histIdx].direction;
                 }
             }
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
@@ -977,7 +1200,7 @@ static void peep_pathfind_heuristic_search(
                  * peep->PathfindHistory - loops through remembered junctions
                  *     the peep has already passed through getting to its
                  *     current position while on the way to its current goal;
-                 * _peepPathFindHistory - loops in the current search path. */
+                 * state.History - loops in the current search path. */
                 bool pathLoop = false;
                 /* Check the peep->PathfindHistory to see if this junction has
                  * already been visited by the peep while heading for this goal. */
@@ -1004,15 +1227,15 @@ static void peep_pathfind_heuristic_search(
 
                 if (!pathLoop)
                 {
-                    /* Check the _peepPathFindHistory to see if this junction has been
+                    /* Check the state.History to see if this junction has been
                      * previously passed through in the current search path.
                      * i.e. this is a loop in the current search path. */
-                    for (int32_t junctionNum = _peepPathFindNumJunctions + 1; junctionNum <= _peepPathFindMaxJunctions;
+                    for (int32_t junctionNum = state.NumJunctions + 1; junctionNum <= state.MaxJunctions;
                          junctionNum++)
                     {
-                        if ((_peepPathFindHistory[junctionNum].location.x == static_cast<uint8_t>(loc.x))
-                            && (_peepPathFindHistory[junctionNum].location.y == static_cast<uint8_t>(loc.y))
-                            && (_peepPathFindHistory[junctionNum].location.z == loc.z))
+                        if ((state.History[junctionNum].location.x == static_cast<uint8_t>(loc.x))
+                            && (state.History[junctionNum].location.y == static_cast<uint8_t>(loc.y))
+                            && (state.History[junctionNum].location.z == loc.z))
                         {
                             pathLoop = true;
                             break;
@@ -1037,7 +1260,7 @@ static void peep_pathfind_heuristic_search(
                  * be reachable from here.
                  * If the search result is better than the best so far (in the parameters),
                  * then update the parameters with this search before continuing to the next map element. */
-                if (_peepPathFindNumJunctions <= 0)
+                if (state.NumJunctions <= 0)
                 {
                     if (new_score < *endScore || (new_score == *endScore && counter < *endSteps))
                     {
@@ -1047,14 +1270,14 @@ static void peep_pathfind_heuristic_search(
                         // Update the end x,y,z
                         *endXYZ = loc;
                         // Update the telemetry
-                        *endJunctions = _peepPathFindMaxJunctions; // - _peepPathFindNumJunctions;
+                        *endJunctions = state.MaxJunctions; // - state.NumJunctions;
                         for (uint8_t junctInd = 0; junctInd < *endJunctions; junctInd++)
                         {
-                            uint8_t histIdx = _peepPathFindMaxJunctions - junctInd;
-                            junctionList[junctInd].x = _peepPathFindHistory[histIdx].location.x;
-                            junctionList[junctInd].y = _peepPathFindHistory[histIdx].location.y;
-                            junctionList[junctInd].z = _peepPathFindHistory[histIdx].location.z;
-                            directionList[junctInd] = _peepPathFindHistory[histIdx].direction;
+                            uint8_t histIdx = state.MaxJunctions - junctInd;
+                            junctionList[junctInd].x = state.History[histIdx].location.x;
+                            junctionList[junctInd].y = state.History[histIdx].location.y;
+                            junctionList[junctInd].z = state.History[histIdx].location.z;
+                            directionList[junctInd] = state.History[histIdx].direction;
                         }
                     }
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
@@ -1070,12 +1293,12 @@ static void peep_pathfind_heuristic_search(
 
                 /* This junction was NOT previously visited in the current
                  * search path, so add the junction to the history. */
-                _peepPathFindHistory[_peepPathFindNumJunctions].location.x = static_cast<uint8_t>(loc.x);
-                _peepPathFindHistory[_peepPathFindNumJunctions].location.y = static_cast<uint8_t>(loc.y);
-                _peepPathFindHistory[_peepPathFindNumJunctions].location.z = loc.z;
+                state.History[state.NumJunctions].location.x = static_cast<uint8_t>(loc.x);
+                state.History[state.NumJunctions].location.y = static_cast<uint8_t>(loc.y);
+                state.History[state.NumJunctions].location.z = loc.z;
                 // .direction take is added below.
 
-                _peepPathFindNumJunctions--;
+                state.NumJunctions--;
             }
         }
 
@@ -1084,7 +1307,7 @@ static void peep_pathfind_heuristic_search(
         do
         {
             edges &= ~(1 << next_test_edge);
-            uint8_t savedNumJunctions = _peepPathFindNumJunctions;
+            uint8_t savedNumJunctions = state.NumJunctions;
 
             uint8_t height = loc.z;
             if (tileElement->AsPath()->IsSloped() && tileElement->AsPath()->GetSlopeDirection() == next_test_edge)
@@ -1113,13 +1336,13 @@ static void peep_pathfind_heuristic_search(
             if (thin_junction)
             {
                 /* Add the current test_edge to the history. */
-                _peepPathFindHistory[_peepPathFindNumJunctions + 1].direction = next_test_edge;
+                state.History[state.NumJunctions + 1].direction = next_test_edge;
             }
 
             peep_pathfind_heuristic_search(
-                { loc.x, loc.y, height }, peep, tileElement, nextInPatrolArea, counter, endScore, next_test_edge, endJunctions,
-                junctionList, directionList, endXYZ, endSteps);
-            _peepPathFindNumJunctions = savedNumJunctions;
+                state, { loc.x, loc.y, height }, peep, tileElement, nextInPatrolArea, counter, endScore, next_test_edge,
+                endJunctions, junctionList, directionList, endXYZ, endSteps);
+            state.NumJunctions = savedNumJunctions;
 
 #if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
             if (gPathFindDebug)
@@ -1161,18 +1384,102 @@ static void peep_pathfind_heuristic_search(
  *
  *  rct2: 0x0069A5F0
  */
+/**
+ * Returns the key of the search about to run for the peep, see PathSearchKey. Staff searches are not shared as
+ * they also depend on the patrol area of the staff member.
+ */
+static std::optional<PathSearchKey> path_search_get_key(
+    PathFindState& state, const TileCoordsXYZ& loc, const Peep* peep, uint8_t edges)
+{
+    if (peep->AssignedPeepType != PeepType::Guest)
+        return std::nullopt;
+
+    if (state.SearchResultsRevision != gTileElementsRevision || state.SearchResults.size() >= MaxPathSearchResults)
+    {
+        state.SearchResults.clear();
+        state.SearchResultsRevision = gTileElementsRevision;
+    }
+
+    /* The search only looks up junctions in the history by location, so the
+     * order of the history does not matter unless the same junction is
+     * remembered twice with different edges left to try. */
+    std::array<rct12_xyzd8, 4> history;
+    std::copy(std::begin(peep->PathfindHistory), std::end(peep->PathfindHistory), history.begin());
+    auto toTuple = [](const rct12_xyzd8& entry) { return std::make_tuple(entry.x, entry.y, entry.z, entry.direction); };
+    bool isOrdered = false;
+    for (size_t i = 0; i < history.size(); i++)
+    {
+        for (size_t j = i + 1; j < history.size(); j++)
+        {
+            if (history[i].x == history[j].x && history[i].y == history[j].y && history[i].z == history[j].z
+                && history[i].direction != history[j].direction)
+            {
+                isOrdered = true;
+            }
+        }
+    }
+    if (!isOrdered)
+    {
+        std::sort(history.begin(), history.end(), [&toTuple](const rct12_xyzd8& a, const rct12_xyzd8& b) {
+            return toTuple(a) < toTuple(b);
+        });
+    }
+
+    PathSearchKey key{};
+    size_t index = 0;
+    auto write = [&key, &index](int32_t value) {
+        key[index++] = static_cast<uint8_t>(value);
+        key[index++] = static_cast<uint8_t>(value >> 8);
+    };
+    write(loc.x);
+    write(loc.y);
+    write(loc.z);
+    write(state.Goal.x);
+    write(state.Goal.y);
+    write(state.Goal.z);
+    write(state.QueueRideIndex);
+    key[index++] = edges;
+    key[index++] = static_cast<uint8_t>(state.MaxJunctions);
+    key[index++] = state.IgnoreForeignQueues ? 1 : 0;
+    for (const auto& entry : history)
+    {
+        key[index++] = entry.x;
+        key[index++] = entry.y;
+        key[index++] = entry.z;
+        key[index++] = entry.direction;
+    }
+    Guard::Assert(index == key.size());
+    return key;
+}
+
+static void path_search_store(PathFindState& state, const std::optional<PathSearchKey>& key, Direction direction)
+{
+    if (key.has_value())
+    {
+        state.SearchResults[*key] = direction;
+        if (state.PreparedSearches != nullptr)
+        {
+            state.PreparedSearches->emplace_back(*key, direction);
+        }
+    }
+}
+
 Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
 {
+    auto& state = _pathFindState;
+    state.Goal = gPeepPathFindGoalPosition;
+    state.QueueRideIndex = gPeepPathFindQueueRideIndex;
+    state.IgnoreForeignQueues = gPeepPathFindIgnoreForeignQueues;
+
     // The max number of thin junctions searched - a per-search-path limit.
-    _peepPathFindMaxJunctions = peep_pathfind_get_max_number_junctions(peep);
+    state.MaxJunctions = peep_pathfind_get_max_number_junctions(peep);
 
     /* The max number of tiles to check - a whole-search limit.
      * Mainly to limit the performance impact of the path finding. */
     int32_t maxTilesChecked = (peep->AssignedPeepType == PeepType::Staff) ? 50000 : 15000;
-    // Used to allow walking through no entry banners
-    _peepPathFindIsStaff = (peep->AssignedPeepType == PeepType::Staff);
+    state.IsStaff = (peep->AssignedPeepType == PeepType::Staff);
 
-    TileCoordsXYZ goal = gPeepPathFindGoalPosition;
+    TileCoordsXYZ goal = state.Goal;
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
     if (gPathFindDebug)
@@ -1228,7 +1535,7 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
         isThin = isThin || path_is_thin_junction(dest_tile_element->AsPath(), loc);
 
         // Collect the permitted edges of ALL matching path elements at this location.
-        permitted_edges |= path_get_permitted_edges(dest_tile_element->AsPath());
+        permitted_edges |= path_get_permitted_edges(state, dest_tile_element->AsPath());
     } while (!(dest_tile_element++)->IsLastForTile());
     // Peep is not on a path.
     if (!found)
@@ -1327,8 +1634,31 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
 
     int32_t chosen_edge = bitscanforward(edges);
 
-    // Peep has multiple edges still to try.
+    /* Reuse the result of an identical search, see PathSearchKey. */
+    std::optional<PathSearchKey> searchKey;
+    bool isSearchCached = false;
     if (edges & ~(1 << chosen_edge))
+    {
+        searchKey = path_search_get_key(state, loc, peep, edges);
+        if (searchKey.has_value())
+        {
+            auto result = state.SearchResults.find(*searchKey);
+            if (result != state.SearchResults.end())
+            {
+                if (state.PreparedSearches != nullptr)
+                {
+                    state.PreparedSearches->emplace_back(*searchKey, result->second);
+                }
+                if (result->second == INVALID_DIRECTION)
+                    return INVALID_DIRECTION;
+                chosen_edge = result->second;
+                isSearchCached = true;
+            }
+        }
+    }
+
+    // Peep has multiple edges still to try.
+    if (!isSearchCached && (edges & ~(1 << chosen_edge)))
     {
         uint16_t best_score = 0xFFFF;
         uint8_t best_sub = 0xFF;
@@ -1360,23 +1690,23 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
                 height += 0x2;
             }
 
-            _peepPathFindFewestNumSteps = 255;
+            state.FewestNumSteps = 255;
             /* Divide the maxTilesChecked global search limit
              * between the remaining edges to ensure the search
              * covers all of the remaining edges. */
-            _peepPathFindTilesChecked = maxTilesChecked / numEdges;
-            _peepPathFindNumJunctions = _peepPathFindMaxJunctions;
+            state.TilesChecked = maxTilesChecked / numEdges;
+            state.NumJunctions = state.MaxJunctions;
 
-            // Initialise _peepPathFindHistory.
-            std::memset(static_cast<void*>(_peepPathFindHistory), 0xFF, sizeof(_peepPathFindHistory));
+            // Initialise state.History.
+            std::memset(static_cast<void*>(state.History), 0xFF, sizeof(state.History));
 
             /* The pathfinding will only use elements
-             * 1.._peepPathFindMaxJunctions, so the starting point
+             * 1..state.MaxJunctions, so the starting point
              * is placed in element 0 */
-            _peepPathFindHistory[0].location.x = static_cast<uint8_t>(loc.x);
-            _peepPathFindHistory[0].location.y = static_cast<uint8_t>(loc.y);
-            _peepPathFindHistory[0].location.z = loc.z;
-            _peepPathFindHistory[0].direction = 0xF;
+            state.History[0].location.x = static_cast<uint8_t>(loc.x);
+            state.History[0].location.y = static_cast<uint8_t>(loc.y);
+            state.History[0].location.z = loc.z;
+            state.History[0].direction = 0xF;
 
             uint16_t score = 0xFFFF;
             /* Variable endXYZ contains the end location of the
@@ -1416,7 +1746,7 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
 #endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
 
             peep_pathfind_heuristic_search(
-                { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
+                state, { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
                 endJunctionList, endDirectionList, &endXYZ, &endSteps);
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
@@ -1466,8 +1796,10 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
                 log_verbose("Pathfind heuristic search failed.");
             }
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+            path_search_store(state, searchKey, INVALID_DIRECTION);
             return INVALID_DIRECTION;
         }
+        path_search_store(state, searchKey, chosen_edge);
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
         if (gPathFindDebug)
         {
@@ -1877,6 +2209,71 @@ static StationIndex guest_pathfinding_select_random_station(
 
     return 0;
 }
+
+/**
+ * Returns the goal of a guest heading for the given open ride from the tile at from: the end of the queue of the
+ * closest entrance station.
+ */
+static TileCoordsXYZ guest_path_find_ride_goal(const Guest* peep, Ride* ride, const TileCoordsXYZ& from)
+{
+    /* Find the ride's closest entrance station to the peep.
+     * At the same time, count how many entrance stations there are and
+     * which stations are entrance stations. */
+    auto bestScore = std::numeric_limits<int32_t>::max();
+    StationIndex closestStationNum = 0;
+
+    int32_t numEntranceStations = 0;
+    std::bitset<MAX_STATIONS> entranceStations = {};
+
+    for (StationIndex stationNum = 0; stationNum < MAX_STATIONS; ++stationNum)
+    {
+        // Skip if stationNum has no entrance (so presumably an exit only station)
+        if (ride_get_entrance_location(ride, stationNum).isNull())
+            continue;
+
+        numEntranceStations++;
+        entranceStations[stationNum] = true;
+
+        TileCoordsXYZD entranceLocation = ride_get_entrance_location(ride, stationNum);
+        auto score = CalculateHeuristicPathingScore(entranceLocation, from);
+        if (score < bestScore)
+        {
+            bestScore = score;
+            closestStationNum = stationNum;
+            continue;
+        }
+    }
+
+    // Ride has no stations with an entrance, so head to station 0.
+    if (numEntranceStations == 0)
+        closestStationNum = 0;
+
+    if (numEntranceStations > 1 && (ride->depart_flags & RIDE_DEPART_SYNCHRONISE_WITH_ADJACENT_STATIONS))
+    {
+        closestStationNum = guest_pathfinding_select_random_station(peep, numEntranceStations, entranceStations);
+    }
+
+    TileCoordsXYZ loc;
+    if (numEntranceStations == 0)
+    {
+        // closestStationNum is always 0 here.
+        auto entranceXY = TileCoordsXY(ride->stations[closestStationNum].Start);
+        loc.x = entranceXY.x;
+        loc.y = entranceXY.y;
+        loc.z = ride->stations[closestStationNum].Height;
+    }
+    else
+    {
+        TileCoordsXYZD entranceXYZD = ride_get_entrance_location(ride, closestStationNum);
+        loc.x = entranceXYZD.x;
+        loc.y = entranceXYZD.y;
+        loc.z = entranceXYZD.z;
+    }
+
+    get_ride_queue_end(loc);
+    return loc;
+}
+
 /**
  *
  *  rct2: 0x00694C35
@@ -1904,8 +2301,9 @@ int32_t guest_path_finding(Guest* peep)
         return 1;
     }
 
-    _peepPathFindIsStaff = false;
-    uint8_t edges = path_get_permitted_edges(pathElement);
+    auto& state = _pathFindState;
+    state.IsStaff = false;
+    uint8_t edges = path_get_permitted_edges(state, pathElement);
 
     if (edges == 0)
     {
@@ -2082,61 +2480,7 @@ int32_t guest_path_finding(Guest* peep)
 
     // The ride is open.
     gPeepPathFindQueueRideIndex = rideIndex;
-
-    /* Find the ride's closest entrance station to the peep.
-     * At the same time, count how many entrance stations there are and
-     * which stations are entrance stations. */
-    auto bestScore = std::numeric_limits<int32_t>::max();
-    StationIndex closestStationNum = 0;
-
-    int32_t numEntranceStations = 0;
-    std::bitset<MAX_STATIONS> entranceStations = {};
-
-    for (StationIndex stationNum = 0; stationNum < MAX_STATIONS; ++stationNum)
-    {
-        // Skip if stationNum has no entrance (so presumably an exit only station)
-        if (ride_get_entrance_location(ride, stationNum).isNull())
-            continue;
-
-        numEntranceStations++;
-        entranceStations[stationNum] = true;
-
-        TileCoordsXYZD entranceLocation = ride_get_entrance_location(ride, stationNum);
-        auto score = CalculateHeuristicPathingScore(entranceLocation, TileCoordsXYZ{ peep->NextLoc });
-        if (score < bestScore)
-        {
-            bestScore = score;
-            closestStationNum = stationNum;
-            continue;
-        }
-    }
-
-    // Ride has no stations with an entrance, so head to station 0.
-    if (numEntranceStations == 0)
-        closestStationNum = 0;
-
-    if (numEntranceStations > 1 && (ride->depart_flags & RIDE_DEPART_SYNCHRONISE_WITH_ADJACENT_STATIONS))
-    {
-        closestStationNum = guest_pathfinding_select_random_station(peep, numEntranceStations, entranceStations);
-    }
-
-    if (numEntranceStations == 0)
-    {
-        // closestStationNum is always 0 here.
-        auto entranceXY = TileCoordsXY(ride->stations[closestStationNum].Start);
-        loc.x = entranceXY.x;
-        loc.y = entranceXY.y;
-        loc.z = ride->stations[closestStationNum].Height;
-    }
-    else
-    {
-        TileCoordsXYZD entranceXYZD = ride_get_entrance_location(ride, closestStationNum);
-        loc.x = entranceXYZD.x;
-        loc.y = entranceXYZD.y;
-        loc.z = entranceXYZD.z;
-    }
-
-    get_ride_queue_end(loc);
+    loc = guest_path_find_ride_goal(peep, ride, TileCoordsXYZ{ peep->NextLoc });
 
     gPeepPathFindGoalPosition = loc;
     gPeepPathFindIgnoreForeignQueues = true;
@@ -2172,3 +2516,114 @@ int32_t guest_path_finding(Guest* peep)
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
     return peep_move_one_tile(direction, peep);
 }
+
+/**
+ * Returns the tile on which the guest will next call guest_path_finding, if it can be foreseen: the tile it walks to
+ * or, when it is walking off its tile, the path it will step onto (see Peep::PerformNextAction).
+ */
+static std::optional<TileCoordsXYZ> guest_path_finding_next_tile(const Guest* peep)
+{
+    TileCoordsXY destination{ CoordsXY{ peep->DestinationX, peep->DestinationY } };
+    if (destination == TileCoordsXY{ peep->NextLoc })
+        return TileCoordsXYZ{ peep->NextLoc };
+
+    auto* tileElement = map_get_first_element_at(destination.ToCoordsXY());
+    if (tileElement == nullptr)
+        return std::nullopt;
+
+    int32_t baseZ = std::max(0, (peep->z / 8) - 2);
+    int32_t topZ = (peep->z / 8) + 1;
+    do
+    {
+        if (tileElement->IsGhost() || tileElement->base_height < baseZ || tileElement->base_height > topZ)
+            continue;
+
+        switch (tileElement->GetType())
+        {
+            case TILE_ELEMENT_TYPE_PATH:
+                return TileCoordsXYZ{ destination, tileElement->base_height };
+            case TILE_ELEMENT_TYPE_TRACK:
+            case TILE_ELEMENT_TYPE_ENTRANCE:
+                // The guest may enter a shop or ride instead
+                return std::nullopt;
+        }
+    } while (!(tileElement++)->IsLastForTile());
+    return std::nullopt;
+}
+
+/**
+ * Runs the path searches of the guests walking to an open ride ahead of the serial peep update, spread over the task
+ * scheduler, and adds the results to the search results of the calling thread.
+ *
+ * The searches run on copies of the guests and never touch the game state; a search result only depends on its
+ * PathSearchKey and the map revision, so a guest that finds its search prepared chooses the same direction it would
+ * have chosen searching by itself. Guests are still updated one after the other in entity order. Guests whose next
+ * search can not be foreseen or would draw a random number (PEEP_FLAGS_2) are left to search by themselves.
+ */
+void guest_path_finding_prepare_all()
+{
+    struct PreparedGuest
+    {
+        const Guest* Peep;
+        TileCoordsXYZ Loc;
+    };
+    std::vector<PreparedGuest> guests;
+    for (auto guest : EntityList<Guest>(EntityListId::Peep))
+    {
+        if (guest->State != PEEP_STATE_WALKING || guest->OutsideOfPark || guest->GetNextIsSurface())
+            continue;
+        if (guest->PeepFlags & (PEEP_FLAGS_LEAVING_PARK | PEEP_FLAGS_2))
+            continue;
+
+        auto ride = get_ride(guest->GuestHeadingToRideId);
+        if (ride == nullptr || ride->status != RIDE_STATUS_OPEN)
+            continue;
+
+        auto loc = guest_path_finding_next_tile(guest);
+        if (loc.has_value())
+        {
+            guests.push_back({ guest, *loc });
+        }
+    }
+    if (guests.empty())
+        return;
+
+    constexpr size_t GuestsPerTask = 64;
+    size_t numTasks = (guests.size() + GuestsPerTask - 1) / GuestsPerTask;
+    std::vector<std::vector<std::pair<PathSearchKey, Direction>>> prepared(numTasks);
+    OpenRCT2::TaskScheduler::Get().ParallelFor(numTasks, [&guests, &prepared](size_t task) {
+        auto& state = _pathFindState;
+        state.PreparedSearches = &prepared[task];
+        size_t end = std::min(guests.size(), (task + 1) * GuestsPerTask);
+        for (size_t i = task * GuestsPerTask; i < end; i++)
+        {
+            Guest peep = *guests[i].Peep;
+            const auto& loc = guests[i].Loc;
+            peep.NextLoc = loc.ToCoordsXYZ();
+
+            auto ride = get_ride(peep.GuestHeadingToRideId);
+            gPeepPathFindQueueRideIndex = ride->id;
+            gPeepPathFindGoalPosition = guest_path_find_ride_goal(&peep, ride, loc);
+            gPeepPathFindIgnoreForeignQueues = true;
+            peep_pathfind_choose_direction(loc, &peep);
+        }
+        state.PreparedSearches = nullptr;
+    });
+
+    auto& state = _pathFindState;
+    if (state.SearchResultsRevision != gTileElementsRevision)
+    {
+        state.SearchResults.clear();
+        state.SearchResultsRevision = gTileElementsRevision;
+    }
+    for (const auto& searches : prepared)
+    {
+        for (const auto& [key, direction] : searches)
+        {
+            // Leave room for the searches made during the update itself
+            if (state.SearchResults.size() >= MaxPathSearchResults / 2)
+                return;
+            state.SearchResults.emplace(key, direction);
+        }
+    }
+}
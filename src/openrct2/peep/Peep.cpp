@@ -47,6 +47,7 @@
 #include "Staff.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <limits>
 
@@ -69,9 +70,9 @@ uint32_t gNextGuestNumber;
 
 uint8_t gPeepWarningThrottle[16];
 
-TileCoordsXYZ gPeepPathFindGoalPosition;
-bool gPeepPathFindIgnoreForeignQueues;
-ride_id_t gPeepPathFindQueueRideIndex;
+thread_local TileCoordsXYZ gPeepPathFindGoalPosition;
+thread_local bool gPeepPathFindIgnoreForeignQueues;
+thread_local ride_id_t gPeepPathFindQueueRideIndex;
 
 static uint8_t _unk_F1AEF0;
 static TileElement* _peepRideEntranceExitElement;
@@ -395,6 +396,11 @@ void peep_update_all()
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
         return;
 
+    if (gConfigGeneral.multithreading)
+    {
+        guest_path_finding_prepare_all();
+    }
+
     int32_t i = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Peep>(EntityListId::Peep))
@@ -1581,7 +1587,7 @@ void Peep::InsertNewThought(PeepThoughtType thoughtType, uint8_t thoughtArgument
  */
 Peep* Peep::Generate(const CoordsXYZ& coords)
 {
-    if (GetEntityListCount(EntityListId::Free) < 400)
+    if (GetNumFreeEntities() < 400)
         return nullptr;
 
     Peep* peep = &create_sprite(SPRITE_IDENTIFIER_PEEP)->peep;
@@ -848,6 +848,7 @@ public:
     void HandleEasterEggName();
     int32_t GetEasterEggNameId() const;
     void UpdateEasterEggInteractions();
+    std::bitset<MAX_RIDES> FindRidesToGoOn();
 
 private:
     void UpdateRide();
@@ -890,7 +891,6 @@ private:
     void MakePassingPeepsSick(Guest* passingPeep);
     void GivePassingPeepsIceCream(Guest* passingPeep);
     Ride* FindBestRideToGoOn();
-    std::bitset<MAX_RIDES> FindRidesToGoOn();
     bool FindVehicleToEnter(Ride* ride, std::vector<uint8_t>& car_array);
     void GoToRideEntrance(Ride* ride);
 };
@@ -1014,9 +1014,13 @@ extern uint32_t gNextGuestNumber;
 
 extern uint8_t gPeepWarningThrottle[16];
 
-extern TileCoordsXYZ gPeepPathFindGoalPosition;
-extern bool gPeepPathFindIgnoreForeignQueues;
-extern ride_id_t gPeepPathFindQueueRideIndex;
+// The goal of the next peep_pathfind_choose_direction call made on the same thread. Only the search state is per thread;
+// the map, sprites and rides it searches are still the single global park, which threads may only read while searching.
+extern thread_local TileCoordsXYZ gPeepPathFindGoalPosition;
+extern thread_local bool gPeepPathFindIgnoreForeignQueues;
+extern thread_local ride_id_t gPeepPathFindQueueRideIndex;
+// Lets the heuristic search step over runs of plain thin path at once, the result is the same either way.
+extern bool gPeepPathFindUseCorridors;
 
 Peep* try_get_guest(uint16_t spriteIndex);
 int32_t peep_get_staff_count();
@@ -1050,6 +1054,7 @@ void peep_reset_pathfind_goal(Peep* peep);
 
 bool is_valid_path_z_and_direction(TileElement* tileElement, int32_t currentZ, int32_t currentDirection);
 int32_t guest_path_finding(Guest* peep);
+void guest_path_finding_prepare_all();
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 #    define PATHFIND_DEBUG                                                                                                     \
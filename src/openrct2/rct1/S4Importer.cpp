@@ -1341,7 +1341,7 @@ private:
                 ImportPeep(peep, srcPeep);
             }
         }
-        for (size_t i = 0; i < MAX_SPRITES; i++)
+        for (size_t i = 0; i < GetEntityCapacity(); i++)
         {
             auto vehicle = GetEntity<Vehicle>(i);
             if (vehicle != nullptr)
@@ -2731,19 +2731,19 @@ private:
 
     void ClearExtraTileEntries()
     {
-        // Reset the map tile pointers
-        std::fill(std::begin(gTileElementTilePointers), std::end(gTileElementTilePointers), nullptr);
+        // Reset the map tile offsets
+        std::fill(std::begin(gTileElementOffsets), std::end(gTileElementOffsets), TILE_ELEMENT_OFFSET_NULL);
 
         // Get the first free map element
-        TileElement* nextFreeTileElement = gTileElements;
+        TileElement* nextFreeTileElement = gTileElements.data();
         for (size_t i = 0; i < RCT1_MAX_MAP_SIZE * RCT1_MAX_MAP_SIZE; i++)
         {
             while (!(nextFreeTileElement++)->IsLastForTile())
                 ;
         }
 
-        TileElement* tileElement = gTileElements;
-        TileElement** tilePointer = gTileElementTilePointers;
+        TileElement* tileElement = gTileElements.data();
+        uint32_t* tileOffset = gTileElementOffsets;
 
         // 128 rows of map data from RCT1 map
         for (int32_t x = 0; x < RCT1_MAX_MAP_SIZE; x++)
@@ -2751,7 +2751,7 @@ private:
             // Assign the first half of this row
             for (int32_t y = 0; y < RCT1_MAX_MAP_SIZE; y++)
             {
-                *tilePointer++ = tileElement;
+                *tileOffset++ = static_cast<uint32_t>(tileElement - gTileElements.data());
                 while (!(tileElement++)->IsLastForTile())
                     ;
             }
@@ -2766,7 +2766,7 @@ private:
                 nextFreeTileElement->AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
                 nextFreeTileElement->AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
                 nextFreeTileElement->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
-                *tilePointer++ = nextFreeTileElement++;
+                *tileOffset++ = static_cast<uint32_t>(nextFreeTileElement++ - gTileElements.data());
             }
         }
 
@@ -2780,7 +2780,7 @@ private:
             nextFreeTileElement->AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
             nextFreeTileElement->AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
             nextFreeTileElement->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
-            *tilePointer++ = nextFreeTileElement++;
+            *tileOffset++ = static_cast<uint32_t>(nextFreeTileElement++ - gTileElements.data());
         }
 
         gNextFreeTileElement = nextFreeTileElement;
@@ -2839,6 +2839,11 @@ private:
                             }
 
                             auto element = tile_element_insert(location, originalTileElement.GetOccupiedQuadrants());
+                            if (element == nullptr)
+                            {
+                                log_error("Cannot insert wall: map element limit reached.");
+                                continue;
+                            }
                             element->SetType(TILE_ELEMENT_TYPE_WALL);
                             element->SetDirection(edge);
                             element->SetBaseZ(baseZ);
@@ -10,6 +10,11 @@
 #include "SawyerChunkReader.h"
 
 #include "../core/IStream.hpp"
+#include "../core/TaskScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 // malloc is very slow for large allocations in MSVC debug builds as it allocates
 // memory on a special debug heap and then initialises all the memory to 0xCC.
@@ -20,6 +25,8 @@
 
 // Allow chunks to be uncompressed to a maximum of 16 MiB
 constexpr size_t MAX_UNCOMPRESSED_CHUNK_SIZE = 16 * 1024 * 1024;
+// Compressed data ReadChunks may hold in memory while its chunks are decoded
+constexpr size_t MAX_BUFFERED_COMPRESSED_SIZE = 4 * 1024 * 1024;
 
 constexpr const char* EXCEPTION_MSG_CORRUPT_CHUNK_SIZE = "Corrupt chunk size.";
 constexpr const char* EXCEPTION_MSG_CORRUPT_RLE = "Corrupt RLE compression data.";
@@ -83,7 +90,7 @@ std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunk()
                     throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
                 }
 
-                auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer());
+                auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer(MAX_UNCOMPRESSED_CHUNK_SIZE));
                 size_t uncompressedLength = DecodeChunk(buffer, MAX_UNCOMPRESSED_CHUNK_SIZE, compressedData.get(), header);
                 if (uncompressedLength == 0)
                 {
@@ -123,7 +130,7 @@ std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunkTrack()
             throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
         }
 
-        auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer());
+        auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer(MAX_UNCOMPRESSED_CHUNK_SIZE));
         sawyercoding_chunk_header header{ CHUNK_ENCODING_RLE, compressedDataLength };
         size_t uncompressedLength = DecodeChunk(buffer, MAX_UNCOMPRESSED_CHUNK_SIZE, compressedData.get(), header);
         if (uncompressedLength == 0)
@@ -162,6 +169,111 @@ void SawyerChunkReader::ReadChunk(void* dst, size_t length)
     }
 }
 
+void SawyerChunkReader::ReadChunks(const std::vector<std::pair<void*, size_t>>& destinations)
+{
+    uint64_t originalPosition = _stream->GetPosition();
+    try
+    {
+        // Each chunk is decoded as soon as it has been read, and the reader waits while the compressed data of the
+        // chunks still being decoded would exceed the budget. A single chunk larger than the budget is still read.
+        std::atomic<size_t> bufferedLength{ 0 };
+        auto& scheduler = OpenRCT2::TaskScheduler::Get();
+        OpenRCT2::TaskGroup decodeJobs(scheduler);
+        for (const auto& destination : destinations)
+        {
+            auto header = _stream->ReadValue<sawyercoding_chunk_header>();
+            if (header.length >= MAX_UNCOMPRESSED_CHUNK_SIZE)
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+
+            switch (header.encoding)
+            {
+                case CHUNK_ENCODING_NONE:
+                case CHUNK_ENCODING_RLE:
+                case CHUNK_ENCODING_RLECOMPRESSED:
+                case CHUNK_ENCODING_ROTATE:
+                    break;
+                default:
+                    throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
+            }
+
+            while (bufferedLength.load(std::memory_order_acquire) != 0
+                   && bufferedLength.load(std::memory_order_acquire) + header.length > MAX_BUFFERED_COMPRESSED_SIZE)
+            {
+                if (!scheduler.RunPendingTask())
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            auto compressedData = std::make_unique<uint8_t[]>(header.length);
+            if (_stream->TryRead(compressedData.get(), header.length) != header.length)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+            }
+
+            bufferedLength.fetch_add(header.length, std::memory_order_acq_rel);
+            decodeJobs.Run([&bufferedLength, destination, header, data = std::move(compressedData)]() {
+                try
+                {
+                    DecodeChunkInto(destination.first, destination.second, data.get(), header);
+                }
+                catch (const std::exception&)
+                {
+                    bufferedLength.fetch_sub(header.length, std::memory_order_acq_rel);
+                    throw;
+                }
+                bufferedLength.fetch_sub(header.length, std::memory_order_acq_rel);
+            });
+        }
+        decodeJobs.Wait();
+    }
+    catch (const std::exception&)
+    {
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
+    }
+}
+
+void SawyerChunkReader::DecodeChunkInto(void* dst, size_t length, const void* src, const sawyercoding_chunk_header& header)
+{
+    // The repeat decoder needs one spare byte past the end of its output. If the chunk turns out to be larger than
+    // the destination, decode it again into a buffer of the maximum size and truncate it.
+    size_t capacity = length + 1;
+    auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer(capacity));
+    size_t uncompressedLength;
+    try
+    {
+        uncompressedLength = DecodeChunk(buffer, capacity, src, header);
+    }
+    catch (const SawyerChunkException&)
+    {
+        FreeLargeTempBuffer(buffer);
+        capacity = MAX_UNCOMPRESSED_CHUNK_SIZE;
+        buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer(capacity));
+        try
+        {
+            uncompressedLength = DecodeChunk(buffer, capacity, src, header);
+        }
+        catch (const std::exception&)
+        {
+            FreeLargeTempBuffer(buffer);
+            throw;
+        }
+    }
+
+    if (uncompressedLength == 0)
+    {
+        FreeLargeTempBuffer(buffer);
+        throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+    }
+
+    auto copyLength = std::min(uncompressedLength, length);
+    std::memcpy(dst, buffer, copyLength);
+    std::fill_n(static_cast<uint8_t*>(dst) + copyLength, length - copyLength, 0x00);
+    FreeLargeTempBuffer(buffer);
+}
+
 size_t SawyerChunkReader::DecodeChunk(void* dst, size_t dstCapacity, const void* src, const sawyercoding_chunk_header& header)
 {
     size_t resultLength;
@@ -192,59 +304,38 @@ size_t SawyerChunkReader::DecodeChunk(void* dst, size_t dstCapacity, const void*
 
 size_t SawyerChunkReader::DecodeChunkRLERepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
 {
-    auto immBuffer = AllocateLargeTempBuffer();
-    auto immLength = DecodeChunkRLE(immBuffer, MAX_UNCOMPRESSED_CHUNK_SIZE, src, srcLength);
-    auto size = DecodeChunkRepeat(dst, dstCapacity, immBuffer, immLength);
-    FreeLargeTempBuffer(immBuffer);
-    return size;
+    // Every repeat code produces at least half a byte of output, so the intermediate data never needs to be larger
+    // than twice the destination.
+    auto immCapacity = std::min(MAX_UNCOMPRESSED_CHUNK_SIZE, (dstCapacity * 2) + 2);
+    auto immBuffer = AllocateLargeTempBuffer(immCapacity);
+    try
+    {
+        auto immLength = DecodeChunkRLE(immBuffer, immCapacity, src, srcLength);
+        auto size = DecodeChunkRepeat(dst, dstCapacity, immBuffer, immLength);
+        FreeLargeTempBuffer(immBuffer);
+        return size;
+    }
+    catch (const std::exception&)
+    {
+        FreeLargeTempBuffer(immBuffer);
+        throw;
+    }
 }
 
 size_t SawyerChunkReader::DecodeChunkRLE(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
 {
-    auto src8 = static_cast<const uint8_t*>(src);
-    auto dst8 = static_cast<uint8_t*>(dst);
-    auto dstEnd = dst8 + dstCapacity;
-    for (size_t i = 0; i < srcLength; i++)
+    size_t length = 0;
+    auto result = sawyercoding_get_kernels().DecodeRLE(
+        static_cast<const uint8_t*>(src), srcLength, static_cast<uint8_t*>(dst), dstCapacity, &length);
+    switch (result)
     {
-        uint8_t rleCodeByte = src8[i];
-        if (rleCodeByte & 128)
-        {
-            i++;
-            size_t count = 257 - rleCodeByte;
-
-            if (i >= srcLength)
-            {
-                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
-            }
-            if (dst8 + count > dstEnd)
-            {
-                throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
-            }
-
-            std::fill_n(dst8, count, src8[i]);
-            dst8 += count;
-        }
-        else
-        {
-            if (i + 1 >= srcLength)
-            {
-                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
-            }
-            if (dst8 + rleCodeByte + 1 > dstEnd)
-            {
-                throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
-            }
-            if (i + 1 + rleCodeByte + 1 > srcLength)
-            {
-                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
-            }
-
-            std::memcpy(dst8, src8 + i + 1, rleCodeByte + 1);
-            dst8 += rleCodeByte + 1;
-            i += rleCodeByte + 1;
-        }
+        case SawyerRLEDecodeResult::CorruptData:
+            throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
+        case SawyerRLEDecodeResult::DestinationTooSmall:
+            throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
+        default:
+            return length;
     }
-    return reinterpret_cast<uintptr_t>(dst8) - reinterpret_cast<uintptr_t>(dst);
 }
 
 size_t SawyerChunkReader::DecodeChunkRepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
@@ -282,23 +373,16 @@ size_t SawyerChunkReader::DecodeChunkRotate(void* dst, size_t dstCapacity, const
         throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
     }
 
-    auto src8 = static_cast<const uint8_t*>(src);
-    auto dst8 = static_cast<uint8_t*>(dst);
-    uint8_t code = 1;
-    for (size_t i = 0; i < srcLength; i++)
-    {
-        dst8[i] = ror8(src8[i], code);
-        code = (code + 2) % 8;
-    }
+    sawyercoding_get_kernels().DecodeRotate(static_cast<const uint8_t*>(src), static_cast<uint8_t*>(dst), srcLength);
     return srcLength;
 }
 
-void* SawyerChunkReader::AllocateLargeTempBuffer()
+void* SawyerChunkReader::AllocateLargeTempBuffer(size_t size)
 {
 #ifdef __USE_HEAP_ALLOC__
-    auto buffer = HeapAlloc(GetProcessHeap(), 0, MAX_UNCOMPRESSED_CHUNK_SIZE);
+    auto buffer = HeapAlloc(GetProcessHeap(), 0, size);
 #else
-    auto buffer = std::malloc(MAX_UNCOMPRESSED_CHUNK_SIZE);
+    auto buffer = std::malloc(size);
 #endif
     if (buffer == nullptr)
     {
@@ -14,6 +14,7 @@
 #include "SawyerChunk.h"
 
 #include <memory>
+#include <vector>
 
 namespace OpenRCT2
 {
@@ -58,6 +59,16 @@ public:
      */
     void ReadChunk(void* dst, size_t length);
 
+    /**
+     * Reads the next chunks from the stream and copies each of them to its
+     * destination buffer, with the same padding and truncation as ReadChunk.
+     * The compressed data is read sequentially and each chunk is decoded in
+     * parallel as soon as it is read, directly into a buffer sized for its
+     * destination. At most a few MiB of compressed data are held at once.
+     * @param destinations The destination buffer and its size for each chunk.
+     */
+    void ReadChunks(const std::vector<std::pair<void*, size_t>>& destinations);
+
     /**
      * Reads the next chunk from the stream into a buffer returned as the
      * specified type. If the chunk is smaller than the size of the type
@@ -77,7 +88,9 @@ private:
     static size_t DecodeChunkRepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
     static size_t DecodeChunkRotate(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
 
-    static void* AllocateLargeTempBuffer();
+    static void DecodeChunkInto(void* dst, size_t length, const void* src, const sawyercoding_chunk_header& header);
+
+    static void* AllocateLargeTempBuffer(size_t size);
     static void* FinaliseLargeTempBuffer(void* buffer, size_t len);
     static void FreeLargeTempBuffer(void* buffer);
 };
@@ -10,6 +10,7 @@
 #include "SawyerChunkWriter.h"
 
 #include "../core/IStream.hpp"
+#include "../core/TaskScheduler.h"
 #include "../util/SawyerCoding.h"
 
 // Maximum buffer size to store compressed data, maximum of 16 MiB
@@ -26,73 +27,50 @@ void SawyerChunkWriter::WriteChunk(const SawyerChunk* chunk)
 }
 
 void SawyerChunkWriter::WriteChunk(const void* src, size_t length, SAWYER_ENCODING encoding)
+{
+    auto data = EncodeChunk(src, length, encoding);
+    _stream->Write(data.data(), data.size());
+}
+
+std::vector<uint8_t> SawyerChunkWriter::EncodeChunk(const void* src, size_t length, SAWYER_ENCODING encoding)
 {
     sawyercoding_chunk_header header;
     header.encoding = static_cast<uint8_t>(encoding);
     header.length = static_cast<uint32_t>(length);
 
-    auto data = std::make_unique<uint8_t[]>(MAX_COMPRESSED_CHUNK_SIZE);
-    size_t dataLength = sawyercoding_write_chunk_buffer(data.get(), static_cast<const uint8_t*>(src), header);
-
-    _stream->Write(data.get(), dataLength);
+    // The repeat pass can at worst double the data and RLE adds one code byte per 125 bytes on top of that.
+    size_t capacity = sizeof(sawyercoding_chunk_header) + (length * 2) + ((length * 2) / 125) + 16;
+    std::vector<uint8_t> data(capacity);
+    size_t dataLength = sawyercoding_write_chunk_buffer(data.data(), static_cast<const uint8_t*>(src), header);
+    data.resize(dataLength);
+    return data;
 }
 
-/**
- * Ensure dst_buffer is bigger than src_buffer then resize afterwards
- * returns length of dst_buffer
- */
-static size_t EncodeChunkRLE(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length)
+std::vector<std::vector<uint8_t>> SawyerChunkWriter::EncodeChunks(const std::vector<ChunkSource>& chunks, bool parallel)
 {
-    const uint8_t* src = src_buffer;
-    uint8_t* dst = dst_buffer;
-    const uint8_t* end_src = src + length;
-    uint8_t count = 0;
-    const uint8_t* src_norm_start = src;
-
-    while (src < end_src - 1)
+    std::vector<std::vector<uint8_t>> result(chunks.size());
+    auto encode = [&chunks, &result](size_t i) {
+        const auto& chunk = chunks[i];
+        result[i] = EncodeChunk(chunk.Data, chunk.Length, chunk.Encoding);
+    };
+    if (parallel)
     {
-        if ((count && *src == src[1]) || count > 125)
-        {
-            *dst++ = count - 1;
-            std::memcpy(dst, src_norm_start, count);
-            dst += count;
-            src_norm_start += count;
-            count = 0;
-        }
-        if (*src == src[1])
-        {
-            for (; (count < 125) && ((src + count) < end_src); count++)
-            {
-                if (*src != src[count])
-                    break;
-            }
-            *dst++ = 257 - count;
-            *dst++ = *src;
-            src += count;
-            src_norm_start = src;
-            count = 0;
-        }
-        else
-        {
-            count++;
-            src++;
-        }
+        OpenRCT2::TaskScheduler::Get().ParallelFor(chunks.size(), encode);
     }
-    if (src == end_src - 1)
-        count++;
-    if (count)
+    else
     {
-        *dst++ = count - 1;
-        std::memcpy(dst, src_norm_start, count);
-        dst += count;
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            encode(i);
+        }
     }
-    return dst - dst_buffer;
+    return result;
 }
 
 void SawyerChunkWriter::WriteChunkTrack(const void* src, size_t length)
 {
     auto data = std::make_unique<uint8_t[]>(MAX_COMPRESSED_CHUNK_SIZE);
-    size_t dataLength = EncodeChunkRLE(static_cast<const uint8_t*>(src), data.get(), length);
+    size_t dataLength = sawyercoding_get_kernels().EncodeRLE(static_cast<const uint8_t*>(src), data.get(), length);
 
     uint32_t checksum = 0;
     for (size_t i = 0; i < dataLength; i++)
@@ -13,6 +13,7 @@
 #include "SawyerChunk.h"
 
 #include <memory>
+#include <vector>
 
 namespace OpenRCT2
 {
@@ -29,8 +30,29 @@ private:
     OpenRCT2::IStream* const _stream = nullptr;
 
 public:
+    /**
+     * Uncompressed data of a chunk that is yet to be encoded.
+     */
+    struct ChunkSource
+    {
+        const void* Data;
+        size_t Length;
+        SAWYER_ENCODING Encoding;
+    };
+
     explicit SawyerChunkWriter(OpenRCT2::IStream* stream);
 
+    /**
+     * Encodes a chunk, including its header, into a buffer sized for the given data.
+     */
+    static std::vector<uint8_t> EncodeChunk(const void* src, size_t length, SAWYER_ENCODING encoding);
+
+    /**
+     * Encodes each of the given chunks, spreading the work across the task scheduler when
+     * parallel is set. The encoded chunks are returned in the same order as the sources.
+     */
+    static std::vector<std::vector<uint8_t>> EncodeChunks(const std::vector<ChunkSource>& chunks, bool parallel);
+
     /**
      * Writes a chunk to the stream.
      */
@@ -13,10 +13,14 @@
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
+#include "../ParkImporter.h"
 #include "../common.h"
 #include "../config/Config.h"
 #include "../core/FileStream.hpp"
 #include "../core/IStream.hpp"
+#include "../core/MemoryStream.h"
+#include "../core/Path.hpp"
 #include "../core/String.hpp"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
@@ -49,13 +53,16 @@
 
 #include <algorithm>
 #include <cstring>
-#include <functional>
+#include <future>
 #include <iterator>
+#include <memory>
 #include <optional>
+#include <stdexcept>
 
 S6Exporter::S6Exporter()
 {
     RemoveTracklessRides = false;
+    EncodeInParallel = true;
     std::memset(&_s6, 0x00, sizeof(_s6));
 }
 
@@ -90,62 +97,74 @@ void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
     _s6.header.magic_number = S6_MAGIC_NUMBER;
     _s6.game_version_number = 201028;
 
-    auto chunkWriter = SawyerChunkWriter(stream);
+    std::vector<SawyerChunkWriter::ChunkSource> chunks;
 
-    // 0: Write header chunk
-    chunkWriter.WriteChunk(&_s6.header, SAWYER_ENCODING::ROTATE);
+    // 0: Header chunk
+    chunks.push_back({ &_s6.header, sizeof(_s6.header), SAWYER_ENCODING::ROTATE });
 
-    // 1: Write scenario info chunk
+    // 1: Scenario info chunk
     if (_s6.header.type == S6_TYPE_SCENARIO)
     {
-        chunkWriter.WriteChunk(&_s6.info, SAWYER_ENCODING::ROTATE);
+        chunks.push_back({ &_s6.info, sizeof(_s6.info), SAWYER_ENCODING::ROTATE });
     }
+    size_t numHeaderChunks = chunks.size();
 
-    // 2: Write packed objects
-    if (_s6.header.num_packed_objects > 0)
-    {
-        auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
-        objRepo.WritePackedObjects(stream, ExportObjectsList);
-    }
-
-    // 3: Write available objects chunk
-    chunkWriter.WriteChunk(_s6.objects, sizeof(_s6.objects), SAWYER_ENCODING::ROTATE);
+    // 3: Available objects chunk
+    chunks.push_back({ _s6.objects, sizeof(_s6.objects), SAWYER_ENCODING::ROTATE });
 
     // 4: Misc fields (data, rand...) chunk
-    chunkWriter.WriteChunk(&_s6.elapsed_months, 16, SAWYER_ENCODING::RLECOMPRESSED);
+    chunks.push_back({ &_s6.elapsed_months, 16, SAWYER_ENCODING::RLECOMPRESSED });
 
     // 5: Map elements + sprites and other fields chunk
-    chunkWriter.WriteChunk(&_s6.tile_elements, 0x180000, SAWYER_ENCODING::RLECOMPRESSED);
+    chunks.push_back({ &_s6.tile_elements, 0x180000, SAWYER_ENCODING::RLECOMPRESSED });
 
     if (_s6.header.type == S6_TYPE_SCENARIO)
     {
         // 6 to 13:
-        chunkWriter.WriteChunk(&_s6.next_free_tile_element_pointer_index, 0x27104C, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.guests_in_park, 4, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.last_guests_in_park, 8, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.park_rating, 2, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.active_research_types, 1082, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.current_expenditure, 16, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.park_value, 4, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.completed_company_value, 0x761E8, SAWYER_ENCODING::RLECOMPRESSED);
+        chunks.push_back({ &_s6.next_free_tile_element_pointer_index, 0x27104C, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.guests_in_park, 4, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.last_guests_in_park, 8, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.park_rating, 2, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.active_research_types, 1082, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.current_expenditure, 16, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.park_value, 4, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.completed_company_value, 0x761E8, SAWYER_ENCODING::RLECOMPRESSED });
     }
     else
     {
         // 6: Everything else...
-        chunkWriter.WriteChunk(&_s6.next_free_tile_element_pointer_index, 0x2E8570, SAWYER_ENCODING::RLECOMPRESSED);
+        chunks.push_back({ &_s6.next_free_tile_element_pointer_index, 0x2E8570, SAWYER_ENCODING::RLECOMPRESSED });
+    }
+
+    auto encodedChunks = SawyerChunkWriter::EncodeChunks(chunks, EncodeInParallel);
+
+    // The checksum is the sum of every byte in the file, accumulate it as the data is written
+    uint32_t checksum = 0;
+    auto write = [stream, &checksum](const void* data, size_t length) {
+        stream->Write(data, length);
+        checksum += sawyercoding_calculate_checksum(static_cast<const uint8_t*>(data), length);
+    };
+
+    for (size_t i = 0; i < numHeaderChunks; i++)
+    {
+        write(encodedChunks[i].data(), encodedChunks[i].size());
     }
 
-    // Determine number of bytes written
-    size_t fileSize = stream->GetLength();
+    // 2: Write packed objects
+    if (_s6.header.num_packed_objects > 0)
+    {
+        OpenRCT2::MemoryStream packedObjects;
+        auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
+        objRepo.WritePackedObjects(&packedObjects, ExportObjectsList);
+        write(packedObjects.GetData(), packedObjects.GetLength());
+    }
 
-    // Read all written bytes back into a single buffer
-    stream->SetPosition(0);
-    auto data = std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>(
-        stream->ReadArray<uint8_t>(fileSize), Memory::Free<uint8_t>);
-    uint32_t checksum = sawyercoding_calculate_checksum(data.get(), fileSize);
+    for (size_t i = numHeaderChunks; i < encodedChunks.size(); i++)
+    {
+        write(encodedChunks[i].data(), encodedChunks[i].size());
+    }
 
     // Write the checksum on the end
-    stream->SetPosition(fileSize);
     stream->WriteValue(checksum);
 }
 
@@ -951,6 +970,55 @@ void S6Exporter::ExportSprites()
         _s6.sprite_lists_head[i] = gSpriteListHead[i];
         _s6.sprite_lists_count[i] = gSpriteListCount[i];
     }
+
+    if (GetEntityCapacity() > RCT2_MAX_SPRITES)
+    {
+        ExportGrownSpriteStorage();
+    }
+}
+
+/**
+ * The sprite storage has grown beyond the sprite array of SV6. This can only be saved while the sprites past it are
+ * free, they are then left out of the saved free list.
+ */
+void S6Exporter::ExportGrownSpriteStorage()
+{
+    for (size_t i = RCT2_MAX_SPRITES; i < GetEntityCapacity(); i++)
+    {
+        auto sprite = GetEntity(i);
+        if (sprite != nullptr && sprite->sprite_identifier != SPRITE_IDENTIFIER_NULL)
+        {
+            throw std::runtime_error("Park has more sprites than can be saved in an SV6 file.");
+        }
+    }
+
+    constexpr auto freeListIndex = static_cast<uint8_t>(EntityListId::Free);
+    uint16_t previous = SPRITE_INDEX_NULL;
+    uint16_t count = 0;
+    _s6.sprite_lists_head[freeListIndex] = SPRITE_INDEX_NULL;
+    for (auto sprite : EntityList(EntityListId::Free))
+    {
+        const auto spriteIndex = sprite->sprite_index;
+        if (spriteIndex >= RCT2_MAX_SPRITES)
+        {
+            continue;
+        }
+
+        auto& dst = _s6.sprites[spriteIndex].unknown;
+        dst.previous = previous;
+        dst.next = SPRITE_INDEX_NULL;
+        if (previous == SPRITE_INDEX_NULL)
+        {
+            _s6.sprite_lists_head[freeListIndex] = spriteIndex;
+        }
+        else
+        {
+            _s6.sprites[previous].unknown.next = spriteIndex;
+        }
+        previous = spriteIndex;
+        count++;
+    }
+    _s6.sprite_lists_count[freeListIndex] = count;
 }
 
 void S6Exporter::ExportSprite(RCT2Sprite* dst, const rct_sprite* src)
@@ -1407,6 +1475,12 @@ void S6Exporter::ExportMapAnimations()
 
 void S6Exporter::ExportTileElements()
 {
+    // The elements have been reorganised, so they are all in front of the next free element.
+    if (gNextFreeTileElement > gTileElements.data() + RCT2_MAX_TILE_ELEMENTS)
+    {
+        throw std::runtime_error("Park has more tile elements than can be saved in an SV6 file.");
+    }
+
     for (uint32_t index = 0; index < RCT2_MAX_TILE_ELEMENTS; index++)
     {
         auto src = &gTileElements[index];
@@ -1674,6 +1748,59 @@ enum : uint32_t
     S6_SAVE_FLAG_AUTOMATIC = 1u << 31,
 };
 
+// Automatic saves are encoded and written on a background thread once the game state has been exported.
+static std::future<void> _backgroundSave;
+
+void scenario_save_wait()
+{
+    if (_backgroundSave.valid())
+    {
+        _backgroundSave.get();
+    }
+}
+
+/**
+ * Writes a park the exporter has already taken a copy of, on a background thread for automatic saves.
+ */
+template<typename TExporter>
+static void scenario_save_exported(std::unique_ptr<TExporter> exporter, const utf8* path, int32_t flags)
+{
+    bool isScenario = (flags & S6_SAVE_FLAG_SCENARIO) != 0;
+    if ((flags & S6_SAVE_FLAG_AUTOMATIC) && !(flags & S6_SAVE_FLAG_EXPORT))
+    {
+        // The exporter holds a complete copy of the park by now, so encoding and writing no longer touch the game
+        // state and can be done without holding up the tick loop. Packed objects are read from the object
+        // repository and are only written by exports, which is why those always save on the calling thread.
+        exporter->EncodeInParallel = false;
+        _backgroundSave = std::async(
+            std::launch::async, [exporter = std::move(exporter), savePath = std::string(path), isScenario]() {
+                try
+                {
+                    if (isScenario)
+                    {
+                        exporter->SaveScenario(savePath.c_str());
+                    }
+                    else
+                    {
+                        exporter->SaveGame(savePath.c_str());
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    log_error("Unable to save park: '%s'", e.what());
+                }
+            });
+    }
+    else if (isScenario)
+    {
+        exporter->SaveScenario(path);
+    }
+    else
+    {
+        exporter->SaveGame(path);
+    }
+}
+
 /**
  *
  *  rct2: 0x006754F5
@@ -1690,6 +1817,9 @@ int32_t scenario_save(const utf8* path, int32_t flags)
         log_verbose("scenario_save(%s, SAVED GAME)", path);
     }
 
+    // Only one save may write at a time, the previous one could target the same file.
+    scenario_save_wait();
+
     if (!(flags & S6_SAVE_FLAG_AUTOMATIC))
     {
         window_close_construction_windows();
@@ -1699,23 +1829,26 @@ int32_t scenario_save(const utf8* path, int32_t flags)
     viewport_set_saved_view();
 
     bool result = false;
-    auto s6exporter = new S6Exporter();
     try
     {
-        if (flags & S6_SAVE_FLAG_EXPORT)
+        if (ParkImporter::ExtensionIsParkFile(Path::GetExtension(path)))
         {
-            auto& objManager = OpenRCT2::GetContext()->GetObjectManager();
-            s6exporter->ExportObjectsList = objManager.GetPackableObjects();
-        }
-        s6exporter->RemoveTracklessRides = true;
-        s6exporter->Export();
-        if (flags & S6_SAVE_FLAG_SCENARIO)
-        {
-            s6exporter->SaveScenario(path);
+            // Park files reference their objects instead of packing them, so exports are saved the same way.
+            auto exporter = std::make_unique<ParkFileExporter>();
+            exporter->Export();
+            scenario_save_exported(std::move(exporter), path, flags);
         }
         else
         {
-            s6exporter->SaveGame(path);
+            auto exporter = std::make_unique<S6Exporter>();
+            if (flags & S6_SAVE_FLAG_EXPORT)
+            {
+                auto& objManager = OpenRCT2::GetContext()->GetObjectManager();
+                exporter->ExportObjectsList = objManager.GetPackableObjects();
+            }
+            exporter->RemoveTracklessRides = true;
+            exporter->Export();
+            scenario_save_exported(std::move(exporter), path, flags);
         }
         result = true;
     }
@@ -1723,7 +1856,6 @@ int32_t scenario_save(const utf8* path, int32_t flags)
     {
         log_error("Unable to save park: '%s'", e.what());
     }
-    delete s6exporter;
 
     gfx_invalidate_screen();
 
@@ -34,6 +34,11 @@ class S6Exporter final
 {
 public:
     bool RemoveTracklessRides;
+    /**
+     * Whether the chunks are encoded on the task scheduler. Saves that run on a background thread encode serially so
+     * that the main thread never picks up their tasks while it waits on its own work.
+     */
+    bool EncodeInParallel;
     std::vector<const ObjectRepositoryItem*> ExportObjectsList;
 
     S6Exporter();
@@ -72,6 +77,7 @@ private:
     void ExportBanners();
     void ExportBanner(RCT12Banner& dst, const Banner& src);
     void ExportMapAnimations();
+    void ExportGrownSpriteStorage();
 
     void ExportTileElements();
     void ExportTileElement(RCT12TileElement* dst, TileElement* src);
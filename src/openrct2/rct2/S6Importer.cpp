@@ -154,26 +154,31 @@ public:
             _isSV7 = _stricmp(extension, ".sv7") == 0;
         }
 
+        // The remaining chunks are decoded in parallel
         if (isScenario)
         {
-            chunkReader.ReadChunk(&_s6.objects, sizeof(_s6.objects));
-            chunkReader.ReadChunk(&_s6.elapsed_months, 16);
-            chunkReader.ReadChunk(&_s6.tile_elements, sizeof(_s6.tile_elements));
-            chunkReader.ReadChunk(&_s6.next_free_tile_element_pointer_index, 2560076);
-            chunkReader.ReadChunk(&_s6.guests_in_park, 4);
-            chunkReader.ReadChunk(&_s6.last_guests_in_park, 8);
-            chunkReader.ReadChunk(&_s6.park_rating, 2);
-            chunkReader.ReadChunk(&_s6.active_research_types, 1082);
-            chunkReader.ReadChunk(&_s6.current_expenditure, 16);
-            chunkReader.ReadChunk(&_s6.park_value, 4);
-            chunkReader.ReadChunk(&_s6.completed_company_value, 483816);
+            chunkReader.ReadChunks({
+                { &_s6.objects, sizeof(_s6.objects) },
+                { &_s6.elapsed_months, 16 },
+                { &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { &_s6.next_free_tile_element_pointer_index, 2560076 },
+                { &_s6.guests_in_park, 4 },
+                { &_s6.last_guests_in_park, 8 },
+                { &_s6.park_rating, 2 },
+                { &_s6.active_research_types, 1082 },
+                { &_s6.current_expenditure, 16 },
+                { &_s6.park_value, 4 },
+                { &_s6.completed_company_value, 483816 },
+            });
         }
         else
         {
-            chunkReader.ReadChunk(&_s6.objects, sizeof(_s6.objects));
-            chunkReader.ReadChunk(&_s6.elapsed_months, 16);
-            chunkReader.ReadChunk(&_s6.tile_elements, sizeof(_s6.tile_elements));
-            chunkReader.ReadChunk(&_s6.next_free_tile_element_pointer_index, 3048816);
+            chunkReader.ReadChunks({
+                { &_s6.objects, sizeof(_s6.objects) },
+                { &_s6.elapsed_months, 16 },
+                { &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { &_s6.next_free_tile_element_pointer_index, 3048816 },
+            });
         }
 
         _s6Path = path;
@@ -1031,6 +1036,8 @@ public:
 
     void ImportTileElements()
     {
+        // A full RCT2 park would otherwise leave no room for the scratch elements at the end of the storage.
+        map_allocate_tile_elements(RCT2_MAX_TILE_ELEMENTS + TILE_ELEMENT_SPARE_ROOM);
         for (uint32_t index = 0; index < RCT2_MAX_TILE_ELEMENTS; index++)
         {
             auto src = &_s6.tile_elements[index];
@@ -1287,6 +1294,8 @@ public:
 
     void ImportSprites()
     {
+        // Brings the storage back to the size of the sprite array of the park.
+        reset_sprite_list();
         for (int32_t i = 0; i < RCT2_MAX_SPRITES; i++)
         {
             auto src = &_s6.sprites[i];
@@ -1299,8 +1308,7 @@ public:
             gSpriteListHead[i] = _s6.sprite_lists_head[i];
             gSpriteListCount[i] = _s6.sprite_lists_count[i];
         }
-        // This list contains the number of free slots. Increase it according to our own sprite limit.
-        gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] += (MAX_SPRITES - RCT2_MAX_SPRITES);
+        InvalidateEntityLists();
     }
 
     void ImportSprite(rct_sprite* dst, const RCT2Sprite* src)
@@ -924,6 +924,31 @@ void ride_init_all()
     _rides.shrink_to_fit();
 }
 
+static void ride_copy_with_measurements(std::vector<Ride>& dst, const std::vector<Ride>& src)
+{
+    dst = src;
+    for (auto& ride : dst)
+    {
+        if (ride.measurement != nullptr)
+        {
+            ride.measurement = std::make_shared<RideMeasurement>(*ride.measurement);
+        }
+    }
+}
+
+/**
+ * Copies every ride slot, including unused ones so ride ids stay the same when they are restored.
+ */
+void ride_copy_all(std::vector<Ride>& rides)
+{
+    ride_copy_with_measurements(rides, _rides);
+}
+
+void ride_restore_all(const std::vector<Ride>& rides)
+{
+    ride_copy_with_measurements(_rides, rides);
+}
+
 /**
  *
  *  rct2: 0x006B7A38
@@ -4294,7 +4319,7 @@ static void ride_set_start_finish_points(ride_id_t rideIndex, CoordsXYE* startEl
 static int32_t count_free_misc_sprite_slots()
 {
     int32_t miscSpriteCount = GetEntityListCount(EntityListId::Misc);
-    int32_t remainingSpriteCount = GetEntityListCount(EntityListId::Free);
+    int32_t remainingSpriteCount = static_cast<int32_t>(GetNumFreeEntities());
     return std::max(0, miscSpriteCount + remainingSpriteCount - 300);
 }
 
@@ -19,6 +19,7 @@
 #include "Vehicle.h"
 
 #include <limits>
+#include <memory>
 #include <string_view>
 
 struct IObjectManager;
@@ -367,7 +368,8 @@ struct Ride
     uint16_t holes;
     uint8_t sheltered_eighths;
 
-    std::unique_ptr<RideMeasurement> measurement;
+    // Shared between copies of the ride, use ride_copy_all for copies that own their measurement.
+    std::shared_ptr<RideMeasurement> measurement;
 
 private:
     void Update();
@@ -1086,6 +1088,8 @@ extern uint8_t gLastEntranceStyle;
 ride_id_t ride_get_empty_slot();
 int32_t ride_get_count();
 void ride_init_all();
+void ride_copy_all(std::vector<Ride>& rides);
+void ride_restore_all(const std::vector<Ride>& rides);
 void reset_all_ride_build_dates();
 void ride_update_favourited_stat();
 void ride_check_all_reachable();
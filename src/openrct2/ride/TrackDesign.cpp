@@ -66,9 +66,10 @@ using namespace OpenRCT2::Drawing;
 
 struct map_backup
 {
-    TileElement tile_elements[MAX_TILE_ELEMENTS];
-    TileElement* tile_pointers[MAX_TILE_TILE_ELEMENT_POINTERS];
-    TileElement* next_free_tile_element;
+    std::vector<TileElement> tile_elements;
+    // Indices into tile_elements, the storage may be moved while the preview is drawn.
+    uint32_t tile_offsets[MAX_TILE_TILE_ELEMENT_POINTERS];
+    size_t next_free_tile_element;
     uint16_t map_size_units;
     uint16_t map_size_units_minus_2;
     uint16_t map_size;
@@ -2099,9 +2100,9 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
     auto backup = std::make_unique<map_backup>();
     if (backup != nullptr)
     {
-        std::memcpy(backup->tile_elements, gTileElements, sizeof(backup->tile_elements));
-        std::memcpy(backup->tile_pointers, gTileElementTilePointers, sizeof(backup->tile_pointers));
-        backup->next_free_tile_element = gNextFreeTileElement;
+        backup->tile_elements = gTileElements;
+        std::copy(std::begin(gTileElementOffsets), std::end(gTileElementOffsets), backup->tile_offsets);
+        backup->next_free_tile_element = gNextFreeTileElement - gTileElements.data();
         backup->map_size_units = gMapSizeUnits;
         backup->map_size_units_minus_2 = gMapSizeMinus2;
         backup->map_size = gMapSize;
@@ -2116,9 +2117,10 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
  */
 static void track_design_preview_restore_map(map_backup* backup)
 {
-    std::memcpy(gTileElements, backup->tile_elements, sizeof(backup->tile_elements));
-    std::memcpy(gTileElementTilePointers, backup->tile_pointers, sizeof(backup->tile_pointers));
-    gNextFreeTileElement = backup->next_free_tile_element;
+    map_allocate_tile_elements(backup->tile_elements.size());
+    std::copy(backup->tile_elements.begin(), backup->tile_elements.end(), gTileElements.begin());
+    std::copy(std::begin(backup->tile_offsets), std::end(backup->tile_offsets), gTileElementOffsets);
+    gNextFreeTileElement = gTileElements.data() + backup->next_free_tile_element;
     gMapSizeUnits = backup->map_size_units;
     gMapSizeMinus2 = backup->map_size_units_minus_2;
     gMapSize = backup->map_size;
@@ -414,6 +414,10 @@ uint32_t scenario_rand_max(uint32_t max);
 
 bool scenario_prepare_for_save();
 int32_t scenario_save(const utf8* path, int32_t flags);
+/**
+ * Blocks until an automatic save that is still being written in the background has finished.
+ */
+void scenario_save_wait();
 void scenario_remove_trackless_rides(rct_s6_data* s6);
 void scenario_fix_ghosts(rct_s6_data* s6);
 void scenario_failure();
@@ -50,7 +50,7 @@ namespace OpenRCT2::Scripting
 
         int32_t numEntities_get() const
         {
-            return MAX_SPRITES;
+            return static_cast<int32_t>(GetEntityCapacity());
         }
 
         std::vector<std::shared_ptr<ScRide>> rides_get() const
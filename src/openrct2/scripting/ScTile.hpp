@@ -15,6 +15,7 @@
 #    include "../common.h"
 #    include "../core/Guard.hpp"
 #    include "../world/Footpath.h"
+#    include "../world/Map.h"
 #    include "../world/Scenery.h"
 #    include "../world/Sprite.h"
 #    include "../world/Surface.h"
@@ -29,11 +30,63 @@ namespace OpenRCT2::Scripting
 {
     class ScSurfaceElement;
 
+    /**
+     * Refers to a tile element by its offset in gTileElements, which stays the same when the storage grows. Scripts can
+     * keep an element around while they insert elements on other tiles.
+     */
+    class ScTileElementRef
+    {
+    private:
+        uint32_t _offset = TILE_ELEMENT_OFFSET_NULL;
+
+    public:
+        ScTileElementRef(TileElement* element)
+        {
+            *this = element;
+        }
+
+        ScTileElementRef& operator=(TileElement* element)
+        {
+            _offset = element == nullptr ? TILE_ELEMENT_OFFSET_NULL
+                                         : static_cast<uint32_t>(element - gTileElements.data());
+            return *this;
+        }
+
+        TileElement* Get() const
+        {
+            return _offset == TILE_ELEMENT_OFFSET_NULL ? nullptr : &gTileElements[_offset];
+        }
+
+        operator TileElement*() const
+        {
+            return Get();
+        }
+
+        TileElement* operator->() const
+        {
+            return Get();
+        }
+
+        ScTileElementRef operator++(int)
+        {
+            auto result = *this;
+            _offset++;
+            return result;
+        }
+
+        ScTileElementRef operator--(int)
+        {
+            auto result = *this;
+            _offset--;
+            return result;
+        }
+    };
+
     class ScTileElement
     {
     protected:
         CoordsXY _coords;
-        TileElement* _element;
+        ScTileElementRef _element;
 
     public:
         ScTileElement(const CoordsXY& coords, TileElement* element)
@@ -963,6 +1016,8 @@ namespace OpenRCT2::Scripting
 
         void Invalidate()
         {
+            // Scripts write element fields directly, bypassing the setters that track changes.
+            tile_elements_changed_at(_coords);
             map_invalidate_tile_full(_coords);
         }
 
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../common.h"
+#include "SawyerCoding.h"
+
+#ifdef __AVX2__
+
+#    include "SawyerCodingKernels.hpp"
+
+#    include <immintrin.h>
+
+namespace
+{
+    struct AVX2Vector
+    {
+        static constexpr size_t Width = 32;
+
+        static uint32_t EqualPairMask(const uint8_t* p)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        }
+
+        static uint32_t EqualToMask(const uint8_t* p, uint8_t value)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i b = _mm256_set1_epi8(static_cast<char>(value));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        }
+
+        static uint32_t BackReferenceMask(const uint8_t* cur, size_t k)
+        {
+            const __m256i value = _mm256_set1_epi8(static_cast<char>(cur[k]));
+            const __m256i window = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + k - 32));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(window, value)));
+        }
+
+        static void Copy(uint8_t* dst, const uint8_t* src, size_t length)
+        {
+            for (size_t i = 0; i < length; i += Width)
+            {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+            }
+        }
+
+        static void Fill(uint8_t* dst, uint8_t value, size_t length)
+        {
+            const __m256i a = _mm256_set1_epi8(static_cast<char>(value));
+            for (size_t i = 0; i < length; i += Width)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+            }
+        }
+
+        /**
+         * Rotates byte TByte of each 32-bit lane right by TShift bits.
+         */
+        template<int TShift, int TByte> static __m256i RotateByte(__m256i v)
+        {
+            const __m256i lowMask = _mm256_set1_epi32(static_cast<int32_t>((0xFFu >> TShift) << (8 * TByte)));
+            const __m256i highMask = _mm256_set1_epi32(
+                static_cast<int32_t>(((0xFFu << (8 - TShift)) & 0xFFu) << (8 * TByte)));
+            return _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi32(v, TShift), lowMask),
+                _mm256_and_si256(_mm256_slli_epi32(v, 8 - TShift), highMask));
+        }
+
+        template<bool TEncode> static void Rotate(const uint8_t* src, uint8_t* dst)
+        {
+            // Encoding rotates left by 1, 3, 5 and 7 bits, which is the same as rotating right by 7, 5, 3 and 1.
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            __m256i result;
+            if constexpr (TEncode)
+            {
+                result = _mm256_or_si256(
+                    _mm256_or_si256(RotateByte<7, 0>(v), RotateByte<5, 1>(v)),
+                    _mm256_or_si256(RotateByte<3, 2>(v), RotateByte<1, 3>(v)));
+            }
+            else
+            {
+                result = _mm256_or_si256(
+                    _mm256_or_si256(RotateByte<1, 0>(v), RotateByte<3, 1>(v)),
+                    _mm256_or_si256(RotateByte<5, 2>(v), RotateByte<7, 3>(v)));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), result);
+        }
+    };
+} // namespace
+
+static constexpr const SawyerCodingKernels AVX2Kernels = SawyerCodingVector::CreateKernels<AVX2Vector>("AVX2");
+
+const SawyerCodingKernels* sawyercoding_kernels_avx2()
+{
+    return &AVX2Kernels;
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with AVX2 enabled, when targeting x86!
+#    endif
+
+const SawyerCodingKernels* sawyercoding_kernels_avx2()
+{
+    return nullptr;
+}
+
+#endif // __AVX2__
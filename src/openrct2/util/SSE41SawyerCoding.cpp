@@ -0,0 +1,118 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../common.h"
+#include "SawyerCoding.h"
+
+#ifdef __SSE4_1__
+
+#    include "SawyerCodingKernels.hpp"
+
+#    include <immintrin.h>
+
+namespace
+{
+    struct SSE41Vector
+    {
+        static constexpr size_t Width = 16;
+
+        static uint32_t EqualPairMask(const uint8_t* p)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+        }
+
+        static uint32_t EqualToMask(const uint8_t* p, uint8_t value)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i b = _mm_set1_epi8(static_cast<char>(value));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+        }
+
+        static uint32_t BackReferenceMask(const uint8_t* cur, size_t k)
+        {
+            const __m128i value = _mm_set1_epi8(static_cast<char>(cur[k]));
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + k - 32));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + k - 16));
+            const uint32_t loMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, value)));
+            const uint32_t hiMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, value)));
+            return loMask | (hiMask << 16);
+        }
+
+        static void Copy(uint8_t* dst, const uint8_t* src, size_t length)
+        {
+            for (size_t i = 0; i < length; i += Width)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), a);
+            }
+        }
+
+        static void Fill(uint8_t* dst, uint8_t value, size_t length)
+        {
+            const __m128i a = _mm_set1_epi8(static_cast<char>(value));
+            for (size_t i = 0; i < length; i += Width)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), a);
+            }
+        }
+
+        /**
+         * Rotates byte TByte of each 32-bit lane right by TShift bits.
+         */
+        template<int TShift, int TByte> static __m128i RotateByte(__m128i v)
+        {
+            const __m128i lowMask = _mm_set1_epi32(static_cast<int32_t>((0xFFu >> TShift) << (8 * TByte)));
+            const __m128i highMask = _mm_set1_epi32(static_cast<int32_t>(((0xFFu << (8 - TShift)) & 0xFFu) << (8 * TByte)));
+            return _mm_or_si128(
+                _mm_and_si128(_mm_srli_epi32(v, TShift), lowMask), _mm_and_si128(_mm_slli_epi32(v, 8 - TShift), highMask));
+        }
+
+        template<bool TEncode> static void Rotate(const uint8_t* src, uint8_t* dst)
+        {
+            // Encoding rotates left by 1, 3, 5 and 7 bits, which is the same as rotating right by 7, 5, 3 and 1.
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i result;
+            if constexpr (TEncode)
+            {
+                result = _mm_or_si128(
+                    _mm_or_si128(RotateByte<7, 0>(v), RotateByte<5, 1>(v)),
+                    _mm_or_si128(RotateByte<3, 2>(v), RotateByte<1, 3>(v)));
+            }
+            else
+            {
+                result = _mm_or_si128(
+                    _mm_or_si128(RotateByte<1, 0>(v), RotateByte<3, 1>(v)),
+                    _mm_or_si128(RotateByte<5, 2>(v), RotateByte<7, 3>(v)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+        }
+    };
+} // namespace
+
+static constexpr const SawyerCodingKernels SSE41Kernels = SawyerCodingVector::CreateKernels<SSE41Vector>("SSE4.1");
+
+const SawyerCodingKernels* sawyercoding_kernels_sse4_1()
+{
+    return &SSE41Kernels;
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with SSE4.1 enabled, when targetting x86!
+#    endif
+
+const SawyerCodingKernels* sawyercoding_kernels_sse4_1()
+{
+    return nullptr;
+}
+
+#endif // __SSE4_1__
@@ -14,17 +14,64 @@
 #include "Util.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 
 static size_t decode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length);
 static size_t decode_chunk_rle_with_size(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length, size_t dstSize);
+static SawyerRLEDecodeResult decode_chunk_rle_checked(
+    const uint8_t* src_buffer, size_t length, uint8_t* dst_buffer, size_t dstCapacity, size_t* outLength);
+static void decode_chunk_rotate(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length);
 
 static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length);
 static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length);
-static void encode_chunk_rotate(uint8_t* buffer, size_t length);
+static void encode_chunk_rotate(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length);
 
 bool gUseRLE = true;
 
+static constexpr const SawyerCodingKernels ScalarKernels = {
+    "scalar", encode_chunk_rle, encode_chunk_repeat, encode_chunk_rotate, decode_chunk_rotate, decode_chunk_rle_checked,
+};
+
+static std::atomic<const SawyerCodingKernels*> _kernelsOverride{ nullptr };
+
+const SawyerCodingKernels* sawyercoding_kernels_scalar()
+{
+    return &ScalarKernels;
+}
+
+static const SawyerCodingKernels* sawyercoding_pick_kernels()
+{
+    if (avx2_available() && sawyercoding_kernels_avx2() != nullptr)
+    {
+        log_verbose("registering AVX2 sawyer coding kernels");
+        return sawyercoding_kernels_avx2();
+    }
+    if (sse41_available() && sawyercoding_kernels_sse4_1() != nullptr)
+    {
+        log_verbose("registering SSE4.1 sawyer coding kernels");
+        return sawyercoding_kernels_sse4_1();
+    }
+    log_verbose("registering scalar sawyer coding kernels");
+    return &ScalarKernels;
+}
+
+const SawyerCodingKernels& sawyercoding_get_kernels()
+{
+    auto kernels = _kernelsOverride.load(std::memory_order_acquire);
+    if (kernels != nullptr)
+    {
+        return *kernels;
+    }
+    static const SawyerCodingKernels* defaultKernels = sawyercoding_pick_kernels();
+    return *defaultKernels;
+}
+
+void sawyercoding_set_kernels(const SawyerCodingKernels* kernels)
+{
+    _kernelsOverride.store(kernels, std::memory_order_release);
+}
+
 uint32_t sawyercoding_calculate_checksum(const uint8_t* buffer, size_t length)
 {
     size_t i;
@@ -43,6 +90,7 @@ uint32_t sawyercoding_calculate_checksum(const uint8_t* buffer, size_t length)
 size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* buffer, sawyercoding_chunk_header chunkHeader)
 {
     uint8_t *encode_buffer, *encode_buffer2;
+    const auto& kernels = sawyercoding_get_kernels();
 
     if (!gUseRLE)
     {
@@ -62,7 +110,7 @@ size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* buffer,
             break;
         case CHUNK_ENCODING_RLE:
             encode_buffer = static_cast<uint8_t*>(malloc(0x600000));
-            chunkHeader.length = static_cast<uint32_t>(encode_chunk_rle(buffer, encode_buffer, chunkHeader.length));
+            chunkHeader.length = static_cast<uint32_t>(kernels.EncodeRLE(buffer, encode_buffer, chunkHeader.length));
             std::memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
             dst_file += sizeof(sawyercoding_chunk_header);
             std::memcpy(dst_file, encode_buffer, chunkHeader.length);
@@ -72,8 +120,8 @@ size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* buffer,
         case CHUNK_ENCODING_RLECOMPRESSED:
             encode_buffer = static_cast<uint8_t*>(malloc(chunkHeader.length * 2));
             encode_buffer2 = static_cast<uint8_t*>(malloc(0x600000));
-            chunkHeader.length = static_cast<uint32_t>(encode_chunk_repeat(buffer, encode_buffer, chunkHeader.length));
-            chunkHeader.length = static_cast<uint32_t>(encode_chunk_rle(encode_buffer, encode_buffer2, chunkHeader.length));
+            chunkHeader.length = static_cast<uint32_t>(kernels.EncodeRepeat(buffer, encode_buffer, chunkHeader.length));
+            chunkHeader.length = static_cast<uint32_t>(kernels.EncodeRLE(encode_buffer, encode_buffer2, chunkHeader.length));
             std::memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
             dst_file += sizeof(sawyercoding_chunk_header);
             std::memcpy(dst_file, encode_buffer2, chunkHeader.length);
@@ -83,8 +131,7 @@ size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* buffer,
             break;
         case CHUNK_ENCODING_ROTATE:
             encode_buffer = static_cast<uint8_t*>(malloc(chunkHeader.length));
-            std::memcpy(encode_buffer, buffer, chunkHeader.length);
-            encode_chunk_rotate(encode_buffer, chunkHeader.length);
+            kernels.EncodeRotate(buffer, encode_buffer, chunkHeader.length);
             std::memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
             dst_file += sizeof(sawyercoding_chunk_header);
             std::memcpy(dst_file, encode_buffer, chunkHeader.length);
@@ -129,7 +176,7 @@ size_t sawyercoding_encode_sv4(const uint8_t* src, uint8_t* dst, size_t length)
     uint32_t checksum;
 
     // Encode
-    encodedLength = encode_chunk_rle(src, dst, length);
+    encodedLength = sawyercoding_get_kernels().EncodeRLE(src, dst, length);
 
     // Append checksum
     checksum = sawyercoding_calculate_checksum(dst, encodedLength);
@@ -145,7 +192,7 @@ size_t sawyercoding_decode_td6(const uint8_t* src, uint8_t* dst, size_t length)
 
 size_t sawyercoding_encode_td6(const uint8_t* src, uint8_t* dst, size_t length)
 {
-    size_t output_length = encode_chunk_rle(src, dst, length);
+    size_t output_length = sawyercoding_get_kernels().EncodeRLE(src, dst, length);
 
     uint32_t checksum = 0;
     for (size_t i = 0; i < output_length; i++)
@@ -258,6 +305,65 @@ static size_t decode_chunk_rle_with_size(const uint8_t* src_buffer, uint8_t* dst
     return dst - dst_buffer;
 }
 
+static SawyerRLEDecodeResult decode_chunk_rle_checked(
+    const uint8_t* src_buffer, size_t length, uint8_t* dst_buffer, size_t dstCapacity, size_t* outLength)
+{
+    uint8_t* dst = dst_buffer;
+    uint8_t* dstEnd = dst_buffer + dstCapacity;
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t rleCodeByte = src_buffer[i];
+        if (rleCodeByte & 128)
+        {
+            i++;
+            size_t count = 257 - rleCodeByte;
+
+            if (i >= length)
+            {
+                return SawyerRLEDecodeResult::CorruptData;
+            }
+            if (dst + count > dstEnd)
+            {
+                return SawyerRLEDecodeResult::DestinationTooSmall;
+            }
+
+            std::fill_n(dst, count, src_buffer[i]);
+            dst += count;
+        }
+        else
+        {
+            if (i + 1 >= length)
+            {
+                return SawyerRLEDecodeResult::CorruptData;
+            }
+            if (dst + rleCodeByte + 1 > dstEnd)
+            {
+                return SawyerRLEDecodeResult::DestinationTooSmall;
+            }
+            if (i + 1 + rleCodeByte + 1 > length)
+            {
+                return SawyerRLEDecodeResult::CorruptData;
+            }
+
+            std::memcpy(dst, src_buffer + i + 1, rleCodeByte + 1);
+            dst += rleCodeByte + 1;
+            i += rleCodeByte + 1;
+        }
+    }
+    *outLength = dst - dst_buffer;
+    return SawyerRLEDecodeResult::Ok;
+}
+
+static void decode_chunk_rotate(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length)
+{
+    uint8_t code = 1;
+    for (size_t i = 0; i < length; i++)
+    {
+        dst_buffer[i] = ror8(src_buffer[i], code);
+        code = (code + 2) % 8;
+    }
+}
+
 #pragma endregion
 
 #pragma region Encoding
@@ -381,13 +487,13 @@ static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer
     return outLength;
 }
 
-static void encode_chunk_rotate(uint8_t* buffer, size_t length)
+static void encode_chunk_rotate(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length)
 {
     size_t i;
     uint8_t code = 1;
     for (i = 0; i < length; i++)
     {
-        buffer[i] = rol8(buffer[i], code);
+        dst_buffer[i] = rol8(src_buffer[i], code);
         code = (code + 2) % 8;
     }
 }
@@ -44,6 +44,44 @@ enum
 
 extern bool gUseRLE;
 
+enum class SawyerRLEDecodeResult
+{
+    Ok,
+    CorruptData,
+    DestinationTooSmall,
+};
+
+/**
+ * The byte loops of the chunk codec. There is a scalar, an SSE4.1 and an AVX2 implementation of each, the fastest one
+ * the CPU supports is picked the first time a codec function is used. All implementations produce identical output.
+ */
+struct SawyerCodingKernels
+{
+    const char* Name;
+    size_t (*EncodeRLE)(const uint8_t* src, uint8_t* dst, size_t length);
+    size_t (*EncodeRepeat)(const uint8_t* src, uint8_t* dst, size_t length);
+    void (*EncodeRotate)(const uint8_t* src, uint8_t* dst, size_t length);
+    void (*DecodeRotate)(const uint8_t* src, uint8_t* dst, size_t length);
+    /**
+     * Decodes RLE data into dst. The vectorised implementations may overwrite any byte of dst up to dstCapacity,
+     * not just the decoded length.
+     */
+    SawyerRLEDecodeResult (*DecodeRLE)(
+        const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* outLength);
+};
+
+/**
+ * The SSE4.1 and AVX2 kernels are nullptr when this build does not include them.
+ */
+const SawyerCodingKernels* sawyercoding_kernels_scalar();
+const SawyerCodingKernels* sawyercoding_kernels_sse4_1();
+const SawyerCodingKernels* sawyercoding_kernels_avx2();
+const SawyerCodingKernels& sawyercoding_get_kernels();
+/**
+ * Overrides the kernels picked for this CPU, nullptr restores the default. Only meant for tests and benchmarks.
+ */
+void sawyercoding_set_kernels(const SawyerCodingKernels* kernels);
+
 uint32_t sawyercoding_calculate_checksum(const uint8_t* buffer, size_t length);
 size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* src_buffer, sawyercoding_chunk_header chunkHeader);
 size_t sawyercoding_decode_sv4(const uint8_t* src, uint8_t* dst, size_t length, size_t bufferLength);
@@ -0,0 +1,296 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "SawyerCoding.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Vectorised versions of the chunk codec, shared by SSE41SawyerCoding.cpp and AVX2SawyerCoding.cpp. TVec provides
+ * the instruction set specific primitives:
+ *
+ *   Width                        number of bytes handled by one vector, a multiple of 4
+ *   EqualPairMask(p)             bit k set if p[k] == p[k + 1], reads Width + 1 bytes
+ *   EqualToMask(p, value)        bit k set if p[k] == value, reads Width bytes
+ *   BackReferenceMask(cur, k)    bit b set if cur[b - 32 + k] == cur[k], reads cur[k - 32] to cur[k]
+ *   Copy(dst, src, length)       copies length bytes rounded up to a multiple of Width
+ *   Fill(dst, value, length)     fills length bytes rounded up to a multiple of Width
+ *   Rotate<TEncode>(src, dst)    rotates Width bytes, the first byte by 1 bit
+ *
+ * Each kernel makes exactly the same choices as its scalar counterpart in SawyerCoding.cpp.
+ */
+namespace SawyerCodingVector
+{
+    /**
+     * Returns the first k < count for which p[k] == p[k + 1], or count if there is none.
+     */
+    template<typename TVec> size_t FindPair(const uint8_t* p, size_t count)
+    {
+        size_t k = 0;
+        for (; k + TVec::Width <= count; k += TVec::Width)
+        {
+            uint32_t mask = TVec::EqualPairMask(p + k);
+            if (mask != 0)
+            {
+                return k + bitscanforward(static_cast<int32_t>(mask));
+            }
+        }
+        for (; k < count; k++)
+        {
+            if (p[k] == p[k + 1])
+            {
+                return k;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Returns how many of the first maxLength bytes of p are equal to p[0].
+     */
+    template<typename TVec> size_t RunLength(const uint8_t* p, size_t maxLength)
+    {
+        constexpr uint32_t fullMask = TVec::Width == 32 ? 0xFFFFFFFF : ((1u << TVec::Width) - 1);
+        size_t k = 0;
+        for (; k + TVec::Width <= maxLength; k += TVec::Width)
+        {
+            uint32_t mask = TVec::EqualToMask(p + k, p[0]);
+            if (mask != fullMask)
+            {
+                return k + bitscanforward(static_cast<int32_t>(~mask & fullMask));
+            }
+        }
+        for (; k < maxLength; k++)
+        {
+            if (p[k] != p[0])
+            {
+                return k;
+            }
+        }
+        return maxLength;
+    }
+
+    template<typename TVec> size_t EncodeRLE(const uint8_t* src, uint8_t* dst_buffer, size_t length)
+    {
+        if (length == 0)
+            return 0;
+
+        uint8_t* dst = dst_buffer;
+        size_t pos = 0;
+        size_t count = 0;
+        size_t literalStart = 0;
+        while (pos < length - 1)
+        {
+            bool isPair = src[pos] == src[pos + 1];
+            if ((count != 0 && isPair) || count > 125)
+            {
+                *dst++ = static_cast<uint8_t>(count - 1);
+                std::memcpy(dst, src + literalStart, count);
+                dst += count;
+                literalStart += count;
+                count = 0;
+            }
+            if (isPair)
+            {
+                count = RunLength<TVec>(src + pos, std::min<size_t>(125, length - pos));
+                *dst++ = static_cast<uint8_t>(257 - count);
+                *dst++ = src[pos];
+                pos += count;
+                literalStart = pos;
+                count = 0;
+            }
+            else
+            {
+                // Skip every byte that does not start a run, up to the maximum length of a literal block.
+                size_t skip = FindPair<TVec>(src + pos, std::min<size_t>(126 - count, length - 1 - pos));
+                pos += skip;
+                count += skip;
+            }
+        }
+        if (pos == length - 1)
+            count++;
+        if (count != 0)
+        {
+            *dst++ = static_cast<uint8_t>(count - 1);
+            std::memcpy(dst, src + literalStart, count);
+            dst += count;
+        }
+        return dst - dst_buffer;
+    }
+
+    template<typename TVec> size_t EncodeRepeat(const uint8_t* src, uint8_t* dst, size_t length)
+    {
+        if (length == 0)
+            return 0;
+
+        size_t outLength = 0;
+
+        // Need to emit at least one byte, otherwise there is nothing to repeat
+        dst[outLength++] = 255;
+        dst[outLength++] = src[0];
+
+        for (size_t i = 1; i < length;)
+        {
+            size_t bestRepeatIndex = 0;
+            size_t bestRepeatCount = 0;
+            if (i >= 32 && i + 8 <= length)
+            {
+                // Candidate b starts 32 - b bytes back and can repeat at most that many bytes. Narrow down the
+                // candidates one byte at a time, the lowest candidate left at the longest length wins.
+                uint32_t candidates = 0xFFFFFFFF;
+                for (size_t repeatCount = 1; repeatCount <= 8; repeatCount++)
+                {
+                    candidates &= TVec::BackReferenceMask(src + i, repeatCount - 1);
+                    uint32_t valid = candidates & (0xFFFFFFFF >> (repeatCount - 1));
+                    if (valid == 0)
+                        break;
+                    bestRepeatCount = repeatCount;
+                    bestRepeatIndex = i - 32 + bitscanforward(static_cast<int32_t>(valid));
+                }
+            }
+            else
+            {
+                size_t searchIndex = (i < 32) ? 0 : (i - 32);
+                size_t searchEnd = i - 1;
+                for (size_t repeatIndex = searchIndex; repeatIndex <= searchEnd; repeatIndex++)
+                {
+                    size_t repeatCount = 0;
+                    size_t maxRepeatCount = std::min(std::min(static_cast<size_t>(7), searchEnd - repeatIndex), length - i - 1);
+                    for (size_t j = 0; j <= maxRepeatCount; j++)
+                    {
+                        if (src[repeatIndex + j] == src[i + j])
+                        {
+                            repeatCount++;
+                        }
+                        else
+                        {
+                            break;
+                        }
+                    }
+                    if (repeatCount > bestRepeatCount)
+                    {
+                        bestRepeatIndex = repeatIndex;
+                        bestRepeatCount = repeatCount;
+                        if (repeatCount == 8)
+                            break;
+                    }
+                }
+            }
+
+            if (bestRepeatCount == 0)
+            {
+                dst[outLength++] = 255;
+                dst[outLength++] = src[i];
+                i++;
+            }
+            else
+            {
+                dst[outLength++] = static_cast<uint8_t>((bestRepeatCount - 1) | ((32 - (i - bestRepeatIndex)) << 3));
+                i += bestRepeatCount;
+            }
+        }
+        return outLength;
+    }
+
+    template<typename TVec, bool TEncode> void Rotate(const uint8_t* src, uint8_t* dst, size_t length)
+    {
+        size_t i = 0;
+        for (; i + TVec::Width <= length; i += TVec::Width)
+        {
+            TVec::template Rotate<TEncode>(src + i, dst + i);
+        }
+
+        // Width is a multiple of 4, so the tail starts with the first code again
+        uint8_t code = 1;
+        for (; i < length; i++)
+        {
+            dst[i] = TEncode ? rol8(src[i], code) : ror8(src[i], code);
+            code = (code + 2) % 8;
+        }
+    }
+
+    template<typename TVec>
+    SawyerRLEDecodeResult DecodeRLE(
+        const uint8_t* src, size_t length, uint8_t* dst_buffer, size_t dstCapacity, size_t* outLength)
+    {
+        uint8_t* dst = dst_buffer;
+        uint8_t* dstEnd = dst_buffer + dstCapacity;
+        for (size_t i = 0; i < length; i++)
+        {
+            uint8_t rleCodeByte = src[i];
+            if (rleCodeByte & 128)
+            {
+                i++;
+                size_t count = 257 - rleCodeByte;
+
+                if (i >= length)
+                {
+                    return SawyerRLEDecodeResult::CorruptData;
+                }
+                if (dst + count > dstEnd)
+                {
+                    return SawyerRLEDecodeResult::DestinationTooSmall;
+                }
+
+                if (static_cast<size_t>(dstEnd - dst) >= count + TVec::Width)
+                {
+                    TVec::Fill(dst, src[i], count);
+                }
+                else
+                {
+                    std::fill_n(dst, count, src[i]);
+                }
+                dst += count;
+            }
+            else
+            {
+                size_t count = rleCodeByte + 1;
+                if (i + 1 >= length)
+                {
+                    return SawyerRLEDecodeResult::CorruptData;
+                }
+                if (dst + count > dstEnd)
+                {
+                    return SawyerRLEDecodeResult::DestinationTooSmall;
+                }
+                if (i + 1 + count > length)
+                {
+                    return SawyerRLEDecodeResult::CorruptData;
+                }
+
+                if (static_cast<size_t>(dstEnd - dst) >= count + TVec::Width && length - (i + 1) >= count + TVec::Width)
+                {
+                    TVec::Copy(dst, src + i + 1, count);
+                }
+                else
+                {
+                    std::memcpy(dst, src + i + 1, count);
+                }
+                dst += count;
+                i += count;
+            }
+        }
+        *outLength = dst - dst_buffer;
+        return SawyerRLEDecodeResult::Ok;
+    }
+
+    template<typename TVec> constexpr SawyerCodingKernels CreateKernels(const char* name)
+    {
+        return { name,
+                 EncodeRLE<TVec>,
+                 EncodeRepeat<TVec>,
+                 Rotate<TVec, true>,
+                 Rotate<TVec, false>,
+                 DecodeRLE<TVec> };
+    }
+} // namespace SawyerCodingVector
@@ -385,13 +385,17 @@ uint8_t BannerElement::GetAllowedEdges() const
 
 void BannerElement::SetAllowedEdges(uint8_t newEdges)
 {
+    const auto oldFlags = flags;
     flags &= ~0b00001111;
     flags |= (newEdges & 0b00001111);
+    // The allowed edges block paths, which is part of the path layout
+    if (flags != oldFlags)
+        tile_element_changed(this);
 }
 
 void BannerElement::ResetAllowedEdges()
 {
-    flags |= 0b00001111;
+    SetAllowedEdges(0b00001111);
 }
 
 Banner* GetBanner(BannerIndex id)
@@ -1423,6 +1423,9 @@ bool PathElement::IsSloped() const
 
 void PathElement::SetSloped(bool isSloped)
 {
+    if (isSloped != IsSloped())
+        tile_element_changed(this);
+
     Flags2 &= ~FOOTPATH_ELEMENT_FLAGS2_IS_SLOPED;
     if (isSloped)
         Flags2 |= FOOTPATH_ELEMENT_FLAGS2_IS_SLOPED;
@@ -1435,6 +1438,9 @@ Direction PathElement::GetSlopeDirection() const
 
 void PathElement::SetSlopeDirection(Direction newSlope)
 {
+    if (newSlope != SlopeDirection)
+        tile_element_changed(this);
+
     SlopeDirection = newSlope;
 }
 
@@ -1445,6 +1451,9 @@ bool PathElement::IsQueue() const
 
 void PathElement::SetIsQueue(bool isQueue)
 {
+    if (isQueue != IsQueue())
+        tile_element_changed(this);
+
     type &= ~FOOTPATH_ELEMENT_TYPE_FLAG_IS_QUEUE;
     if (isQueue)
         type |= FOOTPATH_ELEMENT_TYPE_FLAG_IS_QUEUE;
@@ -1513,6 +1522,10 @@ bool PathElement::IsWide() const
 
 void PathElement::SetWide(bool isWide)
 {
+    // Called for every path on the map by map_update_path_wide_flags, only an actual change counts.
+    if (isWide != IsWide())
+        tile_element_changed(this);
+
     type &= ~FOOTPATH_ELEMENT_TYPE_FLAG_IS_WIDE;
     if (isWide)
         type |= FOOTPATH_ELEMENT_TYPE_FLAG_IS_WIDE;
@@ -1611,25 +1624,6 @@ void PathElement::SetShouldDrawPathOverSupports(bool on)
     log_verbose("Setting 'draw path over supports' to %d", static_cast<size_t>(on));
 }
 
-/**
- *
- *  rct2: 0x006A8B12
- *  clears the wide footpath flag for all footpaths
- *  at location
- */
-static void footpath_clear_wide(const CoordsXY& footpathPos)
-{
-    TileElement* tileElement = map_get_first_element_at(footpathPos);
-    if (tileElement == nullptr)
-        return;
-    do
-    {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
-            continue;
-        tileElement->AsPath()->SetWide(false);
-    } while (!(tileElement++)->IsLastForTile());
-}
-
 /**
  *
  *  rct2: 0x006A8ACF
@@ -1658,191 +1652,201 @@ static TileElement* footpath_can_be_wide(const CoordsXYZ& footpathPos)
 }
 
 /**
- *
- *  rct2: 0x006A87BB
+ * Works out whether the path element should be wide. Only the paths of the neighbouring tiles are looked at, so the
+ * flags of the tile itself do not have to be cleared first.
  */
-void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
+static bool footpath_element_should_be_wide(const CoordsXY& footpathPos, TileElement* tileElement)
 {
-    if (map_is_location_at_edge(footpathPos))
-        return;
-
-    footpath_clear_wide(footpathPos);
-    /* Rather than clearing the wide flag of the following tiles and
-     * checking the state of them later, leave them intact and assume
-     * they were cleared. Consequently only the wide flag for this single
-     * tile is modified by this update.
-     * This is important for avoiding glitches in pathfinding that occurs
-     * between the batches of updates to the path wide flags.
-     * Corresponding pathList[] indexes for the following tiles
-     * are: 2, 3, 4, 5.
-     * Note: indexes 3, 4, 5 are reset in the current call;
-     *       index 2 is reset in the previous call. */
-    // x += 0x20;
-    // footpath_clear_wide(x, y);
-    // y += 0x20;
-    // footpath_clear_wide(x, y);
-    // x -= 0x20;
-    // footpath_clear_wide(x, y);
-    // y -= 0x20;
-
-    TileElement* tileElement = map_get_first_element_at(footpathPos);
-    if (tileElement == nullptr)
-        return;
-    do
-    {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
-            continue;
+    if (tileElement->AsPath()->IsQueue())
+        return false;
 
-        if (tileElement->AsPath()->IsQueue())
-            continue;
+    if (tileElement->AsPath()->IsSloped())
+        return false;
 
-        if (tileElement->AsPath()->IsSloped())
-            continue;
+    if (tileElement->AsPath()->GetEdges() == 0)
+        return false;
 
-        if (tileElement->AsPath()->GetEdges() == 0)
-            continue;
+    auto height = tileElement->GetBaseZ();
 
-        auto height = tileElement->GetBaseZ();
+    // pathList is a list of elements, set by sub_6A8ACF adjacent to x,y
+    // Spanned from 0x00F3EFA8 to 0x00F3EFC7 (8 elements) in the original
+    std::array<TileElement*, 8> pathList;
 
-        // pathList is a list of elements, set by sub_6A8ACF adjacent to x,y
-        // Spanned from 0x00F3EFA8 to 0x00F3EFC7 (8 elements) in the original
-        std::array<TileElement*, 8> pathList;
+    for (int32_t direction = 0; direction < 8; ++direction)
+    {
+        auto footpathLoc = CoordsXYZ(footpathPos + CoordsDirectionDelta[direction], height);
+        pathList[direction] = footpath_can_be_wide(footpathLoc);
+    }
 
-        for (int32_t direction = 0; direction < 8; ++direction)
+    uint8_t pathConnections = 0;
+    if (tileElement->AsPath()->GetEdges() & EDGE_NW)
+    {
+        pathConnections |= FOOTPATH_CONNECTION_NW;
+        if (pathList[3] != nullptr && pathList[3]->AsPath()->IsWide())
         {
-            auto footpathLoc = CoordsXYZ(footpathPos + CoordsDirectionDelta[direction], height);
-            pathList[direction] = footpath_can_be_wide(footpathLoc);
+            pathConnections &= ~FOOTPATH_CONNECTION_NW;
         }
+    }
 
-        uint8_t pathConnections = 0;
-        if (tileElement->AsPath()->GetEdges() & EDGE_NW)
+    if (tileElement->AsPath()->GetEdges() & EDGE_NE)
+    {
+        pathConnections |= FOOTPATH_CONNECTION_NE;
+        if (pathList[0] != nullptr && pathList[0]->AsPath()->IsWide())
         {
-            pathConnections |= FOOTPATH_CONNECTION_NW;
-            if (pathList[3] != nullptr && pathList[3]->AsPath()->IsWide())
-            {
-                pathConnections &= ~FOOTPATH_CONNECTION_NW;
-            }
+            pathConnections &= ~FOOTPATH_CONNECTION_NE;
         }
+    }
 
-        if (tileElement->AsPath()->GetEdges() & EDGE_NE)
-        {
-            pathConnections |= FOOTPATH_CONNECTION_NE;
-            if (pathList[0] != nullptr && pathList[0]->AsPath()->IsWide())
-            {
-                pathConnections &= ~FOOTPATH_CONNECTION_NE;
-            }
-        }
+    if (tileElement->AsPath()->GetEdges() & EDGE_SE)
+    {
+        pathConnections |= FOOTPATH_CONNECTION_SE;
+        /* In the following:
+         * footpath_element_is_wide(pathList[1])
+         * is always false due to the tile update order
+         * in combination with reset tiles.
+         * Commented out since it will never occur. */
+        // if (pathList[1] != nullptr) {
+        //  if (footpath_element_is_wide(pathList[1])) {
+        //      pathConnections &= ~FOOTPATH_CONNECTION_SE;
+        //  }
+        //}
+    }
+
+    if (tileElement->AsPath()->GetEdges() & EDGE_SW)
+    {
+        pathConnections |= FOOTPATH_CONNECTION_SW;
+        /* In the following:
+         * footpath_element_is_wide(pathList[2])
+         * is always false due to the tile update order
+         * in combination with reset tiles.
+         * Commented out since it will never occur. */
+        // if (pathList[2] != nullptr) {
+        //  if (footpath_element_is_wide(pathList[2])) {
+        //      pathConnections &= ~FOOTPATH_CONNECTION_SW;
+        //  }
+        //}
+    }
 
-        if (tileElement->AsPath()->GetEdges() & EDGE_SE)
+    if ((pathConnections & FOOTPATH_CONNECTION_NW) && pathList[3] != nullptr && !pathList[3]->AsPath()->IsWide())
+    {
+        constexpr uint8_t edgeMask1 = EDGE_SE | EDGE_SW;
+        if ((pathConnections & FOOTPATH_CONNECTION_NE) && pathList[7] != nullptr && !pathList[7]->AsPath()->IsWide()
+            && (pathList[7]->AsPath()->GetEdges() & edgeMask1) == edgeMask1 && pathList[0] != nullptr
+            && !pathList[0]->AsPath()->IsWide())
         {
-            pathConnections |= FOOTPATH_CONNECTION_SE;
-            /* In the following:
-             * footpath_element_is_wide(pathList[1])
-             * is always false due to the tile update order
-             * in combination with reset tiles.
-             * Commented out since it will never occur. */
-            // if (pathList[1] != nullptr) {
-            //  if (footpath_element_is_wide(pathList[1])) {
-            //      pathConnections &= ~FOOTPATH_CONNECTION_SE;
-            //  }
-            //}
+            pathConnections |= FOOTPATH_CONNECTION_S;
         }
 
-        if (tileElement->AsPath()->GetEdges() & EDGE_SW)
+        /* In the following:
+         * footpath_element_is_wide(pathList[2])
+         * is always false due to the tile update order
+         * in combination with reset tiles.
+         * Short circuit the logic appropriately. */
+        constexpr uint8_t edgeMask2 = EDGE_NE | EDGE_SE;
+        if ((pathConnections & FOOTPATH_CONNECTION_SW) && pathList[6] != nullptr && !(pathList[6])->AsPath()->IsWide()
+            && (pathList[6]->AsPath()->GetEdges() & edgeMask2) == edgeMask2 && pathList[2] != nullptr)
         {
-            pathConnections |= FOOTPATH_CONNECTION_SW;
-            /* In the following:
-             * footpath_element_is_wide(pathList[2])
-             * is always false due to the tile update order
-             * in combination with reset tiles.
-             * Commented out since it will never occur. */
-            // if (pathList[2] != nullptr) {
-            //  if (footpath_element_is_wide(pathList[2])) {
-            //      pathConnections &= ~FOOTPATH_CONNECTION_SW;
-            //  }
-            //}
+            pathConnections |= FOOTPATH_CONNECTION_E;
         }
+    }
 
-        if ((pathConnections & FOOTPATH_CONNECTION_NW) && pathList[3] != nullptr && !pathList[3]->AsPath()->IsWide())
+    /* In the following:
+     * footpath_element_is_wide(pathList[4])
+     * footpath_element_is_wide(pathList[1])
+     * are always false due to the tile update order
+     * in combination with reset tiles.
+     * Short circuit the logic appropriately. */
+    if ((pathConnections & FOOTPATH_CONNECTION_SE) && pathList[1] != nullptr)
+    {
+        constexpr uint8_t edgeMask1 = EDGE_SW | EDGE_NW;
+        if ((pathConnections & FOOTPATH_CONNECTION_NE) && (pathList[4] != nullptr)
+            && (pathList[4]->AsPath()->GetEdges() & edgeMask1) == edgeMask1 && pathList[0] != nullptr
+            && !pathList[0]->AsPath()->IsWide())
         {
-            constexpr uint8_t edgeMask1 = EDGE_SE | EDGE_SW;
-            if ((pathConnections & FOOTPATH_CONNECTION_NE) && pathList[7] != nullptr && !pathList[7]->AsPath()->IsWide()
-                && (pathList[7]->AsPath()->GetEdges() & edgeMask1) == edgeMask1 && pathList[0] != nullptr
-                && !pathList[0]->AsPath()->IsWide())
-            {
-                pathConnections |= FOOTPATH_CONNECTION_S;
-            }
-
-            /* In the following:
-             * footpath_element_is_wide(pathList[2])
-             * is always false due to the tile update order
-             * in combination with reset tiles.
-             * Short circuit the logic appropriately. */
-            constexpr uint8_t edgeMask2 = EDGE_NE | EDGE_SE;
-            if ((pathConnections & FOOTPATH_CONNECTION_SW) && pathList[6] != nullptr && !(pathList[6])->AsPath()->IsWide()
-                && (pathList[6]->AsPath()->GetEdges() & edgeMask2) == edgeMask2 && pathList[2] != nullptr)
-            {
-                pathConnections |= FOOTPATH_CONNECTION_E;
-            }
+            pathConnections |= FOOTPATH_CONNECTION_W;
         }
 
         /* In the following:
-         * footpath_element_is_wide(pathList[4])
-         * footpath_element_is_wide(pathList[1])
+         * footpath_element_is_wide(pathList[5])
+         * footpath_element_is_wide(pathList[2])
          * are always false due to the tile update order
          * in combination with reset tiles.
          * Short circuit the logic appropriately. */
-        if ((pathConnections & FOOTPATH_CONNECTION_SE) && pathList[1] != nullptr)
+        constexpr uint8_t edgeMask2 = EDGE_NE | EDGE_NW;
+        if ((pathConnections & FOOTPATH_CONNECTION_SW) && pathList[5] != nullptr
+            && (pathList[5]->AsPath()->GetEdges() & edgeMask2) == edgeMask2 && pathList[2] != nullptr)
         {
-            constexpr uint8_t edgeMask1 = EDGE_SW | EDGE_NW;
-            if ((pathConnections & FOOTPATH_CONNECTION_NE) && (pathList[4] != nullptr)
-                && (pathList[4]->AsPath()->GetEdges() & edgeMask1) == edgeMask1 && pathList[0] != nullptr
-                && !pathList[0]->AsPath()->IsWide())
-            {
-                pathConnections |= FOOTPATH_CONNECTION_W;
-            }
-
-            /* In the following:
-             * footpath_element_is_wide(pathList[5])
-             * footpath_element_is_wide(pathList[2])
-             * are always false due to the tile update order
-             * in combination with reset tiles.
-             * Short circuit the logic appropriately. */
-            constexpr uint8_t edgeMask2 = EDGE_NE | EDGE_NW;
-            if ((pathConnections & FOOTPATH_CONNECTION_SW) && pathList[5] != nullptr
-                && (pathList[5]->AsPath()->GetEdges() & edgeMask2) == edgeMask2 && pathList[2] != nullptr)
-            {
-                pathConnections |= FOOTPATH_CONNECTION_N;
-            }
+            pathConnections |= FOOTPATH_CONNECTION_N;
         }
+    }
 
-        if ((pathConnections & FOOTPATH_CONNECTION_NW) && (pathConnections & (FOOTPATH_CONNECTION_E | FOOTPATH_CONNECTION_S)))
-        {
-            pathConnections &= ~FOOTPATH_CONNECTION_NW;
-        }
+    if ((pathConnections & FOOTPATH_CONNECTION_NW) && (pathConnections & (FOOTPATH_CONNECTION_E | FOOTPATH_CONNECTION_S)))
+    {
+        pathConnections &= ~FOOTPATH_CONNECTION_NW;
+    }
 
-        if ((pathConnections & FOOTPATH_CONNECTION_NE) && (pathConnections & (FOOTPATH_CONNECTION_W | FOOTPATH_CONNECTION_S)))
-        {
-            pathConnections &= ~FOOTPATH_CONNECTION_NE;
-        }
+    if ((pathConnections & FOOTPATH_CONNECTION_NE) && (pathConnections & (FOOTPATH_CONNECTION_W | FOOTPATH_CONNECTION_S)))
+    {
+        pathConnections &= ~FOOTPATH_CONNECTION_NE;
+    }
 
-        if ((pathConnections & FOOTPATH_CONNECTION_SE) && (pathConnections & (FOOTPATH_CONNECTION_N | FOOTPATH_CONNECTION_W)))
-        {
-            pathConnections &= ~FOOTPATH_CONNECTION_SE;
-        }
+    if ((pathConnections & FOOTPATH_CONNECTION_SE) && (pathConnections & (FOOTPATH_CONNECTION_N | FOOTPATH_CONNECTION_W)))
+    {
+        pathConnections &= ~FOOTPATH_CONNECTION_SE;
+    }
 
-        if ((pathConnections & FOOTPATH_CONNECTION_SW) && (pathConnections & (FOOTPATH_CONNECTION_E | FOOTPATH_CONNECTION_N)))
-        {
-            pathConnections &= ~FOOTPATH_CONNECTION_SW;
-        }
+    if ((pathConnections & FOOTPATH_CONNECTION_SW) && (pathConnections & (FOOTPATH_CONNECTION_E | FOOTPATH_CONNECTION_N)))
+    {
+        pathConnections &= ~FOOTPATH_CONNECTION_SW;
+    }
 
-        if (!(pathConnections
-              & (FOOTPATH_CONNECTION_NE | FOOTPATH_CONNECTION_SE | FOOTPATH_CONNECTION_SW | FOOTPATH_CONNECTION_NW)))
-        {
-            uint8_t e = tileElement->AsPath()->GetEdgesAndCorners();
-            if ((e != 0b10101111) && (e != 0b01011111) && (e != 0b11101111))
-                tileElement->AsPath()->SetWide(true);
-        }
+    if (!(pathConnections
+          & (FOOTPATH_CONNECTION_NE | FOOTPATH_CONNECTION_SE | FOOTPATH_CONNECTION_SW | FOOTPATH_CONNECTION_NW)))
+    {
+        uint8_t e = tileElement->AsPath()->GetEdgesAndCorners();
+        if ((e != 0b10101111) && (e != 0b01011111) && (e != 0b11101111))
+            return true;
+    }
+    return false;
+}
+
+/**
+ *
+ *  rct2: 0x006A87BB
+ */
+void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
+{
+    if (map_is_location_at_edge(footpathPos))
+        return;
+
+    /* Rather than clearing the wide flag of the following tiles and
+     * checking the state of them later, leave them intact and assume
+     * they were cleared. Consequently only the wide flag for this single
+     * tile is modified by this update.
+     * This is important for avoiding glitches in pathfinding that occurs
+     * between the batches of updates to the path wide flags.
+     * Corresponding pathList[] indexes for the following tiles
+     * are: 2, 3, 4, 5.
+     * Note: indexes 3, 4, 5 are reset in the current call;
+     *       index 2 is reset in the previous call. */
+    // x += 0x20;
+    // footpath_clear_wide(x, y);
+    // y += 0x20;
+    // footpath_clear_wide(x, y);
+    // x -= 0x20;
+    // footpath_clear_wide(x, y);
+    // y -= 0x20;
+
+    TileElement* tileElement = map_get_first_element_at(footpathPos);
+    if (tileElement == nullptr)
+        return;
+    do
+    {
+        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
+            continue;
+
+        // Each flag is set once to its final state, so a path that stays wide is not changed by the update.
+        tileElement->AsPath()->SetWide(footpath_element_should_be_wide(footpathPos, tileElement));
     } while (!(tileElement++)->IsLastForTile());
 }
 
@@ -2212,6 +2216,9 @@ uint8_t PathElement::GetEdges() const
 
 void PathElement::SetEdges(uint8_t newEdges)
 {
+    if ((newEdges & FOOTPATH_PROPERTIES_EDGES_EDGES_MASK) != GetEdges())
+        tile_element_changed(this);
+
     Edges &= ~FOOTPATH_PROPERTIES_EDGES_EDGES_MASK;
     Edges |= (newEdges & FOOTPATH_PROPERTIES_EDGES_EDGES_MASK);
 }
@@ -2234,6 +2241,9 @@ uint8_t PathElement::GetEdgesAndCorners() const
 
 void PathElement::SetEdgesAndCorners(uint8_t newEdgesAndCorners)
 {
+    if ((newEdgesAndCorners & FOOTPATH_PROPERTIES_EDGES_EDGES_MASK) != GetEdges())
+        tile_element_changed(this);
+
     Edges = newEdgesAndCorners;
 }
 
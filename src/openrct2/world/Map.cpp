@@ -27,6 +27,7 @@
 #include "../actions/WaterSetHeightAction.hpp"
 #include "../audio/audio.h"
 #include "../config/Config.h"
+#include "../core/DataSerialiser.h"
 #include "../core/Guard.hpp"
 #include "../interface/Cursors.h"
 #include "../interface/Window.h"
@@ -36,6 +37,7 @@
 #include "../network/network.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../paint/PaintCache.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -99,14 +101,18 @@ int16_t gMapSize;
 int16_t gMapSizeMaxXY;
 int16_t gMapBaseZ;
 
-TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
-TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
+std::vector<TileElement> gTileElements;
+uint32_t gTileElementOffsets[MAX_TILE_TILE_ELEMENT_POINTERS];
 std::vector<CoordsXY> gMapSelectionTiles;
 std::vector<PeepSpawn> gPeepSpawns;
 
 TileElement* gNextFreeTileElement;
 uint32_t gNextFreeTileElementPointerIndex;
 
+// Runs of elements left behind when tile_element_insert moves the elements of a tile, by length of the run minus one.
+// Longer runs are only given back by map_reorganise_elements.
+static std::vector<uint32_t> _freeTileElementRuns[16];
+
 bool gLandMountainMode;
 bool gLandPaintMode;
 bool gClearSmallScenery;
@@ -173,7 +179,8 @@ TileElement* map_get_first_element_at(const CoordsXY& elementPos)
         return nullptr;
     }
     auto tileElementPos = TileCoordsXY{ elementPos };
-    return gTileElementTilePointers[tileElementPos.x + tileElementPos.y * MAXIMUM_MAP_SIZE_TECHNICAL];
+    const auto offset = gTileElementOffsets[tileElementPos.x + tileElementPos.y * MAXIMUM_MAP_SIZE_TECHNICAL];
+    return offset == TILE_ELEMENT_OFFSET_NULL ? nullptr : gTileElements.data() + offset;
 }
 
 TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n)
@@ -210,9 +217,34 @@ void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements)
         log_error("Trying to access element outside of range");
         return;
     }
-    gTileElementTilePointers[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL] = elements;
+
+    auto& offset = gTileElementOffsets[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL];
+    if (elements == nullptr)
+    {
+        offset = TILE_ELEMENT_OFFSET_NULL;
+    }
+    else
+    {
+        Guard::Assert(
+            elements >= gTileElements.data() && elements < gTileElements.data() + gTileElements.size(),
+            "Tile elements must be in gTileElements");
+        offset = static_cast<uint32_t>(elements - gTileElements.data());
+    }
+}
+
+/**
+ * Returns TILE_ELEMENT_SCRATCH_SIZE elements that the map never uses. Tiles can be pointed at them with
+ * map_set_tile_element to draw elements that have not been placed, e.g. the track piece being constructed.
+ */
+TileElement* map_get_scratch_tile_elements()
+{
+    return gTileElements.data() + gTileElements.size() - TILE_ELEMENT_SCRATCH_SIZE;
 }
 
+/**
+ * Scans the elements of the tile for its surface. The surface is not always the first element: ghosts, elements
+ * inserted below it and imported parks can come before it.
+ */
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords)
 {
     TileElement* tileElement = map_get_first_element_at(coords);
@@ -286,6 +318,7 @@ BannerElement* map_get_banner_element_at(const CoordsXYZ& bannerPos, uint8_t pos
 void map_init(int32_t size)
 {
     gNextFreeTileElementPointerIndex = 0;
+    map_allocate_tile_elements(INITIAL_TILE_ELEMENTS_WITH_SPARE_ROOM);
 
     for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
     {
@@ -377,6 +410,63 @@ void map_strip_ghost_flag_from_elements()
     }
 }
 
+static void map_clear_free_tile_element_runs()
+{
+    for (auto& runs : _freeTileElementRuns)
+    {
+        runs.clear();
+    }
+}
+
+/**
+ * Replaces the tile element storage with numElements cleared elements, for the caller to fill in before it sets up
+ * the tile pointers.
+ */
+void map_allocate_tile_elements(size_t numElements)
+{
+    gTileElements = std::vector<TileElement>(numElements);
+    gNextFreeTileElement = gTileElements.data();
+    map_clear_free_tile_element_runs();
+    gTileElementsRevision++;
+}
+
+/**
+ * Writes or reads the tile elements together with the tile pointers and free runs as they are, so a restored map
+ * allocates elements the same way the captured one would have. See GameStateImage.
+ */
+void map_serialise_state(DataSerialiser& ds)
+{
+    ds << DS_RAW(gMapSizeUnits);
+    ds << DS_RAW(gMapSizeMinus2);
+    ds << DS_RAW(gMapSize);
+    ds << DS_RAW(gMapSizeMaxXY);
+    ds << DS_RAW(gMapBaseZ);
+    ds << DS_RAW(gTileElements);
+    ds << DS_RAW(gTileElementOffsets);
+
+    auto nextFreeTileElement = static_cast<uint32_t>(gNextFreeTileElement - gTileElements.data());
+    ds << DS_RAW(nextFreeTileElement);
+    ds << DS_RAW(gNextFreeTileElementPointerIndex);
+    for (auto& runs : _freeTileElementRuns)
+    {
+        ds << DS_RAW(runs);
+    }
+
+    ds << DS_RAW(gPeepSpawns);
+    ds << DS_RAW(gWidePathTileLoopX);
+    ds << DS_RAW(gWidePathTileLoopY);
+    ds << DS_RAW(gGrassSceneryTileLoopPosition);
+    ds << DS_RAW(gLandRemainingOwnershipSales);
+    ds << DS_RAW(gLandRemainingConstructionSales);
+
+    if (ds.IsLoading())
+    {
+        gNextFreeTileElement = gTileElements.data() + nextFreeTileElement;
+        paint_cache_invalidate_all();
+        gTileElementsRevision++;
+    }
+}
+
 /**
  *
  *  rct2: 0x0068AFFD
@@ -385,18 +475,24 @@ void map_update_tile_pointers()
 {
     int32_t i, x, y;
 
+    // Every tile may have moved, including the elements cached paint calls refer to.
+    paint_cache_invalidate_all();
+    // The elements are expected to be stored without gaps.
+    map_clear_free_tile_element_runs();
+    gTileElementsRevision++;
+
     for (i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
     {
-        gTileElementTilePointers[i] = TILE_UNDEFINED_TILE_ELEMENT;
+        gTileElementOffsets[i] = TILE_ELEMENT_OFFSET_NULL;
     }
 
-    TileElement* tileElement = gTileElements;
-    TileElement** tile = gTileElementTilePointers;
+    TileElement* tileElement = gTileElements.data();
+    uint32_t* tile = gTileElementOffsets;
     for (y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
     {
         for (x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
         {
-            *tile++ = tileElement;
+            *tile++ = static_cast<uint32_t>(tileElement - gTileElements.data());
             while (!(tileElement++)->IsLastForTile())
                 ;
         }
@@ -943,6 +1039,8 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  */
 void tile_element_remove(TileElement* tileElement)
 {
+    tile_element_changed(tileElement);
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -1069,6 +1167,14 @@ void map_invalidate_selection_rect()
     }
 }
 
+static size_t map_get_tile_element_run_length(const TileElement* tileElement)
+{
+    const TileElement* endElement = tileElement;
+    while (!(endElement++)->IsLastForTile())
+        ;
+    return static_cast<size_t>(endElement - tileElement);
+}
+
 /**
  *
  *  rct2: 0x0068B111
@@ -1077,14 +1183,23 @@ void map_reorganise_elements()
 {
     context_setcurrentcursor(CURSOR_ZZZ);
 
-    auto newTileElements = std::make_unique<TileElement[]>(MAX_TILE_ELEMENTS_WITH_SPARE_ROOM);
-    TileElement* newElementsPtr = newTileElements.get();
+    size_t numElements = 0;
+    for (auto offset : gTileElementOffsets)
+    {
+        if (offset != TILE_ELEMENT_OFFSET_NULL)
+        {
+            numElements += map_get_tile_element_run_length(&gTileElements[offset]);
+        }
+    }
 
-    if (newTileElements == nullptr)
+    // Size the new storage for the elements in use, giving back what a bigger park needed.
+    size_t storageSize = INITIAL_TILE_ELEMENTS_WITH_SPARE_ROOM;
+    while (storageSize < numElements + TILE_ELEMENT_SPARE_ROOM)
     {
-        log_fatal("Unable to allocate memory for map elements.");
-        return;
+        storageSize += TILE_ELEMENT_CHUNK_SIZE;
     }
+    std::vector<TileElement> newTileElements(storageSize);
+    TileElement* newElementsPtr = newTileElements.data();
 
     for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
     {
@@ -1093,58 +1208,128 @@ void map_reorganise_elements()
             TileElement* startElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
             if (startElement == nullptr)
                 continue;
-            TileElement* endElement = startElement;
-            while (!(endElement++)->IsLastForTile())
-                ;
 
-            const auto numElements = static_cast<uint32_t>(endElement - startElement);
-            std::memcpy(newElementsPtr, startElement, numElements * sizeof(TileElement));
-            newElementsPtr += numElements;
+            const auto runLength = map_get_tile_element_run_length(startElement);
+            std::memcpy(newElementsPtr, startElement, runLength * sizeof(TileElement));
+            newElementsPtr += runLength;
         }
     }
 
-    const auto numElements = static_cast<uint32_t>(newElementsPtr - newTileElements.get());
-    std::memcpy(gTileElements, newTileElements.get(), numElements * sizeof(TileElement));
-    std::memset(gTileElements + numElements, 0, (MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - numElements) * sizeof(TileElement));
-
+    gTileElements = std::move(newTileElements);
     map_update_tile_pointers();
 }
 
+/**
+ * Grows the storage so that numElements more elements fit after the next free element. The tiles refer to their
+ * elements by offset, so only the next free element has to follow the move.
+ * @returns false if the storage would grow beyond MAX_TILE_ELEMENTS_WITH_SPARE_ROOM.
+ */
+static bool map_grow_tile_elements(size_t numElements)
+{
+    const auto numUsed = static_cast<size_t>(gNextFreeTileElement - gTileElements.data());
+
+    // Grow by half the storage at a time so that a growing park does not keep copying all of its elements.
+    size_t storageSize = gTileElements.size();
+    const size_t growth = std::max<size_t>(TILE_ELEMENT_CHUNK_SIZE, storageSize / 2 / TILE_ELEMENT_CHUNK_SIZE * TILE_ELEMENT_CHUNK_SIZE);
+    while (storageSize < numUsed + numElements + TILE_ELEMENT_SPARE_ROOM)
+    {
+        storageSize += growth;
+    }
+    storageSize = std::min<size_t>(storageSize, MAX_TILE_ELEMENTS_WITH_SPARE_ROOM);
+    if (storageSize < numUsed + numElements + TILE_ELEMENT_SPARE_ROOM)
+    {
+        return false;
+    }
+
+    std::vector<TileElement> newTileElements(storageSize);
+    std::copy(gTileElements.begin(), gTileElements.end(), newTileElements.begin());
+    gNextFreeTileElement = newTileElements.data() + numUsed;
+    gTileElements = std::move(newTileElements);
+    gTileElementsRevision++;
+
+    // Cached paint calls refer to the elements that were moved.
+    paint_cache_invalidate_all();
+    return true;
+}
+
+/**
+ * Makes sure that numElements more elements fit after the next free element, growing the storage if they do not.
+ */
+static bool map_ensure_free_elements(size_t numElements)
+{
+    const auto numUsed = static_cast<size_t>(gNextFreeTileElement - gTileElements.data());
+    return numUsed + numElements + TILE_ELEMENT_SPARE_ROOM <= gTileElements.size() || map_grow_tile_elements(numElements);
+}
+
 /**
  *
  *  rct2: 0x0068B044
  *  Returns true on space available for more elements
- *  Reorganises the map elements to check for space
+ *  Grows the element storage to make space
+ *
+ * Growing the storage moves every element. Actions call this before they look up any element, so it also makes room
+ * for the runs that their inserts copy and an insert does not have to grow the storage under their element pointers.
  */
 bool map_check_free_elements_and_reorganise(int32_t numElements)
 {
     if (numElements != 0)
     {
-        auto tileElementEnd = &gTileElements[MAX_TILE_ELEMENTS];
-
-        // Check if is there is room for the required number of elements
-        auto newTileElementEnd = gNextFreeTileElement + numElements;
-        if (newTileElementEnd > tileElementEnd)
+        if (!map_ensure_free_elements(numElements + TILE_ELEMENT_INSERT_RESERVE)
+            && !map_ensure_free_elements(numElements))
         {
-            // Defragment the map element list
-            map_reorganise_elements();
+            // Not enough spare elements left :'(
+            gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
+            return false;
+        }
+    }
+    return true;
+}
 
-            // Check if there is any room again
-            newTileElementEnd = gNextFreeTileElement + numElements;
-            if (newTileElementEnd > tileElementEnd)
+/**
+ * Finds space for the elements of a tile, reusing a run that was given up by another tile if there is one.
+ */
+static TileElement* map_allocate_tile_element_run(size_t length)
+{
+    for (size_t runLength = length; runLength <= std::size(_freeTileElementRuns); runLength++)
+    {
+        auto& runs = _freeTileElementRuns[runLength - 1];
+        if (!runs.empty())
+        {
+            const auto index = runs.back();
+            runs.pop_back();
+            if (runLength > length)
             {
-                // Not enough spare elements left :'(
-                gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
-                return false;
+                _freeTileElementRuns[runLength - length - 1].push_back(index + static_cast<uint32_t>(length));
             }
+            return &gTileElements[index];
         }
     }
-    return true;
+
+    TileElement* run = gNextFreeTileElement;
+    gNextFreeTileElement += length;
+    return run;
+}
+
+static void map_free_tile_element_run(TileElement* run, size_t length)
+{
+    if (run + length == gNextFreeTileElement)
+    {
+        gNextFreeTileElement = run;
+    }
+    else if (length <= std::size(_freeTileElementRuns))
+    {
+        _freeTileElementRuns[length - 1].push_back(static_cast<uint32_t>(run - gTileElements.data()));
+    }
 }
 
 /**
  *
  *  rct2: 0x0068B1F6
+ *
+ * The elements of the tile are copied to a new run, so pointers to them are no longer valid afterwards. When there is
+ * no room left the storage grows, which moves every element of the map. Callers must not use element pointers they
+ * got before the insert, they look them up again or keep the index of the element in gTileElements instead. Actions
+ * call map_check_free_elements_and_reorganise first, which keeps room for their inserts so the storage does not grow.
  */
 TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants)
 {
@@ -1152,17 +1337,25 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
     TileElement *originalTileElement, *newTileElement, *insertedElement;
     bool isLastForTile = false;
 
-    if (!map_check_free_elements_and_reorganise(1))
+    // The run of the tile is copied, so there has to be room for all of it and the new element.
+    originalTileElement = map_get_first_element_at(loc);
+    const size_t originalRunLength = originalTileElement == nullptr ? 0
+                                                                    : map_get_tile_element_run_length(originalTileElement);
+    if (!map_ensure_free_elements(originalRunLength + 1))
     {
         log_error("Cannot insert new element");
+        gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
         return nullptr;
     }
+    tile_elements_changed_at(loc);
 
-    newTileElement = gNextFreeTileElement;
-    originalTileElement = gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x];
+    originalTileElement = map_get_first_element_at(loc);
+    TileElement* originalRun = originalTileElement;
+    newTileElement = map_allocate_tile_element_run(originalRunLength + 1);
 
-    // Set tile index pointer to point to new element block
-    gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x] = newTileElement;
+    // Set tile offset to point to new element block
+    gTileElementOffsets[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x] = static_cast<uint32_t>(
+        newTileElement - gTileElements.data());
 
     if (originalTileElement == nullptr)
     {
@@ -1214,7 +1407,11 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
         } while (!((newTileElement - 1)->IsLastForTile()));
     }
 
-    gNextFreeTileElement = newTileElement;
+    if (originalRun != nullptr)
+    {
+        map_free_tile_element_run(originalRun, originalRunLength);
+    }
+    paint_cache_invalidate_tile(loc);
     return insertedElement;
 }
 
@@ -2017,6 +2214,8 @@ static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int
     if (gOpenRCT2Headless)
         return;
 
+    paint_cache_invalidate_tile({ x, y });
+
     int32_t x1, y1, x2, y2;
 
     x += 16;
@@ -2083,6 +2282,8 @@ void map_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs)
 {
     int32_t x0, y0, x1, y1, left, right, top, bottom;
 
+    paint_cache_invalidate_region(mins, maxs);
+
     x0 = mins.x + 16;
     y0 = mins.y + 16;
 
@@ -17,6 +17,8 @@
 #include <initializer_list>
 #include <vector>
 
+class DataSerialiser;
+
 #define MINIMUM_LAND_HEIGHT 2
 #define MAXIMUM_LAND_HEIGHT 142
 #define MINIMUM_WATER_HEIGHT 2
@@ -33,8 +35,18 @@ constexpr const int32_t MINIMUM_LAND_HEIGHT_BIG = MINIMUM_LAND_HEIGHT * COORDS_Z
 
 #define MAP_MINIMUM_X_Y (-MAXIMUM_MAP_SIZE_TECHNICAL)
 
-constexpr const uint32_t MAX_TILE_ELEMENTS_WITH_SPARE_ROOM = 0x30000;
-constexpr const uint32_t MAX_TILE_ELEMENTS = MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - 512;
+// The tile elements are kept in one array, it starts at the size RCT2 used and grows by whole chunks when it is full.
+constexpr const uint32_t TILE_ELEMENT_SPARE_ROOM = 512;
+// Room that map_check_free_elements_and_reorganise keeps for the tile runs that inserts copy.
+constexpr const uint32_t TILE_ELEMENT_INSERT_RESERVE = 0x1000;
+constexpr const uint32_t TILE_ELEMENT_CHUNK_SIZE = 0x10000;
+constexpr const uint32_t INITIAL_TILE_ELEMENTS_WITH_SPARE_ROOM = 0x30000;
+constexpr const uint32_t MAX_TILE_ELEMENTS_WITH_SPARE_ROOM = 0x1000000;
+constexpr const uint32_t MAX_TILE_ELEMENTS = MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - TILE_ELEMENT_SPARE_ROOM;
+// Elements at the very end of the spare room, see map_get_scratch_tile_elements.
+constexpr const uint32_t TILE_ELEMENT_SCRATCH_SIZE = 2;
+// Offset of a tile without elements in gTileElementOffsets.
+constexpr const uint32_t TILE_ELEMENT_OFFSET_NULL = UINT32_MAX;
 #define MAX_TILE_TILE_ELEMENT_POINTERS (MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL)
 #define MAX_PEEP_SPAWNS 2
 
@@ -117,8 +129,10 @@ extern uint8_t gMapSelectArrowDirection;
 
 extern uint8_t gMapGroundFlags;
 
-extern TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
-extern TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
+extern std::vector<TileElement> gTileElements;
+// Index into gTileElements of the first element of each tile. The elements of a tile are stored next to each other,
+// up to the one flagged as last for the tile.
+extern uint32_t gTileElementOffsets[MAX_TILE_TILE_ELEMENT_POINTERS];
 
 extern std::vector<CoordsXY> gMapSelectionTiles;
 extern std::vector<PeepSpawn> gPeepSpawns;
@@ -145,13 +159,16 @@ extern const uint8_t tile_element_lower_styles[9][32];
 extern const uint8_t tile_element_raise_styles[9][32];
 
 void map_init(int32_t size);
+void map_allocate_tile_elements(size_t numElements);
 
 void map_count_remaining_land_rights();
 void map_strip_ghost_flag_from_elements();
 void map_update_tile_pointers();
+void map_serialise_state(DataSerialiser& ds);
 TileElement* map_get_first_element_at(const CoordsXY& elementPos);
 TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n);
 void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements);
+TileElement* map_get_scratch_tile_elements();
 int32_t map_height_from_slope(const CoordsXY& coords, int32_t slopeDirection, bool isSloped);
 BannerElement* map_get_banner_element_at(const CoordsXYZ& bannerPos, uint8_t direction);
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords);
@@ -14,6 +14,7 @@
 #include "../OpenRCT2.h"
 #include "../audio/audio.h"
 #include "../core/Crypt.h"
+#include "../core/DataSerialiser.h"
 #include "../core/Guard.hpp"
 #include "../interface/Viewport.h"
 #include "../localisation/Date.h"
@@ -24,12 +25,33 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#    include <xmmintrin.h>
+#endif
 
 uint16_t gSpriteListHead[static_cast<uint8_t>(EntityListId::Count)];
 uint16_t gSpriteListCount[static_cast<uint8_t>(EntityListId::Count)];
-static rct_sprite _spriteList[MAX_SPRITES];
+uint32_t gSpriteListGeneration[static_cast<uint8_t>(EntityListId::Count)];
+static EntityListIndex _entityListIndices[static_cast<uint8_t>(EntityListId::Count)];
 
-static bool _spriteFlashingList[MAX_SPRITES];
+// Sprites are allocated in chunks as the park needs them, so that growing the storage never moves a sprite.
+static constexpr size_t EntityChunkSize = 2000;
+static_assert(RCT2_MAX_SPRITES % EntityChunkSize == 0, "The storage must be able to hold exactly the sprites of a park");
+static_assert(MAX_SPRITES % EntityChunkSize == 0, "MAX_SPRITES must be a whole number of chunks");
+// The spatial index, the sprite lists and the network refer to sprites by 16-bit index, MAX_SPRITES keeps them valid.
+static_assert(MAX_SPRITES < SPRITE_INDEX_NULL, "Sprite indices must fit in 16 bits");
+
+struct EntityChunk
+{
+    rct_sprite Sprites[EntityChunkSize];
+};
+static std::vector<std::unique_ptr<EntityChunk>> _entityChunks;
+static size_t _entityCapacity;
+
+static std::vector<bool> _spriteFlashingList;
 
 uint16_t gSpriteSpatialIndex[SPATIAL_INDEX_SIZE];
 
@@ -46,8 +68,8 @@ const rct_string_id litterNames[12] = { STR_LITTER_VOMIT,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_JUICE_CUP,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_BOWL_BLUE };
 
-static CoordsXYZ _spritelocations1[MAX_SPRITES];
-static CoordsXYZ _spritelocations2[MAX_SPRITES];
+static std::vector<CoordsXYZ> _spritelocations1;
+static std::vector<CoordsXYZ> _spritelocations2;
 
 static size_t GetSpatialIndexOffset(int32_t x, int32_t y);
 static void move_sprite_to_list(SpriteBase* sprite, EntityListId newListIndex);
@@ -83,6 +105,67 @@ uint16_t GetEntityListCount(EntityListId list)
     return gSpriteListCount[static_cast<uint8_t>(list)];
 }
 
+size_t GetEntityCapacity()
+{
+    return _entityCapacity;
+}
+
+size_t GetNumFreeEntities()
+{
+    return GetEntityListCount(EntityListId::Free) + (MAX_SPRITES - _entityCapacity);
+}
+
+static void EntityListChanged(EntityListId list)
+{
+    gSpriteListGeneration[static_cast<uint8_t>(list)]++;
+}
+
+void InvalidateEntityLists()
+{
+    for (auto& generation : gSpriteListGeneration)
+    {
+        generation++;
+    }
+}
+
+const EntityListIndex& GetEntityListIndex(EntityListId list)
+{
+    const auto listIndex = static_cast<uint8_t>(list);
+    auto& index = _entityListIndices[listIndex];
+    if (!index.Built || index.Generation != gSpriteListGeneration[listIndex])
+    {
+        index.SpriteIndices.clear();
+        // Stop at MAX_SPRITES in case the list is corrupted and contains a cycle.
+        for (uint16_t spriteIndex = gSpriteListHead[listIndex];
+             spriteIndex != SPRITE_INDEX_NULL && index.SpriteIndices.size() < MAX_SPRITES;)
+        {
+            auto* sprite = try_get_sprite(spriteIndex);
+            if (sprite == nullptr)
+            {
+                break;
+            }
+            index.SpriteIndices.push_back(spriteIndex);
+            spriteIndex = sprite->next;
+        }
+        index.Generation = gSpriteListGeneration[listIndex];
+        index.Built = true;
+    }
+    return index;
+}
+
+void PrefetchEntity(size_t spriteIndex)
+{
+    auto* sprite = try_get_sprite(spriteIndex);
+    if (sprite != nullptr)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(sprite);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(reinterpret_cast<const char*>(sprite), _MM_HINT_T0);
+#endif
+    }
+}
+
 std::string rct_sprite_checksum::ToString() const
 {
     std::string result;
@@ -100,7 +183,11 @@ std::string rct_sprite_checksum::ToString() const
 
 SpriteBase* try_get_sprite(size_t spriteIndex)
 {
-    return spriteIndex >= MAX_SPRITES ? nullptr : &_spriteList[spriteIndex].generic;
+    if (spriteIndex >= _entityCapacity)
+    {
+        return nullptr;
+    }
+    return &_entityChunks[spriteIndex / EntityChunkSize]->Sprites[spriteIndex % EntityChunkSize].generic;
 }
 
 SpriteBase* get_sprite(size_t spriteIndex)
@@ -160,54 +247,198 @@ void SpriteBase::Invalidate2()
     invalidate_sprite_max_zoom(this, 2);
 }
 
+static void AllocateEntityChunk()
+{
+    _entityChunks.push_back(std::make_unique<EntityChunk>());
+    _entityCapacity += EntityChunkSize;
+    _spriteFlashingList.resize(_entityCapacity, false);
+    _spritelocations1.resize(_entityCapacity);
+    _spritelocations2.resize(_entityCapacity);
+}
+
+/**
+ * Sets up the sprites from firstIndex to the end of the storage as null sprites and links them in index order
+ * in front of the free list.
+ */
+static void LinkFreeEntities(size_t firstIndex)
+{
+    auto& freeHead = gSpriteListHead[static_cast<uint8_t>(EntityListId::Free)];
+    for (size_t i = firstIndex; i < _entityCapacity; i++)
+    {
+        auto* spr = try_get_sprite(i);
+        spr->sprite_identifier = SPRITE_IDENTIFIER_NULL;
+        spr->sprite_index = static_cast<uint16_t>(i);
+        spr->linked_list_index = EntityListId::Free;
+        spr->previous = i == firstIndex ? SPRITE_INDEX_NULL : static_cast<uint16_t>(i - 1);
+        spr->next = i + 1 == _entityCapacity ? freeHead : static_cast<uint16_t>(i + 1);
+    }
+
+    auto* oldHead = GetEntity(freeHead);
+    if (oldHead != nullptr)
+    {
+        oldHead->previous = static_cast<uint16_t>(_entityCapacity - 1);
+    }
+    freeHead = static_cast<uint16_t>(firstIndex);
+    gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] += static_cast<uint16_t>(_entityCapacity - firstIndex);
+    EntityListChanged(EntityListId::Free);
+}
+
+/**
+ * Adds a chunk of free sprites to the storage once the free list has run out.
+ * @returns false if the storage already holds MAX_SPRITES.
+ */
+static bool GrowEntityStorage()
+{
+    if (_entityCapacity >= MAX_SPRITES)
+    {
+        return false;
+    }
+
+    const auto firstIndex = _entityCapacity;
+    AllocateEntityChunk();
+    LinkFreeEntities(firstIndex);
+    return true;
+}
+
+/**
+ * Replaces the storage with uninitialised chunks holding capacity sprites.
+ */
+static void ResizeEntityStorage(size_t capacity)
+{
+    _entityChunks.clear();
+    _entityCapacity = 0;
+    _spriteFlashingList.clear();
+    _spritelocations1.clear();
+    _spritelocations2.clear();
+    while (_entityCapacity < capacity)
+    {
+        AllocateEntityChunk();
+    }
+}
+
 /**
  *
  *  rct2: 0x0069EB13
  */
 void reset_sprite_list()
+{
+    // Release the chunks a previous park grew into, a park starts out with the storage RCT2 had.
+    reset_sprite_list_with_capacity(RCT2_MAX_SPRITES);
+}
+
+/**
+ * Resets the sprites like reset_sprite_list, with storage for at least capacity sprites. Parks that grew beyond the
+ * sprite array of RCT2 are loaded with this.
+ */
+void reset_sprite_list_with_capacity(size_t capacity)
 {
     gSavedAge = 0;
-    std::memset(static_cast<void*>(_spriteList), 0, sizeof(_spriteList));
 
     for (int32_t i = 0; i < static_cast<uint8_t>(EntityListId::Count); i++)
     {
         gSpriteListHead[i] = SPRITE_INDEX_NULL;
         gSpriteListCount[i] = 0;
-        _spriteFlashingList[i] = false;
     }
 
-    SpriteBase* previous_spr = nullptr;
+    ResizeEntityStorage(capacity);
+    LinkFreeEntities(0);
+    InvalidateEntityLists();
+
+    reset_sprite_spatial_index();
+}
 
-    for (int32_t i = 0; i < MAX_SPRITES; ++i)
+/**
+ * Writes or reads all sprites with the lists and spatial index linking them as they are, see GameStateImage.
+ */
+void sprite_serialise_state(DataSerialiser& ds)
+{
+    auto capacity = static_cast<uint32_t>(_entityCapacity);
+    ds << DS_RAW(capacity);
+    if (ds.IsLoading())
     {
-        auto* spr = GetEntity(i);
-        if (spr == nullptr)
+        // The names of the peeps being replaced are owned by them
+        for (auto& chunk : _entityChunks)
         {
-            continue;
+            for (auto& sprite : chunk->Sprites)
+            {
+                if (sprite.generic.Is<Peep>())
+                {
+                    sprite.peep.SetName({});
+                }
+            }
         }
+        if (capacity != _entityCapacity)
+        {
+            ResizeEntityStorage(capacity);
+        }
+    }
 
-        spr->sprite_identifier = SPRITE_IDENTIFIER_NULL;
-        spr->sprite_index = i;
-        spr->next = SPRITE_INDEX_NULL;
-        spr->linked_list_index = EntityListId::Free;
+    // Peep names live outside of the sprites, they are taken out while the chunks are copied and stored after them.
+    std::vector<std::pair<uint16_t, std::string>> names;
+    for (size_t chunkIndex = 0; chunkIndex < _entityChunks.size(); chunkIndex++)
+    {
+        auto& chunk = *_entityChunks[chunkIndex];
+        std::vector<std::pair<Peep*, char*>> detachedNames;
+        if (ds.IsSaving())
+        {
+            for (size_t i = 0; i < EntityChunkSize; i++)
+            {
+                auto& sprite = chunk.Sprites[i];
+                if (sprite.generic.Is<Peep>() && sprite.peep.Name != nullptr)
+                {
+                    names.emplace_back(static_cast<uint16_t>(chunkIndex * EntityChunkSize + i), sprite.peep.Name);
+                    detachedNames.emplace_back(&sprite.peep, sprite.peep.Name);
+                    sprite.peep.Name = nullptr;
+                }
+            }
+        }
+
+        ds << DS_RAW(chunk);
 
-        if (previous_spr != nullptr)
+        for (auto& [peep, name] : detachedNames)
         {
-            spr->previous = previous_spr->sprite_index;
-            previous_spr->next = i;
+            peep->Name = name;
         }
-        else
+        if (ds.IsLoading())
         {
-            spr->previous = SPRITE_INDEX_NULL;
-            gSpriteListHead[static_cast<uint8_t>(EntityListId::Free)] = i;
+            for (auto& sprite : chunk.Sprites)
+            {
+                if (sprite.generic.Is<Peep>())
+                {
+                    sprite.peep.Name = nullptr;
+                }
+            }
         }
-        _spriteFlashingList[i] = false;
-        previous_spr = spr;
     }
 
-    gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] = MAX_SPRITES;
+    ds << DS_RAW(gSpriteListHead);
+    ds << DS_RAW(gSpriteListCount);
+    ds << DS_RAW(gSpriteSpatialIndex);
 
-    reset_sprite_spatial_index();
+    auto numNames = static_cast<uint32_t>(names.size());
+    ds << DS_RAW(numNames);
+    if (ds.IsLoading())
+    {
+        names.resize(numNames);
+    }
+    for (auto& [index, name] : names)
+    {
+        ds << DS_RAW(index);
+        ds << name;
+        if (ds.IsLoading())
+        {
+            auto* peep = TryGetEntity<Peep>(index);
+            if (peep != nullptr)
+            {
+                peep->SetName(name);
+            }
+        }
+    }
+
+    if (ds.IsLoading())
+    {
+        InvalidateEntityLists();
+    }
 }
 
 /**
@@ -219,7 +450,7 @@ void reset_sprite_list()
 void reset_sprite_spatial_index()
 {
     std::fill_n(gSpriteSpatialIndex, std::size(gSpriteSpatialIndex), SPRITE_INDEX_NULL);
-    for (size_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _entityCapacity; i++)
     {
         auto* spr = GetEntity(i);
         if (spr != nullptr && spr->sprite_identifier != SPRITE_IDENTIFIER_NULL)
@@ -252,6 +483,37 @@ static size_t GetSpatialIndexOffset(int32_t x, int32_t y)
     return index;
 }
 
+rct_sprite sprite_get_state_copy(const SpriteBase* sprite)
+{
+    // Upconvert it to rct_sprite so that the full size is copied.
+    auto copy = *reinterpret_cast<const rct_sprite*>(sprite);
+
+    // Only required for rendering/invalidation, has no meaning to the game state.
+    copy.generic.sprite_left = copy.generic.sprite_right = copy.generic.sprite_top = copy.generic.sprite_bottom = 0;
+    copy.generic.sprite_width = copy.generic.sprite_height_negative = copy.generic.sprite_height_positive = 0;
+
+    // Next in quadrant might be a misc sprite, set first non-misc sprite in quadrant.
+    while (auto* nextSprite = GetEntity(copy.generic.next_in_quadrant))
+    {
+        if (nextSprite->sprite_identifier == SPRITE_IDENTIFIER_MISC)
+            copy.generic.next_in_quadrant = nextSprite->next_in_quadrant;
+        else
+            break;
+    }
+
+    if (copy.generic.Is<Peep>())
+    {
+        // Name is pointer and will not be the same across clients
+        copy.peep.Name = {};
+
+        // We set this to 0 because as soon the client selects a guest the window will remove the
+        // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
+        // game state.
+        copy.peep.WindowInvalidateFlags = 0;
+    }
+    return copy;
+}
+
 #ifndef DISABLE_NETWORK
 
 rct_sprite_checksum sprite_checksum()
@@ -272,40 +534,14 @@ rct_sprite_checksum sprite_checksum()
         }
 
         _spriteHashAlg->Clear();
-        for (size_t i = 0; i < MAX_SPRITES; i++)
+        for (size_t i = 0; i < _entityCapacity; i++)
         {
             // TODO create a way to copy only the specific type
             auto sprite = GetEntity(i);
             if (sprite != nullptr && sprite->sprite_identifier != SPRITE_IDENTIFIER_NULL
                 && sprite->sprite_identifier != SPRITE_IDENTIFIER_MISC)
             {
-                // Upconvert it to rct_sprite so that the full size is copied.
-                auto copy = *reinterpret_cast<rct_sprite*>(sprite);
-
-                // Only required for rendering/invalidation, has no meaning to the game state.
-                copy.generic.sprite_left = copy.generic.sprite_right = copy.generic.sprite_top = copy.generic.sprite_bottom = 0;
-                copy.generic.sprite_width = copy.generic.sprite_height_negative = copy.generic.sprite_height_positive = 0;
-
-                // Next in quadrant might be a misc sprite, set first non-misc sprite in quadrant.
-                while (auto* nextSprite = GetEntity(copy.generic.next_in_quadrant))
-                {
-                    if (nextSprite->sprite_identifier == SPRITE_IDENTIFIER_MISC)
-                        copy.generic.next_in_quadrant = nextSprite->next_in_quadrant;
-                    else
-                        break;
-                }
-
-                if (copy.generic.Is<Peep>())
-                {
-                    // Name is pointer and will not be the same across clients
-                    copy.peep.Name = {};
-
-                    // We set this to 0 because as soon the client selects a guest the window will remove the
-                    // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
-                    // game state.
-                    copy.peep.WindowInvalidateFlags = 0;
-                }
-
+                auto copy = sprite_get_state_copy(sprite);
                 _spriteHashAlg->Update(&copy, sizeof(copy));
             }
         }
@@ -377,24 +613,24 @@ static constexpr uint16_t MAX_MISC_SPRITES = 300;
 
 rct_sprite* create_sprite(SPRITE_IDENTIFIER spriteIdentifier, EntityListId linkedListIndex)
 {
-    if (GetEntityListCount(EntityListId::Free) == 0)
-    {
-        // No free sprites.
-        return nullptr;
-    }
-
     if (linkedListIndex == EntityListId::Misc)
     {
         // Misc sprites are commonly used for effects, if there are less than MAX_MISC_SPRITES
         // free it will fail to keep slots for more relevant sprites.
         // Also there can't be more than MAX_MISC_SPRITES sprites in this list.
         uint16_t miscSlotsRemaining = MAX_MISC_SPRITES - GetEntityListCount(EntityListId::Misc);
-        if (miscSlotsRemaining >= GetEntityListCount(EntityListId::Free))
+        if (miscSlotsRemaining >= GetNumFreeEntities())
         {
             return nullptr;
         }
     }
 
+    if (GetEntityListCount(EntityListId::Free) == 0 && !GrowEntityStorage())
+    {
+        // No free sprites.
+        return nullptr;
+    }
+
     auto* sprite = GetEntity(gSpriteListHead[static_cast<uint8_t>(EntityListId::Free)]);
     if (sprite == nullptr)
     {
@@ -519,6 +755,8 @@ static void move_sprite_to_list(SpriteBase* sprite, EntityListId newListIndex)
     // Decrement old list counter, increment new list counter.
     gSpriteListCount[static_cast<uint8_t>(oldListIndex)]--;
     gSpriteListCount[static_cast<uint8_t>(newListIndex)]++;
+    EntityListChanged(oldListIndex);
+    EntityListChanged(newListIndex);
 }
 
 /**
@@ -877,7 +1115,7 @@ void litter_remove_at(const CoordsXYZ& litterPos)
 uint16_t remove_floating_sprites()
 {
     uint16_t removed = 0;
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _entityCapacity; i++)
     {
         auto* entity = GetEntity(i);
         if (entity->Is<Balloon>())
@@ -917,16 +1155,16 @@ static bool sprite_should_tween(SpriteBase* sprite)
     return false;
 }
 
-static void store_sprite_locations(CoordsXYZ* sprite_locations)
+static void store_sprite_locations(std::vector<CoordsXYZ>& sprite_locations)
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _entityCapacity; i++)
     {
         // skip going through `get_sprite` to not get stalled on assert,
         // this can get very expensive for busy parks with uncap FPS option on
-        const rct_sprite* sprite = &_spriteList[i];
-        sprite_locations[i].x = sprite->generic.x;
-        sprite_locations[i].y = sprite->generic.y;
-        sprite_locations[i].z = sprite->generic.z;
+        const auto* sprite = try_get_sprite(i);
+        sprite_locations[i].x = sprite->x;
+        sprite_locations[i].y = sprite->y;
+        sprite_locations[i].z = sprite->z;
     }
 }
 
@@ -944,7 +1182,7 @@ void sprite_position_tween_all(float alpha)
 {
     const float inv = (1.0f - alpha);
 
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _entityCapacity; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite != nullptr && sprite_should_tween(sprite))
@@ -970,7 +1208,7 @@ void sprite_position_tween_all(float alpha)
  */
 void sprite_position_tween_restore()
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _entityCapacity; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite != nullptr && sprite_should_tween(sprite))
@@ -985,7 +1223,7 @@ void sprite_position_tween_restore()
 
 void sprite_position_tween_reset()
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _entityCapacity; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite == nullptr)
@@ -1001,13 +1239,13 @@ void sprite_position_tween_reset()
 
 void sprite_set_flashing(SpriteBase* sprite, bool flashing)
 {
-    assert(sprite->sprite_index < MAX_SPRITES);
+    assert(sprite->sprite_index < _entityCapacity);
     _spriteFlashingList[sprite->sprite_index] = flashing;
 }
 
 bool sprite_get_flashing(SpriteBase* sprite)
 {
-    assert(sprite->sprite_index < MAX_SPRITES);
+    assert(sprite->sprite_index < _entityCapacity);
     return _spriteFlashingList[sprite->sprite_index];
 }
 
@@ -1083,6 +1321,7 @@ int32_t check_for_sprite_list_cycles(bool fix)
 
                 // Break the cycle
                 cycle_start->next = SPRITE_INDEX_NULL;
+                EntityListChanged(static_cast<EntityListId>(i));
 
                 // Now re-add remainder of the cycle back to list, safely.
                 // Add each sprite to the list until we encounter one that is already part of the list.
@@ -1099,6 +1338,7 @@ int32_t check_for_sprite_list_cycles(bool fix)
                     cycle_next = spr->next;
                     spr->next = SPRITE_INDEX_NULL;
                     cycle_start = spr;
+                    EntityListChanged(static_cast<EntityListId>(i));
                 }
             }
             return i;
@@ -1115,12 +1355,11 @@ int32_t check_for_sprite_list_cycles(bool fix)
 int32_t fix_disjoint_sprites()
 {
     // Find reachable sprites
-    bool reachable[MAX_SPRITES] = { false };
+    std::vector<bool> reachable(_entityCapacity, false);
 
     SpriteBase* null_list_tail = nullptr;
     for (uint16_t sprite_idx = gSpriteListHead[static_cast<uint8_t>(EntityListId::Free)]; sprite_idx != SPRITE_INDEX_NULL;)
     {
-        reachable[sprite_idx] = true;
         // cache the tail, so we don't have to walk the list twice
         null_list_tail = GetEntity(sprite_idx);
         if (null_list_tail == nullptr)
@@ -1129,13 +1368,14 @@ int32_t fix_disjoint_sprites()
             sprite_idx = SPRITE_INDEX_NULL;
             return 0;
         }
+        reachable[sprite_idx] = true;
         sprite_idx = null_list_tail->next;
     }
 
     int32_t count = 0;
 
     // Find all null sprites
-    for (uint16_t sprite_idx = 0; sprite_idx < MAX_SPRITES; sprite_idx++)
+    for (uint16_t sprite_idx = 0; sprite_idx < _entityCapacity; sprite_idx++)
     {
         auto* spr = GetEntity(sprite_idx);
         if (spr != nullptr && spr->sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -1162,5 +1402,9 @@ int32_t fix_disjoint_sprites()
             }
         }
     }
+    if (count > 0)
+    {
+        EntityListChanged(EntityListId::Free);
+    }
     return count;
 }
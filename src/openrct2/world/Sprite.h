@@ -16,8 +16,13 @@
 #include "Fountain.h"
 #include "SpriteBase.h"
 
+#include <vector>
+
+class DataSerialiser;
+
 #define SPRITE_INDEX_NULL 0xFFFF
-#define MAX_SPRITES 10000
+// Sprite indices are 16 bit, the storage grows in chunks up to this many as the park needs them.
+#define MAX_SPRITES 64000
 
 enum SPRITE_IDENTIFIER
 {
@@ -216,8 +221,43 @@ template<typename T = SpriteBase> T* TryGetEntity(size_t sprite_idx)
 }
 
 uint16_t GetEntityListCount(EntityListId list);
+
+/**
+ * Number of sprites the storage currently holds, sprite indices are always below it.
+ */
+size_t GetEntityCapacity();
+
+/**
+ * Number of sprites that can still be created, including those the storage has not allocated yet.
+ */
+size_t GetNumFreeEntities();
 extern uint16_t gSpriteListHead[static_cast<uint8_t>(EntityListId::Count)];
 extern uint16_t gSpriteListCount[static_cast<uint8_t>(EntityListId::Count)];
+// Incremented every time the links of a sprite list change.
+extern uint32_t gSpriteListGeneration[static_cast<uint8_t>(EntityListId::Count)];
+
+/**
+ * Dense copy of a sprite list: the indices of its sprites in list order, so that iterating the list
+ * does not have to read each sprite to find the next one. The sprites themselves stay in the rct_sprite
+ * layout, one 0x200 byte record each; this is not a per-type store and does not split hot and cold fields.
+ */
+struct EntityListIndex
+{
+    std::vector<uint16_t> SpriteIndices;
+    uint32_t Generation{};
+    bool Built{};
+};
+
+/**
+ * Returns the dense copy of the list, rebuilding it if the list changed since it was last built.
+ */
+const EntityListIndex& GetEntityListIndex(EntityListId list);
+
+/**
+ * Marks every sprite list as changed, required after the links are written directly (e.g. when importing a park).
+ */
+void InvalidateEntityLists();
+void PrefetchEntity(size_t spriteIndex);
 
 constexpr const uint32_t SPATIAL_INDEX_SIZE = (MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL) + 1;
 constexpr const uint32_t SPATIAL_INDEX_LOCATION_NULL = SPATIAL_INDEX_SIZE - 1;
@@ -228,7 +268,9 @@ extern const rct_string_id litterNames[12];
 rct_sprite* create_sprite(SPRITE_IDENTIFIER spriteIdentifier);
 rct_sprite* create_sprite(SPRITE_IDENTIFIER spriteIdentifier, EntityListId linkedListIndex);
 void reset_sprite_list();
+void reset_sprite_list_with_capacity(size_t capacity);
 void reset_sprite_spatial_index();
+void sprite_serialise_state(DataSerialiser& ds);
 void sprite_clear_all_unused();
 void sprite_misc_update_all();
 void sprite_set_coordinates(const CoordsXYZ& spritePos, SpriteBase* sprite);
@@ -268,6 +310,10 @@ void crash_splash_create(const CoordsXYZ& splashPos);
 void crash_splash_update(CrashSplashParticle* splash);
 
 rct_sprite_checksum sprite_checksum();
+/**
+ * Copies the sprite with the fields that differ between clients without being part of the game state cleared.
+ */
+rct_sprite sprite_get_state_copy(const SpriteBase* sprite);
 
 void sprite_set_flashing(SpriteBase* sprite, bool flashing);
 bool sprite_get_flashing(SpriteBase* sprite);
@@ -352,25 +398,117 @@ public:
     }
 };
 
+/**
+ * Walks a sprite list through its EntityListIndex, prefetching the sprites ahead. Visits the same sprites in the same
+ * order as following SpriteBase::next: as soon as the list changes during the iteration, which happens when the loop
+ * creates or removes sprites, it carries on from the links of the last sprite visited.
+ */
+template<typename T> class EntityListIterator
+{
+private:
+    static constexpr size_t PrefetchDistance = 4;
+
+    T* Entity = nullptr;
+    uint16_t NextEntityId = SPRITE_INDEX_NULL;
+    uint8_t ListId = 0;
+    uint32_t Generation = 0;
+    const EntityListIndex* Index = nullptr;
+    size_t NextPosition = 0;
+
+public:
+    EntityListIterator() = default;
+    EntityListIterator(EntityListId list, const EntityListIndex& index)
+        : ListId(static_cast<uint8_t>(list))
+        , Generation(index.Generation)
+        , Index(&index)
+    {
+        for (size_t i = 0; i < PrefetchDistance && i < index.SpriteIndices.size(); i++)
+        {
+            PrefetchEntity(index.SpriteIndices[i]);
+        }
+        if (!index.SpriteIndices.empty())
+        {
+            NextEntityId = index.SpriteIndices[0];
+            NextPosition = 1;
+        }
+        ++(*this);
+    }
+    EntityListIterator& operator++()
+    {
+        Entity = nullptr;
+
+        while (NextEntityId != SPRITE_INDEX_NULL && Entity == nullptr)
+        {
+            auto baseEntity = GetEntity(NextEntityId);
+            if (!baseEntity)
+            {
+                NextEntityId = SPRITE_INDEX_NULL;
+                continue;
+            }
+            if (Index != nullptr && gSpriteListGeneration[ListId] == Generation)
+            {
+                const auto& indices = Index->SpriteIndices;
+                if (NextPosition + PrefetchDistance < indices.size())
+                {
+                    PrefetchEntity(indices[NextPosition + PrefetchDistance]);
+                }
+                NextEntityId = NextPosition < indices.size() ? indices[NextPosition] : SPRITE_INDEX_NULL;
+                NextPosition++;
+            }
+            else
+            {
+                Index = nullptr;
+                NextEntityId = baseEntity->next;
+            }
+            Entity = baseEntity->template As<T>();
+        }
+        return *this;
+    }
+
+    EntityListIterator operator++(int)
+    {
+        EntityListIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(const EntityListIterator& other) const
+    {
+        return Entity == other.Entity;
+    }
+    bool operator!=(const EntityListIterator& other) const
+    {
+        return !(*this == other);
+    }
+    T* operator*()
+    {
+        return Entity;
+    }
+    // iterator traits
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = const T*;
+    using reference = const T&;
+    using iterator_category = std::forward_iterator_tag;
+};
+
 template<typename T = SpriteBase> class EntityList
 {
 private:
-    uint16_t FirstEntity = SPRITE_INDEX_NULL;
-    using EntityListIterator = EntityIterator<T, &SpriteBase::next>;
+    EntityListId ListId;
 
 public:
     EntityList(EntityListId type)
-        : FirstEntity(gSpriteListHead[static_cast<uint8_t>(type)])
+        : ListId(type)
     {
     }
 
-    EntityListIterator begin()
+    EntityListIterator<T> begin()
     {
-        return EntityListIterator(FirstEntity);
+        return EntityListIterator<T>(ListId, GetEntityListIndex(ListId));
     }
-    EntityListIterator end()
+    EntityListIterator<T> end()
     {
-        return EntityListIterator(SPRITE_INDEX_NULL);
+        return EntityListIterator<T>();
     }
 };
 
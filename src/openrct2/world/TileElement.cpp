@@ -16,8 +16,102 @@
 #include "Banner.h"
 #include "LargeScenery.h"
 #include "Location.hpp"
+#include "Map.h"
 #include "Scenery.h"
 
+#include <array>
+
+uint32_t gTileElementsRevision;
+
+namespace
+{
+    struct TileElementsChange
+    {
+        uint32_t Revision;
+        // The changed element, or nullptr if the change is recorded by tile.
+        const TileElementBase* Element;
+        TileCoordsXY Tile;
+    };
+} // namespace
+
+// Working out the tile of an element scans the map, so only the last few changes are worth replaying.
+static constexpr size_t MaxTrackedTileElementsChanges = 64;
+static std::array<TileElementsChange, MaxTrackedTileElementsChanges> _tileElementsChanges;
+
+void tile_element_changed(const TileElementBase* element)
+{
+    gTileElementsRevision++;
+    _tileElementsChanges[gTileElementsRevision % MaxTrackedTileElementsChanges] = { gTileElementsRevision, element, {} };
+}
+
+void tile_elements_changed_at(const CoordsXY& loc)
+{
+    gTileElementsRevision++;
+    _tileElementsChanges[gTileElementsRevision % MaxTrackedTileElementsChanges] = { gTileElementsRevision, nullptr,
+                                                                                    TileCoordsXY{ loc } };
+}
+
+static std::optional<TileCoordsXY> tile_element_get_tile(const TileElementBase* element)
+{
+    if (gTileElements.empty())
+        return std::nullopt;
+
+    const auto* tileElement = reinterpret_cast<const TileElement*>(element);
+    const auto* firstElement = gTileElements.data();
+    if (tileElement < firstElement || tileElement >= firstElement + gTileElements.size())
+        return std::nullopt;
+
+    // A tile's elements are stored together and end with the one flagged last for the tile.
+    while (tileElement != firstElement && !(tileElement - 1)->IsLastForTile())
+    {
+        tileElement--;
+    }
+
+    const auto offset = static_cast<uint32_t>(tileElement - firstElement);
+    for (size_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+    {
+        if (gTileElementOffsets[i] == offset)
+        {
+            return TileCoordsXY(
+                static_cast<int32_t>(i % MAXIMUM_MAP_SIZE_TECHNICAL), static_cast<int32_t>(i / MAXIMUM_MAP_SIZE_TECHNICAL));
+        }
+    }
+    // The element is not on the map, e.g. it was removed since.
+    return std::nullopt;
+}
+
+bool tile_elements_get_changed_tiles(uint32_t revision, std::vector<TileCoordsXY>& tiles)
+{
+    if (gTileElementsRevision - revision > MaxTrackedTileElementsChanges)
+        return false;
+
+    const TileElementBase* lastElement = nullptr;
+    const uint32_t numChanges = gTileElementsRevision - revision;
+    for (uint32_t i = 1; i <= numChanges; i++)
+    {
+        const uint32_t changeRevision = revision + i;
+        const auto& change = _tileElementsChanges[changeRevision % MaxTrackedTileElementsChanges];
+        // Changes to the whole map increment the revision without recording a change.
+        if (change.Revision != changeRevision)
+            return false;
+
+        if (change.Element == nullptr)
+        {
+            tiles.push_back(change.Tile);
+        }
+        else if (change.Element != lastElement)
+        {
+            auto tile = tile_element_get_tile(change.Element);
+            if (!tile.has_value())
+                return false;
+
+            tiles.push_back(*tile);
+            lastElement = change.Element;
+        }
+    }
+    return true;
+}
+
 uint8_t TileElementBase::GetType() const
 {
     return this->type & TILE_ELEMENT_TYPE_MASK;
@@ -25,8 +119,11 @@ uint8_t TileElementBase::GetType() const
 
 void TileElementBase::SetType(uint8_t newType)
 {
+    const auto oldType = this->type;
     this->type &= ~TILE_ELEMENT_TYPE_MASK;
     this->type |= (newType & TILE_ELEMENT_TYPE_MASK);
+    if (this->type != oldType)
+        tile_element_changed(this);
 }
 
 Direction TileElementBase::GetDirection() const
@@ -65,6 +162,9 @@ bool TileElementBase::IsGhost() const
 
 void TileElementBase::SetGhost(bool isGhost)
 {
+    if (isGhost != IsGhost())
+        tile_element_changed(this);
+
     if (isGhost)
     {
         this->Flags |= TILE_ELEMENT_FLAG_GHOST;
@@ -158,6 +258,7 @@ uint8_t tile_element_get_ride_index(const TileElement* tileElement)
 
 void TileElement::ClearAs(uint8_t newType)
 {
+    tile_element_changed(this);
     type = newType;
     Flags = 0;
     base_height = MINIMUM_LAND_HEIGHT;
@@ -232,7 +333,10 @@ int32_t TileElementBase::GetBaseZ() const
 
 void TileElementBase::SetBaseZ(int32_t newZ)
 {
+    const auto oldHeight = base_height;
     base_height = (newZ / COORDS_Z_STEP);
+    if (base_height != oldHeight)
+        tile_element_changed(this);
 }
 
 int32_t TileElementBase::GetClearanceZ() const
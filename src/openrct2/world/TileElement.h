@@ -14,6 +14,9 @@
 #include "../ride/Station.h"
 #include "Banner.h"
 #include "Footpath.h"
+#include "Location.hpp"
+
+#include <vector>
 
 struct Banner;
 struct CoordsXY;
@@ -25,6 +28,32 @@ using track_type_t = uint16_t;
 
 constexpr const uint8_t MAX_ELEMENT_HEIGHT = 255;
 
+/**
+ * Incremented whenever elements are added to or removed from the map, or change their type, height, ghost flag or
+ * path layout, which includes the edges banners allow paths through. Data derived from the map, such as the path
+ * corridors used by peep pathfinding, compares it to find out that it is out of date.
+ */
+extern uint32_t gTileElementsRevision;
+
+struct TileElementBase;
+
+/**
+ * Increments gTileElementsRevision for a change to the given element of the map, and records the change so that
+ * tile_elements_get_changed_tiles can tell which tile it was on.
+ */
+void tile_element_changed(const TileElementBase* element);
+
+/**
+ * As above for changes to the elements of a tile, including adding and removing them.
+ */
+void tile_elements_changed_at(const CoordsXY& loc);
+
+/**
+ * Adds the tiles changed since the given revision to tiles. Returns false if they are no longer known one by one, after
+ * too many changes or a change to the whole map; everything must then be treated as changed.
+ */
+bool tile_elements_get_changed_tiles(uint32_t revision, std::vector<TileCoordsXY>& tiles);
+
 #pragma pack(push, 1)
 
 enum
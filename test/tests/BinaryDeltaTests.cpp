@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/core/BinaryDelta.h>
+#include <random>
+#include <vector>
+
+static std::vector<uint8_t> CreateRandomData(size_t length, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(length);
+    for (auto& b : data)
+    {
+        b = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+static std::vector<uint8_t> RoundTrip(const std::vector<uint8_t>& base, const std::vector<uint8_t>& target, size_t* deltaLength)
+{
+    auto delta = BinaryDelta::Create(base.data(), base.size(), target.data(), target.size());
+    *deltaLength = delta.size();
+    auto result = BinaryDelta::Apply(base.data(), base.size(), delta.data(), delta.size(), target.size());
+    EXPECT_TRUE(result.has_value());
+    return result.value_or(std::vector<uint8_t>());
+}
+
+TEST(BinaryDeltaTest, identical)
+{
+    auto base = CreateRandomData(100000, 1);
+    size_t deltaLength;
+    ASSERT_EQ(RoundTrip(base, base, &deltaLength), base);
+    ASSERT_LT(deltaLength, 32U);
+}
+
+TEST(BinaryDeltaTest, scattered_changes)
+{
+    auto base = CreateRandomData(100000, 2);
+    auto target = base;
+    for (size_t i = 0; i < target.size(); i += 10000)
+    {
+        target[i] ^= 0xFF;
+    }
+    size_t deltaLength;
+    ASSERT_EQ(RoundTrip(base, target, &deltaLength), target);
+    ASSERT_LT(deltaLength, 1000U);
+}
+
+TEST(BinaryDeltaTest, moved_ranges)
+{
+    auto base = CreateRandomData(100000, 3);
+
+    // Insert a few bytes near the start and drop a range near the end, everything in between moves
+    auto target = base;
+    target.insert(target.begin() + 123, { 1, 2, 3, 4, 5 });
+    target.erase(target.begin() + 80000, target.begin() + 81000);
+    size_t deltaLength;
+    ASSERT_EQ(RoundTrip(base, target, &deltaLength), target);
+    ASSERT_LT(deltaLength, 100U);
+}
+
+TEST(BinaryDeltaTest, unrelated)
+{
+    auto base = CreateRandomData(5000, 4);
+    auto target = CreateRandomData(7000, 5);
+    size_t deltaLength;
+    ASSERT_EQ(RoundTrip(base, target, &deltaLength), target);
+
+    auto empty = std::vector<uint8_t>();
+    ASSERT_EQ(RoundTrip(empty, target, &deltaLength), target);
+    ASSERT_EQ(RoundTrip(target, empty, &deltaLength), empty);
+}
+
+TEST(BinaryDeltaTest, rejects_malformed)
+{
+    auto base = CreateRandomData(1000, 6);
+    auto target = base;
+    target[500] ^= 0xFF;
+    auto delta = BinaryDelta::Create(base.data(), base.size(), target.data(), target.size());
+
+    // Truncated
+    ASSERT_FALSE(BinaryDelta::Apply(base.data(), base.size(), delta.data(), delta.size() - 1, target.size()).has_value());
+
+    // Applied to a shorter base, the copies reach past its end
+    ASSERT_FALSE(BinaryDelta::Apply(base.data(), 100, delta.data(), delta.size(), target.size()).has_value());
+
+    // Longer than the caller allows
+    ASSERT_FALSE(BinaryDelta::Apply(base.data(), base.size(), delta.data(), delta.size(), target.size() - 1).has_value());
+
+    // Unknown operation
+    delta.push_back(0xFF);
+    ASSERT_FALSE(BinaryDelta::Apply(base.data(), base.size(), delta.data(), delta.size(), target.size()).has_value());
+}
@@ -0,0 +1,281 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/GameStateHash.h>
+#include <openrct2/GameStateSnapshots.h>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/rct2/RCT2.h>
+#include <openrct2/world/Sprite.h>
+#include <set>
+#include <vector>
+
+// Follows SpriteBase::next directly, the way sprite lists were iterated before EntityListIndex.
+class LinkedLitterList
+{
+public:
+    using Iterator = EntityIterator<Litter, &SpriteBase::next>;
+
+    Iterator begin()
+    {
+        return Iterator(gSpriteListHead[static_cast<uint8_t>(EntityListId::Litter)]);
+    }
+    Iterator end()
+    {
+        return Iterator(SPRITE_INDEX_NULL);
+    }
+};
+
+static Litter* CreateLitter()
+{
+    auto* litter = reinterpret_cast<Litter*>(create_sprite(SPRITE_IDENTIFIER_LITTER));
+    litter->sprite_identifier = SPRITE_IDENTIFIER_LITTER;
+    return litter;
+}
+
+/**
+ * Iterates the litter list, creating and removing litter on the way like the update loops do.
+ * @returns the indices of the sprites visited.
+ */
+template<typename TList> static std::vector<uint16_t> VisitLitter(TList&& list)
+{
+    reset_sprite_list();
+    for (int32_t i = 0; i < 64; i++)
+    {
+        CreateLitter();
+    }
+
+    std::vector<uint16_t> visited;
+    for (auto litter : list)
+    {
+        visited.push_back(litter->sprite_index);
+        if (visited.size() % 5 == 0)
+        {
+            sprite_remove(litter);
+        }
+        else if (visited.size() % 7 == 0)
+        {
+            auto next = GetEntity<Litter>(litter->next);
+            if (next != nullptr)
+            {
+                sprite_remove(next);
+            }
+        }
+        else if (visited.size() % 11 == 0)
+        {
+            CreateLitter();
+        }
+    }
+    return visited;
+}
+
+TEST(EntityListTest, VisitsSpritesInListOrder)
+{
+    reset_sprite_list();
+    for (int32_t i = 0; i < 100; i++)
+    {
+        CreateLitter();
+    }
+
+    std::vector<uint16_t> linked;
+    for (auto litter : LinkedLitterList())
+    {
+        linked.push_back(litter->sprite_index);
+    }
+    std::vector<uint16_t> indexed;
+    for (auto litter : EntityList<Litter>(EntityListId::Litter))
+    {
+        indexed.push_back(litter->sprite_index);
+    }
+    ASSERT_EQ(linked.size(), 100u);
+    ASSERT_EQ(linked, indexed);
+}
+
+TEST(EntityListTest, ListChangedDuringIteration)
+{
+    auto linked = VisitLitter(LinkedLitterList());
+    auto indexed = VisitLitter(EntityList<Litter>(EntityListId::Litter));
+    ASSERT_FALSE(linked.empty());
+    ASSERT_EQ(linked, indexed);
+}
+
+TEST(EntityListTest, IndexFollowsRemovals)
+{
+    reset_sprite_list();
+    std::vector<Litter*> created;
+    for (int32_t i = 0; i < 10; i++)
+    {
+        created.push_back(CreateLitter());
+    }
+    ASSERT_EQ(GetEntityListIndex(EntityListId::Litter).SpriteIndices.size(), 10u);
+
+    sprite_remove(created[3]);
+    sprite_remove(created[7]);
+    const auto& index = GetEntityListIndex(EntityListId::Litter);
+    ASSERT_EQ(index.SpriteIndices.size(), 8u);
+    ASSERT_EQ(index.SpriteIndices.size(), GetEntityListCount(EntityListId::Litter));
+    for (auto spriteIndex : index.SpriteIndices)
+    {
+        ASSERT_NE(spriteIndex, created[3]->sprite_index);
+        ASSERT_NE(spriteIndex, created[7]->sprite_index);
+    }
+}
+
+TEST(EntityListTest, StorageGrowsWithoutMovingSprites)
+{
+    reset_sprite_list();
+    ASSERT_EQ(GetEntityCapacity(), RCT2_MAX_SPRITES);
+    ASSERT_EQ(GetNumFreeEntities(), static_cast<size_t>(MAX_SPRITES));
+
+    std::vector<Litter*> created;
+    std::set<uint16_t> indices;
+    for (size_t i = 0; i < RCT2_MAX_SPRITES + 10; i++)
+    {
+        auto* litter = CreateLitter();
+        ASSERT_NE(litter, nullptr);
+        created.push_back(litter);
+        indices.insert(litter->sprite_index);
+    }
+    ASSERT_GT(GetEntityCapacity(), RCT2_MAX_SPRITES);
+    ASSERT_EQ(indices.size(), created.size());
+    ASSERT_EQ(GetEntityListCount(EntityListId::Litter), created.size());
+    ASSERT_EQ(GetNumFreeEntities(), MAX_SPRITES - created.size());
+    for (auto* litter : created)
+    {
+        ASSERT_EQ(GetEntity<Litter>(litter->sprite_index), litter);
+    }
+
+    while (GetNumFreeEntities() > 0)
+    {
+        ASSERT_NE(CreateLitter(), nullptr);
+    }
+    ASSERT_EQ(GetEntityCapacity(), static_cast<size_t>(MAX_SPRITES));
+    ASSERT_EQ(create_sprite(SPRITE_IDENTIFIER_LITTER), nullptr);
+
+    reset_sprite_list();
+    ASSERT_EQ(GetEntityCapacity(), RCT2_MAX_SPRITES);
+}
+
+TEST(EntityListTest, StateHashFollowsEntities)
+{
+    reset_sprite_list();
+    auto* litter = CreateLitter();
+    CreateLitter();
+    const auto initialHash = game_state_hash_entities();
+
+    litter->x += COORDS_XY_STEP;
+    EXPECT_NE(game_state_hash_entities(), initialHash);
+    litter->x -= COORDS_XY_STEP;
+    EXPECT_EQ(game_state_hash_entities(), initialHash);
+
+    sprite_remove(litter);
+    EXPECT_NE(game_state_hash_entities(), initialHash);
+}
+
+static std::vector<GameStateSpriteChange_t> GetSpriteChanges(const GameStateCompareData_t& cmpData)
+{
+    std::vector<GameStateSpriteChange_t> changes;
+    for (const auto& change : cmpData.spriteChanges)
+    {
+        if (change.changeType != GameStateSpriteChange_t::EQUAL)
+        {
+            changes.push_back(change);
+        }
+    }
+    return changes;
+}
+
+TEST(EntityListTest, DeltaSnapshotsCompareLikeStoredSnapshots)
+{
+    reset_sprite_list();
+    auto snapshots = CreateGameStateSnapshots();
+    auto* moved = CreateLitter();
+    auto* removed = CreateLitter();
+    CreateLitter();
+    auto& before = snapshots->CreateSnapshot();
+    snapshots->Capture(before);
+
+    moved->x += COORDS_XY_STEP;
+    sprite_remove(removed);
+    auto* added = CreateLitter();
+    auto& after = snapshots->CreateSnapshot();
+    snapshots->Capture(after);
+
+    // Round trip both snapshots through the serialised form, which is compared in full.
+    auto roundTrip = [&snapshots](GameStateSnapshot_t& snapshot) -> GameStateSnapshot_t& {
+        OpenRCT2::MemoryStream stream;
+        DataSerialiser saver(true, stream);
+        snapshots->SerialiseSnapshot(snapshot, saver);
+        stream.SetPosition(0);
+        auto& loaded = snapshots->CreateSnapshot();
+        DataSerialiser loader(false, stream);
+        snapshots->SerialiseSnapshot(loaded, loader);
+        return loaded;
+    };
+    auto& storedBefore = roundTrip(before);
+    auto& storedAfter = roundTrip(after);
+
+    auto deltaChanges = GetSpriteChanges(snapshots->Compare(before, after));
+    auto storedChanges = GetSpriteChanges(snapshots->Compare(storedBefore, storedAfter));
+    ASSERT_EQ(deltaChanges.size(), storedChanges.size());
+    ASSERT_FALSE(deltaChanges.empty());
+    for (size_t i = 0; i < deltaChanges.size(); i++)
+    {
+        EXPECT_EQ(deltaChanges[i].spriteIndex, storedChanges[i].spriteIndex);
+        EXPECT_EQ(deltaChanges[i].changeType, storedChanges[i].changeType);
+        EXPECT_EQ(deltaChanges[i].diffs.size(), storedChanges[i].diffs.size());
+    }
+    EXPECT_TRUE(GetSpriteChanges(snapshots->Compare(after, storedAfter)).empty());
+
+    sprite_remove(added);
+}
+
+TEST(EntityListTest, SnapshotsOfLargeChangesCompareLikeStoredSnapshots)
+{
+    reset_sprite_list();
+    auto snapshots = CreateGameStateSnapshots();
+    std::vector<Litter*> litter;
+    for (size_t i = 0; i < GetEntityCapacity() / 2; i++)
+    {
+        litter.push_back(CreateLitter());
+    }
+
+    // Moving every sprite between captures would ask for a new base each time, more than the buffer can hold.
+    GameStateSnapshot_t* previous = nullptr;
+    for (int32_t i = 0; i < 40; i++)
+    {
+        for (auto* entity : litter)
+        {
+            entity->x += COORDS_XY_STEP;
+        }
+        auto& snapshot = snapshots->CreateSnapshot();
+        snapshots->Capture(snapshot);
+        if (previous != nullptr)
+        {
+            auto changes = GetSpriteChanges(snapshots->Compare(*previous, snapshot));
+            ASSERT_EQ(changes.size(), litter.size());
+            for (const auto& change : changes)
+            {
+                ASSERT_EQ(change.changeType, GameStateSpriteChange_t::MODIFIED);
+            }
+        }
+        previous = &snapshot;
+    }
+
+    OpenRCT2::MemoryStream stream;
+    DataSerialiser saver(true, stream);
+    snapshots->SerialiseSnapshot(*previous, saver);
+    stream.SetPosition(0);
+    auto& loaded = snapshots->CreateSnapshot();
+    DataSerialiser loader(false, stream);
+    snapshots->SerialiseSnapshot(loaded, loader);
+    EXPECT_TRUE(GetSpriteChanges(snapshots->Compare(*previous, loaded)).empty());
+
+    reset_sprite_list();
+}
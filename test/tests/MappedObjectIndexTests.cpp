@@ -0,0 +1,154 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/Path.hpp>
+#include <openrct2/object/MappedObjectIndex.h>
+#include <string>
+#include <vector>
+
+class MappedObjectIndexTest : public testing::Test
+{
+protected:
+    static constexpr int32_t LANGUAGE = 1;
+
+    std::string _path;
+    MappedObjectIndex::DirectoryStats _stats;
+    std::vector<ObjectRepositoryItem> _items;
+
+    void SetUp() override
+    {
+        _path = Path::Combine(testing::TempDir(), "objects_test.idx");
+        _stats.TotalFiles = 1000;
+        _stats.TotalFileSize = 123456;
+        _stats.PathChecksum = 0xABCD;
+
+        for (size_t i = 0; i < 1000; i++)
+        {
+            ObjectRepositoryItem item = {};
+            item.Id = i;
+            item.ObjectEntry.flags = i % 3 == 0 ? OBJECT_TYPE_RIDE : OBJECT_TYPE_SCENERY_GROUP;
+            item.ObjectEntry.SetName(std::string("OBJ") + std::to_string(i));
+            item.ObjectEntry.checksum = static_cast<uint32_t>(i * 7);
+            item.Path = "/objects/OBJ" + std::to_string(i) + ".DAT";
+            item.Name = "Object " + std::to_string(i);
+            item.Authors = { "Author", "Author " + std::to_string(i % 10) };
+            item.Sources = { static_cast<uint8_t>(i % 4) };
+            item.RideInfo.RideFlags = static_cast<uint8_t>(i);
+            item.RideInfo.RideType[0] = static_cast<uint8_t>(i % 90);
+            for (size_t j = 0; j < i % 5; j++)
+            {
+                rct_object_entry entry = {};
+                entry.SetName(std::string("ENT") + std::to_string(j));
+                item.SceneryGroupInfo.Entries.push_back(entry);
+            }
+            _items.push_back(item);
+        }
+    }
+
+    void TearDown() override
+    {
+        File::Delete(_path);
+    }
+
+    void AssertItem(const ObjectRepositoryItem& actual, const ObjectRepositoryItem& expected)
+    {
+        ASSERT_EQ(actual.Id, expected.Id);
+        ASSERT_EQ(actual.ObjectEntry.GetName(), expected.ObjectEntry.GetName());
+        ASSERT_EQ(actual.ObjectEntry.flags, expected.ObjectEntry.flags);
+        ASSERT_EQ(actual.ObjectEntry.checksum, expected.ObjectEntry.checksum);
+        ASSERT_EQ(actual.Path, expected.Path);
+        ASSERT_EQ(actual.Name, expected.Name);
+        ASSERT_EQ(actual.Authors, expected.Authors);
+        ASSERT_EQ(actual.Sources, expected.Sources);
+        ASSERT_EQ(actual.RideInfo.RideFlags, expected.RideInfo.RideFlags);
+        ASSERT_EQ(actual.RideInfo.RideType[0], expected.RideInfo.RideType[0]);
+        ASSERT_EQ(actual.SceneryGroupInfo.Entries.size(), expected.SceneryGroupInfo.Entries.size());
+        for (size_t i = 0; i < actual.SceneryGroupInfo.Entries.size(); i++)
+        {
+            ASSERT_EQ(actual.SceneryGroupInfo.Entries[i].GetName(), expected.SceneryGroupInfo.Entries[i].GetName());
+        }
+    }
+};
+
+TEST_F(MappedObjectIndexTest, round_trip)
+{
+    MappedObjectIndex::Write(_path, LANGUAGE, _stats, _items);
+
+    MappedObjectIndex index;
+    ASSERT_TRUE(index.Open(_path, LANGUAGE, _stats));
+    ASSERT_EQ(index.GetNumItems(), _items.size());
+
+    for (const auto& expected : _items)
+    {
+        auto found = index.Find(expected.ObjectEntry);
+        ASSERT_TRUE(found.has_value());
+        ASSERT_EQ(*found, expected.Id);
+
+        ObjectRepositoryItem item = {};
+        index.ReadItem(*found, item);
+        AssertItem(item, expected);
+    }
+
+    rct_object_entry missing = {};
+    missing.SetName("MISSING");
+    ASSERT_FALSE(index.Find(missing).has_value());
+}
+
+TEST_F(MappedObjectIndexTest, read_keeps_loaded_object)
+{
+    MappedObjectIndex::Write(_path, LANGUAGE, _stats, _items);
+
+    MappedObjectIndex index;
+    ASSERT_TRUE(index.Open(_path, LANGUAGE, _stats));
+
+    ObjectRepositoryItem item = {};
+    auto loadedObject = reinterpret_cast<Object*>(&item);
+    item.LoadedObject = loadedObject;
+    index.ReadItem(5, item);
+    ASSERT_EQ(item.LoadedObject, loadedObject);
+    AssertItem(item, _items[5]);
+}
+
+TEST_F(MappedObjectIndexTest, rejects_out_of_date)
+{
+    MappedObjectIndex::Write(_path, LANGUAGE, _stats, _items);
+
+    MappedObjectIndex index;
+    ASSERT_FALSE(index.Open(_path, LANGUAGE + 1, _stats));
+
+    auto changedStats = _stats;
+    changedStats.TotalFiles++;
+    ASSERT_FALSE(index.Open(_path, LANGUAGE, changedStats));
+    ASSERT_FALSE(index.Find(_items[0].ObjectEntry).has_value());
+
+    ASSERT_FALSE(index.Open(_path + ".missing", LANGUAGE, _stats));
+}
+
+TEST_F(MappedObjectIndexTest, rejects_truncated)
+{
+    MappedObjectIndex::Write(_path, LANGUAGE, _stats, _items);
+    auto data = File::ReadAllBytes(_path);
+    data.resize(data.size() - 1);
+    File::WriteAllBytes(_path, data.data(), data.size());
+
+    MappedObjectIndex index;
+    ASSERT_FALSE(index.Open(_path, LANGUAGE, _stats));
+}
+
+TEST_F(MappedObjectIndexTest, empty)
+{
+    MappedObjectIndex::Write(_path, LANGUAGE, _stats, {});
+
+    MappedObjectIndex index;
+    ASSERT_TRUE(index.Open(_path, LANGUAGE, _stats));
+    ASSERT_EQ(index.GetNumItems(), 0U);
+    ASSERT_FALSE(index.Find(_items[0].ObjectEntry).has_value());
+}
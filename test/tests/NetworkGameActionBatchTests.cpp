@@ -0,0 +1,149 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/network/NetworkGameActionBatch.h>
+#include <openrct2/util/Util.h>
+#include <vector>
+
+// Packets are only given their size when they are queued, received packets have it set
+static NetworkPacket& AsReceived(NetworkPacket& packet)
+{
+    packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
+    return packet;
+}
+
+static std::vector<uint8_t> CreateParameters(int32_t x, int32_t y)
+{
+    std::vector<uint8_t> data(32);
+    for (size_t i = 0; i < 4; i++)
+    {
+        data[i] = static_cast<uint8_t>(x >> (i * 8));
+        data[4 + i] = static_cast<uint8_t>(y >> (i * 8));
+    }
+    data[20] = 0x5A;
+    return data;
+}
+
+TEST(NetworkGameActionBatchTest, single_action_is_plain_packet)
+{
+    NetworkGameActionBatch batch;
+    auto data = CreateParameters(1, 2);
+    batch.Add(100, 7, data.data(), data.size());
+
+    auto packets = batch.TakePackets();
+    ASSERT_TRUE(batch.IsEmpty());
+    ASSERT_EQ(packets.size(), 1U);
+
+    auto& packet = AsReceived(packets[0]);
+    ASSERT_EQ(packet.GetCommand(), NetworkCommand::GameAction);
+    uint32_t tick, type;
+    packet >> tick >> type;
+    ASSERT_EQ(tick, 100U);
+    ASSERT_EQ(type, 7U);
+    auto payload = packet.Read(data.size());
+    ASSERT_NE(payload, nullptr);
+    ASSERT_EQ(std::vector<uint8_t>(payload, payload + data.size()), data);
+}
+
+TEST(NetworkGameActionBatchTest, round_trip)
+{
+    // A tool placing scenery over an area, mixed with an action of another type
+    NetworkGameActionBatch batch;
+    std::vector<NetworkGameActionBatch::Action> expected;
+    for (int32_t i = 0; i < 300; i++)
+    {
+        auto data = i == 150 ? std::vector<uint8_t>{ 1, 2, 3 } : CreateParameters(32 * (i % 20), 32 * (i / 20));
+        uint32_t type = i == 150 ? 3 : 25;
+        batch.Add(1000 + i / 100, type, data.data(), data.size());
+        expected.push_back({ static_cast<uint32_t>(1000 + i / 100), type, data });
+    }
+
+    auto packets = batch.TakePackets();
+    ASSERT_EQ(packets.size(), 1U);
+    auto& packet = AsReceived(packets[0]);
+    ASSERT_EQ(packet.GetCommand(), NetworkCommand::GameActionBatch);
+
+    // One packet of a few hundred bytes rather than 300 packets of about 50
+    ASSERT_LT(packet.Data.size(), 1000U);
+
+    std::vector<NetworkGameActionBatch::Action> actions;
+    ASSERT_TRUE(NetworkGameActionBatch::Read(packet, actions));
+    ASSERT_EQ(actions.size(), expected.size());
+    for (size_t i = 0; i < actions.size(); i++)
+    {
+        ASSERT_EQ(actions[i].Tick, expected[i].Tick);
+        ASSERT_EQ(actions[i].Type, expected[i].Type);
+        ASSERT_EQ(actions[i].Data, expected[i].Data);
+    }
+}
+
+TEST(NetworkGameActionBatchTest, splits_large_batches)
+{
+    NetworkGameActionBatch batch;
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < 100; i++)
+    {
+        data[0] = static_cast<uint8_t>(i);
+        batch.Add(1, 2, data.data(), data.size());
+    }
+
+    size_t count = 0;
+    auto packets = batch.TakePackets();
+    ASSERT_GT(packets.size(), 1U);
+    for (auto& packet : packets)
+    {
+        std::vector<NetworkGameActionBatch::Action> actions;
+        ASSERT_TRUE(NetworkGameActionBatch::Read(AsReceived(packet), actions));
+        for (const auto& action : actions)
+        {
+            ASSERT_EQ(action.Data.size(), data.size());
+            ASSERT_EQ(action.Data[0], count);
+            count++;
+        }
+    }
+    ASSERT_EQ(count, 100U);
+}
+
+TEST(NetworkGameActionBatchTest, rejects_malformed)
+{
+    NetworkGameActionBatch batch;
+    auto data = CreateParameters(5, 6);
+    batch.Add(1, 2, data.data(), data.size());
+    batch.Add(1, 2, data.data(), data.size());
+    auto packets = batch.TakePackets();
+    ASSERT_EQ(packets.size(), 1U);
+
+    // Truncated
+    auto truncated = packets[0];
+    truncated.Data.resize(truncated.Data.size() - 1);
+    std::vector<NetworkGameActionBatch::Action> actions;
+    ASSERT_FALSE(NetworkGameActionBatch::Read(AsReceived(truncated), actions));
+
+    // Empty
+    NetworkPacket empty(NetworkCommand::GameActionBatch);
+    ASSERT_FALSE(NetworkGameActionBatch::Read(AsReceived(empty), actions));
+
+    ASSERT_TRUE(NetworkGameActionBatch::Read(AsReceived(packets[0]), actions));
+}
+
+TEST(NetworkGameActionBatchTest, rejects_payload_inflating_beyond_its_size)
+{
+    // Compresses to a few hundred bytes, but is far larger than the payload size the packet claims
+    std::vector<uint8_t> payload(1024 * 1024);
+    auto compressed = util_zlib_deflate(payload.data(), payload.size());
+    ASSERT_TRUE(compressed.has_value());
+
+    NetworkPacket packet(NetworkCommand::GameActionBatch);
+    packet << static_cast<uint8_t>(1) << static_cast<uint32_t>(1024);
+    packet.Write(compressed->data(), compressed->size());
+    std::vector<NetworkGameActionBatch::Action> actions;
+    ASSERT_FALSE(NetworkGameActionBatch::Read(AsReceived(packet), actions));
+    ASSERT_TRUE(actions.empty());
+}
@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/paint/Paint.h>
+#include <random>
+#include <vector>
+
+struct ArrangeTestSession
+{
+    std::unique_ptr<paint_session> Session = std::make_unique<paint_session>();
+    std::vector<paint_struct> Structs;
+};
+
+/**
+ * Generates a session the way sub_98196C would fill it. Structs are placed in a small area so that many of them
+ * overlap, wideSpread places them anywhere on the map instead.
+ */
+static void GenerateSession(ArrangeTestSession& test, uint32_t seed, uint8_t rotation, size_t count, bool wideSpread)
+{
+    std::mt19937 rng(seed);
+    auto random = [&rng](int32_t lo, int32_t hi) { return std::uniform_int_distribution<int32_t>(lo, hi)(rng); };
+
+    auto& session = *test.Session;
+    session.CurrentRotation = rotation;
+    session.QuadrantBackIndex = UINT32_MAX;
+    session.QuadrantFrontIndex = 0;
+    std::fill(std::begin(session.Quadrants), std::end(session.Quadrants), nullptr);
+
+    test.Structs.assign(count, paint_struct{});
+    const int32_t spread = wideSpread ? 8000 : 96;
+    const int32_t originX = random(0, 4000);
+    const int32_t originY = random(0, 4000);
+    for (auto& ps : test.Structs)
+    {
+        const int32_t x = originX + random(0, spread);
+        const int32_t y = originY + random(0, spread);
+        const int32_t z = random(0, 16) * 8;
+        ps.bounds.x = x;
+        ps.bounds.y = y;
+        ps.bounds.z = z;
+        ps.bounds.x_end = x + random(0, 32);
+        ps.bounds.y_end = y + random(0, 32);
+        ps.bounds.z_end = z + random(0, 64);
+        // Flags are left uninitialised by the paint functions.
+        ps.quadrant_flags = random(0, 255);
+
+        int32_t positionHash = 0;
+        switch (rotation)
+        {
+            case 0:
+                positionHash = y + x;
+                break;
+            case 1:
+                positionHash = y - x + 0x2000;
+                break;
+            case 2:
+                positionHash = -(y + x) + 0x4000;
+                break;
+            case 3:
+                positionHash = x - y + 0x2000;
+                break;
+        }
+        const uint32_t quadrantIndex = std::clamp(positionHash / 32, 0, MAX_PAINT_QUADRANTS - 1);
+        ps.quadrant_index = quadrantIndex;
+        ps.next_quadrant_ps = session.Quadrants[quadrantIndex];
+        session.Quadrants[quadrantIndex] = &ps;
+        session.QuadrantBackIndex = std::min(session.QuadrantBackIndex, quadrantIndex);
+        session.QuadrantFrontIndex = std::max(session.QuadrantFrontIndex, quadrantIndex);
+    }
+}
+
+static std::vector<size_t> ArrangeSession(uint32_t seed, uint8_t rotation, size_t count, bool wideSpread, PaintArrangeMethod method)
+{
+    ArrangeTestSession test;
+    GenerateSession(test, seed, rotation, count, wideSpread);
+    paint_session_arrange(test.Session.get(), method);
+
+    std::vector<size_t> order;
+    for (auto ps = test.Session->PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        order.push_back(ps - test.Structs.data());
+    }
+    return order;
+}
+
+static void TestArrangeMethodsMatch(size_t count, bool wideSpread, uint32_t seeds)
+{
+    for (uint32_t seed = 0; seed < seeds; seed++)
+    {
+        for (uint8_t rotation = 0; rotation < 4; rotation++)
+        {
+            auto legacy = ArrangeSession(seed, rotation, count, wideSpread, PaintArrangeMethod::Legacy);
+            auto indexed = ArrangeSession(seed, rotation, count, wideSpread, PaintArrangeMethod::Indexed);
+            ASSERT_EQ(legacy.size(), count);
+            ASSERT_EQ(legacy, indexed) << "seed " << seed << ", rotation " << static_cast<int>(rotation);
+        }
+    }
+}
+
+TEST(PaintArrangeTest, EmptySession)
+{
+    TestArrangeMethodsMatch(0, false, 1);
+}
+
+TEST(PaintArrangeTest, SmallSessions)
+{
+    TestArrangeMethodsMatch(12, false, 200);
+}
+
+TEST(PaintArrangeTest, DenseSessions)
+{
+    TestArrangeMethodsMatch(600, false, 20);
+}
+
+TEST(PaintArrangeTest, SparseSessions)
+{
+    TestArrangeMethodsMatch(600, true, 20);
+}
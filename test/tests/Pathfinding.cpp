@@ -4,6 +4,7 @@
 #include "openrct2/ride/Station.h"
 #include "openrct2/scenario/Scenario.h"
 
+#include <array>
 #include <gtest/gtest.h>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
@@ -12,6 +13,8 @@
 #include <openrct2/platform/platform.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
+#include <thread>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -251,3 +254,227 @@ INSTANTIATE_TEST_CASE_P(
         SimplePathfindingScenario("PathWithFences", { 11, 6, 14 }, 10000),
         SimplePathfindingScenario("PathWithCliff", { 7, 17, 14 }, 10000)),
     SimplePathfindingScenario::ToName);
+
+class CorridorPathfindingTest : public PathfindingTestBase
+{
+protected:
+    static Direction ChooseDirection(Peep* peep, const TileCoordsXYZ& start, bool useCorridors)
+    {
+        gPeepPathFindUseCorridors = useCorridors;
+        // Drop the corridors and search results kept from earlier calls.
+        gTileElementsRevision++;
+        peep->PathfindGoal.direction = INVALID_DIRECTION;
+        const auto direction = peep_pathfind_choose_direction(start, peep);
+        gPeepPathFindUseCorridors = true;
+        return direction;
+    }
+
+    // Every path tile of the test map.
+    static std::vector<TileCoordsXYZ> GetPathTiles()
+    {
+        std::vector<TileCoordsXYZ> pathTiles;
+        for (int32_t y = 0; y < gMapSize; y++)
+        {
+            for (int32_t x = 0; x < gMapSize; x++)
+            {
+                TileElement* tileElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+                if (tileElement == nullptr)
+                    continue;
+                do
+                {
+                    if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH && !tileElement->IsGhost())
+                        pathTiles.emplace_back(x, y, tileElement->base_height);
+                } while (!(tileElement++)->IsLastForTile());
+            }
+        }
+        return pathTiles;
+    }
+};
+
+TEST_F(CorridorPathfindingTest, SameDirectionsAsTileByTileSearch)
+{
+    // Every path tile of the test map, heading for the entrance of every ride.
+    auto starts = GetPathTiles();
+    ASSERT_FALSE(starts.empty());
+
+    Peep* peep = Peep::Generate(starts[0].ToCoordsXYZ().ToTileCentre());
+    ASSERT_NE(peep, nullptr);
+    peep->OutsideOfPark = false;
+
+    size_t numCompared = 0;
+    for (auto& ride : GetRideManager())
+    {
+        auto entrancePos = ride_get_entrance_location(&ride, 0);
+        if (entrancePos.isNull())
+            continue;
+
+        gPeepPathFindGoalPosition = TileCoordsXYZ(
+            entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+            entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+        peep->GuestHeadingToRideId = ride.id;
+        for (const auto& start : starts)
+        {
+            const auto tileByTile = ChooseDirection(peep, start, false);
+            const auto withCorridors = ChooseDirection(peep, start, true);
+            EXPECT_EQ(tileByTile, withCorridors) << "from " << start << " to " << gPeepPathFindGoalPosition;
+            numCompared++;
+        }
+    }
+    peep_sprite_remove(peep);
+    ASSERT_GT(numCompared, 0u);
+}
+
+TEST_F(CorridorPathfindingTest, SharedSearchIgnoresHistoryOrder)
+{
+    const TileCoordsXYZ start{ 9, 13, 14 };
+    auto ride = FindRideByName("TwoEqualRoutes");
+    ASSERT_NE(ride, nullptr);
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    gPeepPathFindGoalPosition = TileCoordsXYZ(
+        entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    Peep* peep = Peep::Generate(start.ToCoordsXYZ().ToTileCentre());
+    ASSERT_NE(peep, nullptr);
+    peep->OutsideOfPark = false;
+    peep->GuestHeadingToRideId = ride->id;
+
+    const rct12_xyzd8 history[4] = { { 9, 14, 14, 0xF }, { 8, 13, 14, 0x5 }, { 10, 13, 14, 0xA }, { 0xFF, 0xFF, 0xFF, 0xFF } };
+    auto choose = [&](const std::array<int, 4>& order) {
+        peep->PathfindGoal = { static_cast<uint8_t>(gPeepPathFindGoalPosition.x),
+                               static_cast<uint8_t>(gPeepPathFindGoalPosition.y),
+                               static_cast<uint8_t>(gPeepPathFindGoalPosition.z), 0 };
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            peep->PathfindHistory[i] = history[order[i]];
+        }
+        return peep_pathfind_choose_direction(start, peep);
+    };
+
+    gTileElementsRevision++;
+    const auto searched = choose({ 0, 1, 2, 3 });
+    const auto shared = choose({ 3, 2, 0, 1 });
+    gTileElementsRevision++;
+    const auto searchedAgain = choose({ 3, 2, 0, 1 });
+    peep_sprite_remove(peep);
+
+    EXPECT_EQ(searched, shared);
+    EXPECT_EQ(searched, searchedAgain);
+}
+
+TEST_F(CorridorPathfindingTest, BannerEdgesChangeSharedSearch)
+{
+    const TileCoordsXYZ start{ 9, 13, 14 };
+    auto ride = FindRideByName("TwoEqualRoutes");
+    ASSERT_NE(ride, nullptr);
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    gPeepPathFindGoalPosition = TileCoordsXYZ(
+        entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    Peep* peep = Peep::Generate(start.ToCoordsXYZ().ToTileCentre());
+    ASSERT_NE(peep, nullptr);
+    peep->OutsideOfPark = false;
+    peep->GuestHeadingToRideId = ride->id;
+    auto choose = [&]() {
+        peep->PathfindGoal.direction = INVALID_DIRECTION;
+        std::fill(std::begin(peep->PathfindHistory), std::end(peep->PathfindHistory), rct12_xyzd8{ 0xFF, 0xFF, 0xFF, 0xFF });
+        return peep_pathfind_choose_direction(start, peep);
+    };
+
+    const auto chosen = choose();
+    ASSERT_NE(chosen, INVALID_DIRECTION);
+
+    // Put a banner on the next path tile of the chosen route, it lets guests through until its edges are cleared.
+    const auto next = CoordsXYZ{ start.ToCoordsXY() + CoordsDirectionDelta[chosen], start.ToCoordsXYZ().z };
+    ASSERT_NE(map_get_footpath_element(next), nullptr);
+    TileElement* tileElement = tile_element_insert({ next, next.z + (2 * COORDS_Z_STEP) }, 0b0000);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetType(TILE_ELEMENT_TYPE_BANNER);
+    BannerElement* bannerElement = tileElement->AsBanner();
+    bannerElement->SetClearanceZ(next.z + PATH_CLEARANCE);
+    bannerElement->ResetAllowedEdges();
+
+    const auto throughBanner = choose();
+    bannerElement->SetAllowedEdges(0);
+    const auto blocked = choose();
+    gTileElementsRevision++;
+    const auto blockedUncached = choose();
+    bannerElement->ResetAllowedEdges();
+    const auto reopened = choose();
+
+    tile_element_remove(tileElement);
+    peep_sprite_remove(peep);
+
+    EXPECT_EQ(throughBanner, chosen);
+    EXPECT_NE(blocked, chosen);
+    EXPECT_EQ(blocked, blockedUncached);
+    EXPECT_EQ(reopened, chosen);
+}
+
+TEST_F(CorridorPathfindingTest, SearchesOnSeparateThreads)
+{
+    constexpr size_t NumThreads = 4;
+    const auto starts = GetPathTiles();
+    ASSERT_FALSE(starts.empty());
+
+    std::vector<TileCoordsXYZ> goals;
+    std::vector<ride_id_t> goalRides;
+    for (auto& ride : GetRideManager())
+    {
+        auto entrancePos = ride_get_entrance_location(&ride, 0);
+        if (entrancePos.isNull())
+            continue;
+        goals.emplace_back(
+            entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+            entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+        goalRides.push_back(ride.id);
+    }
+    ASSERT_FALSE(goals.empty());
+
+    std::array<Peep*, NumThreads> peeps;
+    for (auto& peep : peeps)
+    {
+        peep = Peep::Generate(starts[0].ToCoordsXYZ().ToTileCentre());
+        ASSERT_NE(peep, nullptr);
+        peep->OutsideOfPark = false;
+    }
+
+    // Each thread searches from every start towards every goal with a goal set on that thread only.
+    auto search = [&](Peep* peep, size_t firstStart, size_t step) {
+        std::vector<Direction> directions;
+        for (size_t i = 0; i < goals.size(); i++)
+        {
+            gPeepPathFindGoalPosition = goals[i];
+            gPeepPathFindIgnoreForeignQueues = true;
+            gPeepPathFindQueueRideIndex = goalRides[i];
+            peep->GuestHeadingToRideId = goalRides[i];
+            for (size_t j = firstStart; j < starts.size(); j += step)
+            {
+                peep->PathfindGoal.direction = INVALID_DIRECTION;
+                directions.push_back(peep_pathfind_choose_direction(starts[j], peep));
+            }
+        }
+        return directions;
+    };
+
+    std::array<std::vector<Direction>, NumThreads> threadDirections;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NumThreads; i++)
+    {
+        threads.emplace_back([&, i]() { threadDirections[i] = search(peeps[i], i, NumThreads); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < NumThreads; i++)
+    {
+        EXPECT_EQ(threadDirections[i], search(peeps[0], i, NumThreads)) << "thread " << i;
+    }
+    for (auto peep : peeps)
+    {
+        peep_sprite_remove(peep);
+    }
+}
@@ -16,16 +16,20 @@
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
 #include <openrct2/actions/ParkSetParameterAction.hpp>
+#include <openrct2/actions/RideDemolishAction.hpp>
 #include <openrct2/actions/RideSetPriceAction.hpp>
+#include <openrct2/config/Config.h>
 #include <openrct2/object/ObjectManager.h>
 #include <openrct2/peep/Peep.h>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
+#include <openrct2/world/Map.h>
 #include <openrct2/world/MapAnimation.h>
 #include <openrct2/world/Park.h>
 #include <openrct2/world/Scenery.h>
 #include <openrct2/world/Sprite.h>
 #include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -193,3 +197,124 @@ TEST_F(PlayTests, CarRideWithOneCarOnlyAcceptsTwoGuests)
         gs->UpdateLogic();
     }
 }
+
+TEST_F(PlayTests, TickWithoutMapEditsKeepsTileElementsRevision)
+{
+    auto context = localStartGame(TestData::GetParkPath("bpb.sv6"));
+    ASSERT_NE(context.get(), nullptr);
+
+    // The wide path flags are updated for 128 tiles per tick, let them settle over two passes of the map first.
+    constexpr int ticksPerPass = MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL / 128;
+    auto gs = context->GetGameState();
+    for (int i = 0; i < 2 * ticksPerPass; i++)
+    {
+        gs->UpdateLogic();
+    }
+
+    const auto revision = gTileElementsRevision;
+    for (int i = 0; i < ticksPerPass; i++)
+    {
+        gs->UpdateLogic();
+        ASSERT_EQ(gTileElementsRevision, revision) << "after tick " << i;
+    }
+}
+
+/**
+ * Finds the rides a guest considers by walking the tiles around the guest, the way it was done before the rides were
+ * indexed by map block.
+ */
+static std::bitset<MAX_RIDES> scanRidesToGoOn(Guest* guest)
+{
+    std::bitset<MAX_RIDES> rides;
+    if (guest->ItemStandardFlags & PEEP_ITEM_MAP)
+    {
+        for (auto& ride : GetRideManager())
+        {
+            if (!guest->HasRidden(&ride))
+                rides[ride.id] = true;
+        }
+        return rides;
+    }
+
+    const auto centre = TileCoordsXY{ CoordsXY{ guest->x, guest->y } };
+    for (int32_t y = std::max(centre.y - 10, 0); y <= std::min(centre.y + 10, MAXIMUM_MAP_SIZE_TECHNICAL - 1); y++)
+    {
+        for (int32_t x = std::max(centre.x - 10, 0); x <= std::min(centre.x + 10, MAXIMUM_MAP_SIZE_TECHNICAL - 1); x++)
+        {
+            auto tileElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (tileElement == nullptr)
+                continue;
+            do
+            {
+                if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
+                    rides[tileElement->AsTrack()->GetRideIndex()] = true;
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+    for (auto& ride : GetRideManager())
+    {
+        if (ride.highest_drop_height > 66 || ride.excitement >= RIDE_RATING(8, 00))
+            rides[ride.id] = true;
+    }
+    return rides;
+}
+
+static void assertRidesToGoOnMatchScan()
+{
+    int32_t numGuests = 0;
+    for (auto guest : EntityList<Guest>(EntityListId::Peep))
+    {
+        ASSERT_EQ(guest->FindRidesToGoOn(), scanRidesToGoOn(guest)) << "guest " << guest->sprite_index;
+        numGuests++;
+    }
+    ASSERT_GT(numGuests, 0);
+}
+
+TEST_F(PlayTests, RidesToGoOnMatchMapScan)
+{
+    auto context = localStartGame(TestData::GetParkPath("bpb.sv6"));
+    ASSERT_NE(context.get(), nullptr);
+
+    auto gs = context->GetGameState();
+    for (int i = 0; i < 100; i++)
+    {
+        gs->UpdateLogic();
+    }
+    assertRidesToGoOnMatchScan();
+
+    // The blocks of the demolished ride have to be rebuilt, the others can be reused
+    auto rideManager = GetRideManager();
+    ASSERT_NE(rideManager.begin(), rideManager.end());
+    execute<RideDemolishAction>((*rideManager.begin()).id, RIDE_MODIFY_DEMOLISH);
+    assertRidesToGoOnMatchScan();
+
+    gs->UpdateLogic();
+    assertRidesToGoOnMatchScan();
+}
+
+static std::string runGuestUpdate(bool multithreading, int ticks)
+{
+    gConfigGeneral.multithreading = multithreading;
+    auto context = localStartGame(TestData::GetParkPath("bpb.sv6"));
+    EXPECT_NE(context.get(), nullptr);
+    if (context == nullptr)
+        return {};
+
+    auto gs = context->GetGameState();
+    for (int i = 0; i < ticks; i++)
+    {
+        gs->UpdateLogic();
+    }
+    return sprite_checksum().ToString();
+}
+
+TEST_F(PlayTests, ParallelGuestPathSearchesMatchSerial)
+{
+    const auto savedMultithreading = gConfigGeneral.multithreading;
+    auto serial = runGuestUpdate(false, 1000);
+    auto parallel = runGuestUpdate(true, 1000);
+    gConfigGeneral.multithreading = savedMultithreading;
+
+    ASSERT_FALSE(serial.empty());
+    ASSERT_EQ(serial, parallel);
+}
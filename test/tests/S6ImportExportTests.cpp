@@ -14,7 +14,9 @@
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
 #include <openrct2/GameState.h>
+#include <openrct2/GameStateHash.h>
 #include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkFile.h>
 #include <openrct2/ParkImporter.h>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/config/Config.h>
@@ -30,6 +32,7 @@
 #include <openrct2/ride/Ride.h>
 #include <openrct2/world/Park.h>
 #include <openrct2/world/Sprite.h>
+#include <cstring>
 #include <stdio.h>
 #include <string>
 
@@ -103,6 +106,31 @@ static bool ExportSave(MemoryStream& stream, std::unique_ptr<IContext>& context)
     return true;
 }
 
+static bool ImportParkFile(MemoryStream& stream, std::unique_ptr<IContext>& context)
+{
+    stream.SetPosition(0);
+
+    auto& objManager = context->GetObjectManager();
+
+    auto importer = ParkImporter::CreateParkFile();
+    auto loadResult = importer->LoadFromStream(&stream, false);
+    objManager.LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
+    importer->Import();
+
+    GameInit(true);
+
+    return true;
+}
+
+static bool ExportParkFile(MemoryStream& stream)
+{
+    auto exporter = std::make_unique<ParkFileExporter>();
+    exporter->Export();
+    exporter->SaveGame(&stream);
+
+    return true;
+}
+
 static std::unique_ptr<GameState_t> GetGameState(std::unique_ptr<IContext>& context)
 {
     std::unique_ptr<GameState_t> res = std::make_unique<GameState_t>();
@@ -568,6 +596,193 @@ TEST(S6ImportExportAdvanceTicks, all)
     SUCCEED();
 }
 
+TEST(ParkFileImportExport, all)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    MemoryStream importBuffer;
+    MemoryStream exportBuffer;
+
+    std::unique_ptr<GameState_t> importedState;
+    std::unique_ptr<GameState_t> exportedState;
+    GameStateHash importedHash;
+    GameStateHash exportedHash;
+
+    // Load initial park data.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+        ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+        ASSERT_TRUE(ImportSave(importBuffer, context, false));
+        AdvanceGameTicks(100, context);
+        ASSERT_TRUE(ExportParkFile(exportBuffer));
+
+        importedState = GetGameState(context);
+        ASSERT_NE(importedState, nullptr);
+        importedHash = game_state_hash();
+    }
+
+    // Import the exported version.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        ASSERT_TRUE(ImportParkFile(exportBuffer, context));
+
+        exportedState = GetGameState(context);
+        ASSERT_NE(exportedState, nullptr);
+        exportedHash = game_state_hash();
+    }
+
+    CompareStates(importBuffer, exportBuffer, importedState, exportedState);
+    EXPECT_EQ(importedHash.ToString(), exportedHash.ToString());
+
+    SUCCEED();
+}
+
+static MemoryStream WriteParkFileChunks(bool parallel)
+{
+    ParkFileWriter writer;
+    MemoryStream compressible;
+    for (uint32_t i = 0; i < 4096; i++)
+    {
+        compressible.WriteValue<uint32_t>(i % 16);
+    }
+    writer.AddChunk(ParkFile::ChunkId::MAP, std::move(compressible));
+    MemoryStream small;
+    small.WriteValue<uint8_t>(42);
+    writer.AddChunk(ParkFile::ChunkId::GENERAL, std::move(small));
+
+    MemoryStream file;
+    writer.Save(&file, S6_TYPE_SAVEDGAME, parallel);
+    file.SetPosition(0);
+    return file;
+}
+
+TEST(ParkFileChunks, RoundTrip)
+{
+    for (bool parallel : { false, true })
+    {
+        auto file = WriteParkFileChunks(parallel);
+        ASSERT_TRUE(ParkFileReader::IsParkFile(&file));
+        ASSERT_EQ(file.GetPosition(), 0u);
+
+        ParkFileReader reader(&file);
+        EXPECT_EQ(reader.GetType(), S6_TYPE_SAVEDGAME);
+        EXPECT_EQ(reader.GetVersion(), ParkFile::VERSION);
+        EXPECT_FALSE(reader.HasChunk(ParkFile::ChunkId::RIDES));
+
+        // Chunks can be read in any order
+        auto general = reader.ReadChunk(ParkFile::ChunkId::GENERAL);
+        ASSERT_EQ(general.GetLength(), 1u);
+        EXPECT_EQ(general.ReadValue<uint8_t>(), 42);
+
+        auto map = reader.ReadChunk(ParkFile::ChunkId::MAP);
+        ASSERT_EQ(map.GetLength(), 4096u * sizeof(uint32_t));
+        for (uint32_t i = 0; i < 4096; i++)
+        {
+            ASSERT_EQ(map.ReadValue<uint32_t>(), i % 16);
+        }
+    }
+}
+
+TEST(ParkFileChunks, CompressesChunks)
+{
+    auto file = WriteParkFileChunks(false);
+    ASSERT_LT(file.GetLength(), 4096u * sizeof(uint32_t));
+}
+
+TEST(ParkFileChunks, RejectsCorruptChunk)
+{
+    auto file = WriteParkFileChunks(false);
+    auto data = static_cast<uint8_t*>(const_cast<void*>(file.GetData()));
+    data[file.GetLength() - 1] ^= 0xFF;
+
+    ParkFileReader reader(&file);
+    EXPECT_THROW(reader.ReadChunk(ParkFile::ChunkId::GENERAL), IOException);
+    EXPECT_NO_THROW(reader.ReadChunk(ParkFile::ChunkId::MAP));
+}
+
+TEST(ParkFileChunks, LengthExcludesTrailingData)
+{
+    auto file = WriteParkFileChunks(false);
+    const auto parkLength = file.GetLength();
+    file.SetPosition(parkLength);
+    file.WriteValue<uint32_t>(0xDEADBEEF);
+    file.SetPosition(0);
+
+    ParkFileReader reader(&file);
+    ASSERT_EQ(reader.GetLength(), parkLength);
+    file.SetPosition(reader.GetLength());
+    EXPECT_EQ(file.ReadValue<uint32_t>(), 0xDEADBEEF);
+}
+
+TEST(ParkFileChunks, RejectsChunkWithDataLeftOver)
+{
+    for (uint32_t extraBytes : { 0u, 1u })
+    {
+        MemoryStream objects;
+        objects.WriteValue<uint32_t>(OBJECT_ENTRY_COUNT);
+        for (size_t i = 0; i < OBJECT_ENTRY_COUNT; i++)
+        {
+            rct_object_entry entry;
+            std::memset(&entry, 0xFF, sizeof(entry));
+            objects.WriteValue(entry);
+        }
+        for (uint32_t i = 0; i < extraBytes; i++)
+        {
+            objects.WriteValue<uint8_t>(0);
+        }
+
+        ParkFileWriter writer;
+        writer.AddChunk(ParkFile::ChunkId::OBJECTS, std::move(objects));
+        MemoryStream file;
+        writer.Save(&file, S6_TYPE_SAVEDGAME, false);
+        file.SetPosition(0);
+
+        auto importer = ParkImporter::CreateParkFile();
+        if (extraBytes == 0)
+        {
+            EXPECT_NO_THROW(importer->LoadFromStream(&file, false));
+        }
+        else
+        {
+            EXPECT_THROW(importer->LoadFromStream(&file, false), IOException);
+        }
+    }
+}
+
+TEST(ParkFileChunks, RejectsOlderVersions)
+{
+    auto file = WriteParkFileChunks(false);
+    auto data = static_cast<uint8_t*>(const_cast<void*>(file.GetData()));
+    auto header = file.ReadValue<ParkFile::Header>();
+    header.TargetVersion = ParkFile::MIN_VERSION - 1;
+    std::memcpy(data, &header, sizeof(header));
+    file.SetPosition(0);
+    EXPECT_THROW(ParkFileReader{ &file }, IOException);
+}
+
+TEST(ParkFileChunks, RejectsOtherFiles)
+{
+    MemoryStream file;
+    file.WriteValue<uint32_t>(0x12345678);
+    file.SetPosition(0);
+    EXPECT_FALSE(ParkFileReader::IsParkFile(&file));
+    EXPECT_THROW(ParkFileReader{ &file }, IOException);
+}
+
 TEST(SeaDecrypt, DecryptSea)
 {
     auto path = TestData::GetParkPath("volcania.sea");
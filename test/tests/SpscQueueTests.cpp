@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/core/SpscQueue.h>
+#include <thread>
+#include <vector>
+
+TEST(SpscQueueTest, KeepsOrder)
+{
+    SpscQueue<int> queue;
+    int value;
+    ASSERT_FALSE(queue.TryPop(value));
+    for (int i = 0; i < 10; i++)
+    {
+        queue.Push(std::move(i));
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+}
+
+TEST(SpscQueueTest, MovesValues)
+{
+    SpscQueue<std::unique_ptr<std::vector<int>>> queue;
+    queue.Push(std::make_unique<std::vector<int>>(100, 7));
+
+    std::unique_ptr<std::vector<int>> value;
+    ASSERT_TRUE(queue.TryPop(value));
+    ASSERT_NE(value, nullptr);
+    ASSERT_EQ(value->size(), 100u);
+
+    // Items left in the queue are freed with it
+    queue.Push(std::make_unique<std::vector<int>>(1));
+}
+
+TEST(SpscQueueTest, HandsOverBetweenThreads)
+{
+    constexpr int count = 100000;
+    SpscQueue<int> queue;
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; i++)
+        {
+            queue.Push(std::move(i));
+        }
+    });
+
+    int expected = 0;
+    while (expected < count)
+    {
+        int value;
+        if (queue.TryPop(value))
+        {
+            ASSERT_EQ(value, expected);
+            expected++;
+        }
+    }
+    producer.join();
+}
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <openrct2/core/TaskScheduler.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace OpenRCT2;
+
+TEST(TaskSchedulerTest, ParallelForVisitsEveryIndexOnce)
+{
+    TaskScheduler scheduler(4);
+    std::vector<std::atomic<int>> visits(10000);
+    scheduler.ParallelFor(visits.size(), [&visits](size_t i) { visits[i]++; });
+    for (const auto& v : visits)
+    {
+        ASSERT_EQ(v.load(), 1);
+    }
+}
+
+TEST(TaskSchedulerTest, NestedForkJoin)
+{
+    TaskScheduler scheduler(3);
+    std::atomic<size_t> total{ 0 };
+    TaskGroup outer(scheduler);
+    for (size_t i = 0; i < 16; i++)
+    {
+        outer.Run([&scheduler, &total]() {
+            TaskGroup inner(scheduler);
+            for (size_t j = 0; j < 16; j++)
+            {
+                inner.Run([&total]() { total++; });
+            }
+            inner.Wait();
+        });
+    }
+    outer.Wait();
+    ASSERT_EQ(total.load(), 256u);
+}
+
+TEST(TaskSchedulerTest, NoWorkersRunsInline)
+{
+    TaskScheduler scheduler(0);
+    size_t sum = 0;
+    scheduler.ParallelFor(100, [&sum](size_t i) { sum += i; });
+    ASSERT_EQ(sum, 4950u);
+}
+
+TEST(TaskSchedulerTest, ExceptionIsRethrownOnWait)
+{
+    TaskScheduler scheduler(2);
+    TaskGroup group(scheduler);
+    group.Run([]() { throw std::runtime_error("task failed"); });
+    ASSERT_THROW(group.Wait(), std::runtime_error);
+}
+
+TEST(TaskSchedulerTest, LargeClosuresAndStats)
+{
+    TaskScheduler scheduler(2);
+    std::array<uint64_t, 32> payload{};
+    std::iota(payload.begin(), payload.end(), 1);
+    std::atomic<uint64_t> result{ 0 };
+    TaskGroup group(scheduler);
+    for (size_t i = 0; i < 8; i++)
+    {
+        group.Run([payload, &result]() { result += std::accumulate(payload.begin(), payload.end(), uint64_t{ 0 }); });
+    }
+    group.Wait();
+    ASSERT_EQ(result.load(), 8u * 528u);
+
+    uint64_t executed = 0;
+    auto stats = scheduler.GetStats();
+    ASSERT_EQ(stats.size(), scheduler.GetWorkerCount() + 1);
+    for (const auto& s : stats)
+    {
+        executed += s.Executed;
+    }
+    ASSERT_EQ(executed, 8u);
+}
@@ -9,13 +9,21 @@
 
 #include "TestData.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
+#include <openrct2/GameStateHash.h>
+#include <openrct2/GameStateImage.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
+#include <openrct2/management/Finance.h>
+#include <openrct2/scenario/Scenario.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
+#include <openrct2/world/Sprite.h>
+#include <optional>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -140,3 +148,270 @@ TEST_F(TileElementWantsFootpathConnection, DifferentHeight)
     EXPECT_FALSE(tile_element_wants_path_connection_towards({ 18, 10, 24, 1 }, nullptr));
     SUCCEED();
 }
+
+class TileElementStorage : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        std::string parkPath = TestData::GetParkPath("tile-element-tests.sv6");
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+        SUCCEED();
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+    static size_t GetRunLength(const TileCoordsXY& loc)
+    {
+        size_t length = 0;
+        const TileElement* tileElement = map_get_first_element_at(loc.ToCoordsXY());
+        if (tileElement != nullptr)
+        {
+            do
+            {
+                length++;
+            } while (!(tileElement++)->IsLastForTile());
+        }
+        return length;
+    }
+
+    static size_t CountTileElements()
+    {
+        size_t count = 0;
+        for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+        {
+            for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+            {
+                count += GetRunLength({ x, y });
+            }
+        }
+        return count;
+    }
+
+    static TileElement* InsertElement(const TileCoordsXY& loc)
+    {
+        auto tileElement = tile_element_insert({ loc.ToCoordsXY(), 250 * COORDS_Z_STEP }, 0);
+        if (tileElement != nullptr)
+        {
+            tileElement->SetType(TILE_ELEMENT_TYPE_CORRUPT);
+        }
+        return tileElement;
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> TileElementStorage::_context;
+
+TEST_F(TileElementStorage, InsertReusesFreedRuns)
+{
+    map_reorganise_elements();
+    const auto initialCount = CountTileElements();
+
+    // Find a tile with one element more than another, the second insert fits in the run given up by the first.
+    std::optional<TileCoordsXY> longer;
+    std::optional<TileCoordsXY> shorter;
+    for (int32_t y = 1; y < MAXIMUM_MAP_SIZE_TECHNICAL - 1 && !shorter; y++)
+    {
+        for (int32_t x = 1; x < MAXIMUM_MAP_SIZE_TECHNICAL - 1 && !shorter; x++)
+        {
+            if (GetRunLength({ x, y }) == 2 && !longer)
+                longer = TileCoordsXY{ x, y };
+            else if (GetRunLength({ x, y }) == 1)
+                shorter = TileCoordsXY{ x, y };
+        }
+    }
+    ASSERT_TRUE(longer.has_value());
+    ASSERT_TRUE(shorter.has_value());
+
+    const auto* nextFree = gNextFreeTileElement;
+    ASSERT_NE(InsertElement(*longer), nullptr);
+    ASSERT_EQ(gNextFreeTileElement, nextFree + 3);
+
+    nextFree = gNextFreeTileElement;
+    ASSERT_NE(InsertElement(*shorter), nullptr);
+    ASSERT_EQ(gNextFreeTileElement, nextFree);
+    ASSERT_EQ(GetRunLength(*longer), 3u);
+    ASSERT_EQ(GetRunLength(*shorter), 2u);
+    ASSERT_EQ(CountTileElements(), initialCount + 2);
+}
+
+TEST_F(TileElementStorage, GrowsWhenFull)
+{
+    map_reorganise_elements();
+    const auto initialSize = gTileElements.size();
+    const auto initialCount = CountTileElements();
+
+    size_t inserted = 0;
+    while (gTileElements.size() == initialSize)
+    {
+        for (int32_t y = 1; y < MAXIMUM_MAP_SIZE_TECHNICAL - 1; y++)
+        {
+            for (int32_t x = 1; x < MAXIMUM_MAP_SIZE_TECHNICAL - 1; x++)
+            {
+                ASSERT_NE(InsertElement({ x, y }), nullptr);
+                inserted++;
+            }
+        }
+    }
+    ASSERT_GT(gTileElements.size(), initialSize);
+    ASSERT_EQ(CountTileElements(), initialCount + inserted);
+    EXPECT_NE(map_get_footpath_element(TileCoordsXYZ{ 19, 18, 14 }.ToCoordsXYZ()), nullptr);
+
+    map_reorganise_elements();
+    ASSERT_EQ(CountTileElements(), initialCount + inserted);
+    ASSERT_EQ(static_cast<size_t>(gNextFreeTileElement - gTileElements.data()), initialCount + inserted);
+}
+
+TEST_F(TileElementStorage, OffsetsStayValidWhenGrowing)
+{
+    map_reorganise_elements();
+    const TileCoordsXY untouched{ 19, 18 };
+    const auto untouchedIndex = untouched.x + untouched.y * MAXIMUM_MAP_SIZE_TECHNICAL;
+    const auto offset = gTileElementOffsets[untouchedIndex];
+    const auto runLength = GetRunLength(untouched);
+    ASSERT_NE(offset, TILE_ELEMENT_OFFSET_NULL);
+
+    const auto initialSize = gTileElements.size();
+    while (gTileElements.size() == initialSize)
+    {
+        for (int32_t x = 1; x < MAXIMUM_MAP_SIZE_TECHNICAL - 1; x++)
+        {
+            ASSERT_NE(InsertElement({ x, 1 }), nullptr);
+        }
+    }
+
+    ASSERT_EQ(gTileElementOffsets[untouchedIndex], offset);
+    ASSERT_EQ(map_get_first_element_at(untouched.ToCoordsXY()), &gTileElements[offset]);
+    ASSERT_EQ(GetRunLength(untouched), runLength);
+
+    // The scratch elements are never handed out by the allocator.
+    ASSERT_LE(gNextFreeTileElement, map_get_scratch_tile_elements());
+}
+
+TEST_F(TileElementStorage, StateHashIgnoresGhosts)
+{
+    const TileCoordsXY loc{ 19, 18 };
+    const auto initialHash = game_state_hash_tile_elements();
+
+    auto tileElement = InsertElement(loc);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetGhost(true);
+    EXPECT_EQ(game_state_hash_tile_elements(), initialHash);
+
+    tileElement->SetGhost(false);
+    EXPECT_NE(game_state_hash_tile_elements(), initialHash);
+
+    tile_element_remove(tileElement);
+    EXPECT_EQ(game_state_hash_tile_elements(), initialHash);
+}
+
+TEST_F(TileElementStorage, StateHashIgnoresTrackHighlight)
+{
+    const TileCoordsXY loc{ 19, 18 };
+    auto tileElement = InsertElement(loc);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetType(TILE_ELEMENT_TYPE_TRACK);
+    const auto initialHash = game_state_hash_tile_elements();
+
+    tileElement->AsTrack()->SetHighlight(true);
+    EXPECT_EQ(game_state_hash_tile_elements(), initialHash);
+
+    tileElement->AsTrack()->SetHasChain(true);
+    EXPECT_NE(game_state_hash_tile_elements(), initialHash);
+
+    tile_element_remove(tileElement);
+}
+
+TEST_F(TileElementStorage, ChangedTilesAreTracked)
+{
+    const TileCoordsXY inserted{ 19, 18 };
+    const TileCoordsXY edited{ 21, 18 };
+    const auto revision = gTileElementsRevision;
+
+    auto tileElement = InsertElement(inserted);
+    ASSERT_NE(tileElement, nullptr);
+    auto surfaceElement = map_get_first_element_at(edited.ToCoordsXY());
+    ASSERT_NE(surfaceElement, nullptr);
+    surfaceElement->SetGhost(true);
+    surfaceElement->SetGhost(false);
+
+    std::vector<TileCoordsXY> tiles;
+    ASSERT_TRUE(tile_elements_get_changed_tiles(revision, tiles));
+    EXPECT_NE(std::find(tiles.begin(), tiles.end(), inserted), tiles.end());
+    EXPECT_NE(std::find(tiles.begin(), tiles.end(), edited), tiles.end());
+    for (const auto& tile : tiles)
+    {
+        EXPECT_TRUE(tile == inserted || tile == edited);
+    }
+
+    // Changes to the whole map are not tracked by tile.
+    tile_element_remove(tileElement);
+    map_reorganise_elements();
+    tiles.clear();
+    EXPECT_FALSE(tile_elements_get_changed_tiles(revision, tiles));
+}
+
+TEST_F(TileElementStorage, StateImageRestoresState)
+{
+    GameStateImage image;
+    game_state_image_capture(image);
+    const auto initialHash = game_state_hash();
+
+    ASSERT_NE(InsertElement({ 19, 18 }), nullptr);
+    auto* litter = create_sprite(SPRITE_IDENTIFIER_LITTER);
+    ASSERT_NE(litter, nullptr);
+    litter->generic.sprite_identifier = SPRITE_IDENTIFIER_LITTER;
+    gCash += MONEY(100, 00);
+    scenario_rand();
+    gCurrentTicks++;
+    ASSERT_NE(game_state_hash(), initialHash);
+
+    game_state_image_restore(image);
+    EXPECT_EQ(game_state_hash(), initialHash);
+
+    // The image stays valid after being restored.
+    gCash += MONEY(100, 00);
+    game_state_image_restore(image);
+    EXPECT_EQ(game_state_hash(), initialHash);
+}
+
+TEST_F(TileElementStorage, StateImageRestoresPeepNames)
+{
+    auto* sprite = create_sprite(SPRITE_IDENTIFIER_PEEP);
+    ASSERT_NE(sprite, nullptr);
+    sprite->generic.sprite_identifier = SPRITE_IDENTIFIER_PEEP;
+    const auto peepIndex = sprite->generic.sprite_index;
+    ASSERT_TRUE(sprite->peep.SetName("Captured"));
+
+    GameStateImage image;
+    game_state_image_capture(image);
+    ASSERT_TRUE(sprite->peep.SetName("Renamed"));
+
+    // Each restore gives the peep its own copy of the name, so it can be renamed and restored again.
+    for (int32_t i = 0; i < 2; i++)
+    {
+        game_state_image_restore(image);
+        auto* peep = TryGetEntity<Peep>(peepIndex);
+        ASSERT_NE(peep, nullptr);
+        ASSERT_NE(peep->Name, nullptr);
+        EXPECT_STREQ(peep->Name, "Captured");
+        ASSERT_TRUE(peep->SetName("Renamed"));
+    }
+
+    auto* peep = TryGetEntity<Peep>(peepIndex);
+    peep->SetName({});
+    sprite_remove(peep);
+}
@@ -7,10 +7,14 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/rct12/SawyerChunkReader.h>
 #include <openrct2/util/SawyerCoding.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
 
 constexpr size_t BUFFER_SIZE = 0x600000;
 
@@ -106,6 +110,190 @@ TEST_F(SawyerCodingTest, decode_chunk_rotate)
     test_decode(rotatedata, sizeof(rotatedata));
 }
 
+TEST_F(SawyerCodingTest, read_chunks)
+{
+    OpenRCT2::MemoryStream ms;
+    ms.Write(nonedata, sizeof(nonedata));
+    ms.Write(rledata, sizeof(rledata));
+    ms.Write(rlecompresseddata, sizeof(rlecompresseddata));
+    ms.Write(rotatedata, sizeof(rotatedata));
+    ms.SetPosition(0);
+
+    // Destinations that are exact, truncating and padded.
+    std::vector<uint8_t> exact(sizeof(randomdata));
+    std::vector<uint8_t> truncated(sizeof(randomdata) / 2);
+    std::vector<uint8_t> padded(sizeof(randomdata) * 2, 0xFF);
+    std::vector<uint8_t> rotated(sizeof(randomdata));
+    SawyerChunkReader reader(&ms);
+    reader.ReadChunks({ { exact.data(), exact.size() },
+                        { truncated.data(), truncated.size() },
+                        { padded.data(), padded.size() },
+                        { rotated.data(), rotated.size() } });
+    ASSERT_EQ(ms.GetPosition(), ms.GetLength());
+
+    ASSERT_EQ(memcmp(exact.data(), randomdata, sizeof(randomdata)), 0);
+    ASSERT_EQ(memcmp(truncated.data(), randomdata, truncated.size()), 0);
+    ASSERT_EQ(memcmp(padded.data(), randomdata, sizeof(randomdata)), 0);
+    for (size_t i = sizeof(randomdata); i < padded.size(); i++)
+    {
+        ASSERT_EQ(padded[i], 0);
+    }
+    ASSERT_EQ(memcmp(rotated.data(), randomdata, sizeof(randomdata)), 0);
+}
+
+TEST_F(SawyerCodingTest, read_chunks_rewinds_on_error)
+{
+    OpenRCT2::MemoryStream ms;
+    ms.Write(nonedata, sizeof(nonedata));
+    ms.Write(rledata, sizeof(rledata) - 16);
+    ms.SetPosition(0);
+
+    std::vector<uint8_t> first(sizeof(randomdata));
+    std::vector<uint8_t> second(sizeof(randomdata));
+    SawyerChunkReader reader(&ms);
+    ASSERT_ANY_THROW(reader.ReadChunks({ { first.data(), first.size() }, { second.data(), second.size() } }));
+    ASSERT_EQ(ms.GetPosition(), 0u);
+}
+
+TEST_F(SawyerCodingTest, read_chunks_larger_than_buffer)
+{
+    // More compressed data than ReadChunks holds at once, so that it has to wait for chunks to be decoded.
+    constexpr size_t numChunks = 12;
+    constexpr size_t chunkLength = 1024 * 1024;
+    OpenRCT2::MemoryStream ms;
+    for (size_t i = 0; i < numChunks; i++)
+    {
+        sawyercoding_chunk_header header{ CHUNK_ENCODING_NONE, static_cast<uint32_t>(chunkLength) };
+        ms.Write(&header, sizeof(header));
+        std::vector<uint8_t> data(chunkLength, static_cast<uint8_t>(i + 1));
+        ms.Write(data.data(), data.size());
+    }
+    ms.SetPosition(0);
+
+    std::vector<std::vector<uint8_t>> chunks(numChunks, std::vector<uint8_t>(chunkLength));
+    std::vector<std::pair<void*, size_t>> destinations;
+    for (auto& chunk : chunks)
+    {
+        destinations.emplace_back(chunk.data(), chunk.size());
+    }
+    SawyerChunkReader reader(&ms);
+    reader.ReadChunks(destinations);
+    ASSERT_EQ(ms.GetPosition(), ms.GetLength());
+
+    for (size_t i = 0; i < numChunks; i++)
+    {
+        auto matching = std::count(chunks[i].begin(), chunks[i].end(), static_cast<uint8_t>(i + 1));
+        ASSERT_EQ(static_cast<size_t>(matching), chunkLength);
+    }
+}
+
+static std::vector<const SawyerCodingKernels*> GetVectorKernels()
+{
+    std::vector<const SawyerCodingKernels*> result;
+    if (sse41_available() && sawyercoding_kernels_sse4_1() != nullptr)
+        result.push_back(sawyercoding_kernels_sse4_1());
+    if (avx2_available() && sawyercoding_kernels_avx2() != nullptr)
+        result.push_back(sawyercoding_kernels_avx2());
+    return result;
+}
+
+/**
+ * Generates data with a mix of literals, runs of every length and short repeated sequences.
+ */
+static std::vector<uint8_t> GenerateCodingData(uint32_t seed, size_t length)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data;
+    while (data.size() < length)
+    {
+        auto blockLength = std::uniform_int_distribution<size_t>(1, 300)(rng);
+        switch (rng() % 3)
+        {
+            case 0:
+                for (size_t i = 0; i < blockLength; i++)
+                    data.push_back(static_cast<uint8_t>(rng()));
+                break;
+            case 1:
+                data.insert(data.end(), blockLength, static_cast<uint8_t>(rng() % 4));
+                break;
+            default:
+            {
+                auto period = std::uniform_int_distribution<size_t>(1, 40)(rng);
+                for (size_t i = 0; i < blockLength; i++)
+                    data.push_back(static_cast<uint8_t>((i % period) * 3));
+                break;
+            }
+        }
+    }
+    data.resize(length);
+    return data;
+}
+
+TEST_F(SawyerCodingTest, vector_kernels_match_scalar)
+{
+    const auto& scalar = *sawyercoding_kernels_scalar();
+    for (auto kernels : GetVectorKernels())
+    {
+        for (size_t length : { 1, 2, 3, 31, 32, 33, 127, 128, 129, 1000, 4099, 70001 })
+        {
+            for (uint32_t seed = 0; seed < 4; seed++)
+            {
+                auto data = GenerateCodingData(seed, length);
+                std::vector<uint8_t> expected((length * 3) + 64);
+                std::vector<uint8_t> actual((length * 3) + 64);
+                SCOPED_TRACE(std::string(kernels->Name) + " length " + std::to_string(length));
+
+                auto expectedLength = scalar.EncodeRLE(data.data(), expected.data(), length);
+                ASSERT_EQ(kernels->EncodeRLE(data.data(), actual.data(), length), expectedLength);
+                ASSERT_EQ(memcmp(actual.data(), expected.data(), expectedLength), 0);
+
+                // Decode into a tight destination and into one with room for wide stores
+                for (size_t capacity : { length, length + 64 })
+                {
+                    std::vector<uint8_t> decoded(capacity);
+                    size_t decodedLength = 0;
+                    auto result = kernels->DecodeRLE(
+                        actual.data(), expectedLength, decoded.data(), decoded.size(), &decodedLength);
+                    ASSERT_EQ(result, SawyerRLEDecodeResult::Ok);
+                    ASSERT_EQ(decodedLength, length);
+                    ASSERT_EQ(memcmp(decoded.data(), data.data(), length), 0);
+                }
+
+                expectedLength = scalar.EncodeRepeat(data.data(), expected.data(), length);
+                ASSERT_EQ(kernels->EncodeRepeat(data.data(), actual.data(), length), expectedLength);
+                ASSERT_EQ(memcmp(actual.data(), expected.data(), expectedLength), 0);
+
+                scalar.EncodeRotate(data.data(), expected.data(), length);
+                kernels->EncodeRotate(data.data(), actual.data(), length);
+                ASSERT_EQ(memcmp(actual.data(), expected.data(), length), 0);
+                kernels->DecodeRotate(expected.data(), actual.data(), length);
+                ASSERT_EQ(memcmp(actual.data(), data.data(), length), 0);
+            }
+        }
+    }
+}
+
+TEST_F(SawyerCodingTest, vector_kernels_reject_bad_rle)
+{
+    const auto& scalar = *sawyercoding_kernels_scalar();
+    auto data = GenerateCodingData(0, 1000);
+    std::vector<uint8_t> encoded(4096);
+    auto encodedLength = scalar.EncodeRLE(data.data(), encoded.data(), data.size());
+    for (auto kernels : GetVectorKernels())
+    {
+        std::vector<uint8_t> decoded(data.size() + 64);
+        size_t decodedLength = 0;
+        for (size_t truncatedLength : { encodedLength - 1, encodedLength / 2, static_cast<size_t>(1) })
+        {
+            auto expected = scalar.DecodeRLE(encoded.data(), truncatedLength, decoded.data(), decoded.size(), &decodedLength);
+            auto actual = kernels->DecodeRLE(encoded.data(), truncatedLength, decoded.data(), decoded.size(), &decodedLength);
+            ASSERT_EQ(actual, expected);
+        }
+        auto result = kernels->DecodeRLE(encoded.data(), encodedLength, decoded.data(), data.size() - 1, &decodedLength);
+        ASSERT_EQ(result, SawyerRLEDecodeResult::DestinationTooSmall);
+    }
+}
+
 // 1024 bytes of random data
 // use `dd if=/dev/urandom bs=1024 count=1 | xxd -i` to get your own
 const uint8_t SawyerCodingTest::randomdata[] = {